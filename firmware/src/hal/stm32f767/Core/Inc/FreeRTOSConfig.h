@@ -134,6 +134,16 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* Log records carry the number of the task that printed them. Tasks are
+numbered from 1 in the order they are created. */
+#define configUSE_TRACE_FACILITY                 1
+#define INCLUDE_xTaskGetCurrentTaskHandle        1
+#define traceTASK_CREATE( pxNewTCB )             ( ( pxNewTCB )->uxTaskNumber = ( pxNewTCB )->uxTCBNumber )
+/* Task switches are traced on an ITM stimulus port, see trace/trace.h */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  void Trace_TaskSwitchedIn(uint32_t taskNumber);
+#endif
+#define traceTASK_SWITCHED_IN()                  Trace_TaskSwitchedIn( pxCurrentTCB->uxTaskNumber )
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -11,171 +11,475 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include <math.h>
 
 #include "depends/depends.h"
 #include "logging/logging.h"
 
-REGISTERED_MODULE_STATIC_DEF(ADC);
-
 static Logging_T* logging;
 
-static uint32_t adcDMABuf[ADC_MAX_NUM_CHANNELS]; // DMA buffer
-static volatile uint32_t copyBufferA[ADC_MAX_NUM_CHANNELS];
-static volatile uint32_t copyBufferB[ADC_MAX_NUM_CHANNELS];
-// Copy buffers are "invalid" until the cplt callback has occured when that
-// buffer is active
-static volatile bool copyBufferAValid = false;
-static volatile bool copyBufferBValid = false;
+// Instances are looked up by their master handle in the HAL callbacks
+static ADC_T* instances[ADC_MAX_NUM_INSTANCES];
+static uint16_t numInstances = 0U;
 
-// The "active" buffer is the buffer that will be copied from DMA next
-static volatile enum {
-  COPY_BUFFER_A_ACTIVE,
-  COPY_BUFFER_B_ACTIVE
-} activeCopyBuffer;
+// ------------------- Private methods -------------------
+/**
+ * @brief Word-wise copy out of the (volatile) DMA buffer
+ *
+ * @param dest
+ * @param src
+ * @param len Number of words
+ */
+static void bufferCopy(uint32_t* dest, const volatile uint32_t* src, size_t len)
+{
+  for (size_t i = 0; i < len; ++i) {
+    dest[i] = src[i];
+  }
+}
 
-// details for copying to buffers
-size_t halfCpltCopyLen; // Number of elements to copy at ADC DMA half complete
-size_t cpltCopyOffset; // Array offset to copy from at ADC DMA full complete
-size_t cpltCopyLen; // Number of elements to copy at ADC DMA full complete
+/**
+ * @brief Gets a single channel from a buffer of packed half-word conversions
+ */
+static inline uint16_t bufferGetChannel(const uint32_t* buf, const ADC_Channel_T channel)
+{
+  const uint32_t word = buf[channel / 2U];
+  return (uint16_t)((channel % 2U == 0U) ? (word & 0xFFFFU) : (word >> 16U));
+}
 
-static uint16_t numChannels; // Number of ADC channels in use
+/**
+ * @brief Sequence number of the conversion set after seq.
+ *
+ * Wraps at a multiple of the number of buffers so that the buffer index
+ * (sequence % ADC_NUM_SAMPLE_BUFFERS) is continuous, and skips 0 (no data).
+ */
+static inline uint32_t nextSequence(const uint32_t seq)
+{
+  _Static_assert(UINT32_MAX % ADC_NUM_SAMPLE_BUFFERS == 0U,
+      "Sequence must wrap at a multiple of the number of buffers");
+  const uint32_t next = seq + 1U;
+  return (UINT32_MAX == next) ? ADC_NUM_SAMPLE_BUFFERS : next;
+}
 
-static ADC_HandleTypeDef* adcHandle;
-static IRQn_Type adcIrq;
+/**
+ * @brief Checks that the buffer of conversion set seqStart was not rewritten
+ * while it was being read. Call after reading the buffer.
+ *
+ * The buffer of set n is only written again when preparing set
+ * n + ADC_NUM_SAMPLE_BUFFERS, which starts once the set before it has been
+ * published.
+ *
+ * @param adc ADC instance
+ * @param seqStart Sequence number read before reading the buffer
+ * @return true if the data read is consistent
+ */
+static bool readConsistent(const ADC_T* adc, const uint32_t seqStart)
+{
+  __DMB();
+  const uint32_t seqEnd = adc->sequence;
+  return (uint32_t)(seqEnd - seqStart) < (ADC_NUM_SAMPLE_BUFFERS - 1U);
+}
 
-static bool adcInitialized = false;
+/**
+ * @brief Finds the driver instance that owns a (master) ADC handle
+ *
+ * @param hadc ADC handle
+ * @return ADC instance, or NULL if the handle is not in use
+ */
+static ADC_T* handleToInstance(const ADC_HandleTypeDef* hadc)
+{
+  for (uint16_t i = 0; i < numInstances; ++i) {
+    if (instances[i]->handle == hadc) {
+      return instances[i];
+    }
+  }
+
+  return NULL;
+}
 
-// ------------------- Private methods -------------------
 /**
- * @brief Alternative to memcpy that works on volatile uint32_t arrays
- * 
- * @param dest 
- * @param src 
- * @param len 
+ * @brief Finds the driver instance and ADC in the group for any ADC handle
+ *
+ * @param hadc ADC handle (master or slave)
+ * @param adcIndex Output index of the ADC in the group
+ * @return ADC instance, or NULL if the handle is not in use
  */
-void bufferCopy(volatile uint32_t* dest, volatile uint32_t* src, size_t len)
+static ADC_T* handleToGroupInstance(const ADC_HandleTypeDef* hadc, uint16_t* adcIndex)
 {
-  for (size_t i = 0; i < len; ++i) {
-    dest[i] = src[i];
+  for (uint16_t i = 0; i < numInstances; ++i) {
+    ADC_T* adc = instances[i];
+    if (adc->handle == hadc) {
+      *adcIndex = 0U;
+      return adc;
+    }
+    for (uint16_t j = 1U; j < adc->numAdcs; ++j) {
+      if (adc->slaves[j - 1U] == hadc) {
+        *adcIndex = j;
+        return adc;
+      }
+    }
   }
+
+  return NULL;
 }
 
 /**
- * @brief Alternative to memset to operate on volatile uint32_t arrays
- * 
- * @param dest 
- * @param val 
- * @param len 
+ * @brief Handle of an ADC in the group
  */
-void bufferSet(volatile uint32_t* dest, volatile uint32_t val, size_t len)
+static ADC_HandleTypeDef* groupHandle(const ADC_T* adc, const uint16_t adcIndex)
 {
-  for (size_t i = 0; i < len; ++i) {
-    dest[i] = val;
+  return (0U == adcIndex) ? adc->handle : adc->slaves[adcIndex - 1U];
+}
+
+/**
+ * @brief Number of ADCs sampled in a group for the given mode
+ */
+static uint16_t modeNumAdcs(const ADC_MultiMode_T mode)
+{
+  switch (mode) {
+    case ADC_MULTIMODE_DUAL_SIMULT:
+    case ADC_MULTIMODE_DUAL_INTERL:
+      return 2U;
+
+    case ADC_MULTIMODE_TRIPLE_SIMULT:
+    case ADC_MULTIMODE_TRIPLE_INTERL:
+      return 3U;
+
+    case ADC_MULTIMODE_INDEPENDENT:
+    default:
+      return 1U;
   }
 }
 
-// ------------------- Public methods -------------------
-ADC_Status_T ADC_Init(ADC_Config_T* config)
+/**
+ * @brief Applies the ADC common (multi-mode) settings to the master ADC.
+ *
+ * The DMA access mode is chosen so that the DMA buffer always contains
+ * half-word conversions in the order ADC1, ADC2[, ADC3] for each rank.
+ *
+ * @param adc ADC instance
+ * @param halfWordsPerItem Output number of conversions per DMA data item
+ * @return true if successful
+ */
+static bool configureMultiMode(ADC_T* adc, uint16_t* halfWordsPerItem)
 {
-  logging = config->logger;
-  Log_Print(logging, "ADC_Init begin\n");
-  DEPEND_ON(logging, ADC_STATUS_ERROR_DEPENDS);
+  ADC_MultiModeTypeDef multimode = {
+    .Mode = ADC_MODE_INDEPENDENT,
+    .DMAAccessMode = ADC_DMAACCESSMODE_DISABLED,
+    .TwoSamplingDelay = adc->twoSamplingDelay,
+  };
+
+  switch (adc->mode) {
+    case ADC_MULTIMODE_INDEPENDENT:
+      // No common settings to apply, single ADC uses its own DMA requests
+      *halfWordsPerItem = 1U;
+      return true;
+
+    case ADC_MULTIMODE_DUAL_SIMULT:
+      multimode.Mode = ADC_DUALMODE_REGSIMULT;
+      multimode.DMAAccessMode = ADC_DMAACCESSMODE_2;
+      break;
 
-  if (config->numChannelsUsed > ADC_MAX_NUM_CHANNELS) {
-    return ADC_STATUS_ERROR_CHANNEL_COUNT;
+    case ADC_MULTIMODE_DUAL_INTERL:
+      multimode.Mode = ADC_DUALMODE_INTERL;
+      multimode.DMAAccessMode = ADC_DMAACCESSMODE_2;
+      break;
+
+    case ADC_MULTIMODE_TRIPLE_SIMULT:
+      multimode.Mode = ADC_TRIPLEMODE_REGSIMULT;
+      multimode.DMAAccessMode = ADC_DMAACCESSMODE_1;
+      break;
+
+    case ADC_MULTIMODE_TRIPLE_INTERL:
+      multimode.Mode = ADC_TRIPLEMODE_INTERL;
+      multimode.DMAAccessMode = ADC_DMAACCESSMODE_2;
+      break;
+
+    default:
+      return false;
   }
 
-  ADC_InitTypeDef* hwInit = &config->handle->Init;
-  if (config->numChannelsUsed != hwInit->NbrOfConversion) {
-    Log_Print(logging, "ADC_Init number of channels does not match hardware settings\n");
+  *halfWordsPerItem = (ADC_DMAACCESSMODE_2 == multimode.DMAAccessMode) ? 2U : 1U;
+
+  return HAL_OK == HAL_ADCEx_MultiModeConfigChannel(adc->handle, &multimode);
+}
+
+/**
+ * @brief Checks that a HAL ADC handle matches what the driver requires
+ *
+ * @param adc ADC instance
+ * @param hadc Handle of ADC in the group
+ * @param isMaster True for the ADC that owns the DMA stream
+ * @return ADC_STATUS_OK if consistent
+ */
+static ADC_Status_T checkHwConfig(
+    const ADC_T* adc,
+    ADC_HandleTypeDef* hadc,
+    const bool isMaster)
+{
+  if (NULL == hadc) {
+    Log_Print(logging, LOGGING_MODULE_ADC, LOGGING_LEVEL_ERROR, "ADC_Init ADC handle missing for mode\n");
     return ADC_STATUS_ERROR_HW_CONFIG;
   }
-  if (ENABLE != hwInit->ContinuousConvMode) {
-    Log_Print(logging, "ADC_Init hardware setting ContinuousConvMode required\n");
+
+  ADC_InitTypeDef* hwInit = &hadc->Init;
+  if (adc->numChannelsUsed != hwInit->NbrOfConversion) {
+    Log_Print(logging, LOGGING_MODULE_ADC, LOGGING_LEVEL_ERROR, "ADC_Init number of channels does not match hardware settings\n");
+    return ADC_STATUS_ERROR_HW_CONFIG;
+  }
+  if (isMaster && ENABLE != hwInit->ContinuousConvMode) {
+    Log_Print(logging, LOGGING_MODULE_ADC, LOGGING_LEVEL_ERROR, "ADC_Init hardware setting ContinuousConvMode required\n");
     return ADC_STATUS_ERROR_HW_CONFIG;
   }
   if (ADC_DATAALIGN_RIGHT != hwInit->DataAlign) {
-    Log_Print(logging, "ADC_Init hardware setting DataAlign must be aligned right\n");
+    Log_Print(logging, LOGGING_MODULE_ADC, LOGGING_LEVEL_ERROR, "ADC_Init hardware setting DataAlign must be aligned right\n");
     return ADC_STATUS_ERROR_HW_CONFIG;
   }
 
-  // Initialize buffers to 0 (can't use memset due to volatile)
-  bufferSet(adcDMABuf, 0, ADC_MAX_NUM_CHANNELS);
-  bufferSet(copyBufferA, 0, ADC_MAX_NUM_CHANNELS);
-  bufferSet(copyBufferB, 0, ADC_MAX_NUM_CHANNELS);
-  copyBufferAValid = false;
-  copyBufferBValid = false;
-
-  numChannels = config->numChannelsUsed;
-  adcHandle = config->handle;
-  adcIrq = config->adcIrq;
-
-  // Copy buffer settings
-  activeCopyBuffer = COPY_BUFFER_A_ACTIVE;
-  // For the half complete event, in the event of an uneven number of data
-  // points, just round down with integer divide
-  halfCpltCopyLen = numChannels / 2;
-  cpltCopyOffset = numChannels / 2;
-  if (numChannels % 2 == 0) {
-    cpltCopyLen = numChannels / 2;
-  } else {
-    cpltCopyLen = numChannels / 2 + 1;
+  return ADC_STATUS_OK;
+}
+
+/**
+ * @brief Adds the instance to the list used by the HAL callbacks.
+ * An instance already using the same handle is replaced.
+ *
+ * @return true if successful
+ */
+static bool addInstance(ADC_T* adc)
+{
+  for (uint16_t i = 0; i < numInstances; ++i) {
+    if (instances[i] == adc || instances[i]->handle == adc->handle) {
+      instances[i] = adc;
+      return true;
+    }
   }
 
-  adcInitialized = true;
+  if (numInstances >= ADC_MAX_NUM_INSTANCES) {
+    return false;
+  }
 
-  // Start conversions
-  if (HAL_ADC_Start_DMA(config->handle, adcDMABuf, numChannels) != HAL_OK) {
-    return ADC_STATUS_ERROR_DMA;
+  instances[numInstances++] = adc;
+  return true;
+}
+
+// ------------------- Public methods -------------------
+ADC_Status_T ADC_Init(ADC_T* adc)
+{
+  logging = adc->logger;
+  Log_Print(logging, LOGGING_MODULE_ADC, LOGGING_LEVEL_DEBUG, "ADC_Init begin\n");
+  DEPEND_ON(logging, ADC_STATUS_ERROR_DEPENDS);
+
+  if (adc->numChannelsUsed > ADC_MAX_NUM_RANKS) {
+    return ADC_STATUS_ERROR_CHANNEL_COUNT;
+  }
+
+  // Check the master and every slave ADC used by the mode
+  adc->numAdcs = modeNumAdcs(adc->mode);
+  ADC_Status_T hwStatus = checkHwConfig(adc, adc->handle, true);
+  for (uint16_t i = 1U; i < adc->numAdcs && ADC_STATUS_OK == hwStatus; ++i) {
+    hwStatus = checkHwConfig(adc, adc->slaves[i - 1U], false);
+  }
+  if (ADC_STATUS_OK != hwStatus) {
+    return hwStatus;
+  }
+
+  uint16_t halfWordsPerItem = 1U;
+  if (!configureMultiMode(adc, &halfWordsPerItem)) {
+    Log_Print(logging, LOGGING_MODULE_ADC, LOGGING_LEVEL_ERROR, "ADC_Init multi-mode configuration failed\n");
+    return ADC_STATUS_ERROR_HW_CONFIG;
   }
 
-  // TODO: this only works for ADC1 (with multiple channels), expand to ADCx
+  adc->numChannels = (uint16_t)(adc->numChannelsUsed * adc->numAdcs);
+  if (adc->numChannels % halfWordsPerItem != 0U) {
+    // DMA transfers conversions in pairs in this mode
+    return ADC_STATUS_ERROR_CHANNEL_COUNT;
+  }
+  adc->dmaLen = adc->numChannels / halfWordsPerItem;
+
+  // Initialize buffers to 0
+  memset(adc->dmaBuf, 0, sizeof(adc->dmaBuf));
+  memset(adc->sampleBuf, 0, sizeof(adc->sampleBuf));
+  memset(adc->sampleTimestamp, 0, sizeof(adc->sampleTimestamp));
+  adc->sequence = 0U;
+  memset(adc->watchdog, 0, sizeof(adc->watchdog));
+
+  // Copy buffer settings. Only the words holding used channels are copied.
+  // For the half complete event, in the event of an uneven number of DMA
+  // items, just round down with integer divide. A word split across the two
+  // halves (independent mode, odd number of channels in the first half) is
+  // copied with the second half.
+  const uint16_t numWords = (uint16_t)((adc->numChannels + 1U) / 2U);
+  adc->halfCpltCopyLen = (uint16_t)(((adc->dmaLen / 2U) * halfWordsPerItem) / 2U);
+  adc->cpltCopyOffset = adc->halfCpltCopyLen;
+  adc->cpltCopyLen = (uint16_t)(numWords - adc->halfCpltCopyLen);
+
+  if (!addInstance(adc)) {
+    return ADC_STATUS_ERROR_INSTANCE_COUNT;
+  }
 
-  REGISTER_STATIC(ADC, ADC_STATUS_ERROR_DEPENDS);
-  Log_Print(logging, "ADC_Init complete\n");
+  // Start conversions. Slaves are enabled first and are then triggered by
+  // the master.
+  HAL_StatusTypeDef startStatus = HAL_OK;
+  if (ADC_MULTIMODE_INDEPENDENT == adc->mode) {
+    startStatus = HAL_ADC_Start_DMA(adc->handle, adc->dmaBuf, adc->dmaLen);
+  } else {
+    for (uint16_t i = 1U; i < adc->numAdcs && HAL_OK == startStatus; ++i) {
+      startStatus = HAL_ADC_Start(adc->slaves[i - 1U]);
+    }
+    if (HAL_OK == startStatus) {
+      startStatus = HAL_ADCEx_MultiModeStart_DMA(adc->handle, adc->dmaBuf, adc->dmaLen);
+    }
+  }
+  if (HAL_OK != startStatus) {
+    return ADC_STATUS_ERROR_DMA;
+  }
+
+  REGISTER(adc, ADC_STATUS_ERROR_DEPENDS);
+  Log_Print(logging, LOGGING_MODULE_ADC, LOGGING_LEVEL_DEBUG, "ADC_Init complete\n");
   return ADC_STATUS_OK;
 }
 
 //------------------------------------------------------------------------------
-ADC_Status_T ADC_Get(const ADC_Channel_T channel, uint16_t* val)
+ADC_Status_T ADC_Get(ADC_T* adc, const ADC_Channel_T channel, uint16_t* val)
 {
-  if (channel > numChannels) {
-    *val = 0;
-    return ADC_STATUS_ERROR_INVALID_CHANNEL;
+  return ADC_GetChannels(adc, &channel, val, 1U, NULL);
+}
+
+//------------------------------------------------------------------------------
+ADC_Status_T ADC_GetChannels(
+    ADC_T* adc,
+    const ADC_Channel_T* channels,
+    uint16_t* vals,
+    const uint16_t numChannels,
+    uint32_t* timestamp)
+{
+  memset(vals, 0, numChannels * sizeof(uint16_t));
+
+  for (uint16_t i = 0; i < numChannels; ++i) {
+    if (channels[i] >= adc->numChannels) {
+      return ADC_STATUS_ERROR_INVALID_CHANNEL;
+    }
   }
 
-  ADC_Status_T ret = ADC_STATUS_OK;
+  for (uint16_t attempt = 0; attempt < ADC_READ_MAX_ATTEMPTS; ++attempt) {
+    const uint32_t seq = adc->sequence;
+    if (0U == seq) {
+      return ADC_STATUS_ERROR_DATANOTREADY;
+    }
+    __DMB();
 
-  HAL_NVIC_DisableIRQ(adcIrq);
+    const uint32_t bufIndex = seq % ADC_NUM_SAMPLE_BUFFERS;
+    const uint32_t* buf = adc->sampleBuf[bufIndex];
+    for (uint16_t i = 0; i < numChannels; ++i) {
+      vals[i] = bufferGetChannel(buf, channels[i]);
+    }
+    const uint32_t sampleTime = adc->sampleTimestamp[bufIndex];
 
-  switch (activeCopyBuffer) {
-    case COPY_BUFFER_A_ACTIVE:
-      if (copyBufferBValid) {
-        *val = (uint16_t)(copyBufferB[channel] & 0xFFFF);
-      } else {
-        *val = 0;
-        ret = ADC_STATUS_ERROR_DATANOTREADY;
+    if (readConsistent(adc, seq)) {
+      if (NULL != timestamp) {
+        *timestamp = sampleTime;
       }
-      break;
+      return ADC_STATUS_OK;
+    }
+  }
 
-    case COPY_BUFFER_B_ACTIVE:
-      if (copyBufferAValid) {
-        *val = (uint16_t)(copyBufferA[channel] & 0xFFFF);
-      } else {
-        *val = 0;
-        ret = ADC_STATUS_ERROR_DATANOTREADY;
-      }
-      break;
+  // Kept being overwritten by the DMA interrupt
+  memset(vals, 0, numChannels * sizeof(uint16_t));
+  return ADC_STATUS_ERROR_BUSY;
+}
 
-    default:
-      *val = 0;
-      ret = ADC_STATUS_ERROR_INTERNAL;
+//------------------------------------------------------------------------------
+ADC_Status_T ADC_GetAll(ADC_T* adc, ADC_Snapshot_T* snapshot)
+{
+  memset(snapshot, 0, sizeof(ADC_Snapshot_T));
+
+  const size_t numBytes = ((adc->numChannels + 1U) / 2U) * sizeof(uint32_t);
+
+  for (uint16_t attempt = 0; attempt < ADC_READ_MAX_ATTEMPTS; ++attempt) {
+    const uint32_t seq = adc->sequence;
+    if (0U == seq) {
+      return ADC_STATUS_ERROR_DATANOTREADY;
+    }
+    __DMB();
+
+    const uint32_t bufIndex = seq % ADC_NUM_SAMPLE_BUFFERS;
+    memcpy(snapshot->values, adc->sampleBuf[bufIndex], numBytes);
+    snapshot->timestamp = adc->sampleTimestamp[bufIndex];
+
+    if (readConsistent(adc, seq)) {
+      snapshot->sequence = seq;
+      snapshot->numChannels = adc->numChannels;
+      return ADC_STATUS_OK;
+    }
+  }
+
+  // Kept being overwritten by the DMA interrupt
+  memset(snapshot, 0, sizeof(ADC_Snapshot_T));
+  return ADC_STATUS_ERROR_BUSY;
+}
+
+//------------------------------------------------------------------------------
+ADC_Status_T ADC_ConfigWatchdog(
+    ADC_T* adc,
+    const ADC_Channel_T channel,
+    const uint32_t hwChannel,
+    const uint16_t lowerThreshold,
+    const uint16_t upperThreshold)
+{
+  if (channel >= adc->numChannels) {
+    return ADC_STATUS_ERROR_INVALID_CHANNEL;
+  }
+
+  // Conversions are interleaved by ADC in the group
+  const uint16_t adcIndex = (uint16_t)(channel % adc->numAdcs);
+  ADC_Watchdog_T* watchdog = &adc->watchdog[adcIndex];
+  if (watchdog->enabled && watchdog->channel != channel) {
+    Log_Print(logging, LOGGING_MODULE_ADC, LOGGING_LEVEL_ERROR, "ADC_ConfigWatchdog watchdog already in use\n");
+    return ADC_STATUS_ERROR_WATCHDOG;
+  }
+
+  watchdog->enabled = false;
+  watchdog->channel = channel;
+  watchdog->tripped = false;
+  watchdog->timestamp = 0U;
+
+  ADC_AnalogWDGConfTypeDef awdConfig = {
+    .WatchdogMode = ADC_ANALOGWATCHDOG_SINGLE_REG,
+    .HighThreshold = upperThreshold,
+    .LowThreshold = lowerThreshold,
+    .Channel = hwChannel,
+    .ITMode = ENABLE,
+    .WatchdogNumber = 0U, // Unused on F7
+  };
+  if (HAL_OK != HAL_ADC_AnalogWDGConfig(groupHandle(adc, adcIndex), &awdConfig)) {
+    return ADC_STATUS_ERROR_WATCHDOG;
+  }
+
+  watchdog->enabled = true;
+  return ADC_STATUS_OK;
+}
+
+//------------------------------------------------------------------------------
+bool ADC_GetWatchdogEvent(ADC_T* adc, const ADC_Channel_T channel, uint32_t* timestamp)
+{
+  if (channel >= adc->numChannels) {
+    return false;
   }
-  
-  HAL_NVIC_EnableIRQ(adcIrq);
-  
-  return ret;
+
+  const uint16_t adcIndex = (uint16_t)(channel % adc->numAdcs);
+  ADC_Watchdog_T* watchdog = &adc->watchdog[adcIndex];
+  if (!watchdog->enabled || watchdog->channel != channel || !watchdog->tripped) {
+    return false;
+  }
+
+  // The interrupt is disabled while tripped, so there is no race here
+  if (NULL != timestamp) {
+    *timestamp = watchdog->timestamp;
+  }
+  watchdog->tripped = false;
+  __HAL_ADC_ENABLE_IT(groupHandle(adc, adcIndex), ADC_IT_AWD);
+
+  return true;
 }
 
 //------------------------------------------------------------------------------
@@ -200,30 +504,82 @@ float ADC_ApplyScaling(
   return output;
 }
 
+//------------------------------------------------------------------------------
+ADC_Status_T ADC_CompileScaling(
+    ADC_ScalingTable_T* table,
+    const ADC_Scaling_T* scalings,
+    const uint16_t numScalings)
+{
+  memset(table, 0, sizeof(ADC_ScalingTable_T));
+
+  if (numScalings > ADC_MAX_NUM_CHANNELS) {
+    return ADC_STATUS_ERROR_SCALING;
+  }
+
+  for (uint16_t i = 0; i < numScalings; ++i) {
+    const ADC_Scaling_T* scaling = &scalings[i];
+    const int32_t range = (int32_t)scaling->upperScaling - (int32_t)scaling->lowerScaling;
+
+    // gain must fit in int32_t
+    if (range > -3 && range < 3) {
+      memset(table, 0, sizeof(ADC_ScalingTable_T));
+      return ADC_STATUS_ERROR_SCALING;
+    }
+
+    // 2^32 / range, rounded to nearest (away from zero at half)
+    const int64_t num = (int64_t)1 << 32;
+    const int64_t halfRange = ((range > 0) ? range : -range) / 2;
+    const int64_t gain = (num + halfRange) / range;
+
+    table->offset[i] = scaling->lowerScaling;
+    table->gain[i] = (int32_t)gain;
+    table->min[i] = scaling->saturate ? 0 : INT32_MIN;
+    table->max[i] = scaling->saturate ? ADC_SCALING_Q16_ONE : INT32_MAX;
+  }
+
+  table->numEntries = numScalings;
+  return ADC_STATUS_OK;
+}
+
+//------------------------------------------------------------------------------
+void ADC_ApplyScalingTable(
+    const ADC_ScalingTable_T* table,
+    const uint16_t* raw,
+    int32_t* outQ16,
+    float* outFloat)
+{
+  const float q16ToFloat = 1.0f / (float)ADC_SCALING_Q16_ONE;
+
+  for (uint16_t i = 0; i < table->numEntries; ++i) {
+    const int32_t num = (int32_t)raw[i] - table->offset[i];
+    // 32x32->64 bit multiply, then arithmetic right shift (floor) to round
+    int32_t q16 = (int32_t)(((int64_t)num * table->gain[i] + (1 << 15)) >> 16);
+    q16 = (q16 < table->min[i]) ? table->min[i] : q16;
+    q16 = (q16 > table->max[i]) ? table->max[i] : q16;
+
+    if (NULL != outQ16) {
+      outQ16[i] = q16;
+    }
+    if (NULL != outFloat) {
+      outFloat[i] = (float)q16 * q16ToFloat;
+    }
+  }
+}
+
 // ------------------- Interrupts -------------------
 /**
  * @brief Called when first half of buffer is filled
  */
 void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
 {
-  if (hadc != adcHandle) {
+  ADC_T* adc = handleToInstance(hadc);
+  if (NULL == adc) {
     return;
   }
 
-  // copy first half of buffer to active copy buffer
-  switch (activeCopyBuffer) {
-    case COPY_BUFFER_A_ACTIVE:
-      bufferCopy(copyBufferA, adcDMABuf, halfCpltCopyLen);
-      break;
-
-    case COPY_BUFFER_B_ACTIVE:
-      bufferCopy(copyBufferB, adcDMABuf, halfCpltCopyLen);
-      break;
-
-    default:
-      // This shouldn't ever happen
-      break;
-  }
+  // copy first half of buffer to the buffer of the next conversion set
+  const uint32_t bufIndex = nextSequence(adc->sequence) % ADC_NUM_SAMPLE_BUFFERS;
+  bufferCopy(adc->sampleBuf[bufIndex], adc->dmaBuf, adc->halfCpltCopyLen);
 }
 
 /**
@@ -231,31 +587,43 @@ void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
  */
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
 {
-  if (hadc != adcHandle) {
+  ADC_T* adc = handleToInstance(hadc);
+  if (NULL == adc) {
     return;
   }
 
-  // copy second half of buffer to second half of active copy buffer and
-  // switch the active buffer
-  switch (activeCopyBuffer) {
-    case COPY_BUFFER_A_ACTIVE:
-      bufferCopy(copyBufferA + cpltCopyOffset,
-                 adcDMABuf + cpltCopyOffset,
-                 cpltCopyLen);
-      copyBufferAValid = true;
-      activeCopyBuffer = COPY_BUFFER_B_ACTIVE;
-      break;
+  // copy second half of buffer to second half of the next conversion set,
+  // and publish it
+  const uint32_t seq = nextSequence(adc->sequence);
+  const uint32_t bufIndex = seq % ADC_NUM_SAMPLE_BUFFERS;
+  bufferCopy(adc->sampleBuf[bufIndex] + adc->cpltCopyOffset,
+             adc->dmaBuf + adc->cpltCopyOffset,
+             adc->cpltCopyLen);
+  adc->sampleTimestamp[bufIndex] = HAL_GetTick();
+
+  // Data must be visible before the sequence is
+  __DMB();
+  adc->sequence = seq;
+}
 
-    case COPY_BUFFER_B_ACTIVE:
-      bufferCopy(copyBufferB + cpltCopyOffset,
-                 adcDMABuf + cpltCopyOffset,
-                 cpltCopyLen);
-      copyBufferBValid = true;
-      activeCopyBuffer = COPY_BUFFER_A_ACTIVE;
-      break;
+/**
+ * @brief Called when a conversion is outside of the analog watchdog window
+ */
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef* hadc)
+{
+  // Only report the first out of window conversion until the event is
+  // collected. Otherwise this would fire for every conversion.
+  __HAL_ADC_DISABLE_IT(hadc, ADC_IT_AWD);
 
-    default:
-      // This shouldn't ever happen
-      activeCopyBuffer = COPY_BUFFER_A_ACTIVE;
+  uint16_t adcIndex = 0U;
+  ADC_T* adc = handleToGroupInstance(hadc, &adcIndex);
+  if (NULL == adc) {
+    return;
+  }
+
+  ADC_Watchdog_T* watchdog = &adc->watchdog[adcIndex];
+  if (watchdog->enabled && !watchdog->tripped) {
+    watchdog->timestamp = HAL_GetTick();
+    watchdog->tripped = true;
   }
 }
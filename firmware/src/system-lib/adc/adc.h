@@ -17,7 +17,31 @@
 #include "depends/depends.h"
 #include "logging/logging.h"
 
-REGISTERED_MODULE_STATIC(ADC);
+/*
+ * Max number of conversions (ranks) in the regular sequence of one ADC
+ */
+#define ADC_MAX_NUM_RANKS 16U
+
+/*
+ * Max number of ADCs sampled together in a multi-ADC mode (ADC1/2/3)
+ */
+#define ADC_MAX_NUM_ADCS 3U
+
+/*
+ * Max number of ADC driver instances (i.e. DMA streams) that can be active
+ */
+#define ADC_MAX_NUM_INSTANCES 3U
+
+/*
+ * Number of attempts a reader makes to get a consistent set of samples before
+ * giving up (only fails if the reader is starved for multiple DMA cycles)
+ */
+#define ADC_READ_MAX_ATTEMPTS 3U
+
+/*
+ * Number of buffers that completed conversion sets are copied into
+ */
+#define ADC_NUM_SAMPLE_BUFFERS 3U
 
 typedef enum
 {
@@ -27,10 +51,22 @@ typedef enum
   ADC_STATUS_ERROR_DEPENDS          = 0x03,
   ADC_STATUS_ERROR_HW_CONFIG        = 0x04,
   ADC_STATUS_ERROR_INVALID_CHANNEL  = 0x05,
+  ADC_STATUS_ERROR_INSTANCE_COUNT   = 0x06,
   ADC_STATUS_ERROR_INTERNAL         = 0x07,
   ADC_STATUS_ERROR_DATANOTREADY     = 0x08,
+  ADC_STATUS_ERROR_BUSY             = 0x09,
+  ADC_STATUS_ERROR_WATCHDOG         = 0x0A,
+  ADC_STATUS_ERROR_SCALING          = 0x0B,
 } ADC_Status_T;
 
+/**
+ * @brief Logical channels of an ADC instance.
+ *
+ * Channels are numbered in the order the conversions are transferred by DMA.
+ * For a single (independent) ADC this is the rank order of the regular
+ * sequence. In a multi-ADC mode the conversions of each rank are interleaved
+ * ADC1, ADC2[, ADC3] - see ADC_MULTIMODE_CHANNEL.
+ */
 typedef enum {
   ADC_CONVERSIONCHANNEL0 = 0,
   ADC_CONVERSIONCHANNEL1,
@@ -48,10 +84,75 @@ typedef enum {
   ADC_CONVERSIONCHANNEL13,
   ADC_CONVERSIONCHANNEL14,
   ADC_CONVERSIONCHANNEL15,
+  ADC_CONVERSIONCHANNEL16,
+  ADC_CONVERSIONCHANNEL17,
+  ADC_CONVERSIONCHANNEL18,
+  ADC_CONVERSIONCHANNEL19,
+  ADC_CONVERSIONCHANNEL20,
+  ADC_CONVERSIONCHANNEL21,
+  ADC_CONVERSIONCHANNEL22,
+  ADC_CONVERSIONCHANNEL23,
+  ADC_CONVERSIONCHANNEL24,
+  ADC_CONVERSIONCHANNEL25,
+  ADC_CONVERSIONCHANNEL26,
+  ADC_CONVERSIONCHANNEL27,
+  ADC_CONVERSIONCHANNEL28,
+  ADC_CONVERSIONCHANNEL29,
+  ADC_CONVERSIONCHANNEL30,
+  ADC_CONVERSIONCHANNEL31,
+  ADC_CONVERSIONCHANNEL32,
+  ADC_CONVERSIONCHANNEL33,
+  ADC_CONVERSIONCHANNEL34,
+  ADC_CONVERSIONCHANNEL35,
+  ADC_CONVERSIONCHANNEL36,
+  ADC_CONVERSIONCHANNEL37,
+  ADC_CONVERSIONCHANNEL38,
+  ADC_CONVERSIONCHANNEL39,
+  ADC_CONVERSIONCHANNEL40,
+  ADC_CONVERSIONCHANNEL41,
+  ADC_CONVERSIONCHANNEL42,
+  ADC_CONVERSIONCHANNEL43,
+  ADC_CONVERSIONCHANNEL44,
+  ADC_CONVERSIONCHANNEL45,
+  ADC_CONVERSIONCHANNEL46,
+  ADC_CONVERSIONCHANNEL47,
   ADC_MAX_NUM_CHANNELS
 } ADC_Channel_T;
 _Static_assert( (ADC_MAX_NUM_CHANNELS / 2) * 2 == ADC_MAX_NUM_CHANNELS, "Value must be multiple of 2");
+_Static_assert(ADC_MAX_NUM_CHANNELS == ADC_MAX_NUM_RANKS * ADC_MAX_NUM_ADCS,
+    "Channel enum must cover every rank of every ADC");
 
+/**
+ * @brief Gets the logical channel for a rank sampled by one ADC of a
+ * multi-ADC group.
+ *
+ * @param rank Zero-based rank in the regular sequence.
+ * @param adcIndex 0 for the master (ADC1), 1 for ADC2, 2 for ADC3.
+ * @param numAdcs Number of ADCs in the group (1, 2 or 3).
+ */
+#define ADC_MULTIMODE_CHANNEL(rank, adcIndex, numAdcs) \
+  ((ADC_Channel_T)((rank) * (numAdcs) + (adcIndex)))
+
+/**
+ * @brief ADC operating modes.
+ *
+ * Simultaneous modes convert the same rank on every ADC at the same instant
+ * (e.g. for redundant sensors). Interleaved modes stagger the ADCs sampling
+ * the same channel to multiply the sample rate.
+ *
+ * All ADCs in a multi-ADC mode must be configured with the same number of
+ * conversions. The DMA stream of the master ADC must be configured for
+ * word transfers, except in ADC_MULTIMODE_TRIPLE_SIMULT (and independent mode)
+ * which use half-word transfers.
+ */
+typedef enum
+{
+  ADC_MULTIMODE_INDEPENDENT = 0,
+  ADC_MULTIMODE_DUAL_SIMULT,
+  ADC_MULTIMODE_DUAL_INTERL,
+  ADC_MULTIMODE_TRIPLE_SIMULT,
+  ADC_MULTIMODE_TRIPLE_INTERL,
+} ADC_MultiMode_T;
 
 /**
  * @brief Used to read from a channel and apply scaling to obtain a fraction
@@ -64,41 +165,225 @@ typedef struct
   bool saturate;
 } ADC_Scaling_T;
 
+/*
+ * Fixed-point scaled values are Q16.16, i.e. 1.0 == ADC_SCALING_Q16_ONE
+ */
+#define ADC_SCALING_Q16_ONE ((int32_t)0x00010000)
+
+/**
+ * @brief A set of ADC_Scaling_T compiled to Q16 fixed-point, for scaling
+ * several readings in one pass (see ADC_ApplyScalingTable).
+ *
+ * For each entry i:
+ *   q16 = ((raw - offset[i]) * gain[i] + 2^15) >> 16, clamped to [min[i], max[i]]
+ * where gain[i] = round(2^32 / (upper - lower)) is the reciprocal of the
+ * range. Only integer operations are used, so results are bit-exact between
+ * the target and host tests. The float output is q16 / 2^16, which is exact.
+ *
+ * Arrays are stored separately (rather than an array of structs) so the
+ * scaling pass is a tight loop over contiguous data.
+ */
+typedef struct
+{
+  uint16_t numEntries;
+  int32_t offset[ADC_MAX_NUM_CHANNELS];
+  int32_t gain[ADC_MAX_NUM_CHANNELS]; // Q16 reciprocal of the scaling range
+  int32_t min[ADC_MAX_NUM_CHANNELS]; // Saturation limits (Q16)
+  int32_t max[ADC_MAX_NUM_CHANNELS];
+} ADC_ScalingTable_T;
+
+/**
+ * @brief State of the analog watchdog of one ADC. The STM32F7 has a single
+ * analog watchdog per ADC, so each ADC in a group can watch one channel.
+ */
+typedef struct
+{
+  bool enabled;
+  ADC_Channel_T channel; // Logical channel being watched
+  volatile bool tripped; // Set by the interrupt on an out of window conversion
+  volatile uint32_t timestamp; // HAL tick (ms) that the watchdog tripped
+} ADC_Watchdog_T;
+
 typedef struct
 {
   Logging_T* logger;
-  ADC_HandleTypeDef* handle;
-  IRQn_Type adcIrq; // The IRQ for this ADC
+  ADC_HandleTypeDef* handle; // Master ADC (owns the DMA stream)
+  ADC_HandleTypeDef* slaves[ADC_MAX_NUM_ADCS - 1U]; // ADC2/ADC3 in multi-ADC modes
 
-  uint16_t numChannelsUsed; // Must be consistent with ADC hardware init settings.
+  ADC_MultiMode_T mode;
+  uint32_t twoSamplingDelay; // ADC_TWOSAMPLINGDELAY_x, used in interleaved modes
+
+  uint16_t numChannelsUsed; // Conversions per ADC. Must be consistent with ADC hardware init settings.
 
   // TODO add oversampling
-} ADC_Config_T;
+
+  // ******* Internal use *******
+  uint16_t numAdcs; // Number of ADCs in the group
+  uint16_t numChannels; // Logical channels (numChannelsUsed * numAdcs)
+
+  // DMA buffer, viewed as a stream of half-word conversions. Word storage keeps
+  // it aligned for word DMA transfers.
+  uint32_t dmaBuf[ADC_MAX_NUM_CHANNELS / 2];
+  uint32_t dmaLen; // Number of DMA data items
+
+  // Triple buffer of completed conversion sets. Conversion set n is copied
+  // out of the DMA buffer into sampleBuf[n % ADC_NUM_SAMPLE_BUFFERS], and is
+  // published by incrementing sequence to n once it is complete. Readers
+  // never block the DMA interrupt. Instead they check that sequence did not
+  // advance far enough for the buffer to be reused while they were reading.
+  uint32_t sampleBuf[ADC_NUM_SAMPLE_BUFFERS][ADC_MAX_NUM_CHANNELS / 2];
+  uint32_t sampleTimestamp[ADC_NUM_SAMPLE_BUFFERS];
+  volatile uint32_t sequence; // Number of conversion sets published. 0 = no data yet
+
+  // details for copying to buffers (in words)
+  uint16_t halfCpltCopyLen; // Number of words to copy at ADC DMA half complete
+  uint16_t cpltCopyOffset; // Word offset to copy from at ADC DMA full complete
+  uint16_t cpltCopyLen; // Number of words to copy at ADC DMA full complete
+
+  ADC_Watchdog_T watchdog[ADC_MAX_NUM_ADCS]; // Indexed by ADC in the group
+
+  REGISTERED_MODULE();
+} ADC_T;
+
+/**
+ * @brief A coherent set of readings of every channel of an ADC instance,
+ * all taken from the same DMA cycle.
+ */
+typedef struct
+{
+  uint32_t timestamp; // HAL tick (ms) at which the conversion set completed
+  uint32_t sequence; // Increments with every conversion set
+  uint16_t numChannels; // Number of valid entries in values
+  uint16_t values[ADC_MAX_NUM_CHANNELS]; // Raw readings, indexed by ADC_Channel_T
+} ADC_Snapshot_T;
 
 /**
  * @brief Initialize ADC driver interface
  *
- * @param config ADC config settings.
+ * @param adc ADC instance. Config fields must be set before calling.
  *
  * @return Return status. ADC_STATUS_OK for success. See ADC_Status_T for more.
  */
-ADC_Status_T ADC_Init(ADC_Config_T* config);
+ADC_Status_T ADC_Init(ADC_T* adc);
 
 /**
  * @brief Gets the latest reading from the given ADC channel
  *
- * @param channel ADC channel, 0 up to the value in ADC_Config_T::numChannelsUsed
+ * Does not disable interrupts, so may be called from any task. To read
+ * several channels from the same conversion set, use ADC_GetChannels.
+ *
+ * @param adc ADC instance.
+ * @param channel Logical ADC channel, 0 up to ADC_T::numChannelsUsed multiplied
+ * by the number of ADCs in the group.
  * @param val Output raw ADC reading (12-bit). 0 if the channel is out of range.
  * @returns Return status. ADC_STATUS_OK for success. See ADC_Status_T for more.
  */
-ADC_Status_T ADC_Get(const ADC_Channel_T channel, uint16_t* val);
+ADC_Status_T ADC_Get(ADC_T* adc, const ADC_Channel_T channel, uint16_t* val);
+
+/**
+ * @brief Gets the latest readings from several ADC channels. All readings are
+ * taken from the same conversion set.
+ *
+ * Does not disable interrupts, so may be called from any task.
+ *
+ * @param adc ADC instance.
+ * @param channels Array of logical ADC channels to read.
+ * @param vals Output array of raw ADC readings, same length as channels. All 0
+ * if not successful.
+ * @param numChannels Length of channels and vals.
+ * @param timestamp Output HAL tick (ms) at which the readings completed. May be
+ * NULL.
+ * @returns Return status. ADC_STATUS_OK for success. See ADC_Status_T for more.
+ */
+ADC_Status_T ADC_GetChannels(
+    ADC_T* adc,
+    const ADC_Channel_T* channels,
+    uint16_t* vals,
+    const uint16_t numChannels,
+    uint32_t* timestamp);
+
+/**
+ * @brief Gets the latest readings of every channel of the ADC instance.
+ *
+ * @param adc ADC instance.
+ * @param snapshot Output snapshot.
+ * @returns Return status. ADC_STATUS_OK for success. See ADC_Status_T for more.
+ */
+ADC_Status_T ADC_GetAll(ADC_T* adc, ADC_Snapshot_T* snapshot);
+
+/**
+ * @brief Configures the analog watchdog of the ADC that samples a channel.
+ *
+ * Conversions of the channel outside of [lowerThreshold, upperThreshold]
+ * raise an interrupt, which records the time and latches an event to be
+ * collected with ADC_GetWatchdogEvent. The interrupt is then disabled until
+ * the event is collected, so a channel stuck out of range costs at most one
+ * interrupt per collection.
+ *
+ * Must be called after ADC_Init. Each ADC can only watch one channel.
+ *
+ * @param adc ADC instance.
+ * @param channel Logical ADC channel to watch.
+ * @param hwChannel ADC_CHANNEL_x input that is converted for the channel.
+ * @param lowerThreshold Lowest raw value in the window.
+ * @param upperThreshold Highest raw value in the window.
+ * @returns Return status. ADC_STATUS_OK for success. See ADC_Status_T for more.
+ */
+ADC_Status_T ADC_ConfigWatchdog(
+    ADC_T* adc,
+    const ADC_Channel_T channel,
+    const uint32_t hwChannel,
+    const uint16_t lowerThreshold,
+    const uint16_t upperThreshold);
+
+/**
+ * @brief Collects the latched analog watchdog event of a channel, and re-arms
+ * the watchdog interrupt.
+ *
+ * @param adc ADC instance.
+ * @param channel Logical ADC channel configured with ADC_ConfigWatchdog.
+ * @param timestamp Output HAL tick (ms) of the event. Only set if an event
+ * occurred. May be NULL.
+ * @returns true if the channel went out of the window since the last call.
+ */
+bool ADC_GetWatchdogEvent(ADC_T* adc, const ADC_Channel_T channel, uint32_t* timestamp);
+
+/**
+ * @brief Precomputes the fixed-point form of a set of scalings.
+ * Call when the calibration is loaded.
+ *
+ * @param table Output compiled scaling table.
+ * @param scalings Array of scalings. Entry i of the table scales readings with
+ * scalings[i].
+ * @param numScalings Length of scalings. Up to ADC_MAX_NUM_CHANNELS.
+ * @returns ADC_STATUS_OK for success, ADC_STATUS_ERROR_SCALING if there are too
+ * many scalings, or a range is too narrow (less than 3 counts) for Q16.
+ */
+ADC_Status_T ADC_CompileScaling(
+    ADC_ScalingTable_T* table,
+    const ADC_Scaling_T* scalings,
+    const uint16_t numScalings);
+
+/**
+ * @brief Scales every entry of a compiled scaling table in one pass.
+ *
+ * @param table Compiled scaling table.
+ * @param raw Raw ADC readings. Must have table->numEntries values.
+ * @param outQ16 Output scaled values in Q16 fixed-point. May be NULL.
+ * @param outFloat Output scaled values as float. May be NULL.
+ */
+void ADC_ApplyScalingTable(
+    const ADC_ScalingTable_T* table,
+    const uint16_t* raw,
+    int32_t* outQ16,
+    float* outFloat);
 
 /**
  * @brief Applies a linear scaling between the lower and upper values,
  * resulting in a scaled value between [0,1].
- * 
+ *
  * If channel->saturate == true, then val won't exceed the [0,1] limits.
- * 
+ *
  * @param scaling Scaling settings to use.
  * @param raw A raw ADC reading.
  * @return Output scaled value.
@@ -0,0 +1,127 @@
+/*
+ * blockbuffer.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "blockbuffer.h"
+
+#include <string.h>
+
+#include "stm32f7xx_hal.h"
+
+// ------------------- Private methods -------------------
+static uint8_t* blockAt(BlockBuffer_T* buf, uint32_t index)
+{
+  return &buf->storage[(index & (buf->numBlocks - 1U)) * buf->blockLen];
+}
+
+static void putU32(uint8_t* out, uint32_t value)
+{
+  out[0] = (uint8_t)((value >> 24) & 0xFF);
+  out[1] = (uint8_t)((value >> 16) & 0xFF);
+  out[2] = (uint8_t)((value >> 8) & 0xFF);
+  out[3] = (uint8_t)(value & 0xFF);
+}
+
+// ------------------- Public methods -------------------
+bool BlockBuffer_Init(BlockBuffer_T* buf)
+{
+  const uint32_t blockLen = BLOCKBUFFER_BLOCK_LEN(
+      (uint32_t)buf->sampleLen, (uint32_t)buf->samplesPerBlock);
+  if (NULL == buf->storage ||
+      0U == buf->sampleLen ||
+      0U == buf->samplesPerBlock ||
+      blockLen > UINT16_MAX ||
+      0U == buf->numBlocks ||
+      0U != (buf->numBlocks & (buf->numBlocks - 1U))) {
+    return false;
+  }
+
+  buf->blockLen = (uint16_t)blockLen;
+  buf->head = 0U;
+  buf->tail = 0U;
+  buf->running = false;
+  buf->fill = 0U;
+  buf->numSamples = 0U;
+  buf->dropped = 0U;
+  return true;
+}
+
+void BlockBuffer_Start(BlockBuffer_T* buf)
+{
+  buf->tail = buf->head;
+  __DMB(); // blocks must be free before the producer can fill them
+  buf->running = true;
+}
+
+void BlockBuffer_Stop(BlockBuffer_T* buf)
+{
+  buf->running = false;
+}
+
+bool BlockBuffer_IsRunning(const BlockBuffer_T* buf)
+{
+  return buf->running;
+}
+
+void BlockBuffer_Drop(BlockBuffer_T* buf)
+{
+  if (!buf->running) {
+    buf->fill = 0U;
+    return;
+  }
+
+  if (0U != buf->fill) {
+    buf->dropped += (uint32_t)(buf->fill - BLOCKBUFFER_HEADER_LEN) / buf->sampleLen;
+    buf->fill = 0U;
+  }
+  buf->numSamples++;
+  buf->dropped++;
+}
+
+bool BlockBuffer_Put(BlockBuffer_T* buf, const uint8_t* sample)
+{
+  if (!buf->running) {
+    // Samples after a restart go in a new block
+    buf->fill = 0U;
+    return false;
+  }
+
+  const uint32_t sampleIndex = buf->numSamples++;
+  if (0U == buf->fill) {
+    if (buf->head - buf->tail >= buf->numBlocks) {
+      buf->dropped++;
+      return false;
+    }
+    uint8_t* block = blockAt(buf, buf->head);
+    putU32(&block[0], sampleIndex);
+    putU32(&block[4], buf->dropped);
+    buf->fill = BLOCKBUFFER_HEADER_LEN;
+  }
+
+  memcpy(&blockAt(buf, buf->head)[buf->fill], sample, buf->sampleLen);
+  buf->fill = (uint16_t)(buf->fill + buf->sampleLen);
+  if (buf->fill >= buf->blockLen) {
+    __DMB(); // block must be written before it is visible to the consumer
+    buf->head++;
+    buf->fill = 0U;
+  }
+  return true;
+}
+
+uint16_t BlockBuffer_Flush(BlockBuffer_T* buf, BlockBuffer_Sink_T sink, void* context)
+{
+  uint16_t flushed = 0U;
+  while (buf->tail != buf->head) {
+    __DMB(); // block must be read after head
+    if (!sink(context, blockAt(buf, buf->tail), buf->blockLen)) {
+      break;
+    }
+    __DMB(); // block must be read before it is given back to the producer
+    buf->tail++;
+    flushed++;
+  }
+  return flushed;
+}
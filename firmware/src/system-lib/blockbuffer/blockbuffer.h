@@ -0,0 +1,119 @@
+/*
+ * blockbuffer.h
+ *
+ * Preallocated buffer of fixed size samples, grouped into blocks.
+ *
+ * One producer puts a sample every tick, and one consumer flushes whole
+ * blocks to a byte sink when it can, e.g. one large frame per block on a
+ * slow link. The producer never waits: while every block is full, samples
+ * are dropped and counted.
+ *
+ * The producer and consumer may be different tasks, or an interrupt and a
+ * task. Each block starts with a header, counts big endian:
+ *   First Sample[4] Dropped[4]
+ * First Sample counts every sample put while running, dropped or not, so a
+ * receiver can place each block. Dropped counts samples dropped before the
+ * block. Both count from init.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#ifndef LIB_BLOCKBUFFER_BLOCKBUFFER_H_
+#define LIB_BLOCKBUFFER_BLOCKBUFFER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BLOCKBUFFER_HEADER_LEN 8U
+#define BLOCKBUFFER_BLOCK_LEN(sampleLen, samplesPerBlock) \
+  (BLOCKBUFFER_HEADER_LEN + (sampleLen) * (samplesPerBlock))
+#define BLOCKBUFFER_STORAGE_LEN(sampleLen, samplesPerBlock, numBlocks) \
+  (BLOCKBUFFER_BLOCK_LEN(sampleLen, samplesPerBlock) * (numBlocks))
+
+/**
+ * @brief Takes a full block
+ *
+ * @param context Context given to BlockBuffer_Flush
+ * @param block Block, header included. Only valid until this returns.
+ * @param len Length of block
+ * @return false if the block can't be taken now. It is offered again on
+ * the next flush.
+ */
+typedef bool (*BlockBuffer_Sink_T)(void* context, const uint8_t* block, uint16_t len);
+
+typedef struct
+{
+  // ******* Setup *******
+  uint8_t* storage; // BLOCKBUFFER_STORAGE_LEN bytes
+  uint16_t sampleLen; // bytes per sample
+  uint16_t samplesPerBlock;
+  uint16_t numBlocks; // power of 2
+
+  // ******* Internal use *******
+  uint16_t blockLen;
+  // Blocks are filled at head by the producer, and flushed at tail by the
+  // consumer
+  volatile uint32_t head;
+  volatile uint32_t tail;
+  volatile bool running; // set by the consumer
+  uint16_t fill; // bytes written to the block at head, 0 if not started
+  uint32_t numSamples; // samples put while running
+  volatile uint32_t dropped; // samples dropped
+} BlockBuffer_T;
+
+/**
+ * @brief Initializes an empty, stopped buffer
+ *
+ * @param buf Buffer, setup fields must be set
+ * @return false if the setup is invalid
+ */
+bool BlockBuffer_Init(BlockBuffer_T* buf);
+
+/**
+ * @brief Starts taking samples. Blocks from before are discarded.
+ * Called by the consumer.
+ */
+void BlockBuffer_Start(BlockBuffer_T* buf);
+
+/**
+ * @brief Stops taking samples. The block being filled is discarded, full
+ * blocks can still be flushed. Called by the consumer.
+ */
+void BlockBuffer_Stop(BlockBuffer_T* buf);
+
+/**
+ * @brief Whether samples are being taken. Lets the producer skip gathering
+ * a sample that would be dropped. Called by the producer.
+ */
+bool BlockBuffer_IsRunning(const BlockBuffer_T* buf);
+
+/**
+ * @brief Counts a sample the producer couldn't gather as dropped. Samples in
+ * a block are consecutive, so the part filled block is dropped with it.
+ * Called by the producer.
+ */
+void BlockBuffer_Drop(BlockBuffer_T* buf);
+
+/**
+ * @brief Puts a sample. Called by the producer.
+ *
+ * @param buf Buffer
+ * @param sample sampleLen bytes
+ * @return true if the sample was put. false if stopped, or dropped because
+ * every block is full.
+ */
+bool BlockBuffer_Put(BlockBuffer_T* buf, const uint8_t* sample);
+
+/**
+ * @brief Gives full blocks to a sink, oldest first, until the sink doesn't
+ * take one. Called by the consumer.
+ *
+ * @param buf Buffer
+ * @param sink Sink
+ * @param context Passed to sink
+ * @return Number of blocks the sink took
+ */
+uint16_t BlockBuffer_Flush(BlockBuffer_T* buf, BlockBuffer_Sink_T sink, void* context);
+
+#endif /* LIB_BLOCKBUFFER_BLOCKBUFFER_H_ */
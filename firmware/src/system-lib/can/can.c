@@ -193,7 +193,7 @@ void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef* hcan)
 CAN_Status_T CAN_Init(Logging_T* logger)
 {
   mLog = logger;
-  Log_Print(mLog, "CAN_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_DEBUG, "CAN_Init begin\n");
   DEPEND_ON(logger, CAN_STATUS_ERROR_DEPENDS);
 
   // Initialize mem to 0
@@ -209,25 +209,25 @@ CAN_Status_T CAN_Init(Logging_T* logger)
   }
 
   REGISTER_STATIC(CAN, CAN_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "CAN_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_DEBUG, "CAN_Init complete\n");
   return CAN_STATUS_OK;
 }
 
 //------------------------------------------------------------------------------
 CAN_Status_T CAN_Config(CAN_Device_T device, CAN_HandleTypeDef* handle)
 {
-  Log_Print(mLog, "CAN_Config begin ");
+  Log_Print(mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_DEBUG, "CAN_Config begin ");
   DEPEND_ON_STATIC(CAN, CAN_STATUS_ERROR_DEPENDS);
 
   switch (device) {
     case CAN_DEV1:
-      Log_Print(mLog, "CAN1\n");
+      Log_Print(mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_DEBUG, "CAN1\n");
       break;
     case CAN_DEV2:
-      Log_Print(mLog, "CAN2\n");
+      Log_Print(mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_DEBUG, "CAN2\n");
       break;
     case CAN_DEV3:
-      Log_Print(mLog, "CAN3\n");
+      Log_Print(mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_DEBUG, "CAN3\n");
       break;
     default:
       return CAN_STATUS_ERROR_INVALID_BUS;
@@ -268,7 +268,7 @@ CAN_Status_T CAN_Config(CAN_Device_T device, CAN_HandleTypeDef* handle)
     return CAN_STATUS_ERROR_START_NOTIFY;
   }
 
-  Log_Print(mLog, "CAN_Config complete\n");
+  Log_Print(mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_DEBUG, "CAN_Config complete\n");
   return CAN_STATUS_OK;
 }
 
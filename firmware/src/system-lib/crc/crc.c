@@ -10,17 +10,31 @@
 // ------------------- Private data -------------------
 static Logging_T* mLog;
 
+// ------------------- Private methods -------------------
+static void crcDmaComplete(DMA_HandleTypeDef* hdma);
+static void crcDmaError(DMA_HandleTypeDef* hdma);
+
 CRC_Status_T CRC_Init(Logging_T* logger, CRC_T* crcObj)
 {
   mLog = logger;
-  Log_Print(mLog, "CRC_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_CRC, LOGGING_LEVEL_DEBUG, "CRC_Init begin\n");
   DEPEND_ON(logger, CRC_STATUS_ERROR_DEPENDS);
 
   // Create mutex lock
   crcObj->mutex = xSemaphoreCreateMutexStatic(&crcObj->mutexBuffer);
 
+  crcObj->asyncHead = 0U;
+  crcObj->asyncTail = 0U;
+  crcObj->asyncRunning = false;
+  crcObj->asyncOffset = 0U;
+  if (NULL != crcObj->hdma) {
+    crcObj->hdma->Parent = crcObj;
+    crcObj->hdma->XferCpltCallback = crcDmaComplete;
+    crcObj->hdma->XferErrorCallback = crcDmaError;
+  }
+
   REGISTER(crcObj, CRC_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "complete begin\n");
+  Log_Print(mLog, LOGGING_MODULE_CRC, LOGGING_LEVEL_DEBUG, "complete begin\n");
   return CRC_STATUS_OK;
 }
 
@@ -37,8 +51,209 @@ bool CRC_Calculate(
     return false;
   }
 
-  *crcOut = HAL_CRC_Calculate(crcObj->hcrc, buffer, bufferLen);
+  if (crcObj->asyncRunning) {
+    // Hardware is busy with DMA, software gives the same result
+    *crcOut = CRC32_Calculate((const uint8_t*)buffer, bufferLen);
+  } else {
+    __HAL_CRC_INITIALCRCVALUE_CONFIG(crcObj->hcrc, CRC32_INIT);
+    *crcOut = HAL_CRC_Calculate(crcObj->hcrc, buffer, bufferLen);
+  }
 
   xSemaphoreGive(crcObj->mutex);
   return true;
 }
+
+bool CRC_Update(
+    CRC_T* crcObj,
+    CRC32_Ctx_T* ctx,
+    const uint8_t* data,
+    uint32_t len,
+    TickType_t timeout)
+{
+  BaseType_t locked = xSemaphoreTake(crcObj->mutex, timeout);
+  if (pdTRUE != locked) {
+    return false;
+  }
+
+  if (crcObj->asyncRunning) {
+    CRC32_Update(ctx, data, len);
+  } else {
+    // No reflection or final xor, so the unit carries on from the running CRC
+    // if it is used as the initial value
+    __HAL_CRC_INITIALCRCVALUE_CONFIG(crcObj->hcrc, ctx->crc);
+    ctx->crc = HAL_CRC_Calculate(crcObj->hcrc, (uint32_t*)(uintptr_t)data, len);
+  }
+
+  xSemaphoreGive(crcObj->mutex);
+  return true;
+}
+
+/**
+ * @brief Starts a DMA transfer of the next part of a request into the CRC
+ * unit. Bytes are written one at a time, as the unit takes a word MSB first.
+ */
+static HAL_StatusTypeDef crcDmaStartChunk(CRC_T* crcObj, const CRC_Request_T* req)
+{
+  uint32_t chunk = req->len - crcObj->asyncOffset;
+  if (chunk > CRC_DMA_MAX_LEN) {
+    chunk = CRC_DMA_MAX_LEN;
+  }
+
+  HAL_StatusTypeDef status = HAL_DMA_Start_IT(
+      crcObj->hdma,
+      (uintptr_t)(req->data + crcObj->asyncOffset),
+      (uintptr_t)&crcObj->hcrc->Instance->DR,
+      chunk);
+  if (HAL_OK == status) {
+    crcObj->asyncOffset += chunk;
+  }
+  return status;
+}
+
+/**
+ * @brief Finishes the request at the tail of the queue and notifies its task
+ *
+ * @param crcObj CRC module
+ * @param ok Whether all of the request went through the unit
+ * @param woken From an ISR, set if a higher priority task was woken. NULL
+ * from a task.
+ */
+static void crcAsyncFinish(CRC_T* crcObj, bool ok, BaseType_t* woken)
+{
+  CRC_Request_T* req = crcObj->asyncQueue[crcObj->asyncTail & (CRC_ASYNC_QUEUE_LEN - 1U)];
+  if (ok) {
+    req->ctx.crc = crcObj->hcrc->Instance->DR;
+  }
+  req->ok = ok;
+  __DMB(); // result must be written before done is visible to the task
+  req->done = true;
+  crcObj->asyncTail++;
+
+  if (NULL == req->task) {
+    return;
+  }
+  if (NULL == woken) {
+    xTaskNotifyGive(req->task);
+  } else {
+    vTaskNotifyGiveFromISR(req->task, woken);
+  }
+}
+
+/**
+ * @brief Starts the request at the tail of the queue. Requests that fail to
+ * start are finished unsuccessfully.
+ *
+ * @param crcObj CRC module
+ * @param woken As for crcAsyncFinish
+ * @return true if a transfer was started
+ */
+static bool crcAsyncStart(CRC_T* crcObj, BaseType_t* woken)
+{
+  while (crcObj->asyncTail != crcObj->asyncHead) {
+    const CRC_Request_T* req = crcObj->asyncQueue[crcObj->asyncTail & (CRC_ASYNC_QUEUE_LEN - 1U)];
+    crcObj->asyncOffset = 0U;
+
+    // Carry on from the request's running CRC
+    __HAL_CRC_INITIALCRCVALUE_CONFIG(crcObj->hcrc, req->ctx.crc);
+    __HAL_CRC_DR_RESET(crcObj->hcrc);
+
+    if (0U == req->len) {
+      crcAsyncFinish(crcObj, true, woken);
+    } else if (HAL_OK == crcDmaStartChunk(crcObj, req)) {
+      return true;
+    } else {
+      crcAsyncFinish(crcObj, false, woken);
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief DMA transfer complete. Called from the DMA interrupt.
+ */
+static void crcDmaComplete(DMA_HandleTypeDef* hdma)
+{
+  CRC_T* crcObj = (CRC_T*)hdma->Parent;
+  BaseType_t woken = pdFALSE;
+  const CRC_Request_T* req = crcObj->asyncQueue[crcObj->asyncTail & (CRC_ASYNC_QUEUE_LEN - 1U)];
+
+  // Longer requests go through in several transfers
+  if (crcObj->asyncOffset < req->len) {
+    if (HAL_OK == crcDmaStartChunk(crcObj, req)) {
+      return;
+    }
+    crcAsyncFinish(crcObj, false, &woken);
+  } else {
+    crcAsyncFinish(crcObj, true, &woken);
+  }
+
+  crcObj->asyncRunning = crcAsyncStart(crcObj, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief DMA transfer error. Called from the DMA interrupt.
+ */
+static void crcDmaError(DMA_HandleTypeDef* hdma)
+{
+  CRC_T* crcObj = (CRC_T*)hdma->Parent;
+  BaseType_t woken = pdFALSE;
+
+  crcAsyncFinish(crcObj, false, &woken);
+  crcObj->asyncRunning = crcAsyncStart(crcObj, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+CRC_Status_T CRC_CalculateAsync(
+    CRC_T* crcObj,
+    CRC_Request_T* req,
+    TickType_t timeout)
+{
+  if (NULL == crcObj->hdma) {
+    return CRC_STATUS_ERROR;
+  }
+
+  req->done = false;
+  req->ok = false;
+
+  // Only held to queue. Keeps the unit from being started under
+  // CRC_Calculate, which doesn't use the queue.
+  BaseType_t locked = xSemaphoreTake(crcObj->mutex, timeout);
+  if (pdTRUE != locked) {
+    return CRC_STATUS_ERROR_BUSY;
+  }
+
+  CRC_Status_T ret = CRC_STATUS_OK;
+
+  // disable the DMA interrupt to make this section atomic
+  HAL_NVIC_DisableIRQ(crcObj->dmaIrq);
+
+  if ((uint16_t)(crcObj->asyncHead - crcObj->asyncTail) >= CRC_ASYNC_QUEUE_LEN) {
+    ret = CRC_STATUS_ERROR_BUSY;
+  } else {
+    crcObj->asyncQueue[crcObj->asyncHead & (CRC_ASYNC_QUEUE_LEN - 1U)] = req;
+    __DMB(); // request must be written before it is visible to the interrupt
+    crcObj->asyncHead++;
+
+    // If a transfer is in progress, the interrupt will start this one when done
+    if (!crcObj->asyncRunning) {
+      crcObj->asyncRunning = crcAsyncStart(crcObj, NULL);
+    }
+  }
+
+  // atomic section complete
+  HAL_NVIC_EnableIRQ(crcObj->dmaIrq);
+
+  xSemaphoreGive(crcObj->mutex);
+  return ret;
+}
+
+bool CRC_WaitAsync(CRC_Request_T* req, TickType_t timeout)
+{
+  while (!req->done) {
+    if (0U == ulTaskNotifyTake(pdFALSE, timeout)) {
+      return false;
+    }
+  }
+  return req->ok;
+}
@@ -2,6 +2,17 @@
  * crc.h
  *
  * Provides mutual exclusion for CRC hardware
+ *
+ * The hardware is an accelerated backend for the software CRC (crc32.h): a
+ * block can be added to a CRC32_Ctx_T with CRC_Update, and the lock is only
+ * held for that block. Small or concurrent calculations are better done in
+ * software, which doesn't lock at all.
+ *
+ * Large buffers can be fed to the hardware by DMA with CRC_CalculateAsync.
+ * Requests from any task are queued and run one after another from the DMA
+ * interrupt, and the requesting task is notified as each completes. The lock
+ * is only held to queue a request. While DMA is running, CRC_Calculate and
+ * CRC_Update use the software CRC so they don't wait behind it.
  * 
  *  Created on: 20 Oct 2022
  *      Author: Liam Flaherty
@@ -13,28 +24,58 @@
 #include "stm32f7xx_hal.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "task.h"
 #include <stdint.h>
 #include <stdbool.h>
 
 #include "depends/depends.h"
 #include "logging/logging.h"
+#include "crc32.h"
 
 typedef enum
 {
   CRC_STATUS_OK             = 0x00U,
   CRC_STATUS_ERROR          = 0x01U,
   CRC_STATUS_ERROR_DEPENDS  = 0x02U,
+  CRC_STATUS_ERROR_BUSY     = 0x03U,
 } CRC_Status_T;
 
+#define CRC_ASYNC_QUEUE_LEN 8U // Must be power of 2
+#define CRC_DMA_MAX_LEN 0xFFFFU // Bytes per DMA transfer
+
+/**
+ * @brief An asynchronous CRC request. Owned by the caller, and must stay valid
+ * (along with data) until done is set.
+ */
+typedef struct
+{
+  const uint8_t* data;
+  uint32_t len;
+  CRC32_Ctx_T ctx; // Running CRC, updated with data when done
+  TaskHandle_t task; // Notified when done, can be NULL
+
+  volatile bool done;
+  bool ok; // Whether ctx was updated, valid once done
+} CRC_Request_T;
+
 typedef struct
 {
   CRC_HandleTypeDef* hcrc; // CRC calculation hardware
+  DMA_HandleTypeDef* hdma; // Memory to CRC DMA stream, NULL if not used
+  IRQn_Type dmaIrq; // DMA stream interrupt
 
   // ******* Internal use *******
   // Mutex lock
   SemaphoreHandle_t mutex;
   StaticSemaphore_t mutexBuffer;
 
+  // Async requests, head is added by tasks, tail is finished by the DMA ISR
+  CRC_Request_T* asyncQueue[CRC_ASYNC_QUEUE_LEN];
+  volatile uint16_t asyncHead;
+  volatile uint16_t asyncTail;
+  volatile bool asyncRunning;
+  uint32_t asyncOffset; // Bytes of the current request sent to DMA
+
   REGISTERED_MODULE();
 } CRC_T;
 
@@ -64,4 +105,56 @@ bool CRC_Calculate(
   TickType_t timeout,
   uint32_t* crcOut);
 
+/**
+ * @brief Adds a block to a CRC calculation using the hardware. Blocking, the
+ * same as CRC_Calculate. Gives the same result as CRC32_Update.
+ *
+ * @param crcObj CRC module
+ * @param ctx Context from CRC32_Begin
+ * @param data Bytes to add
+ * @param len Length of data
+ * @param timeout Ticks for mutex pend timeout.
+ * @return true if the block was added. Otherwise ctx is unchanged.
+ */
+bool CRC_Update(
+  CRC_T* crcObj,
+  CRC32_Ctx_T* ctx,
+  const uint8_t* data,
+  uint32_t len,
+  TickType_t timeout);
+
+/**
+ * @brief Queues a CRC of req->data for the hardware, fed by DMA. Returns
+ * straight away. Once the DMA has finished, req->ctx has been updated from
+ * req->data, req->done is set and req->task is notified.
+ *
+ * The ctx is carried on from, as with CRC_Update, so a CRC32_Begin context
+ * gives the CRC of data alone.
+ *
+ * @param crcObj CRC module
+ * @param req Request with data, len, ctx and task set
+ * @param timeout Ticks for mutex pend timeout.
+ * @return CRC_STATUS_OK if queued, CRC_STATUS_ERROR_BUSY if the queue is full
+ */
+CRC_Status_T CRC_CalculateAsync(
+  CRC_T* crcObj,
+  CRC_Request_T* req,
+  TickType_t timeout);
+
+/**
+ * @brief Waits on task notifications for a request queued by the calling task.
+ * A task has one notification value, so other notifications can wake it
+ * early; this waits again until the request is done.
+ *
+ * @param req Request queued by CRC_CalculateAsync, with task set to the
+ * calling task
+ * Tasks that are also woken by notification (e.g. from TaskTimer) shouldn't
+ * wait here; queue with task set to NULL and check done each cycle instead.
+ *
+ * @param timeout Ticks to wait for each notification
+ * @return true if the request is done and ctx was updated. If the wait timed
+ * out the request is still queued, and req must not be reused until done.
+ */
+bool CRC_WaitAsync(CRC_Request_T* req, TickType_t timeout);
+
 #endif /* LIB_CRC_CRC_H_ */
@@ -0,0 +1,78 @@
+/*
+ * crc32.c
+ *
+ * Slice-by-8: 8 bytes are folded into the CRC at a time, with one table
+ * lookup per byte and no dependency between the lookups. Leading and
+ * trailing bytes go through Table[0] one at a time.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "crc32.h"
+
+// ------------------- Private methods -------------------
+static inline uint32_t updateByte(uint32_t crc, uint8_t byte)
+{
+  return (crc << 8) ^ CRC32_Table[0][(crc >> 24) ^ byte];
+}
+
+static inline uint32_t loadBigEndian(const uint8_t* data)
+{
+  return ((uint32_t)data[0] << 24) |
+         ((uint32_t)data[1] << 16) |
+         ((uint32_t)data[2] << 8) |
+         ((uint32_t)data[3] << 0);
+}
+
+// ------------------- Public methods -------------------
+void CRC32_Begin(CRC32_Ctx_T* ctx)
+{
+  ctx->crc = CRC32_INIT;
+}
+
+void CRC32_Update(CRC32_Ctx_T* ctx, const uint8_t* data, size_t len)
+{
+  uint32_t crc = ctx->crc;
+
+  // Align to a word, so the 8 byte loads are aligned on target
+  while (len > 0U && 0U != ((uintptr_t)data & 3U)) {
+    crc = updateByte(crc, *data++);
+    len--;
+  }
+
+  while (len >= 8U) {
+    const uint32_t hi = crc ^ loadBigEndian(data);
+    const uint32_t lo = loadBigEndian(data + 4);
+    crc = CRC32_Table[7][(hi >> 24) & 0xFFU] ^
+          CRC32_Table[6][(hi >> 16) & 0xFFU] ^
+          CRC32_Table[5][(hi >> 8) & 0xFFU] ^
+          CRC32_Table[4][(hi >> 0) & 0xFFU] ^
+          CRC32_Table[3][(lo >> 24) & 0xFFU] ^
+          CRC32_Table[2][(lo >> 16) & 0xFFU] ^
+          CRC32_Table[1][(lo >> 8) & 0xFFU] ^
+          CRC32_Table[0][(lo >> 0) & 0xFFU];
+    data += 8;
+    len -= 8U;
+  }
+
+  while (len > 0U) {
+    crc = updateByte(crc, *data++);
+    len--;
+  }
+
+  ctx->crc = crc;
+}
+
+uint32_t CRC32_Finish(const CRC32_Ctx_T* ctx)
+{
+  return ctx->crc;
+}
+
+uint32_t CRC32_Calculate(const uint8_t* data, size_t len)
+{
+  CRC32_Ctx_T ctx;
+  CRC32_Begin(&ctx);
+  CRC32_Update(&ctx, data, len);
+  return CRC32_Finish(&ctx);
+}
@@ -0,0 +1,74 @@
+/*
+ * crc32.h
+ *
+ * Software CRC, computed incrementally.
+ *
+ * Same CRC as the STM32 CRC unit and the PC tools (MPEG-2 variant:
+ * polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no reflection, no final
+ * xor). Each calculation has its own context, so there is no lock and any
+ * number of tasks can use it at once.
+ *
+ * Usage:
+ *   CRC32_Ctx_T ctx;
+ *   CRC32_Begin(&ctx);
+ *   CRC32_Update(&ctx, part1, len1);
+ *   CRC32_Update(&ctx, part2, len2);
+ *   uint32_t crc = CRC32_Finish(&ctx);
+ *
+ * Running a message followed by its CRC (most significant byte first) through
+ * a context leaves it at 0 (CRC32_RESIDUE), so a receiver can check a frame
+ * without knowing where the CRC starts.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#ifndef LIB_CRC_CRC32_H_
+#define LIB_CRC_CRC32_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CRC32_INIT 0xFFFFFFFFU
+#define CRC32_RESIDUE 0x00000000U
+#define CRC32_TABLE_SLICES 8U
+
+typedef struct
+{
+  uint32_t crc; // running CRC
+} CRC32_Ctx_T;
+
+// Lookup tables (crc32table.c), internal use
+extern const uint32_t CRC32_Table[CRC32_TABLE_SLICES][256];
+
+/**
+ * @brief Starts a CRC calculation
+ * @param ctx Context to start
+ */
+void CRC32_Begin(CRC32_Ctx_T* ctx);
+
+/**
+ * @brief Adds bytes to a CRC calculation
+ * @param ctx Context from CRC32_Begin
+ * @param data Bytes to add
+ * @param len Length of data
+ */
+void CRC32_Update(CRC32_Ctx_T* ctx, const uint8_t* data, size_t len);
+
+/**
+ * @brief Gets the CRC of all bytes added. The context can continue to be
+ * updated afterwards.
+ * @param ctx Context from CRC32_Begin
+ * @return CRC value
+ */
+uint32_t CRC32_Finish(const CRC32_Ctx_T* ctx);
+
+/**
+ * @brief Calculates the CRC of a buffer in one go
+ * @param data Bytes to calculate the CRC of
+ * @param len Length of data
+ * @return CRC value
+ */
+uint32_t CRC32_Calculate(const uint8_t* data, size_t len);
+
+#endif /* LIB_CRC_CRC32_H_ */
@@ -0,0 +1,273 @@
+/*
+ * filter.c
+ *
+ *      Author: Liam Flaherty
+ */
+
+#include "filter.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define Q16_SHIFT 16
+#define Q16_ONE ((int32_t)0x00010000)
+#define Q16_HALF ((int64_t)0x00008000)
+
+// State words used by each filter type
+#define IIR1_STATE_WORDS 1U // y[n-1]
+#define IIR2_STATE_WORDS 4U // x[n-1], x[n-2], y[n-1], y[n-2]
+#define SLEW_STATE_WORDS 1U // y[n-1]
+
+// ------------------- Private methods -------------------
+static int32_t saturate(int64_t value)
+{
+  if (value > INT32_MAX) {
+    return INT32_MAX;
+  } else if (value < INT32_MIN) {
+    return INT32_MIN;
+  } else {
+    return (int32_t)value;
+  }
+}
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Converts a Q32.32 product to Q16.16, rounding half away from zero.
+ * Rounding is symmetric so that filters settle to the same value from either
+ * direction.
+ */
+static int64_t roundQ16(int64_t value)
+{
+  if (value >= 0) {
+    return (value + Q16_HALF) >> Q16_SHIFT;
+  } else {
+    return -((-value + Q16_HALF) >> Q16_SHIFT);
+  }
+}
+
+//------------------------------------------------------------------------------
+static uint16_t stageStateWords(const Filter_Stage_T* stage)
+{
+  switch (stage->type) {
+    case FILTER_TYPE_IIR1:
+      return IIR1_STATE_WORDS;
+
+    case FILTER_TYPE_IIR2:
+      return IIR2_STATE_WORDS;
+
+    case FILTER_TYPE_MEDIAN:
+      return (uint16_t)FILTER_MEDIAN_STATE_WORDS(stage->taps);
+
+    case FILTER_TYPE_SLEW:
+      return SLEW_STATE_WORDS;
+
+    default:
+      return 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+static bool stageValid(const Filter_Stage_T* stage)
+{
+  switch (stage->type) {
+    case FILTER_TYPE_IIR1:
+      // 0 < alpha <= 1
+      return stage->coeff[0] > 0 && stage->coeff[0] <= Q16_ONE;
+
+    case FILTER_TYPE_IIR2:
+      return true;
+
+    case FILTER_TYPE_MEDIAN:
+      return stage->taps > 0 &&
+             stage->taps <= FILTER_MEDIAN_MAX_TAPS &&
+             (stage->taps % 2U) == 1U;
+
+    case FILTER_TYPE_SLEW:
+      return stage->maxStep > 0;
+
+    default:
+      return false;
+  }
+}
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Sets the stage state as if the input had been constant at value.
+ */
+static void stagePrime(const Filter_Stage_T* stage, int32_t* state, int32_t value)
+{
+  if (stage->type == FILTER_TYPE_MEDIAN) {
+    for (uint16_t i = 0; i < 2U * stage->taps; ++i) {
+      state[i] = value;
+    }
+    state[2U * stage->taps] = 0; // history index
+  } else {
+    uint16_t words = stageStateWords(stage);
+    for (uint16_t i = 0; i < words; ++i) {
+      state[i] = value;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+static int32_t processIIR1(const Filter_Stage_T* stage, int32_t* state, int32_t x)
+{
+  int32_t y = state[0];
+  int64_t step = roundQ16((int64_t)stage->coeff[0] * ((int64_t)x - y));
+  y = saturate(y + step);
+  state[0] = y;
+  return y;
+}
+
+//------------------------------------------------------------------------------
+static int32_t processIIR2(const Filter_Stage_T* stage, int32_t* state, int32_t x)
+{
+  // Direct form I, 64-bit accumulator
+  const int32_t* c = stage->coeff;
+  int64_t acc = (int64_t)c[0] * x +
+                (int64_t)c[1] * state[0] +
+                (int64_t)c[2] * state[1] -
+                (int64_t)c[3] * state[2] -
+                (int64_t)c[4] * state[3];
+  int32_t y = saturate(roundQ16(acc));
+
+  state[1] = state[0];
+  state[0] = x;
+  state[3] = state[2];
+  state[2] = y;
+  return y;
+}
+
+//------------------------------------------------------------------------------
+static int32_t processMedian(const Filter_Stage_T* stage, int32_t* state, int32_t x)
+{
+  // State: history ring[taps], sorted window[taps], ring index
+  const uint16_t taps = stage->taps;
+  int32_t* history = state;
+  int32_t* sorted = &state[taps];
+  uint16_t index = (uint16_t)state[2U * taps];
+
+  // Replace the oldest sample in the sorted window with the new one, then
+  // move it into place. The rest of the window remains sorted.
+  int32_t oldest = history[index];
+  uint16_t pos = 0;
+  while (sorted[pos] != oldest) {
+    ++pos;
+  }
+
+  while (pos > 0U && sorted[pos - 1U] > x) {
+    sorted[pos] = sorted[pos - 1U];
+    --pos;
+  }
+  while (pos + 1U < taps && sorted[pos + 1U] < x) {
+    sorted[pos] = sorted[pos + 1U];
+    ++pos;
+  }
+  sorted[pos] = x;
+
+  history[index] = x;
+  index = (uint16_t)(index + 1U);
+  if (index >= taps) {
+    index = 0;
+  }
+  state[2U * taps] = (int32_t)index;
+
+  return sorted[taps / 2U];
+}
+
+//------------------------------------------------------------------------------
+static int32_t processSlew(const Filter_Stage_T* stage, int32_t* state, int32_t x)
+{
+  int64_t step = (int64_t)x - state[0];
+  if (step > stage->maxStep) {
+    step = stage->maxStep;
+  } else if (step < -(int64_t)stage->maxStep) {
+    step = -(int64_t)stage->maxStep;
+  }
+
+  int32_t y = (int32_t)(state[0] + step);
+  state[0] = y;
+  return y;
+}
+
+//------------------------------------------------------------------------------
+static int32_t processStage(const Filter_Stage_T* stage, int32_t* state, int32_t x)
+{
+  switch (stage->type) {
+    case FILTER_TYPE_IIR1:
+      return processIIR1(stage, state, x);
+
+    case FILTER_TYPE_IIR2:
+      return processIIR2(stage, state, x);
+
+    case FILTER_TYPE_MEDIAN:
+      return processMedian(stage, state, x);
+
+    case FILTER_TYPE_SLEW:
+      return processSlew(stage, state, x);
+
+    default:
+      return x;
+  }
+}
+
+//------------------------------------------------------------------------------
+// ------------------- Public methods -------------------
+Filter_Status_T Filter_Init(Filter_Bank_T* bank)
+{
+  if (bank->numChannels > FILTER_MAX_CHANNELS) {
+    return FILTER_STATUS_ERROR_CONFIG;
+  }
+
+  uint32_t words = 0;
+  for (uint16_t ch = 0; ch < bank->numChannels; ++ch) {
+    const Filter_Chain_T* chain = &bank->chains[ch];
+    if (chain->numStages > FILTER_MAX_STAGES) {
+      return FILTER_STATUS_ERROR_CONFIG;
+    }
+
+    for (uint16_t i = 0; i < chain->numStages; ++i) {
+      if (!stageValid(&chain->stages[i])) {
+        return FILTER_STATUS_ERROR_CONFIG;
+      }
+      words += stageStateWords(&chain->stages[i]);
+    }
+  }
+
+  bank->stateWords = (uint16_t)words;
+  Filter_Reset(bank);
+
+  return FILTER_STATUS_OK;
+}
+
+//------------------------------------------------------------------------------
+void Filter_Reset(Filter_Bank_T* bank)
+{
+  memset(bank->state, 0, sizeof(bank->state));
+  bank->primed = false;
+}
+
+//------------------------------------------------------------------------------
+void Filter_Process(Filter_Bank_T* bank, const int32_t* in, int32_t* out)
+{
+  // State for each stage is packed in the order it is processed
+  int32_t* state = bank->state;
+
+  for (uint16_t ch = 0; ch < bank->numChannels; ++ch) {
+    const Filter_Chain_T* chain = &bank->chains[ch];
+    int32_t value = in[ch];
+
+    for (uint16_t i = 0; i < chain->numStages; ++i) {
+      const Filter_Stage_T* stage = &chain->stages[i];
+      if (!bank->primed) {
+        stagePrime(stage, state, value);
+      }
+      value = processStage(stage, state, value);
+      state += stageStateWords(stage);
+    }
+
+    out[ch] = value;
+  }
+
+  bank->primed = true;
+}
@@ -0,0 +1,109 @@
+/*
+ * filter.h
+ *
+ * Fixed-point digital filters for sampled sensor inputs.
+ *
+ * A filter bank runs a chain of filter stages for each of its channels, one
+ * sample per channel per call. Samples are Q16.16 fixed-point, e.g. ADC counts
+ * or the output of ADC_ApplyScalingTable. Only integer arithmetic is used, so
+ * results are
+ * bit-exact between the target and host tests.
+ *
+ *      Author: Liam Flaherty
+ */
+
+#ifndef LIB_FILTER_FILTER_H_
+#define LIB_FILTER_FILTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FILTER_MAX_CHANNELS 8U
+#define FILTER_MAX_STAGES 3U // per channel
+#define FILTER_MEDIAN_MAX_TAPS 9U
+
+// State words used by a median stage (history, sorted window, index)
+#define FILTER_MEDIAN_STATE_WORDS(taps) (2U * (taps) + 1U)
+#define FILTER_MAX_STATE_WORDS \
+  (FILTER_MAX_CHANNELS * FILTER_MAX_STAGES * FILTER_MEDIAN_STATE_WORDS(FILTER_MEDIAN_MAX_TAPS))
+
+/*
+ * Converts a constant to a Q16.16 coefficient, e.g. FILTER_Q16(0.25f)
+ */
+#define FILTER_Q16(x) ((int32_t)((x) * 65536.0f + (((x) >= 0.0f) ? 0.5f : -0.5f)))
+
+typedef enum
+{
+  FILTER_STATUS_OK            = 0x00U,
+  FILTER_STATUS_ERROR_CONFIG  = 0x01U,
+} Filter_Status_T;
+
+typedef enum
+{
+  FILTER_TYPE_IIR1 = 0,   // First order low pass
+  FILTER_TYPE_IIR2,       // Second order section (biquad)
+  FILTER_TYPE_MEDIAN,     // Moving median
+  FILTER_TYPE_SLEW,       // Rate (slew) limit
+} Filter_Type_T;
+
+typedef struct
+{
+  Filter_Type_T type;
+
+  // FILTER_TYPE_IIR1: coeff[0] = alpha, y[n] = y[n-1] + alpha * (x[n] - y[n-1])
+  // FILTER_TYPE_IIR2: coeff = {b0, b1, b2, a1, a2},
+  //   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+  // All in Q16.16. Second order sections must have unity DC gain.
+  int32_t coeff[5];
+
+  uint16_t taps; // FILTER_TYPE_MEDIAN: window length. Odd, up to FILTER_MEDIAN_MAX_TAPS.
+  int32_t maxStep; // FILTER_TYPE_SLEW: max change per sample (Q16.16)
+} Filter_Stage_T;
+
+/**
+ * @brief Filter stages applied in order to one channel. No stages passes the
+ * input through unchanged.
+ */
+typedef struct
+{
+  uint16_t numStages;
+  Filter_Stage_T stages[FILTER_MAX_STAGES];
+} Filter_Chain_T;
+
+typedef struct
+{
+  uint16_t numChannels;
+  Filter_Chain_T chains[FILTER_MAX_CHANNELS];
+
+  // ******* Internal use *******
+  // State of every stage of every channel, packed in processing order
+  int32_t state[FILTER_MAX_STATE_WORDS];
+  uint16_t stateWords; // Number of words of state used
+  bool primed; // State is initialized from the first samples after reset
+} Filter_Bank_T;
+
+/**
+ * @brief Checks the filter configuration and lays out the state.
+ *
+ * @param bank Filter bank. Config fields must be set before calling.
+ * @return FILTER_STATUS_OK on success, FILTER_STATUS_ERROR_CONFIG if the
+ * configuration is invalid.
+ */
+Filter_Status_T Filter_Init(Filter_Bank_T* bank);
+
+/**
+ * @brief Resets all filters. The next samples initialize the filter states
+ * (as if the input had been constant), to avoid a startup transient.
+ */
+void Filter_Reset(Filter_Bank_T* bank);
+
+/**
+ * @brief Filters one sample of every channel.
+ *
+ * @param bank Filter bank.
+ * @param in Input samples (Q16.16), one per channel.
+ * @param out Output samples (Q16.16), one per channel. May be the same as in.
+ */
+void Filter_Process(Filter_Bank_T* bank, const int32_t* in, int32_t* out);
+
+#endif /* LIB_FILTER_FILTER_H_ */
@@ -102,28 +102,28 @@ void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef* hi2c)
 I2C_Status_T I2C_Init(Logging_T* logger)
 {
   mLog = logger;
-  Log_Print(mLog, "I2C_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_I2C, LOGGING_LEVEL_DEBUG, "I2C_Init begin\n");
   DEPEND_ON(logger, I2C_STATUS_ERROR_DEPENDS);
 
   // Reset memory
   memset(i2cInstances, 0, sizeof(i2cInstances));
 
   REGISTER_STATIC(I2C, I2C_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "I2C_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_I2C, LOGGING_LEVEL_DEBUG, "I2C_Init complete\n");
   return I2C_STATUS_OK;
 }
 
 I2C_Status_T I2C_Config(const I2C_BusConfig_T* devConfig)
 {
-  Log_Print(mLog, "I2C_Config begin ");
+  Log_Print(mLog, LOGGING_MODULE_I2C, LOGGING_LEVEL_DEBUG, "I2C_Config begin ");
   DEPEND_ON_STATIC(I2C, I2C_STATUS_ERROR_DEPENDS);
 
   switch (devConfig->dev) {
     case I2C_DEV0:
-      Log_Print(mLog, "I2C0\n");
+      Log_Print(mLog, LOGGING_MODULE_I2C, LOGGING_LEVEL_DEBUG, "I2C0\n");
       break;
     case I2C_DEV1:
-      Log_Print(mLog, "I2C1\n");
+      Log_Print(mLog, LOGGING_MODULE_I2C, LOGGING_LEVEL_DEBUG, "I2C1\n");
       break;
     default:
       return I2C_STATUS_ERROR_INVALID_BUS;
@@ -131,7 +131,7 @@ I2C_Status_T I2C_Config(const I2C_BusConfig_T* devConfig)
 
   struct I2C_Instance* i2cDev = &i2cInstances[devConfig->dev];
   if (i2cDev->inUse) {
-    Log_Print(mLog, "I2C_Config Error: Instance already in use\n");
+    Log_Print(mLog, LOGGING_MODULE_I2C, LOGGING_LEVEL_ERROR, "I2C_Config Error: Instance already in use\n");
     return I2C_STATUS_ERROR_INVALID_BUS;
   }
 
@@ -153,7 +153,7 @@ I2C_Status_T I2C_Config(const I2C_BusConfig_T* devConfig)
     return I2C_STATUS_ERROR_OS;
   }
 
-  Log_Print(mLog, "I2C_Config complete\n");
+  Log_Print(mLog, LOGGING_MODULE_I2C, LOGGING_LEVEL_DEBUG, "I2C_Config complete\n");
   return I2C_STATUS_OK;
 }
 
@@ -8,30 +8,168 @@
 #include "logging.h"
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "stm32f7xx_hal.h"
+#include "task.h"
+#include "trace/trace.h"
+
+// Each record in the buffer is a marker, then the record as sent
+#define RECORD_MARKER_LEN 1U
+#define RECORD_COMMITTED 0xA5U
+
+#define DWT_LAR_UNLOCK 0xC5ACCE55U
+
+const char* const Log_ModuleNames[LOGGING_NUM_MODULES] = {
+  [LOGGING_MODULE_GENERAL] = "general",
+  [LOGGING_MODULE_PCINTERFACE] = "pcinterface",
+  [LOGGING_MODULE_INVERTER] = "inverter",
+  [LOGGING_MODULE_BMS] = "bms",
+  [LOGGING_MODULE_VEHICLE] = "vehicle",
+  [LOGGING_MODULE_ADC] = "adc",
+  [LOGGING_MODULE_CAN] = "can",
+  [LOGGING_MODULE_CRC] = "crc",
+  [LOGGING_MODULE_I2C] = "i2c",
+  [LOGGING_MODULE_RTC] = "rtc",
+  [LOGGING_MODULE_SPI] = "spi",
+  [LOGGING_MODULE_UART] = "uart",
+  [LOGGING_MODULE_TASKTIMER] = "tasktimer",
+  [LOGGING_MODULE_SENSE] = "sense",
+  [LOGGING_MODULE_WHEELSPEED] = "wheelspeed",
+  [LOGGING_MODULE_GPS] = "gps",
+  [LOGGING_MODULE_PDM] = "pdm",
+  [LOGGING_MODULE_SDC] = "sdc",
+  [LOGGING_MODULE_DASHBOARD] = "dashboard",
+};
+
+const char* const Log_LevelNames[LOGGING_NUM_LEVELS] = {
+  [LOGGING_LEVEL_OFF] = "off",
+  [LOGGING_LEVEL_ERROR] = "error",
+  [LOGGING_LEVEL_WARN] = "warn",
+  [LOGGING_LEVEL_INFO] = "info",
+  [LOGGING_LEVEL_DEBUG] = "debug",
+};
 
 /**
- * Allows printing to SWO debug console
+ * Allows printing to SWO debug console. Characters the trace FIFO can't take
+ * are dropped, so printf never retries them.
  */
 int _write(int file, char *ptr, int len)
 {
   (void)file; // ignore param
-  
-  int i=0;
-  for(i = 0; i < len; i++) {
-    uint32_t chr = (uint32_t)(*ptr++);
-    ITM_SendChar(chr);
-  }
+
+  Trace_WriteText(ptr, (uint32_t)len);
   return len;
 }
 
+// ------------------- Private methods -------------------
+static volatile uint8_t* recordByte(Logging_T* log, uint32_t index)
+{
+  return &log->recordBuffer[index & (LOGGING_RECORD_BUFFER_LEN - 1U)];
+}
+
+/**
+ * @brief Level mask of a module logging up to level, bits 1 to level set.
+ * Nothing above LOGGING_BUILD_LEVEL is built in, so it's limited to that.
+ */
+static uint8_t levelMask(uint8_t level)
+{
+  if (level > LOGGING_BUILD_LEVEL) {
+    level = LOGGING_BUILD_LEVEL;
+  }
+  return (uint8_t)((1U << (level + 1U)) - 2U);
+}
+
+/**
+ * @brief Reserves room for a record, lock free. Any number of tasks and
+ * interrupts can reserve at once, each gets its own part of the buffer.
+ *
+ * @param at Set to the buffer index of the record's marker
+ * @return false if there isn't room
+ */
+static bool reserveRecord(Logging_T* log, uint32_t len, uint32_t* at)
+{
+  uint32_t head = log->recordHead;
+  do {
+    if (LOGGING_RECORD_BUFFER_LEN - (head - log->recordTail) < RECORD_MARKER_LEN + len) {
+      return false;
+    }
+  } while (!__atomic_compare_exchange_n(
+      &log->recordHead, &head, head + RECORD_MARKER_LEN + len,
+      true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+  *at = head;
+  return true;
+}
+
+/**
+ * @brief Writes a reserved record, then marks it committed for the reader
+ */
+static void commitRecord(Logging_T* log, uint32_t at, const uint8_t* record, uint32_t len)
+{
+  for (uint32_t i = 0U; i < len; ++i) {
+    *recordByte(log, at + RECORD_MARKER_LEN + i) = record[i];
+  }
+  __DMB(); // record must be written before it is visible to the reader
+  *recordByte(log, at) = RECORD_COMMITTED;
+}
+
+/**
+ * @brief Microseconds since init. Lock free, retried if the time base is
+ * moved on while it is read.
+ */
+static uint32_t timestampUs(Logging_T* log)
+{
+  uint32_t count;
+  uint32_t baseCycles;
+  uint32_t baseUs;
+  uint32_t cycles;
+  do {
+    count = log->timeBaseCount;
+    __DMB(); // time base must be read after the count
+    baseCycles = log->timeBase[count & 1U].cycles;
+    baseUs = log->timeBase[count & 1U].us;
+    cycles = DWT->CYCCNT;
+    __DMB();
+  } while (count != log->timeBaseCount);
+
+  return baseUs + (cycles - baseCycles) / log->cyclesPerUs;
+}
+
+static uint8_t recordSource(void)
+{
+  const uint32_t exception = __get_IPSR();
+  if (0U != exception) {
+    return (uint8_t)(LOGGING_SOURCE_ISR | (exception & 0x7FU));
+  }
+  if (taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState()) {
+    return 0U;
+  }
+  return (uint8_t)(uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle()) & 0x7FU);
+}
+
 //------------------------------------------------------------------------------
 Logging_Status_T Log_Init(Logging_T* log)
 {
   log->mutex = xSemaphoreCreateMutexStatic(&log->mutexBuffer);
   log->enableSerial = false;
   log->enableSWO = false;
+  memset((uint8_t*)log->recordBuffer, 0, sizeof(log->recordBuffer));
+  log->recordHead = 0U;
+  log->recordTail = 0U;
+  log->recordsDropped = 0U;
+  for (uint8_t i = 0U; i < LOGGING_NUM_MODULES; ++i) {
+    log->levelMasks[i] = levelMask(LOGGING_DEFAULT_LEVEL);
+  }
+
+  // Cycle counter for record timestamps
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = DWT_LAR_UNLOCK;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  log->cyclesPerUs = SystemCoreClock / 1000000U;
+  log->timeBase[0].cycles = DWT->CYCCNT;
+  log->timeBase[0].us = 0U;
+  log->timeBaseCount = 0U;
 
   REGISTER(log, LOGGING_STATUS_ERROR_DEPEND);
   return LOGGING_STATUS_OK;
@@ -67,8 +205,13 @@ Logging_Status_T Log_EnableSWO(Logging_T* log)
 }
 
 //------------------------------------------------------------------------------
-void Log_Print(Logging_T* log, const char* msg)
+void Log_PrintText(Logging_T* log, Logging_Module_T module, uint8_t level, const char* msg)
 {
+  if (module >= LOGGING_NUM_MODULES || level >= LOGGING_NUM_LEVELS ||
+      0U == (log->levelMasks[module] & (1U << level))) {
+    return;
+  }
+
   if (pdTRUE != xSemaphoreTake(log->mutex, pdMS_TO_TICKS(100))) {
     return;
   }
@@ -90,6 +233,112 @@ void Log_Print(Logging_T* log, const char* msg)
   xSemaphoreGive(log->mutex);
 }
 
+//------------------------------------------------------------------------------
+Logging_Status_T Log_SetLevel(Logging_T* log, Logging_Module_T module, uint8_t level)
+{
+  if (module >= LOGGING_NUM_MODULES || level >= LOGGING_NUM_LEVELS) {
+    return LOGGING_STATUS_LOG_ERROR;
+  }
+
+  log->levelMasks[module] = levelMask(level);
+  return LOGGING_STATUS_OK;
+}
+
+//------------------------------------------------------------------------------
+uint8_t Log_GetLevel(Logging_T* log, Logging_Module_T module)
+{
+  uint8_t level = LOGGING_LEVEL_OFF;
+  if (module >= LOGGING_NUM_MODULES) {
+    return level;
+  }
+  while (level + 1U < LOGGING_NUM_LEVELS &&
+         0U != (log->levelMasks[module] & (1U << (level + 1U)))) {
+    level++;
+  }
+  return level;
+}
+
+//------------------------------------------------------------------------------
+void Log_Record(Logging_T* log, uint16_t id, const uint32_t* args, uint8_t numArgs)
+{
+  if (numArgs > LOGGING_RECORD_MAX_ARGS) {
+    return;
+  }
+
+  uint8_t record[LOGGING_RECORD_MAX_LEN];
+  record[0] = (uint8_t)((id >> 8) & 0xFF);
+  record[1] = (uint8_t)(id & 0xFF);
+  record[2] = numArgs;
+  record[3] = recordSource();
+  const uint32_t time = timestampUs(log);
+  record[4] = (uint8_t)((time >> 24) & 0xFF);
+  record[5] = (uint8_t)((time >> 16) & 0xFF);
+  record[6] = (uint8_t)((time >> 8) & 0xFF);
+  record[7] = (uint8_t)(time & 0xFF);
+  for (uint8_t i = 0U; i < numArgs; ++i) {
+    uint8_t* out = &record[LOGGING_RECORD_HEADER_LEN + 4U * i];
+    out[0] = (uint8_t)((args[i] >> 24) & 0xFF);
+    out[1] = (uint8_t)((args[i] >> 16) & 0xFF);
+    out[2] = (uint8_t)((args[i] >> 8) & 0xFF);
+    out[3] = (uint8_t)(args[i] & 0xFF);
+  }
+  const uint32_t len = LOGGING_RECORD_HEADER_LEN + 4U * numArgs;
+
+  // Traced even if the buffer is full
+  if (log->enableSWO) {
+    Trace_WriteEvent(record, len);
+  }
+
+  uint32_t at;
+  if (!reserveRecord(log, len, &at)) {
+    __atomic_fetch_add(&log->recordsDropped, 1U, __ATOMIC_RELAXED);
+    return;
+  }
+  commitRecord(log, at, record, len);
+}
+
+//------------------------------------------------------------------------------
+void Log_UpdateTime(Logging_T* log)
+{
+  const uint32_t count = log->timeBaseCount;
+  const uint32_t baseCycles = log->timeBase[count & 1U].cycles;
+  const uint32_t elapsedUs = (DWT->CYCCNT - baseCycles) / log->cyclesPerUs;
+
+  // Moved on by whole microseconds, so the remainder isn't lost
+  log->timeBase[(count + 1U) & 1U].cycles = baseCycles + elapsedUs * log->cyclesPerUs;
+  log->timeBase[(count + 1U) & 1U].us = log->timeBase[count & 1U].us + elapsedUs;
+  __DMB(); // time base must be written before writers use it
+  log->timeBaseCount = count + 1U;
+}
+
+//------------------------------------------------------------------------------
+uint16_t Log_ReadRecords(Logging_T* log, uint8_t* out, uint16_t maxLen)
+{
+  uint32_t tail = log->recordTail;
+  uint16_t read = 0U;
+  // Stops at the first record not committed yet, even if later ones are
+  while (RECORD_COMMITTED == *recordByte(log, tail)) {
+    __DMB(); // record must be read after its marker
+    const uint8_t numArgs = *recordByte(log, tail + RECORD_MARKER_LEN + 2U);
+    const uint16_t len = (uint16_t)(LOGGING_RECORD_HEADER_LEN + 4U * numArgs);
+    if (len > maxLen - read) {
+      break;
+    }
+    for (uint16_t i = 0U; i < len; ++i) {
+      out[read + i] = *recordByte(log, tail + RECORD_MARKER_LEN + i);
+    }
+    // Cleared, as markers of the next records can land anywhere in it
+    for (uint32_t i = 0U; i < RECORD_MARKER_LEN + len; ++i) {
+      *recordByte(log, tail + i) = 0U;
+    }
+    read = (uint16_t)(read + len);
+    tail += RECORD_MARKER_LEN + len;
+  }
+  __DMB(); // records must be read and cleared before they are given back
+  log->recordTail = tail;
+  return read;
+}
+
 //------------------------------------------------------------------------------
 size_t strnlen(const char* str, const size_t maxBufferLen)
 {
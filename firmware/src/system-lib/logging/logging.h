@@ -1,6 +1,29 @@
 /*
  * logging.h
  *
+ * Text logs are copied to the outputs as they are printed. Deferred logs,
+ * printed with Log_Printf, store a binary record instead:
+ *   ID[2] NumArgs[1] Source[1] Time[4] Args[4 each]
+ * big endian. Formatting is left to the PC.
+ *
+ * Time is microseconds since Log_Init, from the cycle counter, and wraps
+ * every 71 minutes. Source is what printed the record: 0 before the
+ * scheduler starts, the task number (tasks are numbered from 1 in the order
+ * they are created), or LOGGING_SOURCE_ISR plus the exception number.
+ *
+ * Each format string is placed in the logfmt section, which isn't loaded on
+ * the target. A record's ID is the offset of its format string in the
+ * section, so the PC reads the format strings from the ELF (the build dumps
+ * the section to vcu.logfmt). IDs are 16 bits, so the section must stay under
+ * 64 KiB. Arguments are integers or floats, each sent as
+ * 32 bits, so the PC formats them like printf would. Strings can't be
+ * deferred.
+ *
+ * Text logs have a level and module. Deferred logs can have them too
+ * (Log_Error to Log_Debug). For both, levels above LOGGING_BUILD_LEVEL
+ * compile to nothing. Both are checked against the module's level, set at
+ * runtime with Log_SetLevel, before anything else is done.
+ *
  *  Created on: 24 Jul 2021
  *      Author: Liam Flaherty
  */
@@ -12,12 +35,36 @@
 #include "semphr.h"
 #include "stream_buffer.h"
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "depends/depends.h"
 
 #define LOGGING_MAX_MSG_LEN 512
 
+#define LOGGING_RECORD_HEADER_LEN 8U
+#define LOGGING_RECORD_MAX_ARGS 6U
+#define LOGGING_RECORD_MAX_LEN (LOGGING_RECORD_HEADER_LEN + 4U * LOGGING_RECORD_MAX_ARGS)
+#define LOGGING_RECORD_BUFFER_LEN 1024U // power of 2
+#define LOGGING_SOURCE_ISR 0x80U
+
+// Levels, most severe first
+#define LOGGING_LEVEL_OFF   0U
+#define LOGGING_LEVEL_ERROR 1U
+#define LOGGING_LEVEL_WARN  2U
+#define LOGGING_LEVEL_INFO  3U
+#define LOGGING_LEVEL_DEBUG 4U
+#define LOGGING_NUM_LEVELS  5U
+
+// Most detailed level built in, can be set for the whole build
+#ifndef LOGGING_BUILD_LEVEL
+#define LOGGING_BUILD_LEVEL LOGGING_LEVEL_DEBUG
+#endif
+
+// Level of each module at init
+#define LOGGING_DEFAULT_LEVEL LOGGING_LEVEL_INFO
+
 /**
  * These error statuses are arranged to be bit fields.
  */
@@ -29,6 +76,36 @@ typedef enum
   LOGGING_STATUS_ERROR_DEPEND = 0x03U,
 } Logging_Status_T;
 
+typedef enum
+{
+  LOGGING_MODULE_GENERAL = 0U,
+  LOGGING_MODULE_PCINTERFACE,
+  LOGGING_MODULE_INVERTER,
+  LOGGING_MODULE_BMS,
+  LOGGING_MODULE_VEHICLE,
+  // Peripheral drivers
+  LOGGING_MODULE_ADC,
+  LOGGING_MODULE_CAN,
+  LOGGING_MODULE_CRC,
+  LOGGING_MODULE_I2C,
+  LOGGING_MODULE_RTC,
+  LOGGING_MODULE_SPI,
+  LOGGING_MODULE_UART,
+  LOGGING_MODULE_TASKTIMER,
+  // Device drivers
+  LOGGING_MODULE_SENSE,
+  LOGGING_MODULE_WHEELSPEED,
+  LOGGING_MODULE_GPS,
+  LOGGING_MODULE_PDM,
+  LOGGING_MODULE_SDC,
+  LOGGING_MODULE_DASHBOARD,
+  LOGGING_NUM_MODULES
+} Logging_Module_T;
+
+// Names used by the debug terminal
+extern const char* const Log_ModuleNames[LOGGING_NUM_MODULES];
+extern const char* const Log_LevelNames[LOGGING_NUM_LEVELS];
+
 typedef struct {
   // ******* Internal use *******
   // Mutex lock
@@ -41,6 +118,25 @@ typedef struct {
 
   StreamBufferHandle_t serialOutputStream;
 
+  // Deferred records, reserved at head by any number of writers, and read
+  // at tail once committed
+  volatile uint8_t recordBuffer[LOGGING_RECORD_BUFFER_LEN];
+  volatile uint32_t recordHead;
+  volatile uint32_t recordTail;
+  volatile uint32_t recordsDropped; // records that didn't fit
+
+  // Cycle counter value at a time, one for writers to use while the other
+  // is moved on. timeBase[timeBaseCount & 1] is current.
+  struct {
+    uint32_t cycles;
+    uint32_t us;
+  } timeBase[2];
+  volatile uint32_t timeBaseCount;
+  uint32_t cyclesPerUs;
+
+  // Bit n set if level n of the module is logged
+  volatile uint8_t levelMasks[LOGGING_NUM_MODULES];
+
   REGISTERED_MODULE();
 } Logging_T;
 
@@ -72,13 +168,201 @@ Logging_Status_T Log_SetSerialStream(
 Logging_Status_T Log_EnableSWO(Logging_T* log);
 
 /**
- * @brief Prints message to enabled log output streams.
- * msg should be terminated with a '\0' character.
- * 
+ * @brief Prints message to enabled log output streams, if the module logs
+ * the level. Called through Log_Print.
+ *
+ * @param log Log struct
+ * @param module Logging_Module_T of the caller
+ * @param level LOGGING_LEVEL_ERROR to LOGGING_LEVEL_DEBUG
+ * @param msg Char array of message.
+ */
+void Log_PrintText(Logging_T* log, Logging_Module_T module, uint8_t level, const char* msg);
+
+/**
+ * @brief Prints message to enabled log output streams, if the module logs
+ * the level. msg should be terminated with a '\0' character. The call is
+ * compiled out if the level is above LOGGING_BUILD_LEVEL.
+ *
  * @param log Log struct
+ * @param module Logging_Module_T of the caller
+ * @param level LOGGING_LEVEL_ERROR to LOGGING_LEVEL_DEBUG, a constant
  * @param msg Char array of message.
  */
-void Log_Print(Logging_T* log, const char* msg);
+#define Log_Print(log, module, level, msg) \
+  do { \
+    if ((level) <= LOGGING_BUILD_LEVEL) { \
+      Log_PrintText((log), (module), (level), (msg)); \
+    } \
+  } while (0)
+
+/**
+ * @brief Sets the most detailed level logged by a module. Takes no lock, so
+ * can be changed at any time. Levels above LOGGING_BUILD_LEVEL are set to it.
+ *
+ * @param log Log struct
+ * @param module Module
+ * @param level LOGGING_LEVEL_OFF to LOGGING_LEVEL_DEBUG
+ * @return LOGGING_STATUS_OK if successful
+ */
+Logging_Status_T Log_SetLevel(Logging_T* log, Logging_Module_T module, uint8_t level);
+
+/**
+ * @brief Gets the most detailed level logged by a module
+ *
+ * @param log Log struct
+ * @param module Module
+ * @return LOGGING_LEVEL_OFF to LOGGING_LEVEL_DEBUG
+ */
+uint8_t Log_GetLevel(Logging_T* log, Logging_Module_T module);
+
+/**
+ * @brief Prints a deferred log message, formatted on the PC. Called through
+ * Log_Printf. Never blocks, and can be called from interrupts.
+ *
+ * @param log Log struct
+ * @param id Format string ID
+ * @param args Arguments, each 32 bits
+ * @param numArgs Length of args, up to LOGGING_RECORD_MAX_ARGS
+ */
+void Log_Record(Logging_T* log, uint16_t id, const uint32_t* args, uint8_t numArgs);
+
+/**
+ * @brief Moves the time base of record timestamps on. Called by one task at
+ * least every 10 s, as the cycle counter wraps every 19.9 s at 216 MHz.
+ *
+ * @param log Log struct
+ */
+void Log_UpdateTime(Logging_T* log);
+
+/**
+ * @brief Reads whole deferred records, oldest first. Called by the one task
+ * that sends them on. Records after one that is still being written wait
+ * for it.
+ *
+ * @param log Log struct
+ * @param out Buffer for the records
+ * @param maxLen Length of out
+ * @return Bytes read, 0 if there are no records or the next doesn't fit
+ */
+uint16_t Log_ReadRecords(Logging_T* log, uint8_t* out, uint16_t maxLen);
+
+/**
+ * @brief Prints a deferred log message, formatted on the PC. Only the format
+ * string ID and the arguments are stored, so this is much cheaper than
+ * formatting the message and printing it with Log_Print. Takes no lock, so
+ * it can be called from any task or interrupt. When the record buffer is
+ * full the record is dropped and counted.
+ *
+ * Up to LOGGING_RECORD_MAX_ARGS arguments, each an integer or float.
+ *
+ * @param log Log struct
+ * @param fmt printf format, a string literal
+ */
+#define Log_Printf(log, fmt, ...) \
+  do { \
+    static const char logFmt_[] LOGGING_FMT_SECTION = fmt; \
+    const uint32_t logArgs_[] = { LOGGING_ARGS(__VA_ARGS__) 0U }; \
+    Log_Record((log), LOGGING_FMT_ID(logFmt_), logArgs_, LOGGING_NARGS(__VA_ARGS__)); \
+  } while (0)
+
+/**
+ * @brief Prints a deferred log message at a level, if the module logs that
+ * level. The arguments aren't evaluated if it doesn't, and the call is
+ * compiled out if the level is above LOGGING_BUILD_LEVEL.
+ *
+ * @param log Log struct
+ * @param module Logging_Module_T of the caller
+ * @param fmt printf format, a string literal
+ */
+#if LOGGING_BUILD_LEVEL >= LOGGING_LEVEL_ERROR
+#define Log_Error(log, module, fmt, ...) \
+  LOGGING_LEVEL_PRINTF(log, module, LOGGING_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define Log_Error(log, module, fmt, ...) do { } while (0)
+#endif
+
+#if LOGGING_BUILD_LEVEL >= LOGGING_LEVEL_WARN
+#define Log_Warn(log, module, fmt, ...) \
+  LOGGING_LEVEL_PRINTF(log, module, LOGGING_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define Log_Warn(log, module, fmt, ...) do { } while (0)
+#endif
+
+#if LOGGING_BUILD_LEVEL >= LOGGING_LEVEL_INFO
+#define Log_Info(log, module, fmt, ...) \
+  LOGGING_LEVEL_PRINTF(log, module, LOGGING_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define Log_Info(log, module, fmt, ...) do { } while (0)
+#endif
+
+#if LOGGING_BUILD_LEVEL >= LOGGING_LEVEL_DEBUG
+#define Log_Debug(log, module, fmt, ...) \
+  LOGGING_LEVEL_PRINTF(log, module, LOGGING_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define Log_Debug(log, module, fmt, ...) do { } while (0)
+#endif
+
+// ******* Internal use *******
+// One load and test of the module's mask before anything else
+#define LOGGING_LEVEL_PRINTF(log, module, level, fmt, ...) \
+  do { \
+    if (0U != ((log)->levelMasks[(module)] & (1U << (level)))) { \
+      Log_Printf((log), fmt, ##__VA_ARGS__); \
+    } \
+  } while (0)
+
+#define LOGGING_FMT_SECTION __attribute__((section("logfmt"), used))
+extern const char __start_logfmt[]; // defined by the linker
+#define LOGGING_FMT_ID(fmt) ((uint16_t)((uintptr_t)(fmt) - (uintptr_t)__start_logfmt))
+
+#define LOGGING_NARGS(...) \
+  ((uint8_t)LOGGING_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0))
+#define LOGGING_NARGS_(z, a1, a2, a3, a4, a5, a6, n, ...) n
+
+#define LOGGING_CAT(a, b) LOGGING_CAT_(a, b)
+#define LOGGING_CAT_(a, b) a##b
+#define LOGGING_ARGS(...) \
+  LOGGING_CAT(LOGGING_ARGS_, LOGGING_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0))(__VA_ARGS__)
+#define LOGGING_ARGS_0(...)
+#define LOGGING_ARGS_1(a) LOGGING_ARG(a)
+#define LOGGING_ARGS_2(a, ...) LOGGING_ARG(a) LOGGING_ARGS_1(__VA_ARGS__)
+#define LOGGING_ARGS_3(a, ...) LOGGING_ARG(a) LOGGING_ARGS_2(__VA_ARGS__)
+#define LOGGING_ARGS_4(a, ...) LOGGING_ARG(a) LOGGING_ARGS_3(__VA_ARGS__)
+#define LOGGING_ARGS_5(a, ...) LOGGING_ARG(a) LOGGING_ARGS_4(__VA_ARGS__)
+#define LOGGING_ARGS_6(a, ...) LOGGING_ARG(a) LOGGING_ARGS_5(__VA_ARGS__)
+
+// Each argument as 32 bits, floats as their bits
+#define LOGGING_ARG(x) _Generic((x), \
+    float: Log_FloatArg, \
+    double: Log_DoubleArg, \
+    signed char: Log_SignedArg, \
+    short: Log_SignedArg, \
+    int: Log_SignedArg, \
+    long: Log_SignedArg, \
+    long long: Log_SignedArg, \
+    default: Log_UnsignedArg)(x),
+
+static inline uint32_t Log_FloatArg(float x)
+{
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+static inline uint32_t Log_DoubleArg(double x)
+{
+  return Log_FloatArg((float)x);
+}
+
+static inline uint32_t Log_SignedArg(long long x)
+{
+  return (uint32_t)x;
+}
+
+static inline uint32_t Log_UnsignedArg(unsigned long long x)
+{
+  return (uint32_t)x;
+}
 
 /**
  * strlen with a max iteration length
@@ -23,13 +23,13 @@ static Logging_T* log;
 RTC_Status_T RTC_Init(Logging_T* logger)
 {
   log = logger;
-  Log_Print(log, "RTC_Init begin\n");
+  Log_Print(log, LOGGING_MODULE_RTC, LOGGING_LEVEL_DEBUG, "RTC_Init begin\n");
   DEPEND_ON(logger, RTC_STATUS_ERROR);
 
   // Nothing to do here
 
   REGISTER_STATIC(RTC, RTC_STATUS_ERROR);
-  Log_Print(log, "RTC_Init complete\n");
+  Log_Print(log, LOGGING_MODULE_RTC, LOGGING_LEVEL_DEBUG, "RTC_Init complete\n");
   return RTC_STATUS_OK;
 }
 
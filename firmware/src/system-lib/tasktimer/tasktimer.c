@@ -25,42 +25,160 @@ static Logging_T* mLog;
 typedef struct {
   bool isSet;                  // Only true when used
   TaskHandle_t* taskHandle;    // Handle for notification
+  uint16_t phase;              // Timer ticks after the period starts
+  bool isAuto;                 // Phase chosen by autoPhase
+  bool isPlaced;               // Phase counted by phaseLoad
+  uint16_t order;              // Registered by all frequencies before this
+
+  // Timing, in DWT cycles
+  volatile uint32_t releaseCycles; // Last release, set by the ISR
+  uint32_t jobReleaseCycles;   // Release of the job being run
+  bool isRunning;              // Started a job, and not waiting again yet
+  uint32_t jobs;
+  uint32_t minLatency;
+  uint32_t maxLatency;
+  uint32_t maxResponse;
 } TimedTask_T;
 
 typedef struct {
   uint8_t numTasks;
   TimedTask_T tasks[TASKTIMER_MAX_TASKS];
+  uint16_t tick; // timer ticks into the period
 } TaskList_T;
 
-static TIM_HandleTypeDef* timHandles[TASKTIMER_FREQUENCY_COUNT] = {0};
+// Timer ticks per period of each frequency. Each divides the next, so the
+// periods all start together.
+static const uint16_t periodTicks[TASKTIMER_FREQUENCY_COUNT] = {
+  [TASKTIMER_FREQUENCY_1KHZ] = TASKTIMER_BASE_HZ / 1000U,
+  [TASKTIMER_FREQUENCY_100HZ] = TASKTIMER_BASE_HZ / 100U,
+  [TASKTIMER_FREQUENCY_10HZ] = TASKTIMER_BASE_HZ / 10U,
+  [TASKTIMER_FREQUENCY_1HZ] = TASKTIMER_BASE_HZ / 1U,
+};
+
+const char* const TaskTimer_FrequencyNames[TASKTIMER_FREQUENCY_COUNT] = {
+  [TASKTIMER_FREQUENCY_1KHZ] = "1kHz",
+  [TASKTIMER_FREQUENCY_100HZ] = "100Hz",
+  [TASKTIMER_FREQUENCY_10HZ] = "10Hz",
+  [TASKTIMER_FREQUENCY_1HZ] = "1Hz",
+};
+
+static TIM_HandleTypeDef* timHandle = NULL;
 static TaskList_T taskLists[TASKTIMER_FREQUENCY_COUNT] = {0};
+static uint16_t numRegistered = 0U;
 static bool isInitialized = false;
 
+// ------------------- Private methods -------------------
+static void resetStats(TimedTask_T* task)
+{
+  task->jobs = 0U;
+  task->minLatency = UINT32_MAX;
+  task->maxLatency = 0U;
+  task->maxResponse = 0U;
+}
+
+/**
+ * @brief Number of registered tasks released on the same timer tick as a
+ * task of the given frequency and phase
+ */
+static uint16_t phaseLoad(const TaskTimer_Frequency_T timer, const uint16_t phase)
+{
+  uint16_t load = 0U;
+  for (uint16_t f = 0; f < TASKTIMER_FREQUENCY_COUNT; ++f) {
+    // Releases coincide when the phases match over the shorter period
+    const uint16_t shorter = (periodTicks[f] < periodTicks[timer]) ?
+        periodTicks[f] : periodTicks[timer];
+    for (uint16_t i = 0; i < taskLists[f].numTasks; ++i) {
+      if (taskLists[f].tasks[i].isPlaced &&
+          (taskLists[f].tasks[i].phase % shorter) == (phase % shorter)) {
+        load++;
+      }
+    }
+  }
+  return load;
+}
+
+/**
+ * @brief Chooses the phase with the fewest releases on its tick, the
+ * earliest of those if several
+ */
+static uint16_t autoPhase(const TaskTimer_Frequency_T timer)
+{
+  uint16_t bestPhase = 0U;
+  uint16_t bestLoad = UINT16_MAX;
+  for (uint16_t phase = 0U; phase < periodTicks[timer] && bestLoad > 0U; ++phase) {
+    const uint16_t load = phaseLoad(timer, phase);
+    if (load < bestLoad) {
+      bestPhase = phase;
+      bestLoad = load;
+    }
+  }
+  return bestPhase;
+}
+
+/**
+ * @brief Chooses the phases of the automatically placed tasks again, in the
+ * order they were registered, around every given phase
+ */
+static void placeAutoTasks(void)
+{
+  for (uint16_t f = 0; f < TASKTIMER_FREQUENCY_COUNT; ++f) {
+    for (uint16_t i = 0; i < taskLists[f].numTasks; ++i) {
+      taskLists[f].tasks[i].isPlaced = !taskLists[f].tasks[i].isAuto;
+    }
+  }
+
+  for (uint16_t order = 0; order < numRegistered; ++order) {
+    for (uint16_t f = 0; f < TASKTIMER_FREQUENCY_COUNT; ++f) {
+      for (uint16_t i = 0; i < taskLists[f].numTasks; ++i) {
+        TimedTask_T* timedTask = &taskLists[f].tasks[i];
+        if (timedTask->isAuto && order == timedTask->order) {
+          timedTask->phase = autoPhase((TaskTimer_Frequency_T)f);
+          timedTask->isPlaced = true;
+        }
+      }
+    }
+  }
+}
+
+static TimedTask_T* findTask(const TaskHandle_t* taskHandle)
+{
+  for (uint16_t f = 0; f < TASKTIMER_FREQUENCY_COUNT; ++f) {
+    for (uint16_t i = 0; i < taskLists[f].numTasks; ++i) {
+      if (taskLists[f].tasks[i].taskHandle == taskHandle) {
+        return &taskLists[f].tasks[i];
+      }
+    }
+  }
+  return NULL;
+}
+
+static uint32_t cyclesToUs(uint32_t cycles)
+{
+  return cycles / (SystemCoreClock / 1000000U);
+}
 
 // ------------------- Public methods -------------------
 TaskTimer_Status_T TaskTimer_Init(
     Logging_T* logger,
-    TIM_HandleTypeDef* htim100Hz)
+    TIM_HandleTypeDef* htim1kHz)
 {
   mLog = logger;
-  Log_Print(mLog, "TaskTimer_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_TASKTIMER, LOGGING_LEVEL_DEBUG, "TaskTimer_Init begin\n");
   DEPEND_ON(logger, TASKTIMER_STATUS_ERROR_DEPENDS);
 
   memset(&taskLists, 0U, sizeof(taskLists));
-  memset(&timHandles, 0U, sizeof(timHandles));
+  numRegistered = 0U;
 
-  timHandles[TASKTIMER_FREQUENCY_100HZ] = htim100Hz;
+  timHandle = htim1kHz;
   isInitialized = true;
 
-  // Start the timers
-  for (uint16_t i = 0; i < TASKTIMER_FREQUENCY_COUNT; ++i) {
-    if (NULL == timHandles[i] || HAL_OK != HAL_TIM_Base_Start_IT(timHandles[i])) {
-      return TASKTIMER_STATUS_ERROR_TIMER;
-    }
+  // Start the timer
+  if (NULL == timHandle || HAL_OK != HAL_TIM_Base_Start_IT(timHandle)) {
+    return TASKTIMER_STATUS_ERROR_TIMER;
   }
 
   REGISTER_STATIC(TASKTIMER, TASKTIMER_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "TaskTimer_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_TASKTIMER, LOGGING_LEVEL_DEBUG, "TaskTimer_Init complete\n");
   return TASKTIMER_STATUS_OK;
 }
 
@@ -68,6 +186,15 @@ TaskTimer_Status_T TaskTimer_Init(
 TaskTimer_Status_T TaskTimer_RegisterTask(
     TaskHandle_t* task,
     const TaskTimer_Frequency_T timer)
+{
+  return TaskTimer_RegisterTaskPhase(task, timer, TASKTIMER_PHASE_AUTO);
+}
+
+//------------------------------------------------------------------------------
+TaskTimer_Status_T TaskTimer_RegisterTaskPhase(
+    TaskHandle_t* task,
+    const TaskTimer_Frequency_T timer,
+    const uint16_t phase)
 {
   DEPEND_ON_STATIC(TASKTIMER, TASKTIMER_STATUS_ERROR_DEPENDS);
 
@@ -75,6 +202,10 @@ TaskTimer_Status_T TaskTimer_RegisterTask(
     return TASKTIMER_STATUS_ERROR_INVALID_TIMER;
   }
 
+  if (TASKTIMER_PHASE_AUTO != phase && phase >= periodTicks[timer]) {
+    return TASKTIMER_STATUS_ERROR_INVALID_PHASE;
+  }
+
   // Check size of task list
   if (TASKTIMER_MAX_TASKS == taskLists[timer].numTasks) {
     // Timer list is full
@@ -83,42 +214,130 @@ TaskTimer_Status_T TaskTimer_RegisterTask(
 
   // Store task
   uint8_t i = taskLists[timer].numTasks;
-  taskLists[timer].tasks[i].taskHandle = task;
-  taskLists[timer].tasks[i].isSet = true;
+  TimedTask_T* timedTask = &taskLists[timer].tasks[i];
+  timedTask->isAuto = (TASKTIMER_PHASE_AUTO == phase);
+  timedTask->phase = timedTask->isAuto ? 0U : phase;
+  timedTask->order = numRegistered++;
+  timedTask->taskHandle = task;
+  timedTask->isRunning = false;
+  resetStats(timedTask);
+  timedTask->isSet = true;
   taskLists[timer].numTasks++;
 
+  placeAutoTasks();
+
   return TASKTIMER_STATUS_OK;
 }
 
 //------------------------------------------------------------------------------
-void TaskTimer_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
+uint32_t TaskTimer_Wait(TaskHandle_t* task, TickType_t blockTime)
 {
-  if (!isInitialized)
-  {
-    return;
+  TimedTask_T* timedTask = findTask(task);
+
+  // The last job is done
+  if (NULL != timedTask && timedTask->isRunning) {
+    const uint32_t response = DWT->CYCCNT - timedTask->jobReleaseCycles;
+    if (response > timedTask->maxResponse) {
+      timedTask->maxResponse = response;
+    }
+    timedTask->isRunning = false;
   }
 
-  TaskList_T* taskList = NULL;
+  uint32_t notifiedValue = ulTaskNotifyTake(pdTRUE, blockTime);
 
-  // Find the relevant task list
-  for (uint16_t i = 0; i < TASKTIMER_FREQUENCY_COUNT; ++i) {
-    if (htim->Instance == timHandles[i]->Instance) {
-      taskList = &taskLists[i];
-      break;
+  // Start the job of the latest release
+  if (NULL != timedTask && notifiedValue > 0U) {
+    timedTask->jobReleaseCycles = timedTask->releaseCycles;
+    const uint32_t latency = DWT->CYCCNT - timedTask->jobReleaseCycles;
+    if (latency < timedTask->minLatency) {
+      timedTask->minLatency = latency;
+    }
+    if (latency > timedTask->maxLatency) {
+      timedTask->maxLatency = latency;
     }
+    timedTask->jobs++;
+    timedTask->isRunning = true;
   }
 
-  if (NULL == taskList) {
+  return notifiedValue;
+}
+
+//------------------------------------------------------------------------------
+uint16_t TaskTimer_NumTasks(void)
+{
+  uint16_t numTasks = 0U;
+  for (uint16_t f = 0; f < TASKTIMER_FREQUENCY_COUNT; ++f) {
+    numTasks = (uint16_t)(numTasks + taskLists[f].numTasks);
+  }
+  return numTasks;
+}
+
+//------------------------------------------------------------------------------
+bool TaskTimer_GetStats(uint16_t index, TaskTimer_Stats_T* stats)
+{
+  for (uint16_t f = 0; f < TASKTIMER_FREQUENCY_COUNT; ++f) {
+    if (index >= taskLists[f].numTasks) {
+      index = (uint16_t)(index - taskLists[f].numTasks);
+      continue;
+    }
+
+    const TimedTask_T* timedTask = &taskLists[f].tasks[index];
+    stats->taskHandle = timedTask->taskHandle;
+    stats->frequency = (TaskTimer_Frequency_T)f;
+    stats->phase = timedTask->phase;
+    stats->jobs = timedTask->jobs;
+    stats->minLatencyUs = (0U == timedTask->jobs) ? 0U : cyclesToUs(timedTask->minLatency);
+    stats->maxLatencyUs = cyclesToUs(timedTask->maxLatency);
+    stats->maxResponseUs = cyclesToUs(timedTask->maxResponse);
+    return true;
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void TaskTimer_ResetStats(void)
+{
+  for (uint16_t f = 0; f < TASKTIMER_FREQUENCY_COUNT; ++f) {
+    for (uint16_t i = 0; i < taskLists[f].numTasks; ++i) {
+      resetStats(&taskLists[f].tasks[i]);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void TaskTimer_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
+{
+  if (!isInitialized)
+  {
+    return;
+  }
+
+  if (htim->Instance != timHandle->Instance) {
     return;
   }
 
-  // Notify all tasks in the list
+  // Notify the tasks whose phase of their period is this tick
+  const uint32_t now = DWT->CYCCNT;
   BaseType_t higherPriorityTaskWoken = pdFALSE;
-  for (uint16_t i = 0; i < taskList->numTasks; ++i) {
-    BaseType_t taskWokenI = pdFALSE;
-    vTaskNotifyGiveFromISR(*taskList->tasks[i].taskHandle, &taskWokenI);
+  for (uint16_t f = 0; f < TASKTIMER_FREQUENCY_COUNT; ++f) {
+    TaskList_T* taskList = &taskLists[f];
+    taskList->tick++;
+    if (periodTicks[f] == taskList->tick) {
+      taskList->tick = 0U;
+    }
+
+    for (uint16_t i = 0; i < taskList->numTasks; ++i) {
+      TimedTask_T* timedTask = &taskList->tasks[i];
+      if (timedTask->phase != taskList->tick) {
+        continue;
+      }
 
-    higherPriorityTaskWoken = (taskWokenI == pdTRUE) ? pdTRUE : higherPriorityTaskWoken;
+      timedTask->releaseCycles = now;
+      BaseType_t taskWokenI = pdFALSE;
+      vTaskNotifyGiveFromISR(*timedTask->taskHandle, &taskWokenI);
+
+      higherPriorityTaskWoken = (taskWokenI == pdTRUE) ? pdTRUE : higherPriorityTaskWoken;
+    }
   }
 
   portYIELD_FROM_ISR(higherPriorityTaskWoken);
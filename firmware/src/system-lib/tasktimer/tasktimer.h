@@ -1,7 +1,21 @@
 /*
  * tasktimer.h
  *
- * Provides notifications to tasks using hardware timers.
+ * Provides notifications to tasks using a hardware timer.
+ *
+ * The timer runs at TASKTIMER_BASE_HZ. Slower rates are divided from it, so
+ * each task is only notified when its own period has elapsed.
+ *
+ * Each task is released at a phase within its period, in timer ticks, so
+ * tasks of the same frequency don't all wake on the same tick and contend
+ * for the CPU and shared state. The phase is given, or chosen for the tick
+ * with the fewest releases. Chosen phases are chosen again, in register
+ * order, whenever a task is registered, so they avoid given phases however
+ * late those are registered.
+ *
+ * Tasks wait with TaskTimer_Wait, which measures the latency from release
+ * to the task starting, and the response time from release until the task
+ * waits again, using the DWT cycle counter (enabled by Log_Init).
  *
  *  Created on: 6 May 2021
  *      Author: Liam Flaherty
@@ -11,6 +25,7 @@
 #define TIME_TASKTIMER_TASKTIMER_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "stm32f7xx_hal.h"
 #include "FreeRTOS.h"
 #include "task.h"
@@ -21,45 +36,114 @@
 REGISTERED_MODULE_STATIC(TASKTIMER);
 
 /*
- * Max number of tasks allowed to be registered
+ * Max number of tasks allowed to be registered, per frequency
  */
 #define TASKTIMER_MAX_TASKS 16U
 
+/*
+ * Frequency of the hardware timer
+ */
+#define TASKTIMER_BASE_HZ 1000U
+
+/*
+ * Phase that is chosen on register
+ */
+#define TASKTIMER_PHASE_AUTO 0xFFFFU
+
 typedef enum {
   TASKTIMER_STATUS_OK                     = 0x00U,
   TASKTIMER_STATUS_ERROR_TIMER            = 0x01U,
   TASKTIMER_STATUS_ERROR_FULL             = 0x02U,
   TASKTIMER_STATUS_ERROR_INVALID_TIMER    = 0x03U,
   TASKTIMER_STATUS_ERROR_DEPENDS          = 0x04U,
+  TASKTIMER_STATUS_ERROR_INVALID_PHASE    = 0x05U,
 } TaskTimer_Status_T;
 
 typedef enum {
-  TASKTIMER_FREQUENCY_100HZ = 0U,
+  TASKTIMER_FREQUENCY_1KHZ = 0U,
+  TASKTIMER_FREQUENCY_100HZ,
+  TASKTIMER_FREQUENCY_10HZ,
+  TASKTIMER_FREQUENCY_1HZ,
   TASKTIMER_FREQUENCY_COUNT,
 } TaskTimer_Frequency_T;
 
+extern const char* const TaskTimer_FrequencyNames[TASKTIMER_FREQUENCY_COUNT];
+
+/*
+ * Timing of a registered task, since init or the last reset
+ */
+typedef struct {
+  TaskHandle_t* taskHandle;
+  TaskTimer_Frequency_T frequency;
+  uint16_t phase;           // timer ticks after the period starts
+  uint32_t jobs;            // releases the task started on
+  uint32_t minLatencyUs;    // release to start
+  uint32_t maxLatencyUs;
+  uint32_t maxResponseUs;   // release to waiting again, worst case response time
+} TaskTimer_Stats_T;
+
 /*
  * Starts the timer function
  * @param logger Pointer to logging settings
- * @param htim100Hz Handle for the 100Hz timer
+ * @param htim1kHz Handle for the timer, elapsing at TASKTIMER_BASE_HZ
  */
 TaskTimer_Status_T TaskTimer_Init(
     Logging_T* logger,
-    TIM_HandleTypeDef* htim100Hz);
+    TIM_HandleTypeDef* htim1kHz);
 
 /*
  * Registers a task for real-time notifications.
- * When the timer has elapsed, a notification will be sent to the task
- * 
- * Various timers are set up to trigger at different frequencies.
- * This method will internally map TaskTimer_Frequency_T to the correct
- * hardware timer.
+ * Each time the period of its frequency has elapsed, a notification will be
+ * sent to the task. The phase is chosen to spread releases over the timer
+ * ticks, and may change as later tasks are registered.
  *
  * @param task The task to be notified
  * @param timer The timer to notify from.
  */
 TaskTimer_Status_T TaskTimer_RegisterTask(TaskHandle_t* task, const TaskTimer_Frequency_T timer);
 
+/*
+ * Registers a task for real-time notifications at a given phase.
+ *
+ * @param task The task to be notified
+ * @param timer The timer to notify from.
+ * @param phase Timer ticks after the period starts, less than the period, or
+ * TASKTIMER_PHASE_AUTO
+ */
+TaskTimer_Status_T TaskTimer_RegisterTaskPhase(
+    TaskHandle_t* task,
+    const TaskTimer_Frequency_T timer,
+    const uint16_t phase);
+
+/*
+ * Waits for the next notification, in place of ulTaskNotifyTake(pdTRUE, ...).
+ * Called by the registered task, which finishes its last job by calling this.
+ *
+ * @param task The task handle given on register
+ * @param blockTime Max time to wait
+ * @return Notification value before it was cleared, 0 if timed out
+ */
+uint32_t TaskTimer_Wait(TaskHandle_t* task, TickType_t blockTime);
+
+/*
+ * @return Number of registered tasks
+ */
+uint16_t TaskTimer_NumTasks(void);
+
+/*
+ * Gets the timing of a registered task
+ *
+ * @param index Task index, less than TaskTimer_NumTasks()
+ * @param stats Returns the timing
+ * @return false if index is out of range
+ */
+bool TaskTimer_GetStats(uint16_t index, TaskTimer_Stats_T* stats);
+
+/*
+ * Restarts the timing of every task
+ */
+void TaskTimer_ResetStats(void);
+
 /*
  * Handler for the timer period elapsed callback.
  * Invoke this method from the main HAL_TIM_PeriodElapsedCallback
@@ -0,0 +1,126 @@
+/*
+ * telemetry.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "telemetry.h"
+
+#include <stddef.h>
+
+// ------------------- Private methods -------------------
+/**
+ * @brief Finds a field of the stream
+ * @return The field, or NULL if the stream doesn't have it
+ */
+static Telemetry_Field_T* findField(Telemetry_T* stream, uint16_t fieldId)
+{
+  for (uint16_t i = 0U; i < stream->numFields; ++i) {
+    if (fieldId == stream->fields[i].fieldId) {
+      return &stream->fields[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Writes a keyframe field: the absolute value
+ */
+static uint16_t encodeKey(uint8_t* out, const Telemetry_Field_T* field)
+{
+  out[0] = (uint8_t)((field->fieldId >> 8) & 0xFF);
+  out[1] = (uint8_t)(field->fieldId & 0xFF);
+  out[2] = field->size;
+  for (uint8_t i = 0U; i < field->size; ++i) {
+    out[TELEMETRY_KEY_HEADER_LEN + i] =
+        (uint8_t)((field->last >> (8U * (field->size - 1U - i))) & 0xFF);
+  }
+  return (uint16_t)(TELEMETRY_KEY_HEADER_LEN + field->size);
+}
+
+// ------------------- Public methods -------------------
+void Telemetry_Init(Telemetry_T* stream)
+{
+  stream->numFields = 0U;
+  stream->sinceKeyframe = 0U;
+  stream->keyframePending = true;
+  stream->keyframe = false;
+}
+
+bool Telemetry_Begin(Telemetry_T* stream)
+{
+  stream->sinceKeyframe++;
+  if (stream->keyframePending || stream->sinceKeyframe >= stream->keyframePeriod) {
+    stream->keyframePending = false;
+    stream->sinceKeyframe = 0U;
+    stream->keyframe = true;
+  } else {
+    stream->keyframe = false;
+  }
+  return stream->keyframe;
+}
+
+void Telemetry_ForceKeyframe(Telemetry_T* stream)
+{
+  stream->keyframePending = true;
+}
+
+uint16_t Telemetry_EncodeField(
+    Telemetry_T* stream,
+    uint8_t* out,
+    uint16_t fieldId,
+    uint8_t size,
+    uint32_t value)
+{
+  if (0U == size || size > sizeof(uint32_t)) {
+    return 0U;
+  }
+  if (size < sizeof(uint32_t)) {
+    value &= (1U << (8U * size)) - 1U;
+  }
+
+  Telemetry_Field_T* field = findField(stream, fieldId);
+  if (NULL == field) {
+    if (stream->numFields >= TELEMETRY_MAX_FIELDS) {
+      return 0U;
+    }
+    field = &stream->fields[stream->numFields++];
+    field->fieldId = fieldId;
+    field->size = size;
+    field->last = value;
+    if (!stream->keyframe) {
+      // The receiver doesn't know the field yet
+      stream->keyframePending = true;
+      return 0U;
+    }
+    return encodeKey(out, field);
+  }
+
+  if (stream->keyframe) {
+    field->size = size;
+    field->last = value;
+    return encodeKey(out, field);
+  }
+
+  if (value == field->last) {
+    return 0U;
+  }
+
+  const uint32_t diff = value - field->last;
+  field->last = value;
+  uint16_t len = Telemetry_PutVarint(out, fieldId);
+  len = (uint16_t)(len + Telemetry_PutVarint(out + len, Telemetry_Zigzag(diff)));
+  return len;
+}
+
+uint16_t Telemetry_PutVarint(uint8_t* out, uint32_t value)
+{
+  uint16_t len = 0U;
+  while (value >= 0x80U) {
+    out[len++] = (uint8_t)((value & 0x7FU) | 0x80U);
+    value >>= 7;
+  }
+  out[len++] = (uint8_t)value;
+  return len;
+}
@@ -0,0 +1,106 @@
+/*
+ * telemetry.h
+ *
+ * Change-only encoding of telemetry fields.
+ *
+ * Keeps the last value sent of each field of a stream. Each update is either
+ * a keyframe, where every field is sent as its absolute value, or a delta,
+ * where only fields that changed since they were last sent are sent, as the
+ * difference. Keyframes are sent every keyframePeriod updates so a receiver
+ * that missed a delta can resync.
+ *
+ * Keyframe fields are: Field ID[2] Size[1] Value[Size], value big endian.
+ * Delta fields are: varint(Field ID) varint(zigzag(value - last value)),
+ * varints LSB first, 7 bits per byte. The difference is modulo 2^32, and the
+ * receiver keeps the low Size bytes of the result.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#ifndef LIB_TELEMETRY_TELEMETRY_H_
+#define LIB_TELEMETRY_TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TELEMETRY_MAX_FIELDS 16U // per stream
+#define TELEMETRY_KEY_HEADER_LEN 3U
+#define TELEMETRY_VARINT_MAX_LEN(bits) (((bits) + 6U) / 7U)
+// Most bytes one field can encode to, as a keyframe or a delta
+#define TELEMETRY_FIELD_MAX_LEN \
+  (TELEMETRY_VARINT_MAX_LEN(16U) + TELEMETRY_VARINT_MAX_LEN(32U))
+
+typedef struct
+{
+  uint16_t fieldId;
+  uint8_t size;
+  uint32_t last; // Value last sent
+} Telemetry_Field_T;
+
+typedef struct
+{
+  uint16_t keyframePeriod; // Updates from one keyframe to the next, 1 for all
+
+  // ******* Internal use *******
+  Telemetry_Field_T fields[TELEMETRY_MAX_FIELDS];
+  uint16_t numFields;
+  uint16_t sinceKeyframe; // Updates since the last keyframe
+  bool keyframePending; // Next update must be a keyframe
+  bool keyframe; // Current update is a keyframe
+} Telemetry_T;
+
+/**
+ * @brief Forgets all fields. The next update is a keyframe.
+ *
+ * @param stream Stream, keyframePeriod must be set
+ */
+void Telemetry_Init(Telemetry_T* stream);
+
+/**
+ * @brief Starts an update of the stream
+ *
+ * @return true if the update is a keyframe
+ */
+bool Telemetry_Begin(Telemetry_T* stream);
+
+/**
+ * @brief Makes the next update a keyframe, e.g. when an update couldn't be sent
+ */
+void Telemetry_ForceKeyframe(Telemetry_T* stream);
+
+/**
+ * @brief Encodes a field for the current update. A field that hasn't been
+ * seen before is added to the stream, and sent from the next keyframe (which
+ * is the next update).
+ *
+ * @param stream Stream
+ * @param out Output, at least TELEMETRY_FIELD_MAX_LEN bytes
+ * @param fieldId Field ID
+ * @param size Bytes of the value to send, 1 to 4
+ * @param value Value, in the low size bytes
+ * @return Bytes written to out. 0 if the field doesn't need sending.
+ */
+uint16_t Telemetry_EncodeField(
+  Telemetry_T* stream,
+  uint8_t* out,
+  uint16_t fieldId,
+  uint8_t size,
+  uint32_t value);
+
+/**
+ * @brief Writes an unsigned varint
+ * @return Bytes written, up to TELEMETRY_VARINT_MAX_LEN(32U)
+ */
+uint16_t Telemetry_PutVarint(uint8_t* out, uint32_t value);
+
+/**
+ * @brief Zigzag encodes a difference, so small negative and positive
+ * differences are both small numbers: 0, -1, 1, -2 become 0, 1, 2, 3
+ */
+static inline uint32_t Telemetry_Zigzag(uint32_t diff)
+{
+  return (diff << 1) ^ (0U - (diff >> 31));
+}
+
+#endif /* LIB_TELEMETRY_TELEMETRY_H_ */
@@ -0,0 +1,116 @@
+/*
+ * trace.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "trace.h"
+
+#include <string.h>
+
+#include "stm32f7xx_hal.h"
+
+#define TASK_NUMBER_MASK 0x7FU
+
+volatile uint32_t Trace_Dropped[TRACE_NUM_PORTS];
+
+// ------------------- Private methods -------------------
+static bool portReady(uint8_t port)
+{
+  // Reads 1 when the FIFO can take a write
+  return 0U != ITM->PORT[port].u32;
+}
+
+static void countDropped(uint8_t port, uint32_t count)
+{
+  __atomic_fetch_add(&Trace_Dropped[port], count, __ATOMIC_RELAXED);
+}
+
+// ------------------- Public methods -------------------
+bool Trace_Enabled(uint8_t port)
+{
+  return 0U != (ITM->TCR & ITM_TCR_ITMENA_Msk) &&
+         0U != (ITM->TER & (1UL << port));
+}
+
+uint32_t Trace_WriteText(const char* text, uint32_t len)
+{
+  if (!Trace_Enabled(TRACE_PORT_TEXT)) {
+    return 0U;
+  }
+
+  uint32_t written = 0U;
+  while (written < len) {
+    if (!portReady(TRACE_PORT_TEXT)) {
+      countDropped(TRACE_PORT_TEXT, len - written);
+      break;
+    }
+    // Sent least significant byte first, so characters stay in order
+    const uint32_t left = len - written;
+    if (left >= 4U) {
+      uint32_t word;
+      memcpy(&word, &text[written], sizeof(word));
+      ITM->PORT[TRACE_PORT_TEXT].u32 = word;
+      written += 4U;
+    } else if (left >= 2U) {
+      uint16_t half;
+      memcpy(&half, &text[written], sizeof(half));
+      ITM->PORT[TRACE_PORT_TEXT].u16 = half;
+      written += 2U;
+    } else {
+      ITM->PORT[TRACE_PORT_TEXT].u8 = (uint8_t)text[written];
+      written += 1U;
+    }
+  }
+  return written;
+}
+
+bool Trace_WriteEvent(const uint8_t* event, uint32_t len)
+{
+  if (!Trace_Enabled(TRACE_PORT_EVENT) ||
+      len < TRACE_EVENT_HEADER_LEN ||
+      0U != (len - TRACE_EVENT_HEADER_LEN) % 4U) {
+    return false;
+  }
+
+  // Header as 2, 1 and 1 bytes, the 2 byte packet starts the event
+  bool whole = portReady(TRACE_PORT_EVENT);
+  if (whole) {
+    ITM->PORT[TRACE_PORT_EVENT].u16 = (uint16_t)(event[0] | (event[1] << 8));
+    whole = portReady(TRACE_PORT_EVENT);
+  }
+  if (whole) {
+    ITM->PORT[TRACE_PORT_EVENT].u8 = event[2];
+    whole = portReady(TRACE_PORT_EVENT);
+  }
+  if (whole) {
+    ITM->PORT[TRACE_PORT_EVENT].u8 = event[3];
+  }
+  for (uint32_t i = TRACE_EVENT_HEADER_LEN; whole && i < len; i += 4U) {
+    whole = portReady(TRACE_PORT_EVENT);
+    if (whole) {
+      uint32_t word;
+      memcpy(&word, &event[i], sizeof(word));
+      ITM->PORT[TRACE_PORT_EVENT].u32 = word;
+    }
+  }
+
+  if (!whole) {
+    countDropped(TRACE_PORT_EVENT, 1U);
+  }
+  return whole;
+}
+
+void Trace_TaskSwitchedIn(uint32_t taskNumber)
+{
+  if (!Trace_Enabled(TRACE_PORT_TASK)) {
+    return;
+  }
+  if (!portReady(TRACE_PORT_TASK)) {
+    countDropped(TRACE_PORT_TASK, 1U);
+    return;
+  }
+  ITM->PORT[TRACE_PORT_TASK].u32 =
+      (DWT->CYCCNT & ~TASK_NUMBER_MASK) | (taskNumber & TASK_NUMBER_MASK);
+}
@@ -0,0 +1,74 @@
+/*
+ * trace.h
+ *
+ * Trace output on the ITM stimulus ports, read by a debugger over SWO while
+ * bench testing. Each kind of output has its own port:
+ *   TRACE_PORT_TEXT  Text logs, as printed
+ *   TRACE_PORT_EVENT Deferred log records, as sent to the PC
+ *   TRACE_PORT_TASK  A word per task switch: the cycle counter with the low
+ *                    7 bits replaced by the number of the task switched in
+ *
+ * Writes are up to 32 bits, so a word takes one FIFO slot instead of four.
+ * Nothing waits for the FIFO: when it is busy, the rest of the output is
+ * dropped and counted. Output to a port the debugger hasn't enabled, or with
+ * no debugger, costs two register reads.
+ *
+ * An event is written as a 2 byte packet, two 1 byte packets, then 4 byte
+ * packets. The bytes on the port are the event's bytes, and the 2 byte
+ * packet marks the start of each event, so the PC can find the next event
+ * after one is cut short, or interrupted by another event.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#ifndef LIB_TRACE_TRACE_H_
+#define LIB_TRACE_TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TRACE_PORT_TEXT  0U
+#define TRACE_PORT_EVENT 1U
+#define TRACE_PORT_TASK  2U
+#define TRACE_NUM_PORTS  3U
+
+#define TRACE_EVENT_HEADER_LEN 4U
+
+// Bytes, events and task switches dropped, per port
+extern volatile uint32_t Trace_Dropped[TRACE_NUM_PORTS];
+
+/**
+ * @brief Gets whether a port is enabled by the debugger
+ *
+ * @param port TRACE_PORT_TEXT to TRACE_PORT_TASK
+ */
+bool Trace_Enabled(uint8_t port);
+
+/**
+ * @brief Writes text to the text port, 4 characters per write
+ *
+ * @param text Characters, not terminated
+ * @param len Length of text
+ * @return Characters written, the rest are dropped
+ */
+uint32_t Trace_WriteText(const char* text, uint32_t len);
+
+/**
+ * @brief Writes an event to the event port. Can be called from interrupts.
+ *
+ * @param event TRACE_EVENT_HEADER_LEN bytes, then a multiple of 4 bytes
+ * @param len Length of event
+ * @return false if not written whole
+ */
+bool Trace_WriteEvent(const uint8_t* event, uint32_t len);
+
+/**
+ * @brief Writes a task switch to the task port. Called by the kernel
+ * through traceTASK_SWITCHED_IN.
+ *
+ * @param taskNumber Number of the task switched in
+ */
+void Trace_TaskSwitchedIn(uint32_t taskNumber);
+
+#endif /* LIB_TRACE_TRACE_H_ */
@@ -0,0 +1,49 @@
+/*
+ * msgframe.h
+ *
+ * Message frame format shared by the encoder and decoder.
+ *
+ * Frame fields, MSB first:
+ *   Seq[1] Length[2] Address[2] Function[2] Data[Length] CRC[4]
+ * The sender keeps a Seq counter per function, incremented with each frame of
+ * that function, so the receiver can count lost frames of each type. The CRC
+ * covers everything before it.
+ *
+ * The frame is COBS encoded (so it contains no 0x00 bytes) and followed by a
+ * 0x00 delimiter. A receiver resynchronises at the next delimiter.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#ifndef COMM_UART_MSGFRAME_H_
+#define COMM_UART_MSGFRAME_H_
+
+#define MSGFRAME_HEADER_LEN     7U // seq, length, address, function
+#define MSGFRAME_CRC_LEN        4U
+#define MSGFRAME_MAX_DATA_LEN   1024U
+#define MSGFRAME_DELIMITER      0x00U
+
+// Worst case bytes added by COBS encoding n bytes
+#define MSGFRAME_COBS_OVERHEAD(n) (1U + (n) / 254U)
+
+// Unencoded frame length for dataLen bytes of data
+#define MSGFRAME_RAW_LEN(dataLen) \
+    (MSGFRAME_HEADER_LEN + (dataLen) + MSGFRAME_CRC_LEN)
+
+// The encoder builds the frame at this offset into its buffer, and encodes it
+// down to the start. Fixed so the data position doesn't depend on its length.
+#define MSGFRAME_ENCODE_OFFSET \
+    MSGFRAME_COBS_OVERHEAD(MSGFRAME_RAW_LEN(MSGFRAME_MAX_DATA_LEN))
+
+// Buffer needed to encode a frame with dataLen bytes of data
+#define MSGFRAME_ENCODE_BUFFER_LEN(dataLen) \
+    (MSGFRAME_ENCODE_OFFSET + MSGFRAME_RAW_LEN(dataLen) + 1U)
+
+// Longest frame on the wire, including the delimiter, for dataLen bytes of
+// data. Exact for frames under 254 bytes.
+#define MSGFRAME_MAX_ENCODED_LEN(dataLen) \
+    (MSGFRAME_COBS_OVERHEAD(MSGFRAME_RAW_LEN(dataLen)) + \
+     MSGFRAME_RAW_LEN(dataLen) + 1U)
+
+#endif // COMM_UART_MSGFRAME_H_
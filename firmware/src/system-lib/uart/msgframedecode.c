@@ -10,110 +10,188 @@
 #include <string.h>
 #include <assert.h>
 
-static const TickType_t mBlockTime = 100 / portTICK_PERIOD_MS; // 100ms
+#define MSGFRAME_BUFFER_MASK (MSGFRAME_BUFFER_LEN - 1U)
+_Static_assert(0U == (MSGFRAME_BUFFER_LEN & MSGFRAME_BUFFER_MASK), "ring buffer length must be a power of two");
+_Static_assert(MSGFRAME_BUFFER_LEN <= 0x8000U, "ring buffer indices are 16 bit");
 
 // ------------------- Private methods -------------------
-static bool verifyCrc(MsgFrameDecode_T* mf)
+/**
+ * @brief Checks the decoded frame once its delimiter has arrived
+ * @return true if the frame is valid, and *msg is set
+ */
+static bool finishFrame(MsgFrameDecode_T* mf, MsgFrameDecode_Msg_T* msg)
 {
-  // This required for the (void*) cast to work
-  assert(NULL != mf->crc);
-  assert(NULL != mf->crc->hcrc);
-  assert(CRC_INPUTDATA_FORMAT_BYTES == mf->crc->hcrc->InputDataFormat);
-
-  uint8_t* msg = mf->data + mf->start;
-  size_t crcOffset = mf->msgLen - 6U;
-
-  uint32_t msgCrc = 0U;
-  msgCrc |= (uint32_t)msg[crcOffset + 0U] << 24U;
-  msgCrc |= (uint32_t)msg[crcOffset + 1U] << 16U;
-  msgCrc |= (uint32_t)msg[crcOffset + 2U] << 8U;
-  msgCrc |= (uint32_t)msg[crcOffset + 3U] << 0U;
-  memset(msg + crcOffset, 0U, sizeof(uint32_t));
-
-  uint32_t calcCrc = 0U;
-  CRC_Calculate(
-    mf->crc,
-    (void*)msg,
-    mf->msgLen,
-    mBlockTime,
-    &calcCrc);
-
-  // restore original message
-  msg[crcOffset + 0U] = (uint8_t)((msgCrc >> 24U) & 0xFF);
-  msg[crcOffset + 1U] = (uint8_t)((msgCrc >> 16U) & 0xFF);
-  msg[crcOffset + 2U] = (uint8_t)((msgCrc >> 8U) & 0xFF);
-  msg[crcOffset + 3U] = (uint8_t)((msgCrc >> 0U) & 0xFF);
-
-  return calcCrc == msgCrc;
-}
+  // Delimiter inside a block, or too long
+  if (mf->invalid || 0U != mf->blockLeft) {
+    return false;
+  }
 
-// ------------------- Public methods -------------------
-bool MsgFrameDecode_Init(MsgFrameDecode_T* mf)
-{
-  if (mf->msgLen > MSGFRAME_BUFFER_LEN) {
+  if (mf->rawLen < MSGFRAME_RAW_LEN(0U)) {
     return false;
   }
 
-  mf->start = 0U;
-  mf->end = 0U;
-  mf->availableBytes = MSGFRAME_BUFFER_LEN;
+  const uint8_t* raw = mf->raw;
+  uint16_t dataLen = 0U;
+  dataLen |= (uint16_t)(raw[1] << 8);
+  dataLen |= (uint16_t)raw[2];
+  if (mf->rawLen != MSGFRAME_RAW_LEN(dataLen)) {
+    return false;
+  }
+
+  // CRC of the frame including its own CRC is the residue when correct
+  if (CRC32_RESIDUE != CRC32_Finish(&mf->crc)) {
+    return false;
+  }
+
+  msg->seq = raw[0];
+  msg->dataLen = dataLen;
+  msg->address = (uint16_t)((raw[3] << 8) | raw[4]);
+  msg->function = (uint16_t)((raw[5] << 8) | raw[6]);
+  msg->data = mf->raw + MSGFRAME_HEADER_LEN;
 
   return true;
 }
 
+static void resetFrame(MsgFrameDecode_T* mf)
+{
+  mf->rawLen = 0U;
+  mf->blockCode = 0U;
+  mf->blockLeft = 0U;
+  mf->invalid = false;
+  CRC32_Begin(&mf->crc);
+}
+
+/**
+ * @brief Starts a COBS block. Every block but the first follows a zero,
+ * unless the previous block was full (254 bytes).
+ */
+static void startBlock(MsgFrameDecode_T* mf, uint8_t code)
+{
+  if (0U != mf->blockCode && 0xFFU != mf->blockCode) {
+    if (mf->rawLen < sizeof(mf->raw)) {
+      mf->raw[mf->rawLen] = 0U;
+      CRC32_Update(&mf->crc, &mf->raw[mf->rawLen], 1U);
+      mf->rawLen++;
+    } else {
+      mf->invalid = true;
+    }
+  }
+
+  mf->blockCode = code;
+  mf->blockLeft = (uint8_t)(code - 1U);
+}
+
+/**
+ * @brief Decodes as much of the current block as has been received, up to
+ * the end of the ring. Data bytes are copied as a run.
+ */
+static void decodeBlock(MsgFrameDecode_T* mf)
+{
+  const uint16_t index = mf->tail & MSGFRAME_BUFFER_MASK;
+  uint16_t len = (uint16_t)(mf->head - mf->tail);
+  if (len > MSGFRAME_BUFFER_LEN - index) {
+    len = (uint16_t)(MSGFRAME_BUFFER_LEN - index);
+  }
+  if (len > mf->blockLeft) {
+    len = mf->blockLeft;
+  }
+
+  const uint8_t* src = &mf->ring[index];
+  const uint8_t* delim = memchr(src, MSGFRAME_DELIMITER, len);
+  if (NULL != delim) {
+    // Frame ended early. Leave the delimiter to end it.
+    len = (uint16_t)(delim - src);
+    mf->invalid = true;
+    mf->blockLeft = (uint8_t)len;
+  }
+
+  if (mf->rawLen + len > sizeof(mf->raw)) {
+    mf->invalid = true;
+  }
+  if (!mf->invalid) {
+    memcpy(mf->raw + mf->rawLen, src, len);
+    CRC32_Update(&mf->crc, src, len);
+    mf->rawLen = (uint16_t)(mf->rawLen + len);
+  }
+
+  mf->tail = (uint16_t)(mf->tail + len);
+  mf->blockLeft = (uint8_t)(mf->blockLeft - len);
+}
+
+// ------------------- Public methods -------------------
+void MsgFrameDecode_Init(MsgFrameDecode_T* mf)
+{
+  mf->head = 0U;
+  mf->tail = 0U;
+  mf->badFrames = 0U;
+  resetFrame(mf);
+}
+
 bool MsgFrameDecode_RecvBytes(MsgFrameDecode_T* mf,
                         uint8_t* recvBytes,
                         uint16_t recvNumBytes)
 {
-  if (recvNumBytes > mf->availableBytes) {
+  if (recvNumBytes > MSGFRAME_BUFFER_LEN - (uint16_t)(mf->head - mf->tail)) {
     return false;
   }
 
-  memcpy(mf->data + mf->end, recvBytes, recvNumBytes * sizeof(uint8_t));
-  mf->end += recvNumBytes;
-  mf->availableBytes -= recvNumBytes;
+  // Up to the end of the ring, then the rest from the start
+  const uint16_t index = mf->head & MSGFRAME_BUFFER_MASK;
+  uint16_t firstLen = (uint16_t)(MSGFRAME_BUFFER_LEN - index);
+  if (firstLen > recvNumBytes) {
+    firstLen = recvNumBytes;
+  }
+  memcpy(&mf->ring[index], recvBytes, firstLen);
+  memcpy(mf->ring, recvBytes + firstLen, (size_t)(recvNumBytes - firstLen));
+  mf->head = (uint16_t)(mf->head + recvNumBytes);
 
   return true;
 }
 
-bool MsgFrameDecode_RecvMsg(MsgFrameDecode_T* mf, size_t* msgOffset)
+uint8_t* MsgFrameDecode_GetWriteSpace(MsgFrameDecode_T* mf, uint16_t* len)
+{
+  // Contiguous free space, up to the end of the ring
+  const uint16_t index = mf->head & MSGFRAME_BUFFER_MASK;
+  const uint16_t space = (uint16_t)(MSGFRAME_BUFFER_LEN - (uint16_t)(mf->head - mf->tail));
+  *len = (uint16_t)(MSGFRAME_BUFFER_LEN - index);
+  if (*len > space) {
+    *len = space;
+  }
+  return &mf->ring[index];
+}
+
+void MsgFrameDecode_CommitBytes(MsgFrameDecode_T* mf, uint16_t len)
+{
+  assert(len <= MSGFRAME_BUFFER_LEN - (uint16_t)(mf->head - mf->tail));
+  mf->head = (uint16_t)(mf->head + len);
+}
+
+bool MsgFrameDecode_RecvMsg(MsgFrameDecode_T* mf, MsgFrameDecode_Msg_T* msg)
 {
-  uint32_t usedBytes = mf->end - mf->start;
-
-  while (usedBytes >= mf->msgLen) {
-    // try to extract the next message
-    uint8_t startByte = mf->data[mf->start];
-    uint8_t crByte = mf->data[mf->start + mf->msgLen - 2U];
-    uint8_t lfByte = mf->data[mf->start + mf->msgLen - 1U];
-
-    if (':' == startByte && '\r' == crByte && '\n' == lfByte) {
-      // Do CRC check
-      if (verifyCrc(mf)) {
-        // Valid message
-        *msgOffset = mf->start;
-
-        // update internals to next possible message
-        usedBytes -= mf->msgLen;
-        mf->start += mf->msgLen;
-
-        return true;
-      }
+  while (mf->tail != mf->head) {
+    if (mf->blockLeft > 0U) {
+      decodeBlock(mf);
+      continue;
     }
 
-    // no valid message yet
-    usedBytes--;
-    mf->start++;
-  }
+    const uint8_t code = mf->ring[mf->tail & MSGFRAME_BUFFER_MASK];
+    mf->tail++;
+    if (MSGFRAME_DELIMITER != code) {
+      startBlock(mf, code);
+      continue;
+    }
+
+    if (0U == mf->blockCode) {
+      // Consecutive delimiters, e.g. a sender flushing the line
+      continue;
+    }
 
-  if (mf->start > 1U) {
-    // no valid messages, and data is offset into the buffer
-    // shift data down
-    for (uint32_t i = 0U; i < usedBytes; ++i) {
-      mf->data[i] = mf->data[i + mf->start];
+    const bool valid = finishFrame(mf, msg);
+    resetFrame(mf);
+    if (valid) {
+      return true;
     }
-    mf->availableBytes += mf->start;
-    mf->end -= mf->start;
-    mf->start = 0U;
+    mf->badFrames++;
   }
 
   return false;
@@ -7,12 +7,20 @@
  *   acquire data and feed the MsgFrame.
  * 
  *   Use the uart interface to receive serial bytes, and store them in a
- *   buffer. Use this to extract pointers to messages in the buffer.
- *   1. Call MsgFrameDecode_RecvByte(...) when data comes from the ISR stream buffer
+ *   buffer. Use this to extract messages (format in msgframe.h) from the buffer.
+ *   1. Put received bytes in the decoder, either
+ *      * MsgFrameDecode_RecvBytes(...) to copy them in, or
+ *      * MsgFrameDecode_GetWriteSpace(...) to receive straight into the
+ *        decoder, then MsgFrameDecode_CommitBytes(...)
  *   2. Repeatedly call MsgFrameDecode_RecvMsg(...) and process the resulting message
  *      (until it returns false)
- *      MsgFrameDecode_RecvMsg will automatically trim the internal buffer once all
- *      messages have been read out (i.e. when it returns false)
+ *      MsgFrameDecode_RecvMsg decodes every received byte before returning
+ *      false, so all of the buffer is free again.
+ *
+ *   Bytes are held in a ring buffer and decoded (COBS) into a frame buffer as
+ *   they are read out, so the cost is the same for each byte whatever the
+ *   frame sizes and however the data arrives. Nothing is shifted. The CRC is
+ *   also calculated as the frame is decoded (in software, so without a lock).
  *
  *  Created on: Jul 23 2021
  *      Author: Liam Flaherty
@@ -25,56 +33,86 @@
 #include <stdbool.h>
 #include <stddef.h>
 
-#include "crc/crc.h"
+#include "crc/crc32.h"
+#include "msgframe.h"
 
+// Received bytes not yet decoded. Must be a power of two.
 #define MSGFRAME_BUFFER_LEN 1024U
 
 typedef struct {
-  // MsgFrame settings
-  uint16_t msgLen; // length of a single message
-  CRC_T* crc;
+  uint8_t seq;
+  uint16_t address;
+  uint16_t function;
+  uint16_t dataLen;
+  uint8_t* data; // Points into the decoder. Valid until the next call to
+                 // MsgFrameDecode_RecvMsg.
+} MsgFrameDecode_Msg_T;
+
+typedef struct {
+  // Statistics
+  uint32_t badFrames; // frames dropped for a COBS, length or CRC error
 
-  // Variables
-  uint16_t start; // offset into `data` where next set of received data starts
-  uint16_t end; // offset into `data` where to place next byte of data
-  uint16_t availableBytes; // remaining bytes in buffer
-  uint8_t data[MSGFRAME_BUFFER_LEN];
+  // ******* Internal use *******
+  uint16_t head; // ring index where the next received byte goes (free running)
+  uint16_t tail; // ring index of the next byte to decode (free running)
+  uint16_t rawLen; // bytes of the current frame decoded into raw
+  uint8_t blockCode; // code byte of the current COBS block, 0 between frames
+  uint8_t blockLeft; // bytes of the current COBS block still to decode
+  bool invalid; // current frame can't be valid, drop it at the delimiter
+  CRC32_Ctx_T crc; // CRC of the current frame so far
+  uint8_t ring[MSGFRAME_BUFFER_LEN];
+  uint8_t raw[MSGFRAME_RAW_LEN(MSGFRAME_MAX_DATA_LEN)]; // current frame
 } MsgFrameDecode_T;
 
 /**
- * @brief Initialize MsgFrameDecode_T struct
+ * @brief Initialize MsgFrameDecode_T struct. Drops anything received.
  * 
- * @param msg 
- * @return Success
+ * @param mf MsgFrame struct
  */
-bool MsgFrameDecode_Init(MsgFrameDecode_T* mf);
+void MsgFrameDecode_Init(MsgFrameDecode_T* mf);
 
 /**
- * @brief 
+ * @brief Copies received bytes into the decoder
  * @param msg 
  * @param recvBytes 
  * @param recvNumBytes 
- * @return true If all data was inserted.
+ * @return true If all data was inserted. Nothing is inserted if there isn't
+ * space for all of it.
  */
 bool MsgFrameDecode_RecvBytes(MsgFrameDecode_T* mf,
                               uint8_t* recvBytes,
                               uint16_t recvNumBytes);
 
 /**
- * @brief Processes the internal buffer to find the next valid message.
- * If a message was found, *msgOffset will be updated to contain the
- * offset into mf->data. If MsgFrameDecode_RecvMsg returns true, mf->data[msgOffset]
- * will have mf->msgLen bytes of data.
+ * @brief Gets space in the decoder to receive bytes directly into.
+ * Call MsgFrameDecode_CommitBytes with the number of bytes written.
+ *
+ * @param mf MsgFrame struct
+ * @param len Updated with the number of bytes that can be written
+ * @return Where to write received bytes
+ */
+uint8_t* MsgFrameDecode_GetWriteSpace(MsgFrameDecode_T* mf, uint16_t* len);
+
+/**
+ * @brief Adds bytes written to the space from MsgFrameDecode_GetWriteSpace
+ *
+ * @param mf MsgFrame struct
+ * @param len Bytes written, no more than the space given
+ */
+void MsgFrameDecode_CommitBytes(MsgFrameDecode_T* mf, uint16_t len);
+
+/**
+ * @brief Decodes received bytes up to the end of the next valid message.
+ * If a message was found, *msg is updated to describe it.
  * 
- * Keep calling this until it returns false.
- * Upon a call that returns false, it will clean the internal buffer to save
- * space for the next set of data to be received.
+ * Keep calling this until it returns false, at which point every received
+ * byte has been decoded.
  * 
  * @param mf MsgFrame struct 
- * @param msgOffset Updates a reference to the buffer offset.
- * @return true A message was found and the value of *msgOffset is valid.
- * @return false No more messages. Do not use the msgOffset result.
+ * @param msg Updated with the received message.
+ * @return true A message was found and *msg is valid.
+ * @return false No more messages. Do not use the msg result.
  */
-bool MsgFrameDecode_RecvMsg(MsgFrameDecode_T* mf, size_t* msgOffset);
+bool MsgFrameDecode_RecvMsg(MsgFrameDecode_T* mf, MsgFrameDecode_Msg_T* msg);
 
 #endif // COMM_UART_MSGFRAMEDECODE_H_
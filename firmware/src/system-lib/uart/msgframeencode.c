@@ -10,55 +10,83 @@
 #include <assert.h>
 #include <string.h>
 
-// Number of bytes that make up:
-// start byte, end bytes, addr, function, crc
-#define MSGFRAME_NUM_FRAME_BYTES 11U
-
-static const TickType_t mBlockTime = 100 / portTICK_PERIOD_MS; // 100ms
-
 uint8_t* MsgFrameEncode_InitFrame(MsgFrameEncode_T* mf)
 {
-  assert(mf->msgLen >= MSGFRAME_NUM_FRAME_BYTES);
-  assert(mf->msgLen - MSGFRAME_NUM_FRAME_BYTES == mf->dataLen);
+  assert(mf->bufferLen >= MSGFRAME_ENCODE_BUFFER_LEN(mf->dataLen));
 
-  mf->buffer[0] = ':';
-  mf->buffer[mf->msgLen - 2U] = '\r';
-  mf->buffer[mf->msgLen - 1U] = '\n';
+  uint8_t* raw = mf->buffer + MSGFRAME_ENCODE_OFFSET;
+
+  raw[0] = mf->seq;
 
   // Address[1:0]
-  mf->buffer[1] = (uint8_t)((mf->address >> 8) & 0xFF);
-  mf->buffer[2] = (uint8_t)((mf->address >> 0) & 0xFF);
+  raw[3] = (uint8_t)((mf->address >> 8) & 0xFF);
+  raw[4] = (uint8_t)((mf->address >> 0) & 0xFF);
 
   // Function[1:0]
-  mf->buffer[3] = (uint8_t)((mf->function >> 8) & 0xFF);
-  mf->buffer[4] = (uint8_t)((mf->function >> 0) & 0xFF);
+  raw[5] = (uint8_t)((mf->function >> 8) & 0xFF);
+  raw[6] = (uint8_t)((mf->function >> 0) & 0xFF);
+
+  return raw + MSGFRAME_HEADER_LEN;
+}
+
+void MsgFrameEncode_Finish(MsgFrameEncode_T* mf)
+{
+  assert(mf->dataLen <= MSGFRAME_MAX_DATA_LEN);
+  assert(mf->bufferLen >= MSGFRAME_ENCODE_BUFFER_LEN(mf->dataLen));
 
-  return mf->buffer + 5U;
+  uint8_t* raw = mf->buffer + MSGFRAME_ENCODE_OFFSET;
+
+  // Length[1:0]
+  raw[1] = (uint8_t)((mf->dataLen >> 8) & 0xFF);
+  raw[2] = (uint8_t)((mf->dataLen >> 0) & 0xFF);
+
+  const uint16_t crcOffset = (uint16_t)(MSGFRAME_HEADER_LEN + mf->dataLen);
+  const uint32_t calcCrc = CRC32_Calculate(raw, crcOffset);
+
+  raw[crcOffset + 0U] = (uint8_t)((calcCrc >> 24U) & 0xFF);
+  raw[crcOffset + 1U] = (uint8_t)((calcCrc >> 16U) & 0xFF);
+  raw[crcOffset + 2U] = (uint8_t)((calcCrc >> 8U) & 0xFF);
+  raw[crcOffset + 3U] = (uint8_t)((calcCrc >> 0U) & 0xFF);
+
+  uint16_t encodedLen = MsgFrameEncode_Cobs(
+      mf->buffer,
+      MSGFRAME_ENCODE_OFFSET,
+      (uint16_t)MSGFRAME_RAW_LEN(mf->dataLen));
+  mf->buffer[encodedLen] = MSGFRAME_DELIMITER;
+  mf->msgLen = (uint16_t)(encodedLen + 1U);
+  mf->seq++;
 }
 
-void MsgFrameEncode_UpdateCRC(MsgFrameEncode_T* mf)
+uint16_t MsgFrameEncode_Cobs(uint8_t* buffer, uint16_t srcOffset, uint16_t len)
 {
-  // This required for the (void*) cast to work
-  assert(NULL != mf->crc);
-  assert(NULL != mf->crc->hcrc);
-  assert(CRC_INPUTDATA_FORMAT_BYTES == mf->crc->hcrc->InputDataFormat);
-
-  size_t crcOffset = mf->msgLen - 6U;
-  mf->buffer[crcOffset + 0U] = 0U;
-  mf->buffer[crcOffset + 1U] = 0U;
-  mf->buffer[crcOffset + 2U] = 0U;
-  mf->buffer[crcOffset + 3U] = 0U;
-
-  uint32_t calcCrc = 0U;
-  CRC_Calculate(
-    mf->crc,
-    (void*)mf->buffer,
-    mf->msgLen,
-    mBlockTime,
-    &calcCrc);
-
-  mf->buffer[crcOffset + 0U] = (uint8_t)((calcCrc >> 24U) & 0xFF);
-  mf->buffer[crcOffset + 1U] = (uint8_t)((calcCrc >> 16U) & 0xFF);
-  mf->buffer[crcOffset + 2U] = (uint8_t)((calcCrc >> 8U) & 0xFF);
-  mf->buffer[crcOffset + 3U] = (uint8_t)((calcCrc >> 0U) & 0xFF);
+  // The output never overtakes the input: after reading n bytes at most
+  // 1 + n + n/254 have been written, and the input starts at least
+  // 1 + len/254 in. So each byte is read before it is overwritten.
+  assert(srcOffset >= MSGFRAME_COBS_OVERHEAD(len));
+
+  const uint8_t* src = buffer + srcOffset;
+  uint16_t codePos = 0U; // where the code byte of the current block goes
+  uint16_t out = 1U;
+  uint8_t code = 1U; // 1 + number of non-zero bytes in the current block
+
+  for (uint16_t i = 0U; i < len; ++i) {
+    const uint8_t b = src[i];
+    if (0U == b) {
+      buffer[codePos] = code;
+      codePos = out++;
+      code = 1U;
+    } else {
+      buffer[out++] = b;
+      code++;
+      if (0xFFU == code) {
+        // Block full, continue without an implied zero
+        buffer[codePos] = code;
+        codePos = out++;
+        code = 1U;
+      }
+    }
+  }
+  buffer[codePos] = code;
+
+  return out;
 }
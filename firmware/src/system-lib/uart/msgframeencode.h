@@ -1,14 +1,18 @@
 /*
  * msgframeencode.h
  *
+ * Encodes frames in the format described in msgframe.h
+ *
  * Usage:
- *   1. Create a MsgFrameEncode_T and set all fields.
+ *   1. Create a MsgFrameEncode_T and set all fields. The buffer must be at
+ *      least MSGFRAME_ENCODE_BUFFER_LEN(largest dataLen) long.
  *   2. Call MsgFrameEncode_InitFrame to populate buffer.
- *   3. Use pointer returned by MsgFrameEncode_InitFrame (which will be
- *      buffer + data_offset) to set data in msg.
- *   4. Use MsgFrameEncode_UpdateCRC to populate CRC bytes
- *   5. Use MsgFrameEncode_T::buffer to transmit message.
- * 
+ *   3. Use pointer returned by MsgFrameEncode_InitFrame to set data in msg.
+ *      dataLen can be changed until the frame is finished.
+ *   4. Use MsgFrameEncode_Finish to add the length and CRC, and encode the
+ *      frame.
+ *   5. Transmit MsgFrameEncode_T::msgLen bytes of MsgFrameEncode_T::buffer.
+ *
  *  Created on: 31 Jul 2022
  *      Author: Liam Flaherty
  */
@@ -18,36 +22,51 @@
 
 #include <stdint.h>
 
-#include "crc/crc.h"
+#include "crc/crc32.h"
+#include "msgframe.h"
 
 typedef struct {
-  uint16_t msgLen; // length of whole message
+  uint16_t bufferLen; // length of buffer
   uint16_t dataLen; // length of data portion of message
   uint16_t address;
   uint16_t function;
-  uint8_t* buffer; // Pointer to full message. Must be of length msgLen
+  uint8_t* buffer; // Pointer to full message. Must be of length bufferLen
                    // Ownership and management is retained by caller and
                    // borrowed during call.
 
-  CRC_T* crc; // CRC module
+  // ******* Internal use *******
+  uint16_t msgLen; // length of encoded message, set by MsgFrameEncode_Finish
+  uint8_t seq; // sequence number of the next message
 } MsgFrameEncode_T;
 
 /**
  * @brief Sets up boiler-plate msg contents.
- *   * Begin and end bytes
+ *   * Sequence number
  *   * Function/address bytes
- * 
- * @param mf 
- * @return Pointer to data contents in message.
+ *
+ * @param mf
+ * @return Pointer to data contents in message (dataLen bytes).
  *         Will be a pointer to within mf->buffer
  */
 uint8_t* MsgFrameEncode_InitFrame(MsgFrameEncode_T* mf);
 
 /**
- * @brief Add the CRC bytes to the message.
- * 
+ * @brief Add the length and CRC bytes to the message, and encode it in
+ * place. The encoded message is the first mf->msgLen bytes of mf->buffer.
+ *
  * @param mf message frame encoder struct
  */
-void MsgFrameEncode_UpdateCRC(MsgFrameEncode_T* mf);
+void MsgFrameEncode_Finish(MsgFrameEncode_T* mf);
+
+/**
+ * @brief COBS encodes a buffer in place. The result starts at buffer.
+ *
+ * @param buffer Buffer, at least srcOffset + len long
+ * @param srcOffset Offset of the data to encode, at least
+ *        MSGFRAME_COBS_OVERHEAD(len)
+ * @param len Number of bytes to encode
+ * @return Length of encoded data (no delimiter)
+ */
+uint16_t MsgFrameEncode_Cobs(uint8_t* buffer, uint16_t srcOffset, uint16_t len);
 
 #endif // COMM_UART_MSGFRAMEENCODE_H_
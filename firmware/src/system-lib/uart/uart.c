@@ -19,27 +19,60 @@ REGISTERED_MODULE_STATIC_DEF(UART);
 // ------------------- Private data -------------------
 static Logging_T* mLog;
 
+// transmit descriptor
+struct uartTxDesc {
+  const uint8_t* data;
+  uint16_t len;
+  bool pooled; // data is in txPool
+  uint32_t poolEnd; // txPoolHead after data was allocated (if pooled)
+  UART_TxCallback_T callback;
+  void* context;
+};
+
+// receive stream
+struct uartRecvStream {
+  StreamBufferHandle_t sb;
+  volatile uint32_t overflow; // bytes that didn't fit in sb
+};
+
 // uart operating info
 struct uartInfo {
   volatile bool isEnabled;
   UART_HandleTypeDef* handle;
 
-  // output stream buffer
-  bool outputSbEnabled;
-  StreamBufferHandle_t outputSb;
+  // output stream buffers, all receive a copy of the data
+  volatile uint8_t numRecvStreams;
+  struct uartRecvStream recvStreams[UART_MAX_RECV_STREAMS];
 
   // DMA buffers
-  uint8_t uartDmaRx[UART_MAX_DMA_LEN];
-  uint8_t uartDmaTx[UART_MAX_DMA_LEN];
+  uint8_t uartDmaRx[UART_MAX_DMA_LEN]; // Circular, written continuously by DMA
+  uint16_t rxReadPos; // Position in uartDmaRx up to which data has been forwarded
 
   // Interrupts
   IRQn_Type txIrq;
+  IRQn_Type uartIrq;
 
   // tx info
+  // Pending transmissions are a ring of descriptors. Tasks add to the head,
+  // the transmit complete interrupt removes from the tail and starts the next.
+  // Indexes are free running (wrap at UINT32_MAX).
   volatile bool txInProgress;
-  uint8_t txPendingStorage[UART_MAX_DMA_LEN];
-  StaticStreamBuffer_t txPendingStreamStruct;
-  StreamBufferHandle_t txPendingStreamHandle;
+  struct uartTxDesc txQueue[UART_TX_QUEUE_LEN];
+  volatile uint32_t txHead;
+  volatile uint32_t txTail;
+  uint32_t txInFlight; // Number of descriptors in the current DMA transfer
+
+  // Copies of messages sent by UART_SendMessage. Allocated in order from the
+  // head by tasks, and freed in order from the tail by the interrupt.
+  uint8_t txPool[UART_TX_POOL_LEN];
+  uint32_t txPoolHead;
+  volatile uint32_t txPoolTail;
+
+  // Link statistics. txFullBytes and txBacklogPeak are written by the sending
+  // task, everything else by the interrupts.
+  volatile UART_Stats_T stats;
+  uint32_t txQueuedBytes; // Total bytes ever queued, for the backlog
+  uint32_t txChain; // Transfers run back to back so far
 };
 
 static struct uartInfo interfaces[UART_NUM_INTERFACES];
@@ -64,10 +97,45 @@ static UART_Device_T uartHandleToDevice(const UART_HandleTypeDef* huart)
   }
 }
 
+/**
+ * @brief Forward received bytes uartDmaRx[start..end) to each output stream
+ */
+static void uartForwardRx(
+    struct uartInfo* uartInfo,
+    uint16_t start,
+    uint16_t end,
+    BaseType_t* higherPriorityTaskWoken)
+{
+  if (end <= start) {
+    return;
+  }
+
+  const size_t len = (size_t)(end - start);
+  uartInfo->stats.rxBytes += (uint32_t)len;
+  const uint8_t numStreams = uartInfo->numRecvStreams;
+  for (uint8_t i = 0U; i < numStreams; ++i) {
+    struct uartRecvStream* stream = &uartInfo->recvStreams[i];
+    BaseType_t woken = pdFALSE;
+    size_t sent = xStreamBufferSendFromISR(stream->sb, &uartInfo->uartDmaRx[start], len, &woken);
+    if (sent < len) {
+      stream->overflow += (uint32_t)(len - sent);
+      uartInfo->stats.rxOverflowBytes += (uint32_t)(len - sent);
+    }
+    if (woken) {
+      *higherPriorityTaskWoken = pdTRUE;
+    }
+  }
+}
+
 /**
  * @brief UART DMA Rx interrupt
+ * Called on DMA half transfer, transfer complete and idle line. The DMA runs
+ * in circular mode and is never stopped, so size is the current DMA write
+ * position in the receive buffer. Forward everything between the last position
+ * and this one.
  *
  * @brief huart UART handle provided by interrupt
+ * @brief size DMA write position in receive buffer
  */
 void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t size)
 {
@@ -77,24 +145,200 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t size)
   }
   struct uartInfo* uartInfo = &interfaces[uartDev];
 
-  if (!uartInfo->isEnabled) {
+  if (!uartInfo->isEnabled || size > UART_MAX_DMA_LEN) {
     return;
   }
 
   BaseType_t higherPriorityTaskWoken = pdFALSE;
-  if (uartInfo->outputSbEnabled) {
-    xStreamBufferSendFromISR(uartInfo->outputSb, uartInfo->uartDmaRx, size,
-                             &higherPriorityTaskWoken);
+  const uint16_t readPos = uartInfo->rxReadPos;
+  const uint16_t writePos = size;
+
+  if (writePos >= readPos) {
+    uartForwardRx(uartInfo, readPos, writePos, &higherPriorityTaskWoken);
+  } else {
+    // DMA has wrapped around the end of the buffer
+    uartForwardRx(uartInfo, readPos, UART_MAX_DMA_LEN, &higherPriorityTaskWoken);
+    uartForwardRx(uartInfo, 0U, writePos, &higherPriorityTaskWoken);
   }
 
-  // start the next DMA transfer
-  HAL_UARTEx_ReceiveToIdle_DMA(huart, uartInfo->uartDmaRx, UART_MAX_DMA_LEN);
+  uartInfo->rxReadPos = (UART_MAX_DMA_LEN == writePos) ? 0U : writePos;
 
   portYIELD_FROM_ISR(higherPriorityTaskWoken);
 }
 
+/**
+ * @brief Releases the descriptors of the current DMA transfer
+ *
+ * @param uartInfo UART device info
+ * @param sent Whether the data was transmitted
+ */
+static void uartTxComplete(struct uartInfo* uartInfo, bool sent)
+{
+  for (uint32_t i = 0; i < uartInfo->txInFlight; ++i) {
+    const struct uartTxDesc* desc =
+        &uartInfo->txQueue[uartInfo->txTail & (UART_TX_QUEUE_LEN - 1U)];
+    if (desc->pooled) {
+      uartInfo->txPoolTail = desc->poolEnd;
+    }
+    if (sent) {
+      uartInfo->stats.txBytes += desc->len;
+    } else {
+      uartInfo->stats.txDroppedBytes += desc->len;
+    }
+    if (NULL != desc->callback) {
+      desc->callback(desc->context, desc->data, desc->len, sent);
+    }
+    uartInfo->txTail++;
+  }
+  uartInfo->txInFlight = 0U;
+}
+
+/**
+ * @brief Starts a DMA transfer of the next pending descriptor(s).
+ * Consecutive copied messages that are contiguous in the pool are sent in one
+ * transfer. Descriptors that fail to start are dropped.
+ *
+ * @param uartInfo UART device info
+ * @return true if a transfer was started
+ */
+static bool uartTxStart(struct uartInfo* uartInfo)
+{
+  while (uartInfo->txTail != uartInfo->txHead) {
+    const uint32_t tail = uartInfo->txTail;
+    const struct uartTxDesc* first = &uartInfo->txQueue[tail & (UART_TX_QUEUE_LEN - 1U)];
+    uint32_t total = first->len;
+    uint32_t n = 1U;
+
+    while (first->pooled && tail + n != uartInfo->txHead) {
+      const struct uartTxDesc* next = &uartInfo->txQueue[(tail + n) & (UART_TX_QUEUE_LEN - 1U)];
+      if (!next->pooled || next->data != first->data + total || total + next->len > UINT16_MAX) {
+        break;
+      }
+      total += next->len;
+      n++;
+    }
+
+    uartInfo->txInFlight = n;
+    HAL_StatusTypeDef txStatus = HAL_UART_Transmit_DMA(
+        uartInfo->handle, (uint8_t*)first->data, (uint16_t)total);
+    if (HAL_OK == txStatus) {
+      uartInfo->txInProgress = true;
+      return true;
+    }
+
+    // drop the failed bytes
+    uartTxComplete(uartInfo, false);
+  }
+
+  uartInfo->txInProgress = false;
+  return false;
+}
+
+/**
+ * @brief Records the length of the current chain of back to back transfers
+ *
+ * @param uartInfo UART device info
+ * @param started Whether another transfer was started
+ */
+static void uartTxChain(struct uartInfo* uartInfo, bool started)
+{
+  if (!started) {
+    uartInfo->txChain = 0U;
+    return;
+  }
+
+  uartInfo->txChain++;
+  if (uartInfo->txChain > uartInfo->stats.txChainPeak) {
+    uartInfo->stats.txChainPeak = uartInfo->txChain;
+  }
+}
+
+/**
+ * @brief Adds a descriptor to the transmit queue, and starts transmitting if
+ * the hardware is idle. Caller must check there is space in the queue.
+ */
+static UART_Status_T uartTxEnqueue(struct uartInfo* uartInfo, const struct uartTxDesc* desc)
+{
+  uartInfo->txQueue[uartInfo->txHead & (UART_TX_QUEUE_LEN - 1U)] = *desc;
+  __DMB(); // descriptor must be written before it is visible to the interrupt
+  uartInfo->txHead++;
+
+  uartInfo->txQueuedBytes += desc->len;
+  const uint32_t backlog = uartInfo->txQueuedBytes -
+      (uartInfo->stats.txBytes + uartInfo->stats.txDroppedBytes);
+  if (backlog > uartInfo->stats.txBacklogPeak) {
+    uartInfo->stats.txBacklogPeak = backlog;
+  }
+
+  UART_Status_T ret = UART_STATUS_OK;
+
+  // disable HAL_UART_TxCpltCallback to make this section atomic. The HAL runs
+  // it from the U(S)ART interrupt once the DMA stream interrupt has handed over
+  // the last byte, so both have to be masked
+  HAL_NVIC_DisableIRQ(uartInfo->txIrq);
+  HAL_NVIC_DisableIRQ(uartInfo->uartIrq);
+
+  // If a transfer is in progress, the interrupt will start this one when done
+  if (!uartInfo->txInProgress) {
+    const bool started = uartTxStart(uartInfo);
+    uartTxChain(uartInfo, started);
+    if (!started) {
+      ret = UART_STATUS_ERROR_TX;
+    }
+  }
+
+  // atomic section complete
+  HAL_NVIC_EnableIRQ(uartInfo->uartIrq);
+  HAL_NVIC_EnableIRQ(uartInfo->txIrq);
+
+  return ret;
+}
+
+/**
+ * @brief Number of bytes to skip at the end of the transmit pool so that an
+ * allocation of len bytes is contiguous.
+ */
+static uint32_t uartTxPoolSkip(const struct uartInfo* uartInfo, uint16_t len)
+{
+  const uint32_t offset = uartInfo->txPoolHead & (UART_TX_POOL_LEN - 1U);
+  return (offset + len > UART_TX_POOL_LEN) ? UART_TX_POOL_LEN - offset : 0U;
+}
+
+/**
+ * @brief Returns true if len bytes can be allocated from the transmit pool
+ */
+static bool uartTxPoolSpace(const struct uartInfo* uartInfo, uint16_t len)
+{
+  const uint32_t used = uartInfo->txPoolHead - uartInfo->txPoolTail;
+  return used + uartTxPoolSkip(uartInfo, len) + len <= UART_TX_POOL_LEN;
+}
+
+/**
+ * @brief Allocates contiguous space in the transmit pool. Caller must check
+ * there is space.
+ *
+ * @param uartInfo UART device info
+ * @param len Number of bytes
+ * @return Pointer to allocated space.
+ */
+static uint8_t* uartTxPoolAlloc(struct uartInfo* uartInfo, uint16_t len)
+{
+  const uint32_t start = uartInfo->txPoolHead + uartTxPoolSkip(uartInfo, len);
+  uartInfo->txPoolHead = start + len;
+  return &uartInfo->txPool[start & (UART_TX_POOL_LEN - 1U)];
+}
+
+/**
+ * @brief Returns true if there is space for another transmit descriptor
+ */
+static bool uartTxQueueSpace(const struct uartInfo* uartInfo)
+{
+  return (uartInfo->txHead - uartInfo->txTail) < UART_TX_QUEUE_LEN;
+}
+
 /**
  * @brief UART DMA Tx complete interrupt
+ * Releases the data just sent, and chains the next pending transfer.
  * 
  * @param huart UART handle provided by interrupt
  */
@@ -110,25 +354,8 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
     return;
   }
 
-  BaseType_t higherPriorityTaskWoken = pdFALSE;
-
-  // check whether there is more data to transmit
-  if (pdTRUE == xStreamBufferIsEmpty(uartInfo->txPendingStreamHandle)) {
-    uartInfo->txInProgress = false;
-  } else {
-    uint16_t numSending = (uint16_t)xStreamBufferReceiveFromISR(
-        uartInfo->txPendingStreamHandle, uartInfo->uartDmaTx, UART_MAX_DMA_LEN,
-        &higherPriorityTaskWoken);
-
-    HAL_StatusTypeDef txStatus = HAL_UART_Transmit_DMA(
-        huart, uartInfo->uartDmaTx, numSending);
-    if (HAL_OK != txStatus) {
-      // drop the failed bytes
-      uartInfo->txInProgress = false;
-    }
-  }
-
-  portYIELD_FROM_ISR(higherPriorityTaskWoken);
+  uartTxComplete(uartInfo, true);
+  uartTxChain(uartInfo, uartTxStart(uartInfo));
 }
 
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
@@ -143,9 +370,36 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
     return;
   }
 
-  uartInfo->txInProgress = false;
+  const uint32_t errorCode = huart->ErrorCode;
+  if (errorCode & HAL_UART_ERROR_ORE) {
+    uartInfo->stats.overrunErrors++;
+  }
+  if (errorCode & HAL_UART_ERROR_FE) {
+    uartInfo->stats.framingErrors++;
+  }
+  if (errorCode & HAL_UART_ERROR_NE) {
+    uartInfo->stats.noiseErrors++;
+  }
+  if (errorCode & HAL_UART_ERROR_PE) {
+    uartInfo->stats.parityErrors++;
+  }
+  if (errorCode & HAL_UART_ERROR_DMA) {
+    uartInfo->stats.dmaErrors++;
+  }
 
-  HAL_UARTEx_ReceiveToIdle_DMA(huart, uartInfo->uartDmaRx, UART_MAX_DMA_LEN);
+  // Transmit DMA errors end the transfer. Drop the data and continue with
+  // the next.
+  if (uartInfo->txInProgress && HAL_UART_STATE_BUSY_TX != huart->gState) {
+    uartTxComplete(uartInfo, false);
+    uartTxChain(uartInfo, uartTxStart(uartInfo));
+  }
+
+  // Receive errors that the HAL can't recover from (e.g. overrun) abort the
+  // circular DMA. Restart it from the beginning of the buffer.
+  if (HAL_UART_STATE_BUSY_RX != huart->RxState) {
+    uartInfo->rxReadPos = 0U;
+    HAL_UARTEx_ReceiveToIdle_DMA(huart, uartInfo->uartDmaRx, UART_MAX_DMA_LEN);
+  }
 }
 
 
@@ -153,21 +407,21 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 UART_Status_T UART_Init(Logging_T* logger)
 {
   mLog = logger;
-  Log_Print(mLog, "UART_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_UART, LOGGING_LEVEL_DEBUG, "UART_Init begin\n");
   DEPEND_ON(logger, UART_STATUS_ERROR_DEPENDS);
 
   memset(interfaces, 0, sizeof(interfaces));
   // Individual device initialization is done in UART_Config
 
   REGISTER_STATIC(UART, UART_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "UART_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_UART, LOGGING_LEVEL_DEBUG, "UART_Init complete\n");
   return UART_STATUS_OK;
 }
 
 //------------------------------------------------------------------------------
 UART_Status_T UART_Config(UART_DeviceConfig_T* devConfig)
 {
-  Log_Print(mLog, "UART_Config begin\n");
+  Log_Print(mLog, LOGGING_MODULE_UART, LOGGING_LEVEL_DEBUG, "UART_Config begin\n");
   DEPEND_ON_STATIC(UART, UART_STATUS_ERROR_DEPENDS);
 
   UART_Device_T uartDev = uartHandleToDevice(devConfig->handle);
@@ -189,22 +443,18 @@ UART_Status_T UART_Config(UART_DeviceConfig_T* devConfig)
   memset(uartInfo, 0, sizeof(struct uartInfo));
   uartInfo->handle = devConfig->handle;
   uartInfo->txIrq = devConfig->txIrq;
-  uartInfo->txPendingStreamHandle = xStreamBufferCreateStatic(
-      UART_MAX_DMA_LEN,
-      1U,
-      uartInfo->txPendingStorage,
-      &uartInfo->txPendingStreamStruct);
+  uartInfo->uartIrq = devConfig->uartIrq;
   uartInfo->isEnabled = true;
 
-  // Start receiving
+  // Start receiving. Runs continuously (circular DMA).
   HAL_UARTEx_ReceiveToIdle_DMA(uartInfo->handle, uartInfo->uartDmaRx, UART_MAX_DMA_LEN);
 
-  Log_Print(mLog, "UART_Config complete\n");
+  Log_Print(mLog, LOGGING_MODULE_UART, LOGGING_LEVEL_DEBUG, "UART_Config complete\n");
   return UART_STATUS_OK;
 }
 
 //------------------------------------------------------------------------------
-UART_Status_T UART_SetRecvStream(
+UART_Status_T UART_RegisterRecvStream(
     const UART_Device_T dev,
     const StreamBufferHandle_t sb)
 {
@@ -217,12 +467,41 @@ UART_Status_T UART_SetRecvStream(
     return UART_STATUS_NOT_READY;
   }
 
-  uartInfo->outputSb = sb;
-  uartInfo->outputSbEnabled = true;
+  uint8_t numStreams = uartInfo->numRecvStreams;
+  if (numStreams == UART_MAX_RECV_STREAMS) {
+    return UART_STATUS_ERROR_MAX_STREAMS;
+  }
+
+  // Fill in the entry before the interrupt can see it
+  uartInfo->recvStreams[numStreams].sb = sb;
+  uartInfo->recvStreams[numStreams].overflow = 0U;
+  __DMB();
+  uartInfo->numRecvStreams = (uint8_t)(numStreams + 1U);
 
   return UART_STATUS_OK;
 }
 
+//------------------------------------------------------------------------------
+UART_Status_T UART_GetRecvStreamOverflow(
+    const UART_Device_T dev,
+    const StreamBufferHandle_t sb,
+    uint32_t* overflow)
+{
+  if (dev >= UART_NUM_INTERFACES) {
+    return UART_STATUS_ERROR_INVALID_DEV;
+  }
+  struct uartInfo* uartInfo = &interfaces[dev];
+
+  for (uint8_t i = 0U; i < uartInfo->numRecvStreams; ++i) {
+    if (uartInfo->recvStreams[i].sb == sb) {
+      *overflow = uartInfo->recvStreams[i].overflow;
+      return UART_STATUS_OK;
+    }
+  }
+
+  return UART_STATUS_ERROR_NOT_FOUND;
+}
+
 //------------------------------------------------------------------------------
 UART_Status_T UART_SendMessage(const UART_Device_T dev, uint8_t* data, uint16_t len)
 {
@@ -235,28 +514,177 @@ UART_Status_T UART_SendMessage(const UART_Device_T dev, uint8_t* data, uint16_t
     return UART_STATUS_NOT_READY;
   }
 
+  if (len > UART_TX_POOL_LEN) {
+    return UART_STATUS_ERROR_LEN;
+  }
+
+  if (!uartTxQueueSpace(uartInfo) || !uartTxPoolSpace(uartInfo, len)) {
+    uartInfo->stats.txFullBytes += len;
+    return UART_STATUS_ERROR_TX_FULL;
+  }
+
+  struct uartTxDesc desc = {
+    .data = NULL,
+    .len = len,
+    .pooled = true,
+    .poolEnd = 0U,
+    .callback = NULL,
+    .context = NULL,
+  };
+  uint8_t* buf = uartTxPoolAlloc(uartInfo, len);
+  memcpy(buf, data, len);
+  desc.data = buf;
+  desc.poolEnd = uartInfo->txPoolHead;
+
+  return uartTxEnqueue(uartInfo, &desc);
+}
+
+//------------------------------------------------------------------------------
+UART_Status_T UART_Transmit(
+    const UART_Device_T dev,
+    const uint8_t* data,
+    uint16_t len,
+    UART_TxCallback_T callback,
+    void* context)
+{
+  if (dev >= UART_NUM_INTERFACES) {
+    return UART_STATUS_ERROR_INVALID_DEV;
+  }
+  struct uartInfo* uartInfo = &interfaces[dev];
+
+  if (!uartInfo->isEnabled) {
+    return UART_STATUS_NOT_READY;
+  }
+
+  if (!uartTxQueueSpace(uartInfo)) {
+    uartInfo->stats.txFullBytes += len;
+    return UART_STATUS_ERROR_TX_FULL;
+  }
+
+  const struct uartTxDesc desc = {
+    .data = data,
+    .len = len,
+    .pooled = false,
+    .poolEnd = 0U,
+    .callback = callback,
+    .context = context,
+  };
+  return uartTxEnqueue(uartInfo, &desc);
+}
+
+//------------------------------------------------------------------------------
+bool UART_TxSpaceAvailable(const UART_Device_T dev, uint16_t len)
+{
+  if (dev >= UART_NUM_INTERFACES) {
+    return false;
+  }
+  const struct uartInfo* uartInfo = &interfaces[dev];
+
+  return uartInfo->isEnabled &&
+         uartTxQueueSpace(uartInfo) &&
+         uartTxPoolSpace(uartInfo, len);
+}
+
+//------------------------------------------------------------------------------
+UART_Status_T UART_GetStats(const UART_Device_T dev, UART_Stats_T* stats)
+{
+  if (dev >= UART_NUM_INTERFACES) {
+    return UART_STATUS_ERROR_INVALID_DEV;
+  }
+  const struct uartInfo* uartInfo = &interfaces[dev];
+
+  if (!uartInfo->isEnabled) {
+    return UART_STATUS_NOT_READY;
+  }
+
+  *stats = uartInfo->stats;
+  return UART_STATUS_OK;
+}
+
+//------------------------------------------------------------------------------
+UART_Status_T UART_SetBaudRate(const UART_Device_T dev, uint32_t baudRate)
+{
+  if (dev >= UART_NUM_INTERFACES) {
+    return UART_STATUS_ERROR_INVALID_DEV;
+  }
+  struct uartInfo* uartInfo = &interfaces[dev];
+
+  if (!uartInfo->isEnabled) {
+    return UART_STATUS_NOT_READY;
+  }
+
+  // The transmit queue is only added to by the caller's task, so once empty
+  // it stays empty
+  if (uartInfo->txInProgress || uartInfo->txHead != uartInfo->txTail) {
+    return UART_STATUS_ERROR_BUSY;
+  }
+
+  UART_HandleTypeDef* handle = uartInfo->handle;
+  const uint32_t prevBaudRate = handle->Init.BaudRate;
   UART_Status_T ret = UART_STATUS_OK;
 
-  // disable HAL_UART_TxCpltCallback to make this section atomic
+  // Stop reception and reconfigure the peripheral. HAL_UART_Init only
+  // re-runs the MSP (pins, DMA) init from reset, so the DMA links remain.
+  HAL_UART_AbortReceive(handle);
+  handle->Init.BaudRate = baudRate;
+  if (HAL_OK != HAL_UART_Init(handle)) {
+    handle->Init.BaudRate = prevBaudRate;
+    HAL_UART_Init(handle);
+    ret = UART_STATUS_ERROR_CONFIG;
+  }
+
+  // Restart reception from the beginning of the buffer
+  uartInfo->rxReadPos = 0U;
+  HAL_UARTEx_ReceiveToIdle_DMA(handle, uartInfo->uartDmaRx, UART_MAX_DMA_LEN);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+UART_Status_T UART_FlushTx(const UART_Device_T dev)
+{
+  if (dev >= UART_NUM_INTERFACES) {
+    return UART_STATUS_ERROR_INVALID_DEV;
+  }
+  struct uartInfo* uartInfo = &interfaces[dev];
+
+  if (!uartInfo->isEnabled) {
+    return UART_STATUS_NOT_READY;
+  }
+
+  // Same atomic section as uartTxEnqueue, the interrupts can't chain another
+  // transfer while the queue is dropped
   HAL_NVIC_DisableIRQ(uartInfo->txIrq);
+  HAL_NVIC_DisableIRQ(uartInfo->uartIrq);
 
   if (uartInfo->txInProgress) {
-    // queue for when hardware is done
-    xStreamBufferSend(uartInfo->txPendingStreamHandle, (void*)data, len, pdMS_TO_TICKS(100U));
-  } else {
-    // directly initiate transfer
-    uartInfo->txInProgress = true;
-    memcpy(uartInfo->uartDmaTx, data, len);
-
-    HAL_StatusTypeDef txStatus = HAL_UART_Transmit_DMA(uartInfo->handle, uartInfo->uartDmaTx, len);
-    if (HAL_OK != txStatus) {
-      uartInfo->txInProgress = false;
-      ret = UART_STATUS_ERROR_TX;
-    }
+    HAL_UART_AbortTransmit(uartInfo->handle);
   }
 
-  // atomic section complete
+  // Drop the transfer in progress (if any) and everything queued after it
+  uartInfo->txInFlight = uartInfo->txHead - uartInfo->txTail;
+  uartTxComplete(uartInfo, false);
+  uartInfo->txInProgress = false;
+  uartTxChain(uartInfo, false);
+
+  HAL_NVIC_EnableIRQ(uartInfo->uartIrq);
   HAL_NVIC_EnableIRQ(uartInfo->txIrq);
 
-  return ret;
+  return UART_STATUS_OK;
+}
+
+//------------------------------------------------------------------------------
+UART_Status_T UART_GetBaudRate(const UART_Device_T dev, uint32_t* baudRate)
+{
+  if (dev >= UART_NUM_INTERFACES) {
+    return UART_STATUS_ERROR_INVALID_DEV;
+  }
+  const struct uartInfo* uartInfo = &interfaces[dev];
+
+  if (!uartInfo->isEnabled) {
+    return UART_STATUS_NOT_READY;
+  }
+
+  *baudRate = uartInfo->handle->Init.BaudRate;
+  return UART_STATUS_OK;
 }
@@ -12,6 +12,7 @@
 #include "FreeRTOS.h"
 #include "stream_buffer.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "depends/depends.h"
 #include "logging/logging.h"
@@ -32,6 +33,9 @@ typedef enum
 
 #define UART_NUM_CALLBACKS 16     /* Max number of UART callbacks on any device */
 #define UART_MAX_DMA_LEN 512   /* Max number of bytes in one message */
+#define UART_MAX_RECV_STREAMS 4U /* Max number of receive streams on any device */
+#define UART_TX_QUEUE_LEN 32U  /* Max number of pending transmissions per device (power of 2) */
+#define UART_TX_POOL_LEN 1024U /* Bytes for copies of pending messages per device (power of 2) */
 
 typedef enum
 {
@@ -41,12 +45,51 @@ typedef enum
   UART_STATUS_ERROR_SB_FULL       = 0x03U,
   UART_STATUS_ERROR_DEPENDS       = 0x04U,
   UART_STATUS_ERROR_INVALID_DEV   = 0x05U,
+  UART_STATUS_ERROR_TX_FULL       = 0x06U,
+  UART_STATUS_ERROR_MAX_STREAMS   = 0x07U,
+  UART_STATUS_ERROR_NOT_FOUND     = 0x08U,
+  UART_STATUS_ERROR_BUSY          = 0x09U,
+  UART_STATUS_ERROR_CONFIG        = 0x0AU,
+  UART_STATUS_ERROR_LEN           = 0x0BU,
 } UART_Status_T;
 
+/**
+ * @brief Called when a transmission started with UART_Transmit is complete,
+ * and the data buffer is no longer used by the driver.
+ * Called from the UART interrupt.
+ *
+ * @param context Context pointer given to UART_Transmit
+ * @param data Data buffer given to UART_Transmit
+ * @param len Length given to UART_Transmit
+ * @param sent True if data was transmitted, false if it was dropped due to a
+ * hardware error.
+ */
+typedef void (*UART_TxCallback_T)(void* context, const uint8_t* data, uint16_t len, bool sent);
+
+/**
+ * @brief Link statistics for one device. Counters start at 0 when the device
+ * is configured and wrap at UINT32_MAX.
+ */
+typedef struct {
+  uint32_t rxBytes;         // Bytes received
+  uint32_t txBytes;         // Bytes transmitted
+  uint32_t overrunErrors;   // Receive overrun (ORE) errors
+  uint32_t framingErrors;   // Framing (FE) errors
+  uint32_t noiseErrors;     // Noise (NE) errors
+  uint32_t parityErrors;    // Parity (PE) errors
+  uint32_t dmaErrors;       // DMA transfer errors
+  uint32_t rxOverflowBytes; // Received bytes that didn't fit in a receive stream (all streams)
+  uint32_t txDroppedBytes;  // Bytes dropped due to a failed transfer, or by UART_FlushTx
+  uint32_t txFullBytes;     // Bytes rejected with UART_STATUS_ERROR_TX_FULL
+  uint32_t txBacklogPeak;   // Max bytes queued or in flight at once
+  uint32_t txChainPeak;     // Max DMA transfers run back to back without the transmitter going idle
+} UART_Stats_T;
+
 typedef struct {
   UART_Device_T dev;
-  UART_HandleTypeDef* handle;
-  IRQn_Type txIrq;
+  UART_HandleTypeDef* handle; // Rx DMA must be configured in circular mode
+  IRQn_Type txIrq;   // Tx DMA stream interrupt
+  IRQn_Type uartIrq; // U(S)ART global interrupt, completes transfers
 } UART_DeviceConfig_T;
 
 /**
@@ -64,25 +107,132 @@ UART_Status_T UART_Init(Logging_T* logger);
 UART_Status_T UART_Config(UART_DeviceConfig_T* devConfig);
 
 /**
- * @biref Sets the output stream buffer for a particular UART device
+ * @brief Adds a stream buffer to send received data to.
+ * Every registered stream gets its own copy of all data received on the
+ * device. If a stream is full, the bytes that don't fit are dropped for that
+ * stream only and counted (see UART_GetRecvStreamOverflow).
+ * Register streams before data is needed, streams can't be removed.
  *
- * @param handle UART device handle
+ * @param dev UART device
  * @param sb Stream buffer to send data to. (Note: This type is a pointer)
- * @return Return status. UART_STATUS_OK for success. See UART_Status_T for more.
+ * @return Return status. UART_STATUS_OK for success.
+ * UART_STATUS_ERROR_MAX_STREAMS if UART_MAX_RECV_STREAMS are already
+ * registered. See UART_Status_T for more.
  */
-UART_Status_T UART_SetRecvStream(
+UART_Status_T UART_RegisterRecvStream(
     const UART_Device_T dev,
     const StreamBufferHandle_t sb);
 
+/**
+ * @brief Gets the number of received bytes dropped because a stream was full
+ *
+ * @param dev UART device
+ * @param sb Stream buffer given to UART_RegisterRecvStream
+ * @param overflow Output, number of bytes dropped since registration
+ * @return Return status. UART_STATUS_OK for success.
+ * UART_STATUS_ERROR_NOT_FOUND if sb isn't registered on dev.
+ */
+UART_Status_T UART_GetRecvStreamOverflow(
+    const UART_Device_T dev,
+    const StreamBufferHandle_t sb,
+    uint32_t* overflow);
+
 /**
  * @brief Send a serial message
+ * The data is copied, so the buffer can be reused as soon as this returns.
+ * Does not block: the message is queued if a transmission is in progress.
+ * Not safe to call from multiple tasks for the same device.
  *
  * @param handle UARTdevice handle
  * @param data Array of data to send
  * @param n Length of data array
- * @return Return status. UART_STATUS_OK for success. See UART_Status_T for more.
+ * @return Return status. UART_STATUS_OK for success.
+ * UART_STATUS_ERROR_TX_FULL if there isn't space to queue the message.
+ * UART_STATUS_ERROR_LEN if the message is longer than UART_TX_POOL_LEN and can
+ * never be queued.
+ * See UART_Status_T for more.
  */
 UART_Status_T UART_SendMessage(const UART_Device_T dev, uint8_t* data, uint16_t len);
 
+/**
+ * @brief Send a serial message without copying it.
+ * Does not block: the message is queued if a transmission is in progress.
+ * Queued messages are transmitted back to back from the transmit complete
+ * interrupt. Not safe to call from multiple tasks for the same device.
+ *
+ * @param dev UART device
+ * @param data Data to send. Must remain valid until callback is called.
+ * @param len Length of data
+ * @param callback Called when data is no longer used. May be NULL.
+ * @param context Passed to callback
+ * @return Return status. UART_STATUS_OK for success.
+ * UART_STATUS_ERROR_TX_FULL if the transmit queue is full (callback is not
+ * called). UART_STATUS_ERROR_TX if transmission couldn't be started (callback
+ * has been called with sent = false). See UART_Status_T for more.
+ */
+UART_Status_T UART_Transmit(
+    const UART_Device_T dev,
+    const uint8_t* data,
+    uint16_t len,
+    UART_TxCallback_T callback,
+    void* context);
+
+/**
+ * @brief Checks whether a message of a given length can be queued by
+ * UART_SendMessage without blocking or being rejected.
+ *
+ * @param dev UART device
+ * @param len Length of message
+ * @return true if there is space for the message.
+ */
+bool UART_TxSpaceAvailable(const UART_Device_T dev, uint16_t len);
+
+/**
+ * @brief Gets a copy of the link statistics of a device.
+ * Counters are updated from interrupts, so the copy isn't an atomic snapshot
+ * (but each counter is consistent).
+ *
+ * @param dev UART device
+ * @param stats Output statistics
+ * @return Return status. UART_STATUS_OK for success. See UART_Status_T for more.
+ */
+UART_Status_T UART_GetStats(const UART_Device_T dev, UART_Stats_T* stats);
+
+/**
+ * @brief Changes the baud rate of a device.
+ * Only possible while nothing is being transmitted, so it doesn't block.
+ * Reception is restarted, bytes in flight on the line may be lost.
+ * Not safe to call from multiple tasks for the same device, or at the same
+ * time as sending on the device from another task.
+ *
+ * @param dev UART device
+ * @param baudRate New baud rate
+ * @return Return status. UART_STATUS_OK for success.
+ * UART_STATUS_ERROR_BUSY if a transmission is queued or in progress (try again
+ * later). UART_STATUS_ERROR_CONFIG if the hardware can't run at baudRate (the
+ * previous baud rate is restored). See UART_Status_T for more.
+ */
+UART_Status_T UART_SetBaudRate(const UART_Device_T dev, uint32_t baudRate);
+
+/**
+ * @brief Drops everything queued to send on a device, aborting the transfer
+ * in progress. Callbacks of dropped zero copy messages are called with sent
+ * false, and the bytes are counted in txDroppedBytes.
+ * Not safe to call from multiple tasks for the same device, or at the same
+ * time as sending on the device from another task.
+ *
+ * @param dev UART device
+ * @return Return status. UART_STATUS_OK for success. See UART_Status_T for more.
+ */
+UART_Status_T UART_FlushTx(const UART_Device_T dev);
+
+/**
+ * @brief Gets the current baud rate of a device
+ *
+ * @param dev UART device
+ * @param baudRate Output baud rate
+ * @return Return status. UART_STATUS_OK for success. See UART_Status_T for more.
+ */
+UART_Status_T UART_GetBaudRate(const UART_Device_T dev, uint32_t* baudRate);
 
 #endif /* COMM_UART_UART_H_ */
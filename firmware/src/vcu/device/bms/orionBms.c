@@ -145,7 +145,7 @@ static void HandleMsg_Status(const CAN_DataFrame_T* data, VehicleState_T* state)
 static void BMSProcessing(BMS_T* bms)
 {
   // Wait for 10ms notification to wake up
-  uint32_t notifiedValue = ulTaskNotifyTake(pdTRUE, mBlockTime);
+  uint32_t notifiedValue = TaskTimer_Wait(&bms->taskHandle, mBlockTime);
   if (notifiedValue > 0) {
     CAN_DataFrame_T queuedData;
     while (pdTRUE == xQueueReceive(bms->canDataQueueHandle, &queuedData, 0U)) {
@@ -191,7 +191,7 @@ static void BMSProcessing_Task(void* pvParameters)
 BMS_Status_T BMS_Init(Logging_T* logger, BMS_T* bms)
 {
   mLog = logger;
-  Log_Print(mLog, "BMS_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_BMS, LOGGING_LEVEL_DEBUG, "BMS_Init begin\n");
   DEPEND_ON(logger, BMS_STATUS_ERROR_DEPENDS);
   DEPEND_ON_STATIC(CAN, BMS_STATUS_ERROR_DEPENDS);
 
@@ -229,6 +229,6 @@ BMS_Status_T BMS_Init(Logging_T* logger, BMS_T* bms)
   }
 
   REGISTER(bms, BMS_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "BMS_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_BMS, LOGGING_LEVEL_DEBUG, "BMS_Init complete\n");
   return BMS_STATUS_OK;
 }
@@ -11,12 +11,12 @@ DashboardOut_Status_T DashboardOut_Init(DashboardOut_T* dash)
 {
   DEPEND_ON(dash->log, DASHBOARDOUT_DEPENDS);
   DEPEND_ON(dash->vehicleState, DASHBOARDOUT_DEPENDS);
-  Log_Print(dash->log, "DashboardOut_Init begin\n");
+  Log_Print(dash->log, LOGGING_MODULE_DASHBOARD, LOGGING_LEVEL_DEBUG, "DashboardOut_Init begin\n");
 
   GPIO_WritePin(dash->output_pin, false);
 
   REGISTER(dash, DASHBOARDOUT_DEPENDS);
-  Log_Print(dash->log, "DashboardOut_Init complete\n");
+  Log_Print(dash->log, LOGGING_MODULE_DASHBOARD, LOGGING_LEVEL_DEBUG, "DashboardOut_Init complete\n");
   return DASHBOARDOUT_OK;
 }
 
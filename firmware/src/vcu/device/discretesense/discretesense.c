@@ -12,59 +12,107 @@
 // ------------------- Private data -------------------
 static Logging_T* mLog;
 static const TickType_t mBlockTime = 100 / portTICK_PERIOD_MS; // 100ms
+static const float mQ16ToFloat = 1.0f / (float)ADC_SCALING_Q16_ONE;
 
 // ------------------- Private methods -------------------
+/**
+ * @brief Rounds filtered Q16.16 counts back to whole ADC counts
+ */
+static uint16_t q16ToCounts(int32_t q16)
+{
+  if (q16 <= 0) {
+    return 0U;
+  }
+  return (uint16_t)(((uint32_t)q16 + 0x8000U) >> 16);
+}
+
 static void DiscreteSense_TaskMethod(DiscreteSense_T* ds)
 {
   // Wait for notification to wake up
-  uint32_t notifiedValue = ulTaskNotifyTake(pdTRUE, mBlockTime);
+  uint32_t notifiedValue = TaskTimer_Wait(&ds->taskHandle, mBlockTime);
   if (notifiedValue > 0) {
-    // Sample each and update the vehicle state
+    // Sample each and update the vehicle state.
+    // All channels are read from the same ADC conversion set.
+    const ADC_Channel_T channels[4] = {
+      ds->adcAccelPedalA,
+      ds->adcAccelPedalB,
+      ds->adcBrakeFront,
+      ds->adcBrakeRear,
+    };
+    uint16_t raw[4];
+    ADC_Status_T retAdc = ADC_GetChannels(ds->adc, channels, raw, 4U, NULL);
+
+    // Filter the raw counts in fixed-point, then scale. The published raw
+    // values are filtered too, so the range faults checked on them don't trip
+    // on noise the filters remove. Only filter valid samples, so a failed read
+    // does not disturb the filter state.
+    float scaled[4] = { 0.0f };
+    if (ADC_STATUS_OK == retAdc) {
+      int32_t q16[4];
+      for (uint16_t i = 0; i < 4U; ++i) {
+        q16[i] = (int32_t)((uint32_t)raw[i] << 16); // 12 bit counts
+      }
+      Filter_Process(&ds->filterBank, q16, q16);
+      for (uint16_t i = 0; i < 4U; ++i) {
+        raw[i] = q16ToCounts(q16[i]);
+      }
 
-    uint16_t rawAccelA;
-    uint16_t rawAccelB;
-    uint16_t rawBrakeFront;
-    uint16_t rawBrakeRear;
+      ADC_ApplyScalingTable(&ds->scalingTable, raw, q16, NULL);
+      for (uint16_t i = 0; i < 4U; ++i) {
+        scaled[i] = (float)q16[i] * mQ16ToFloat;
+      }
+    }
 
-    ADC_Status_T retAccelA = ADC_Get(ds->adcAccelPedalA, &rawAccelA);
-    ADC_Status_T retAccelB = ADC_Get(ds->adcAccelPedalB, &rawAccelB);
-    ADC_Status_T retBrakeFront = ADC_Get(ds->adcBrakeFront, &rawBrakeFront);
-    ADC_Status_T retBrakeRear = ADC_Get(ds->adcBrakeRear, &rawBrakeRear);
+    const uint16_t rawAccelA = raw[0];
+    const uint16_t rawAccelB = raw[1];
+    const uint16_t rawBrakeFront = raw[2];
+    const uint16_t rawBrakeRear = raw[3];
 
-    float accelA = ADC_ApplyScaling(&ds->scalingAccelPedalA, rawAccelA);
-    float accelB = ADC_ApplyScaling(&ds->scalingAccelPedalB, rawAccelB);
-    float brakeFront = ADC_ApplyScaling(&ds->scalingBrakeFront, rawBrakeFront);
-    float brakeRear = ADC_ApplyScaling(&ds->scalingBrakeRear, rawBrakeRear);
+    float accelA = scaled[0];
+    float accelB = scaled[1];
+    float brakeFront = scaled[2];
+    float brakeRear = scaled[3];
 
     float accel = 0.5f * (accelA + accelB);
 
+    // Collect any out of range events latched by the ADC since the last tick,
+    // keeping the time of the earliest
+    bool accelOutOfRange = false;
+    uint32_t accelOutOfRangeTime = 0U;
+    if (ds->accelPedalWatchdog) {
+      uint32_t timeA = 0U;
+      uint32_t timeB = 0U;
+      const bool trippedA = ADC_GetWatchdogEvent(ds->adc, ds->adcAccelPedalA, &timeA);
+      const bool trippedB = ADC_GetWatchdogEvent(ds->adc, ds->adcAccelPedalB, &timeB);
+      accelOutOfRange = trippedA || trippedB;
+      if (trippedA && trippedB) {
+        accelOutOfRangeTime = ((int32_t)(timeB - timeA) < 0) ? timeB : timeA;
+      } else {
+        accelOutOfRangeTime = trippedA ? timeA : timeB;
+      }
+    }
+
     bool dashButtonPressed = GPIO_ReadPin(ds->gpioDashboardButton);
 
     if (VehicleState_AccessAcquire(ds->state)) {
       VehicleState_Data_T* stateData = &ds->state->data;
 
-      if (ADC_STATUS_OK == retAccelA) {
+      if (ADC_STATUS_OK == retAdc) {
         stateData->inputs.accelA = accelA;
         stateData->inputs.accelRawA = rawAccelA;
-      }
-      if (ADC_STATUS_OK == retAccelB) {
         stateData->inputs.accelB = accelB;
         stateData->inputs.accelRawB = rawAccelB;
-      }
-      if (ADC_STATUS_OK == retAccelA && ADC_STATUS_OK == retAccelB) {
         stateData->inputs.accel = accel;
         stateData->inputs.accelValid = true;
-      }
 
-      if (ADC_STATUS_OK == retBrakeFront) {
         stateData->inputs.brakePresFront = brakeFront;
         stateData->inputs.brakeRawFront = rawBrakeFront;
-      }
-      if (ADC_STATUS_OK == retBrakeRear) {
         stateData->inputs.brakePresRear = brakeRear;
         stateData->inputs.brakeRawRear = rawBrakeRear;
       }
 
+      stateData->inputs.accelOutOfRange = accelOutOfRange;
+      stateData->inputs.accelOutOfRangeTime = accelOutOfRangeTime;
       stateData->dash.buttonPressed = dashButtonPressed;
     }
 
@@ -87,16 +135,56 @@ static void DiscreteSense_Task(void* pvParameters)
 DiscreteSense_Status_T DiscreteSense_Init(DiscreteSense_T* module)
 {
   mLog = module->logger;
-  Log_Print(mLog, "DiscreteSense_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_SENSE, LOGGING_LEVEL_DEBUG, "DiscreteSense_Init begin\n");
   DEPEND_ON(module->logger, DISCRETESENSE_STATUS_ERROR_DEPENDS);
   DEPEND_ON(module->state, DISCRETESENSE_STATUS_ERROR_DEPENDS);
-  DEPEND_ON_STATIC(ADC, DISCRETESENSE_STATUS_ERROR_DEPENDS);
+  DEPEND_ON(module->adc, DISCRETESENSE_STATUS_ERROR_DEPENDS);
   DEPEND_ON_STATIC(TASKTIMER, DISCRETESENSE_STATUS_ERROR_DEPENDS);
 
   if (NULL == module->gpioDashboardButton) {
     return DISCRETESENSE_STATUS_ERROR_INIT;
   }
 
+  const ADC_Scaling_T scalings[4] = {
+    module->scalingAccelPedalA,
+    module->scalingAccelPedalB,
+    module->scalingBrakeFront,
+    module->scalingBrakeRear,
+  };
+  if (ADC_STATUS_OK != ADC_CompileScaling(&module->scalingTable, scalings, 4U)) {
+    Log_Print(mLog, LOGGING_MODULE_SENSE, LOGGING_LEVEL_ERROR, "DiscreteSense_Init invalid scaling\n");
+    return DISCRETESENSE_STATUS_ERROR_INIT;
+  }
+
+  module->filterBank.numChannels = 4U;
+  module->filterBank.chains[0] = module->filterAccelPedalA;
+  module->filterBank.chains[1] = module->filterAccelPedalB;
+  module->filterBank.chains[2] = module->filterBrakeFront;
+  module->filterBank.chains[3] = module->filterBrakeRear;
+  if (FILTER_STATUS_OK != Filter_Init(&module->filterBank)) {
+    Log_Print(mLog, LOGGING_MODULE_SENSE, LOGGING_LEVEL_ERROR, "DiscreteSense_Init invalid filter\n");
+    return DISCRETESENSE_STATUS_ERROR_INIT;
+  }
+
+  if (module->accelPedalWatchdog) {
+    ADC_Status_T statusA = ADC_ConfigWatchdog(
+        module->adc,
+        module->adcAccelPedalA,
+        module->adcHwAccelPedalA,
+        module->scalingAccelPedalA.lowerScaling,
+        module->scalingAccelPedalA.upperScaling);
+    ADC_Status_T statusB = ADC_ConfigWatchdog(
+        module->adc,
+        module->adcAccelPedalB,
+        module->adcHwAccelPedalB,
+        module->scalingAccelPedalB.lowerScaling,
+        module->scalingAccelPedalB.upperScaling);
+    if (ADC_STATUS_OK != statusA || ADC_STATUS_OK != statusB) {
+      Log_Print(mLog, LOGGING_MODULE_SENSE, LOGGING_LEVEL_ERROR, "DiscreteSense_Init ADC watchdog config failed\n");
+      return DISCRETESENSE_STATUS_ERROR_INIT;
+    }
+  }
+
   // create main task
   module->taskHandle = xTaskCreateStatic(
       DiscreteSense_Task,
@@ -108,14 +196,15 @@ DiscreteSense_Status_T DiscreteSense_Init(DiscreteSense_T* module)
       &module->taskBuffer);
 
   // Register the task for timer notifications every 10ms (100Hz)
-  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTask(
+  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTaskPhase(
       &module->taskHandle,
-      TASKTIMER_FREQUENCY_100HZ);
+      TASKTIMER_FREQUENCY_100HZ,
+      DISCRETESENSE_TASK_PHASE);
   if (TASKTIMER_STATUS_OK != statusTimer) {
     return DISCRETESENSE_STATUS_ERROR_INIT;
   }
 
   REGISTER(module, DISCRETESENSE_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "DiscreteSense_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_SENSE, LOGGING_LEVEL_DEBUG, "DiscreteSense_Init complete\n");
   return DISCRETESENSE_STATUS_OK;
 }
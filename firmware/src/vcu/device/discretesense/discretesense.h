@@ -21,6 +21,7 @@
 #include "logging/logging.h"
 #include "adc/adc.h"
 #include "gpio/gpio.h"
+#include "filter/filter.h"
 
 #include "vehicleInterface/vehicleState/vehicleState.h"
 
@@ -33,6 +34,7 @@ typedef enum
 
 #define DISCRETESENSE_STACK_SIZE 2000U
 #define DISCRETESENSE_TASK_PRIORITY 10U
+#define DISCRETESENSE_TASK_PHASE 3U  /* ms into the 100Hz period, first in the pipeline */
 
 typedef struct
 {
@@ -40,19 +42,40 @@ typedef struct
   VehicleState_T* state; // Vehicle state object to push data to
   
   // sense inputs:
+  ADC_T* adc;
   ADC_Channel_T adcAccelPedalA;
   ADC_Channel_T adcAccelPedalB;
   ADC_Channel_T adcBrakeFront;
   ADC_Channel_T adcBrakeRear;
   GPIO_T* gpioDashboardButton;
 
+  // Monitor the accelerator pedals with the ADC analog watchdogs, using the
+  // scaling limits as the window. Pedals A and B must be sampled by different
+  // ADCs (one watchdog per ADC).
+  bool accelPedalWatchdog;
+  uint32_t adcHwAccelPedalA; // ADC_CHANNEL_x input of pedal A
+  uint32_t adcHwAccelPedalB; // ADC_CHANNEL_x input of pedal B
+
   // scaling for ADC inputs:
   ADC_Scaling_T scalingAccelPedalA;
   ADC_Scaling_T scalingAccelPedalB;
   ADC_Scaling_T scalingBrakeFront;
   ADC_Scaling_T scalingBrakeRear;
 
+  // filtering of raw ADC inputs, before scaling (no stages for unfiltered).
+  // Samples are ADC counts in Q16.16, e.g. a slew maxStep of
+  // FILTER_Q16(10.0f) is 10 counts per sample.
+  Filter_Chain_T filterAccelPedalA;
+  Filter_Chain_T filterAccelPedalB;
+  Filter_Chain_T filterBrakeFront;
+  Filter_Chain_T filterBrakeRear;
+
   // ******* Internal use *******
+  // Fixed-point form of the scalings, in the order pedal A, pedal B, brake
+  // front, brake rear
+  ADC_ScalingTable_T scalingTable;
+  Filter_Bank_T filterBank; // Same channel order as scalingTable
+
   // RTOS task
   TaskHandle_t taskHandle;
   StaticTask_t taskBuffer;
@@ -109,7 +109,7 @@ GPS_Status_T GPS_Init(
     GPS_T* gps)
 {
   mLog = logger;
-  Log_Print(mLog, "GPS_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_GPS, LOGGING_LEVEL_DEBUG, "GPS_Init begin\n");
   DEPEND_ON(logger, GPS_STATUS_ERROR_DEPENDS);
   DEPEND_ON(gps->state, GPS_STATUS_ERROR_DEPENDS);
   DEPEND_ON_STATIC(UART, GPS_STATUS_ERROR_DEPENDS);
@@ -136,11 +136,11 @@ GPS_Status_T GPS_Init(
       GPS_RECV_STREAM_TRIGGER_LEVEL_BYTES,
       gps->recvStreamStorage,
       &gps->recvStreamStruct);
-  if (UART_STATUS_OK != UART_SetRecvStream(gps->uart, gps->recvStreamHandle)) {
+  if (UART_STATUS_OK != UART_RegisterRecvStream(gps->uart, gps->recvStreamHandle)) {
     return GPS_STATUS_ERROR_INIT;
   }
 
   REGISTER(gps, GPS_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "GPS_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_GPS, LOGGING_LEVEL_DEBUG, "GPS_Init complete\n");
   return GPS_STATUS_OK;
 }
@@ -294,10 +294,60 @@ static void HandleMsg_FluxWeakening(const CAN_DataFrame_T* data, VehicleState_T*
   VehicleState_AccessRelease(state);
 }
 
+static void PutChannel(uint8_t* sample, CInverter_Channel_T channel, float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint8_t* out = &sample[channel * 4U];
+  out[0] = (uint8_t)((bits >> 24) & 0xFF);
+  out[1] = (uint8_t)((bits >> 16) & 0xFF);
+  out[2] = (uint8_t)((bits >> 8) & 0xFF);
+  out[3] = (uint8_t)(bits & 0xFF);
+}
+
+/**
+ * @brief Puts a sample of the inverter and motor channels in the stream, if
+ * running. A sample that can't be read is counted as dropped.
+ */
+static void SampleChannels(CInverter_T* inv)
+{
+  if (NULL == inv->stream || !BlockBuffer_IsRunning(inv->stream)) {
+    return;
+  }
+
+  uint8_t sample[CINVERTER_STREAM_SAMPLE_LEN];
+  VehicleState_T* state = inv->vehicleState;
+  if (VehicleState_AccessAcquire(state)) {
+    const VehicleState_Motor_T* motor = &state->data.motor;
+    const VehicleState_Inverter_T* inverter = &state->data.inverter;
+    PutChannel(sample, CINVERTER_CHANNEL_PHASEA_CURRENT, motor->phaseACurrent);
+    PutChannel(sample, CINVERTER_CHANNEL_PHASEB_CURRENT, motor->phaseBCurrent);
+    PutChannel(sample, CINVERTER_CHANNEL_PHASEC_CURRENT, motor->phaseCCurrent);
+    PutChannel(sample, CINVERTER_CHANNEL_DCBUS_CURRENT, inverter->dcBusCurrent);
+    PutChannel(sample, CINVERTER_CHANNEL_VD, inverter->vd);
+    PutChannel(sample, CINVERTER_CHANNEL_VQ, inverter->vq);
+    PutChannel(sample, CINVERTER_CHANNEL_FLUX_COMMAND, inverter->fluxCommand);
+    PutChannel(sample, CINVERTER_CHANNEL_FLUX_FEEDBACK, inverter->fluxFeedback);
+    PutChannel(sample, CINVERTER_CHANNEL_ID_COMMAND, inverter->idCommand);
+    PutChannel(sample, CINVERTER_CHANNEL_IQ_COMMAND, inverter->iqCommand);
+    PutChannel(sample, CINVERTER_CHANNEL_ID_FEEDBACK, inverter->idFeedback);
+    PutChannel(sample, CINVERTER_CHANNEL_IQ_FEEDBACK, inverter->iqFeedback);
+    PutChannel(sample, CINVERTER_CHANNEL_MODULATION_INDEX, inverter->modulationIndex);
+    PutChannel(sample, CINVERTER_CHANNEL_COMMANDED_TORQUE, inverter->commandedTorque);
+    PutChannel(sample, CINVERTER_CHANNEL_CALCULATED_TORQUE, motor->calculatedTorque);
+    PutChannel(sample, CINVERTER_CHANNEL_MOTOR_SPEED, (float)motor->speed);
+    VehicleState_AccessRelease(state);
+
+    BlockBuffer_Put(inv->stream, sample);
+  } else {
+    BlockBuffer_Drop(inv->stream);
+  }
+}
+
 static void InverterProcessing(CInverter_T* inv)
 {
   // Wait for 10ms notification to wake up
-  uint32_t notifiedValue = ulTaskNotifyTake(pdTRUE, mBlockTime);
+  uint32_t notifiedValue = TaskTimer_Wait(&inv->taskHandle, mBlockTime);
   if (notifiedValue > 0) {
     CAN_DataFrame_T queuedData;
     while (pdTRUE == xQueueReceive(inv->canDataQueueHandle, &queuedData, 0U)) {
@@ -345,6 +395,9 @@ static void InverterProcessing(CInverter_T* inv)
           break;
       }
     }
+
+    // Every tick, whether or not new data arrived, so samples are evenly spaced
+    SampleChannels(inv);
   }
 
 }
@@ -364,7 +417,7 @@ static void InverterProcessing_Task(void* pvParameters)
 CInverter_Status_T CInverter_Init(Logging_T* logger, CInverter_T* inv)
 {
   mLog = logger;
-  Log_Print(mLog, "CInverter_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_INVERTER, LOGGING_LEVEL_DEBUG, "CInverter_Init begin\n");
   DEPEND_ON(logger, CINVERTER_STATUS_ERROR_DEPENDS);
   DEPEND_ON_STATIC(CAN, CINVERTER_STATUS_ERROR_DEPENDS);
 
@@ -390,7 +443,10 @@ CInverter_Status_T CInverter_Init(Logging_T* logger, CInverter_T* inv)
       &inv->taskBuffer);
 
   // Register RTOS task for 100Hz updates
-  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTask(&inv->taskHandle, TASKTIMER_FREQUENCY_100HZ);
+  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTaskPhase(
+      &inv->taskHandle,
+      TASKTIMER_FREQUENCY_100HZ,
+      INVERTER_TASK_PHASE);
   if (TASKTIMER_STATUS_OK != statusTimer) {
     return CINVERTER_STATUS_ERROR_INIT;
   }
@@ -406,7 +462,7 @@ CInverter_Status_T CInverter_Init(Logging_T* logger, CInverter_T* inv)
   }
 
   REGISTER(inv, CINVERTER_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "CInverter_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_INVERTER, LOGGING_LEVEL_DEBUG, "CInverter_Init complete\n");
   return CINVERTER_STATUS_OK;
 }
 
@@ -15,6 +15,7 @@
 #include "FreeRTOS.h"
 
 #include "can/can.h"
+#include "blockbuffer/blockbuffer.h"
 #include "vehicleInterface/vehicleState/vehicleState.h"
 
 #include "cInverterCAN.h"  /* Defines offset CAN IDs */
@@ -22,6 +23,7 @@
 
 #define INVERTER_STACK_SIZE 2000
 #define INVERTER_TASK_PRIORITY 10
+#define INVERTER_TASK_PHASE 6U  /* after the throttle controller requests torque */
 #define INVERTER_QUEUE_LENGTH 256
 #define INVERTER_QUEUE_DATA_SIZE sizeof(CAN_DataFrame_T)
 
@@ -31,6 +33,29 @@
 // Maximum supported torque value in message format
 #define INVERTER_MAX_TORQUE 3276.7f
 
+// Channels of a stream sample, in order. Each is a big endian float.
+typedef enum
+{
+  CINVERTER_CHANNEL_PHASEA_CURRENT = 0U,
+  CINVERTER_CHANNEL_PHASEB_CURRENT,
+  CINVERTER_CHANNEL_PHASEC_CURRENT,
+  CINVERTER_CHANNEL_DCBUS_CURRENT,
+  CINVERTER_CHANNEL_VD,
+  CINVERTER_CHANNEL_VQ,
+  CINVERTER_CHANNEL_FLUX_COMMAND,
+  CINVERTER_CHANNEL_FLUX_FEEDBACK,
+  CINVERTER_CHANNEL_ID_COMMAND,
+  CINVERTER_CHANNEL_IQ_COMMAND,
+  CINVERTER_CHANNEL_ID_FEEDBACK,
+  CINVERTER_CHANNEL_IQ_FEEDBACK,
+  CINVERTER_CHANNEL_MODULATION_INDEX,
+  CINVERTER_CHANNEL_COMMANDED_TORQUE,
+  CINVERTER_CHANNEL_CALCULATED_TORQUE,
+  CINVERTER_CHANNEL_MOTOR_SPEED,
+  CINVERTER_NUM_CHANNELS
+} CInverter_Channel_T;
+#define CINVERTER_STREAM_SAMPLE_LEN (CINVERTER_NUM_CHANNELS * 4U)
+
 struct CInverterCommand {
   bool inverterEnabled;
   bool dischargeModeEnabled;
@@ -45,6 +70,7 @@ typedef struct
   // ******* Setup *******
   CAN_Device_T canInst;       // CAN device connected to inverter
   VehicleState_T* vehicleState;
+  BlockBuffer_T* stream; // Channels sampled every tick, NULL if not streamed
 
   // ******* Internal use *******
   // RTOS task
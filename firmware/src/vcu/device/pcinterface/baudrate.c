@@ -0,0 +1,245 @@
+/*
+ * baudrate.c
+ *
+ * Implements negotiated baud rate switching of the PC interface ports.
+ *
+ * The switch is requested by the PC, per port:
+ *   1. PC sends a baud request (new rate) at the current rate.
+ *   2. VCU responds ACCEPTED at the current rate, then switches once
+ *      everything queued on the port has been sent.
+ *   3. PC switches when it receives ACCEPTED, then sends a baud confirm (new
+ *      rate) at the new rate until it gets a response.
+ *   4. VCU responds CONFIRMED at the new rate. Switch complete.
+ * If the VCU isn't confirmed within PCINTERFACE_BAUD_TIMEOUT_TICKS of
+ * accepting, it goes back to the previous rate. The PC does the same if it
+ * doesn't receive CONFIRMED, so both ends fall back to the old rate.
+ *
+ * While a port is waiting for its transmit queue to empty (switching or
+ * reverting) nothing new is queued on it. If the queue still hasn't emptied
+ * PCINTERFACE_BAUD_REVERT_TICKS into reverting it is dropped: the PC is
+ * already back at the old rate, so nothing sent at the new one is received.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "pcinterface.h"
+
+/**
+ * @brief Reads the baud rate from a request/confirm payload
+ */
+static uint32_t decodeBaudRate(const uint8_t* payloadBytes)
+{
+  uint32_t baudRate = 0U;
+  baudRate |= (uint32_t)payloadBytes[0] << 24U;
+  baudRate |= (uint32_t)payloadBytes[1] << 16U;
+  baudRate |= (uint32_t)payloadBytes[2] << 8U;
+  baudRate |= (uint32_t)payloadBytes[3] << 0U;
+  return baudRate;
+}
+
+/**
+ * @brief Whether a port is waiting for its transmit queue to empty to change
+ * rate. Nothing more should be queued on it.
+ */
+bool PCInterface_BaudTxHeld(const struct PCInterface_Port* port)
+{
+  return PCINTERFACE_BAUD_STATE_SWITCHING == port->baud.state ||
+         PCINTERFACE_BAUD_STATE_REVERTING == port->baud.state;
+}
+
+/**
+ * @brief Sends a baud rate response on one port only
+ *
+ * @param pcinterface PCInterface struct
+ * @param port Port to respond on
+ * @param baudRate Rate the response refers to
+ * @param status PCINTERFACE_BAUD_ status
+ */
+static void sendBaudResponse(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint32_t baudRate,
+    uint8_t status)
+{
+  if (PCInterface_BaudTxHeld(port)) {
+    return;
+  }
+
+  uint8_t* payload = MsgFrameEncode_InitFrame(&pcinterface->mfBaudResponse);
+  payload[0] = (uint8_t)((baudRate >> 24) & 0xFF);
+  payload[1] = (uint8_t)((baudRate >> 16) & 0xFF);
+  payload[2] = (uint8_t)((baudRate >> 8) & 0xFF);
+  payload[3] = (uint8_t)(baudRate & 0xFF);
+  payload[4] = status;
+  MsgFrameEncode_Finish(&pcinterface->mfBaudResponse);
+
+  UART_SendMessage(
+      port->uart,
+      pcinterface->mfBaudResponseBuffer,
+      pcinterface->mfBaudResponse.msgLen);
+}
+
+/**
+ * @brief Drops any partially received frame (e.g. garbage received while the
+ * two ends were at different rates)
+ */
+static void resetDecoder(struct PCInterface_Port* port)
+{
+  MsgFrameDecode_Init(&port->mfDecode);
+}
+
+/**
+ * @brief Sets up the baud rate state of a port
+ *
+ * @param port Port, uart must be configured
+ * @return true if successful
+ */
+bool PCInterface_BaudInit(struct PCInterface_Port* port)
+{
+  port->baud.state = PCINTERFACE_BAUD_STATE_IDLE;
+  port->baud.newBaudRate = 0U;
+  port->baud.ticks = 0U;
+  return UART_STATUS_OK == UART_GetBaudRate(port->uart, &port->baud.baudRate);
+}
+
+/**
+ * @brief Whether any port is waiting for its transmit queue to empty to change
+ * rate. Output to both ports should be held back until it has.
+ */
+bool PCInterface_BaudSwitchPending(PCInterface_T* pcinterface)
+{
+  for (uint8_t i = 0U; i < pcinterface->numPorts; ++i) {
+    if (PCInterface_BaudTxHeld(&pcinterface->ports[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Handles a baud rate request from the PC
+ *
+ * @param pcinterface PCInterface struct
+ * @param port Port the request was received on
+ * @param payloadBytes Message payload
+ * @param nBytes Length of payloadBytes
+ */
+void PCInterface_BaudRequest(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint8_t* payloadBytes,
+    uint16_t nBytes)
+{
+  if (nBytes != PCINTERFACE_MSG_COMMON_DATALEN) {
+    return;
+  }
+
+  const uint32_t baudRate = decodeBaudRate(payloadBytes);
+
+  if (PCINTERFACE_BAUD_STATE_IDLE != port->baud.state) {
+    sendBaudResponse(pcinterface, port, baudRate, PCINTERFACE_BAUD_BUSY);
+    return;
+  }
+
+  if (baudRate < PCINTERFACE_BAUD_MIN || baudRate > pcinterface->maxBaudRate) {
+    sendBaudResponse(pcinterface, port, baudRate, PCINTERFACE_BAUD_REJECTED);
+    return;
+  }
+
+  // Switch once the response (and anything before it) has gone out
+  sendBaudResponse(pcinterface, port, baudRate, PCINTERFACE_BAUD_ACCEPTED);
+  port->baud.newBaudRate = baudRate;
+  port->baud.ticks = 0U;
+  port->baud.state = PCINTERFACE_BAUD_STATE_SWITCHING;
+}
+
+/**
+ * @brief Handles a baud rate confirm from the PC. Received at the new rate,
+ * so the PC to VCU direction is working.
+ *
+ * @param pcinterface PCInterface struct
+ * @param port Port the confirm was received on
+ * @param payloadBytes Message payload
+ * @param nBytes Length of payloadBytes
+ */
+void PCInterface_BaudConfirm(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint8_t* payloadBytes,
+    uint16_t nBytes)
+{
+  if (nBytes != PCINTERFACE_MSG_COMMON_DATALEN) {
+    return;
+  }
+
+  const uint32_t baudRate = decodeBaudRate(payloadBytes);
+
+  if (PCINTERFACE_BAUD_STATE_CONFIRMING == port->baud.state &&
+      baudRate == port->baud.newBaudRate) {
+    port->baud.baudRate = baudRate;
+    port->baud.state = PCINTERFACE_BAUD_STATE_IDLE;
+    sendBaudResponse(pcinterface, port, baudRate, PCINTERFACE_BAUD_CONFIRMED);
+    Log_Print(pcinterface->log, LOGGING_MODULE_PCINTERFACE, LOGGING_LEVEL_INFO, "PCInterface: baud rate switched\n");
+  } else if (PCINTERFACE_BAUD_STATE_IDLE == port->baud.state &&
+             baudRate == port->baud.baudRate) {
+    // PC repeated its confirm, the response must have been lost
+    sendBaudResponse(pcinterface, port, baudRate, PCINTERFACE_BAUD_CONFIRMED);
+  }
+}
+
+/**
+ * @brief Steps the baud rate switch of each port. Call once per task tick,
+ * before anything is queued for the tick.
+ *
+ * @param pcinterface PCInterface struct
+ */
+void PCInterface_HandleBaudSwitch(PCInterface_T* pcinterface)
+{
+  for (uint8_t i = 0U; i < pcinterface->numPorts; ++i) {
+    struct PCInterface_Port* port = &pcinterface->ports[i];
+    UART_Status_T status = UART_STATUS_OK;
+
+    switch (port->baud.state) {
+      case PCINTERFACE_BAUD_STATE_SWITCHING:
+        port->baud.ticks++;
+        status = UART_SetBaudRate(port->uart, port->baud.newBaudRate);
+        if (UART_STATUS_OK == status) {
+          resetDecoder(port);
+          port->baud.state = PCINTERFACE_BAUD_STATE_CONFIRMING;
+        } else if (UART_STATUS_ERROR_BUSY != status ||
+                   port->baud.ticks >= PCINTERFACE_BAUD_TIMEOUT_TICKS) {
+          // Couldn't switch. Still at the old rate, PC will time out.
+          port->baud.state = PCINTERFACE_BAUD_STATE_IDLE;
+          Log_Print(pcinterface->log, LOGGING_MODULE_PCINTERFACE, LOGGING_LEVEL_WARN, "PCInterface: baud rate switch failed\n");
+        }
+        break;
+
+      case PCINTERFACE_BAUD_STATE_CONFIRMING:
+        port->baud.ticks++;
+        if (port->baud.ticks >= PCINTERFACE_BAUD_TIMEOUT_TICKS) {
+          port->baud.ticks = 0U;
+          port->baud.state = PCINTERFACE_BAUD_STATE_REVERTING;
+        }
+        break;
+
+      case PCINTERFACE_BAUD_STATE_REVERTING:
+        port->baud.ticks++;
+        if (port->baud.ticks >= PCINTERFACE_BAUD_REVERT_TICKS) {
+          // Still not empty, don't wait for it any longer
+          UART_FlushTx(port->uart);
+        }
+        status = UART_SetBaudRate(port->uart, port->baud.baudRate);
+        if (UART_STATUS_ERROR_BUSY != status) {
+          resetDecoder(port);
+          port->baud.state = PCINTERFACE_BAUD_STATE_IDLE;
+          Log_Print(pcinterface->log, LOGGING_MODULE_PCINTERFACE, LOGGING_LEVEL_WARN, "PCInterface: baud rate not confirmed, reverted\n");
+        }
+        break;
+
+      case PCINTERFACE_BAUD_STATE_IDLE:
+      default:
+        break;
+    }
+  }
+}
@@ -11,6 +11,8 @@
 
 #include <stdio.h>
 
+#include "tasktimer/tasktimer.h"
+
 /**
  * @brief Search the command list for a command with a specific name.
  * 
@@ -134,6 +136,93 @@ static void cmd_setsdc(
   DebugPrint(pcinterface, buf);
 }
 
+/**
+ * @brief Finds a name in a table of names
+ *
+ * @return Index of the name, or num if not found
+ */
+static uint8_t findName(const char* const* names, uint8_t num, const char* name)
+{
+  uint8_t i = 0U;
+  while (i < num && strcmp(names[i], name) != 0) {
+    ++i;
+  }
+  return i;
+}
+
+static void cmd_loglevel(
+    PCInterface_T* pcinterface,
+    uint16_t argc,
+    char argv[DEBUGTERM_NUM_ARGS][PCINTERFACE_DEBUGTERM_BUFLEN+1])
+{
+  if (argc == 3) {
+    uint8_t level = findName(Log_LevelNames, LOGGING_NUM_LEVELS, argv[2]);
+    if (LOGGING_NUM_LEVELS == level) {
+      DebugPrint(pcinterface, "Unknown level\n");
+      return;
+    }
+
+    if (strcmp(argv[1], "all") == 0) {
+      for (uint8_t i = 0U; i < LOGGING_NUM_MODULES; ++i) {
+        Log_SetLevel(pcinterface->log, (Logging_Module_T)i, level);
+      }
+    } else {
+      uint8_t module = findName(Log_ModuleNames, LOGGING_NUM_MODULES, argv[1]);
+      if (LOGGING_NUM_MODULES == module) {
+        DebugPrint(pcinterface, "Unknown module\n");
+        return;
+      }
+      Log_SetLevel(pcinterface->log, (Logging_Module_T)module, level);
+    }
+  } else if (argc != 1) {
+    DebugPrint(pcinterface, "Unexpected number of params\n");
+    return;
+  }
+
+  for (uint8_t i = 0U; i < LOGGING_NUM_MODULES; ++i) {
+    char buf[32] = { 0 };
+    snprintf(buf, 32, "  %-12s %s\n", Log_ModuleNames[i],
+        Log_LevelNames[Log_GetLevel(pcinterface->log, (Logging_Module_T)i)]);
+    DebugPrint(pcinterface, buf);
+  }
+}
+
+static void cmd_tasks(
+    PCInterface_T* pcinterface,
+    uint16_t argc,
+    char argv[DEBUGTERM_NUM_ARGS][PCINTERFACE_DEBUGTERM_BUFLEN+1])
+{
+  if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+    TaskTimer_ResetStats();
+    DebugPrint(pcinterface, "Task timing reset\n");
+    return;
+  } else if (argc != 1) {
+    DebugPrint(pcinterface, "Unexpected number of params\n");
+    return;
+  }
+
+  DebugPrint(pcinterface, "  task  freq  phase     jobs  lat min  lat max   jitter     wcrt\n");
+  const uint16_t numTasks = TaskTimer_NumTasks();
+  for (uint16_t i = 0U; i < numTasks; ++i) {
+    TaskTimer_Stats_T stats;
+    if (!TaskTimer_GetStats(i, &stats)) {
+      break;
+    }
+
+    char buf[80] = { 0 };
+    snprintf(buf, 80, "  %4u %5s %6u %8lu %8lu %8lu %8lu %8lu\n",
+        (unsigned int)uxTaskGetTaskNumber(*stats.taskHandle),
+        TaskTimer_FrequencyNames[stats.frequency],
+        (unsigned int)stats.phase,
+        (unsigned long)stats.jobs,
+        (unsigned long)stats.minLatencyUs,
+        (unsigned long)stats.maxLatencyUs,
+        (unsigned long)(stats.maxLatencyUs - stats.minLatencyUs),
+        (unsigned long)stats.maxResponseUs);
+    DebugPrint(pcinterface, buf);
+  }
+}
+
 struct DebugTerm_CmdDef DebugTerm_Commands[] = {
   {
     .name = "help",
@@ -157,5 +246,23 @@ struct DebugTerm_CmdDef DebugTerm_Commands[] = {
             "where x is 0 or 1 to disable or enable the SDC output.\n",
     .exec = cmd_setsdc,
   },
+  {
+    .name = "loglevel",
+    .desc = "Show or set log levels",
+    .help = "Usage: loglevel [module level]\n"
+            "Sets the most detailed level logged by module, or by all modules.\n"
+            "level is off, error, warn, info or debug. Prints each module's level.\n",
+    .exec = cmd_loglevel,
+  },
+  {
+    .name = "tasks",
+    .desc = "Show task timer release timing",
+    .help = "Usage: tasks [reset]\n"
+            "For each timed task, prints its task number, frequency and phase in timer\n"
+            "ticks, then the jobs run, the min and max latency from release to start,\n"
+            "the release jitter and the worst case response time, in us.\n"
+            "reset restarts the timing.\n",
+    .exec = cmd_tasks,
+  },
 };
 const size_t DebugTerm_NumCommands = sizeof(DebugTerm_Commands) / sizeof(DebugTerm_Commands[0]);
@@ -19,6 +19,8 @@
 
 #define DEBUGTERM_MSG_TRUNCATED "[Message truncated]\n"
 
+extern bool PCInterface_BaudSwitchPending(PCInterface_T* pcinterface);
+
 /**
  * @brief Debug terminal print to serial method.
  * 
@@ -27,7 +29,12 @@
  */
 static void DebugPrint(PCInterface_T* pcinterface, const char* msg)
 {
-  _Static_assert(PCINTERFACE_MSG_DEBUGTERM_BUFFERLEN >= DEBUGTERM_MAX_MSG_LEN, "mf buffer must have enough space for largest debug term msg");
+  _Static_assert(PCINTERFACE_MSG_DEBUGTERM_DATALEN >= DEBUGTERM_MAX_MSG_LEN + 2, "mf buffer must have enough space for largest debug term msg");
+
+  // Dropped while a port needs its transmit queue to empty to switch baud rate
+  if (PCInterface_BaudSwitchPending(pcinterface)) {
+    return;
+  }
 
   uint16_t textLen = (uint16_t)strnlen(msg, DEBUGTERM_MAX_MSG_LEN);
   uint16_t payloadLen = textLen + 2; // For size characters
@@ -36,7 +43,6 @@ static void DebugPrint(PCInterface_T* pcinterface, const char* msg)
   if (DEBUGTERM_MAX_MSG_LEN == textLen) {
     textLen = sizeof(DEBUGTERM_MSG_TRUNCATED);
     pcinterface->mfDebugEncode.dataLen = payloadLen;
-    pcinterface->mfDebugEncode.msgLen = payloadLen + PCINTERFACE_MSG_PACKET_BYTES;
     uint8_t* msgPayload = MsgFrameEncode_InitFrame(&pcinterface->mfDebugEncode);
 
     msgPayload[0] = (uint8_t)(textLen & 0xFF);
@@ -44,14 +50,13 @@ static void DebugPrint(PCInterface_T* pcinterface, const char* msg)
     snprintf((char*)(msgPayload + 2), textLen, DEBUGTERM_MSG_TRUNCATED);
   } else {
     pcinterface->mfDebugEncode.dataLen = payloadLen;
-    pcinterface->mfDebugEncode.msgLen = payloadLen + PCINTERFACE_MSG_PACKET_BYTES;
     uint8_t* msgPayload = MsgFrameEncode_InitFrame(&pcinterface->mfDebugEncode);
 
     msgPayload[0] = (uint8_t)(textLen & 0xFF);
     msgPayload[1] = (uint8_t)((textLen >> 8) & 0xFF);
     memcpy(msgPayload + 2, msg, textLen);
   }
-  MsgFrameEncode_UpdateCRC(&pcinterface->mfDebugEncode);
+  MsgFrameEncode_Finish(&pcinterface->mfDebugEncode);
 
   // Duplicate the data on both ports (hardware probing is easier this way)
   UART_SendMessage(pcinterface->uartA, pcinterface->mfDebugEncodeBuffer, pcinterface->mfDebugEncode.msgLen);
@@ -21,5 +21,38 @@
 #define PCCONTROLLER_FIELDID_BATTERY_SOC            0x0009
 #define PCCONTROLLER_FIELDID_BATTERY_COUNTER        0x000A
 #define PCCONTROLLER_FIELDID_BMS_FAULTINDICATOR     0x000B
+#define PCCONTROLLER_FIELDID_BATTERY_MINCELLVOLT    0x000C
+#define PCCONTROLLER_FIELDID_BATTERY_MINCELLTEMP    0x000D
+
+#define PCCONTROLLER_FIELDID_INPUT_ACCEL            0x0010
+#define PCCONTROLLER_FIELDID_INPUT_BRAKEFRONT       0x0011
+#define PCCONTROLLER_FIELDID_INPUT_BRAKEREAR        0x0012
+#define PCCONTROLLER_FIELDID_WHEELSPEED_FRONT       0x0018
+#define PCCONTROLLER_FIELDID_WHEELSPEED_REAR        0x0019
+
+#define PCCONTROLLER_FIELDID_MOTOR_TEMPERATURE      0x0020
+#define PCCONTROLLER_FIELDID_MOTOR_SPEED            0x0021
+#define PCCONTROLLER_FIELDID_MOTOR_TORQUE           0x0022
+#define PCCONTROLLER_FIELDID_INVERTER_DCBUSVOLTAGE  0x0028
+#define PCCONTROLLER_FIELDID_INVERTER_DCBUSCURRENT  0x0029
+#define PCCONTROLLER_FIELDID_INVERTER_TORQUECMD     0x002A
+#define PCCONTROLLER_FIELDID_INVERTER_VSMSTATE      0x002B
+#define PCCONTROLLER_FIELDID_INVERTER_RUNFAULTS     0x002C
+
+// UART link statistics, field ID is base of the port + offset of the counter
+#define PCCONTROLLER_FIELDID_UARTA_BASE             0x0100
+#define PCCONTROLLER_FIELDID_UARTB_BASE             0x0110
+#define PCCONTROLLER_FIELDID_UART_RXBYTES           0x0000
+#define PCCONTROLLER_FIELDID_UART_TXBYTES           0x0001
+#define PCCONTROLLER_FIELDID_UART_OVERRUNERRORS     0x0002
+#define PCCONTROLLER_FIELDID_UART_FRAMINGERRORS     0x0003
+#define PCCONTROLLER_FIELDID_UART_NOISEERRORS       0x0004
+#define PCCONTROLLER_FIELDID_UART_PARITYERRORS      0x0005
+#define PCCONTROLLER_FIELDID_UART_DMAERRORS         0x0006
+#define PCCONTROLLER_FIELDID_UART_RXOVERFLOW        0x0007
+#define PCCONTROLLER_FIELDID_UART_TXDROPPED         0x0008
+#define PCCONTROLLER_FIELDID_UART_TXFULL            0x0009
+#define PCCONTROLLER_FIELDID_UART_TXBACKLOGPEAK     0x000A
+#define PCCONTROLLER_FIELDID_UART_TXCHAINPEAK       0x000B
 
 #endif // VEHICLELOGIC_PCCONTROLLER_FIELDID_H_
@@ -10,35 +10,102 @@
 #ifndef DEVICE_PCINTERFACE_MESSAGES_H_
 #define DEVICE_PCINTERFACE_MESSAGES_H_
 
+#include "uart/msgframe.h"
+
 #define PCINTERFACE_MSG_DESTADDR_VCU    0x01
 #define PCINTERFACE_MSG_DESTADDR_PC     0x02
 
-// Number of non-payload bytes in the packet
-#define PCINTERFACE_MSG_PACKET_BYTES    11
+// Messages are framed as described in uart/msgframe.h. BUFFERLEN is the
+// encoder buffer needed for the largest message of each type.
 
 // Tx messages:
 
-#define PCINTERFACE_MSG_STATEUPDATE_FUNCITION 0x01
-#define PCINTERFACE_MSG_STATEUPDATE_DATALEN   7U
-#define PCINTERFACE_MSG_STATEUPDATE_MSGLEN    18U
+// 0x01 was a single state field per message, replaced by the state batch
+
 
+// Variable length, up to DATALEN
 #define PCINTERFACE_MSG_LOG_FUNCTION 0x02
-#define PCINTERFACE_MSG_LOG_DATALEN  32U
-#define PCINTERFACE_MSG_LOG_MSGLEN   43U
+#define PCINTERFACE_MSG_LOG_DATALEN  128U
+#define PCINTERFACE_MSG_LOG_BUFFERLEN \
+    MSGFRAME_ENCODE_BUFFER_LEN(PCINTERFACE_MSG_LOG_DATALEN)
+
+#define PCINTERFACE_MSG_BAUD_RESPONSE_FUNCTION 0x03
+#define PCINTERFACE_MSG_BAUD_RESPONSE_DATALEN  5U
+#define PCINTERFACE_MSG_BAUD_RESPONSE_BUFFERLEN \
+    MSGFRAME_ENCODE_BUFFER_LEN(PCINTERFACE_MSG_BAUD_RESPONSE_DATALEN)
+
+// Variable length, up to DATALEN. Any number of state fields, each:
+//   Field ID[2] Size[1] Value[Size]
+// Value is big endian, Size is 1 to 4 bytes.
+#define PCINTERFACE_MSG_STATEBATCH_FUNCTION 0x04
+#define PCINTERFACE_MSG_STATEBATCH_DATALEN  128U
+#define PCINTERFACE_MSG_STATEBATCH_FIELD_HEADER_LEN 3U
+#define PCINTERFACE_MSG_STATEBATCH_BUFFERLEN \
+    MSGFRAME_ENCODE_BUFFER_LEN(PCINTERFACE_MSG_STATEBATCH_DATALEN)
+
+// Variable length, up to the state batch DATALEN. State fields that changed
+// since they were last sent, each:
+//   varint(Field ID) varint(zigzag(Value - Last Value))
+// as described in telemetry/telemetry.h. Shares the state batch sequence
+// number: after a gap, deltas are ignored until the next state batch, which
+// is sent every KEYFRAME_PERIOD updates.
+#define PCINTERFACE_MSG_STATEDELTA_FUNCTION 0x05
+#define PCINTERFACE_MSG_STATEDELTA_KEYFRAME_PERIOD 10U
+
+// Response to a subscribe request: Field ID[2] Rate[1] Status[1]
+#define PCINTERFACE_MSG_SUBSCRIBE_RESPONSE_FUNCTION 0x06
+#define PCINTERFACE_MSG_SUBSCRIBE_RESPONSE_DATALEN  4U
+#define PCINTERFACE_MSG_SUBSCRIBE_RESPONSE_BUFFERLEN \
+    MSGFRAME_ENCODE_BUFFER_LEN(PCINTERFACE_MSG_SUBSCRIBE_RESPONSE_DATALEN)
+
+// Variable length, up to DATALEN. A block of the channel stream:
+//   First Sample[4] Dropped[4] Samples
+// as described in blockbuffer/blockbuffer.h. Each sample is the channels of
+// CInverter_Channel_T in order, each a big endian float. Blocks are sent in
+// one frame each, so a whole block is sent or none of it.
+#define PCINTERFACE_MSG_STREAMBLOCK_FUNCTION 0x07
+#define PCINTERFACE_MSG_STREAMBLOCK_DATALEN  MSGFRAME_MAX_DATA_LEN
+#define PCINTERFACE_MSG_STREAMBLOCK_BUFFERLEN \
+    MSGFRAME_ENCODE_BUFFER_LEN(PCINTERFACE_MSG_STREAMBLOCK_DATALEN)
+
+// Variable length, up to DATALEN. Whole deferred log records, each:
+//   ID[2] NumArgs[1] Source[1] Time[4] Args[4 each]
+// as described in logging/logging.h.
+#define PCINTERFACE_MSG_LOGRECORDS_FUNCTION 0x08
+#define PCINTERFACE_MSG_LOGRECORDS_DATALEN  128U
+#define PCINTERFACE_MSG_LOGRECORDS_BUFFERLEN \
+    MSGFRAME_ENCODE_BUFFER_LEN(PCINTERFACE_MSG_LOGRECORDS_DATALEN)
 
 // Variable length message
 #define PCINTERFACE_MSG_DEBUGTERM_FUNCTION 0x09
-#define PCINTERFACE_MSG_DEBUGTERM_BUFFERLEN 256
+#define PCINTERFACE_MSG_DEBUGTERM_DATALEN 258U // Text length (2) + text
+#define PCINTERFACE_MSG_DEBUGTERM_BUFFERLEN \
+    MSGFRAME_ENCODE_BUFFER_LEN(PCINTERFACE_MSG_DEBUGTERM_DATALEN)
 
 // Rx messages:
 
-// Use a common message length to simplifying decoding
+// Commands have a common data length
 #define PCINTERFACE_MSG_COMMON_DATALEN  8U
-#define PCINTERFACE_MSG_COMMON_MSGLEN   19U
 
 #define PCINTERFACE_MSG_DEBUG_TERMINAL          0x9
 #define PCINTERFACE_MSG_TESTCMD_SDC_FUNCTION    0x101
 #define PCINTERFACE_MSG_TESTCMD_PDM_FUNCTION    0x102
+#define PCINTERFACE_MSG_BAUD_REQUEST_FUNCTION   0x103
+#define PCINTERFACE_MSG_BAUD_CONFIRM_FUNCTION   0x104
+#define PCINTERFACE_MSG_SUBSCRIBE_FUNCTION      0x105 /* Field ID[2] Rate[1] */
+#define PCINTERFACE_MSG_STREAM_FUNCTION         0x106 /* Enable[1] */
+
+// Baud rate response status
+#define PCINTERFACE_BAUD_ACCEPTED   0x00 /* Switching to the new rate, confirm at new rate */
+#define PCINTERFACE_BAUD_REJECTED   0x01 /* Rate not supported */
+#define PCINTERFACE_BAUD_BUSY       0x02 /* Another switch is in progress */
+#define PCINTERFACE_BAUD_CONFIRMED  0x03 /* Link is running at the new rate */
+
+// Subscribe response status
+#define PCINTERFACE_SUBSCRIBE_OK            0x00 /* Field is sent at the rate, or no longer sent if 0 */
+#define PCINTERFACE_SUBSCRIBE_UNKNOWNFIELD  0x01 /* No such field */
+#define PCINTERFACE_SUBSCRIBE_BADRATE       0x02 /* Rate over PCINTERFACE_SUBSCRIBE_MAX_RATE */
+#define PCINTERFACE_SUBSCRIBE_FULL          0x03 /* No room for another rate, or field at the rate */
 
 
 #endif // DEVICE_PCINTERFACE_MESSAGES_H_
@@ -21,6 +21,14 @@ static const TickType_t mBlockTime2 = 100 / portTICK_PERIOD_MS; // 100ms // TODO
 // ************ Request handlers ************
 extern void PCInterface_HandleRequests(PCInterface_T* pcinterface);
 extern void PCInterface_HandlePeriodic(PCInterface_T* pcinterface);
+// ************ Baud rate switching ************
+extern bool PCInterface_BaudInit(struct PCInterface_Port* port);
+extern bool PCInterface_BaudSwitchPending(PCInterface_T* pcinterface);
+extern void PCInterface_HandleBaudSwitch(PCInterface_T* pcinterface);
+// ************ State field subscriptions ************
+extern void PCInterface_SubscribeInit(PCInterface_T* pcinterface);
+// ************ Channel stream ************
+extern void PCInterface_StreamFlush(PCInterface_T* pcinterface);
 
 /**
  * @brief Sends all queued log messages to serial
@@ -29,17 +37,54 @@ extern void PCInterface_HandlePeriodic(PCInterface_T* pcinterface);
  */
 static void flushLogMessage(PCInterface_T* pcinterface)
 {
-  // Send saved log data to UART
-  while (!xStreamBufferIsEmpty(pcinterface->logStreamHandle)) {
-    // Construct message:
-    memset(pcinterface->mfLogDataBuffer, 0U, PCINTERFACE_MSG_LOG_MSGLEN);
+  // Send saved log data to UART. Anything that doesn't fit in the UART
+  // queues stays in the log stream until next time. Logs also wait while a
+  // port needs its transmit queue to empty to switch baud rate.
+  if (PCInterface_BaudSwitchPending(pcinterface)) {
+    return;
+  }
+
+  while (!xStreamBufferIsEmpty(pcinterface->logStreamHandle) &&
+         UART_TxSpaceAvailable(pcinterface->uartA, PCINTERFACE_MSG_LOG_BUFFERLEN) &&
+         UART_TxSpaceAvailable(pcinterface->uartB, PCINTERFACE_MSG_LOG_BUFFERLEN)) {
+    // Construct message, as long as the data available:
+    pcinterface->mfLogData.dataLen = PCINTERFACE_MSG_LOG_DATALEN;
     uint8_t* msgData = MsgFrameEncode_InitFrame(&pcinterface->mfLogData);
-    xStreamBufferReceive(pcinterface->logStreamHandle, msgData, PCINTERFACE_MSG_LOG_DATALEN, mBlockTime2);
-    MsgFrameEncode_UpdateCRC(&pcinterface->mfLogData);
+    pcinterface->mfLogData.dataLen = (uint16_t)xStreamBufferReceive(
+        pcinterface->logStreamHandle,
+        msgData,
+        PCINTERFACE_MSG_LOG_DATALEN,
+        mBlockTime2);
+    MsgFrameEncode_Finish(&pcinterface->mfLogData);
 
     // Duplicate the data on both ports (hardware probing is easier this way)
-    UART_SendMessage(pcinterface->uartA, pcinterface->mfLogDataBuffer, PCINTERFACE_MSG_LOG_MSGLEN);
-    UART_SendMessage(pcinterface->uartB, pcinterface->mfLogDataBuffer, PCINTERFACE_MSG_LOG_MSGLEN);
+    UART_SendMessage(pcinterface->uartA, pcinterface->mfLogDataBuffer, pcinterface->mfLogData.msgLen);
+    UART_SendMessage(pcinterface->uartB, pcinterface->mfLogDataBuffer, pcinterface->mfLogData.msgLen);
+  }
+}
+
+static void flushLogRecords(PCInterface_T* pcinterface)
+{
+  // Deferred log records, whole records per frame. Like the log messages,
+  // records that don't fit in the UART queues wait until next time.
+  Log_UpdateTime(pcinterface->log);
+  if (PCInterface_BaudSwitchPending(pcinterface)) {
+    return;
+  }
+
+  while (UART_TxSpaceAvailable(pcinterface->uartA, PCINTERFACE_MSG_LOGRECORDS_BUFFERLEN) &&
+         UART_TxSpaceAvailable(pcinterface->uartB, PCINTERFACE_MSG_LOGRECORDS_BUFFERLEN)) {
+    pcinterface->mfLogRecords.dataLen = PCINTERFACE_MSG_LOGRECORDS_DATALEN;
+    uint8_t* msgData = MsgFrameEncode_InitFrame(&pcinterface->mfLogRecords);
+    pcinterface->mfLogRecords.dataLen = Log_ReadRecords(
+        pcinterface->log, msgData, PCINTERFACE_MSG_LOGRECORDS_DATALEN);
+    if (0U == pcinterface->mfLogRecords.dataLen) {
+      break;
+    }
+    MsgFrameEncode_Finish(&pcinterface->mfLogRecords);
+
+    UART_SendMessage(pcinterface->uartA, pcinterface->mfLogRecordsBuffer, pcinterface->mfLogRecords.msgLen);
+    UART_SendMessage(pcinterface->uartB, pcinterface->mfLogRecordsBuffer, pcinterface->mfLogRecords.msgLen);
   }
 }
 
@@ -60,7 +105,7 @@ static void periodicCanDebug(PCInterface_T* pcinterface)
     CAN_Status_T status = CAN_SendMessage(CAN_DEV1, msgId, data, dlc);
     if (status != CAN_STATUS_OK) {
       if (pcinterface->canErrorCounter % 10 == 0) {
-        Log_Print(mLog, "PCInterface: CAN Error\n");
+        Log_Print(mLog, LOGGING_MODULE_PCINTERFACE, LOGGING_LEVEL_WARN, "PCInterface: CAN Error\n");
       }
       pcinterface->canErrorCounter++;
     }
@@ -70,8 +115,9 @@ static void periodicCanDebug(PCInterface_T* pcinterface)
 static void PCInterface_TaskMethod(PCInterface_T* pcinterface)
 {
   // Wait for notification to wake up
-  uint32_t notifiedValue = ulTaskNotifyTake(pdTRUE, mBlockTime2);
+  uint32_t notifiedValue = TaskTimer_Wait(&pcinterface->taskHandle, mBlockTime2);
   if (notifiedValue > 0) {
+    PCInterface_HandleBaudSwitch(pcinterface);
     PCInterface_HandleRequests(pcinterface);
     PCInterface_HandlePeriodic(pcinterface);
 
@@ -79,6 +125,8 @@ static void PCInterface_TaskMethod(PCInterface_T* pcinterface)
     GPIO_TogglePin(pcinterface->pinToggle);
     periodicCanDebug(pcinterface);
     flushLogMessage(pcinterface);
+    flushLogRecords(pcinterface);
+    PCInterface_StreamFlush(pcinterface);
 
     pcinterface->counter++;
   }
@@ -102,7 +150,7 @@ PCInterface_Status_T PCInterface_Init(
 {
   mLog = logger;
   pcinterface->log = logger; // TODO migrate to this way
-  Log_Print(mLog, "PCInterface_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_PCINTERFACE, LOGGING_LEVEL_DEBUG, "PCInterface_Init begin\n");
   DEPEND_ON(logger, PCINTERFACE_STATUS_ERROR_DEPENDS);
   DEPEND_ON_STATIC(UART, PCINTERFACE_STATUS_ERROR_DEPENDS);
   DEPEND_ON_STATIC(TASKTIMER, PCINTERFACE_STATUS_ERROR_DEPENDS);
@@ -112,37 +160,71 @@ PCInterface_Status_T PCInterface_Init(
   pcinterface->canDebugEnable = false;
   pcinterface->stateEnabled = false;
   pcinterface->controlEnabled = false;
+  pcinterface->channelStream = NULL;
+  pcinterface->streamPort = NULL;
+  pcinterface->streamTxBusy = false;
 
   // Set up message frame encoders
   // Encoder init method is called when frame is used
   // But set common fields here once
-  pcinterface->mfStateUpdate.crc = pcinterface->crc;
-  pcinterface->mfStateUpdate.address = PCINTERFACE_MSG_DESTADDR_PC;
-  pcinterface->mfStateUpdate.function = PCINTERFACE_MSG_STATEUPDATE_FUNCITION;
-  pcinterface->mfStateUpdate.dataLen = PCINTERFACE_MSG_STATEUPDATE_DATALEN;
-  pcinterface->mfStateUpdate.msgLen = PCINTERFACE_MSG_STATEUPDATE_MSGLEN;
-  pcinterface->mfStateUpdate.buffer = pcinterface->mfStateUpdateBuffer;
-
-  pcinterface->mfLogData.crc = pcinterface->crc;
+  pcinterface->mfStateBatch.address = PCINTERFACE_MSG_DESTADDR_PC;
+  pcinterface->mfStateBatch.function = PCINTERFACE_MSG_STATEBATCH_FUNCTION;
+  pcinterface->mfStateBatch.dataLen = PCINTERFACE_MSG_STATEBATCH_DATALEN;
+  pcinterface->mfStateBatch.bufferLen = PCINTERFACE_MSG_STATEBATCH_BUFFERLEN;
+  pcinterface->mfStateBatch.seq = 0U;
+  pcinterface->mfStateBatch.buffer = pcinterface->mfStateBatchBuffer;
+  pcinterface->stateBatchData = NULL;
+  pcinterface->stateBatchLen = 0U;
+  pcinterface->stateStream = NULL;
+  for (uint8_t i = 0U; i < PCINTERFACE_NUM_PORTS; ++i) {
+    pcinterface->linkStatsTelemetry[i].keyframePeriod = PCINTERFACE_MSG_STATEDELTA_KEYFRAME_PERIOD;
+    Telemetry_Init(&pcinterface->linkStatsTelemetry[i]);
+  }
+
   pcinterface->mfLogData.address = PCINTERFACE_MSG_DESTADDR_PC;
   pcinterface->mfLogData.function = PCINTERFACE_MSG_LOG_FUNCTION;
   pcinterface->mfLogData.dataLen = PCINTERFACE_MSG_LOG_DATALEN;
-  pcinterface->mfLogData.msgLen = PCINTERFACE_MSG_LOG_MSGLEN;
+  pcinterface->mfLogData.bufferLen = PCINTERFACE_MSG_LOG_BUFFERLEN;
+  pcinterface->mfLogData.seq = 0U;
   pcinterface->mfLogData.buffer = pcinterface->mfLogDataBuffer;
 
-  pcinterface->mfDebugEncode.crc = pcinterface->crc;
+  pcinterface->mfLogRecords.address = PCINTERFACE_MSG_DESTADDR_PC;
+  pcinterface->mfLogRecords.function = PCINTERFACE_MSG_LOGRECORDS_FUNCTION;
+  pcinterface->mfLogRecords.dataLen = 0; // variable length, just init to 0
+  pcinterface->mfLogRecords.bufferLen = PCINTERFACE_MSG_LOGRECORDS_BUFFERLEN;
+  pcinterface->mfLogRecords.seq = 0U;
+  pcinterface->mfLogRecords.buffer = pcinterface->mfLogRecordsBuffer;
+
   pcinterface->mfDebugEncode.address = PCINTERFACE_MSG_DESTADDR_PC;
   pcinterface->mfDebugEncode.function = PCINTERFACE_MSG_DEBUGTERM_FUNCTION;
   pcinterface->mfDebugEncode.dataLen = 0; // variable length, just init to 0
-  pcinterface->mfDebugEncode.msgLen = 0;
+  pcinterface->mfDebugEncode.bufferLen = PCINTERFACE_MSG_DEBUGTERM_BUFFERLEN;
+  pcinterface->mfDebugEncode.seq = 0U;
   pcinterface->mfDebugEncode.buffer = pcinterface->mfDebugEncodeBuffer;
 
-  // Setup message frame decoder
-  pcinterface->mfDecode.crc = pcinterface->crc;
-  pcinterface->mfDecode.msgLen = PCINTERFACE_MSG_COMMON_MSGLEN;
-  if (!MsgFrameDecode_Init(&pcinterface->mfDecode)) {
-    return PCINTERFACE_STATUS_ERROR_INIT;
-  }
+  pcinterface->mfBaudResponse.address = PCINTERFACE_MSG_DESTADDR_PC;
+  pcinterface->mfBaudResponse.function = PCINTERFACE_MSG_BAUD_RESPONSE_FUNCTION;
+  pcinterface->mfBaudResponse.dataLen = PCINTERFACE_MSG_BAUD_RESPONSE_DATALEN;
+  pcinterface->mfBaudResponse.bufferLen = PCINTERFACE_MSG_BAUD_RESPONSE_BUFFERLEN;
+  pcinterface->mfBaudResponse.seq = 0U;
+  pcinterface->mfBaudResponse.buffer = pcinterface->mfBaudResponseBuffer;
+
+  pcinterface->mfSubscribeResponse.address = PCINTERFACE_MSG_DESTADDR_PC;
+  pcinterface->mfSubscribeResponse.function = PCINTERFACE_MSG_SUBSCRIBE_RESPONSE_FUNCTION;
+  pcinterface->mfSubscribeResponse.dataLen = PCINTERFACE_MSG_SUBSCRIBE_RESPONSE_DATALEN;
+  pcinterface->mfSubscribeResponse.bufferLen = PCINTERFACE_MSG_SUBSCRIBE_RESPONSE_BUFFERLEN;
+  pcinterface->mfSubscribeResponse.seq = 0U;
+  pcinterface->mfSubscribeResponse.buffer = pcinterface->mfSubscribeResponseBuffer;
+
+  pcinterface->mfStreamBlock.address = PCINTERFACE_MSG_DESTADDR_PC;
+  pcinterface->mfStreamBlock.function = PCINTERFACE_MSG_STREAMBLOCK_FUNCTION;
+  pcinterface->mfStreamBlock.dataLen = 0; // variable length, just init to 0
+  pcinterface->mfStreamBlock.bufferLen = PCINTERFACE_MSG_STREAMBLOCK_BUFFERLEN;
+  pcinterface->mfStreamBlock.seq = 0U;
+  pcinterface->mfStreamBlock.buffer = pcinterface->mfStreamBlockBuffer;
+
+  // Vehicle state sent by default, until the PC subscribes to others
+  PCInterface_SubscribeInit(pcinterface);
 
   // init debug term
   pcinterface->debugterm.next = 0U;
@@ -178,21 +260,33 @@ PCInterface_Status_T PCInterface_Init(
     return PCINTERFACE_STATUS_ERROR_INIT;
   }
 
-  // Register to receive serial data
-  pcinterface->recvStreamHandle = xStreamBufferCreateStatic(
-      PCINTERFACE_RECV_STREAM_SIZE_BYTES,
-      PCINTERFACE_RECV_STREAM_TRIGGER_LEVEL_BYTES,
-      pcinterface->recvStreamStorage,
-      &pcinterface->recvStreamStruct);
-  if (UART_STATUS_OK != UART_SetRecvStream(pcinterface->uartA, pcinterface->recvStreamHandle)) {
-    return PCINTERFACE_STATUS_ERROR_INIT;
-  }
-  if (UART_STATUS_OK != UART_SetRecvStream(pcinterface->uartB, pcinterface->recvStreamHandle)) {
-    return PCINTERFACE_STATUS_ERROR_INIT;
+  // Register to receive serial data. Each port gets its own stream,
+  // message frame decoder and baud rate.
+  pcinterface->ports[0].uart = pcinterface->uartA;
+  pcinterface->ports[1].uart = pcinterface->uartB;
+  pcinterface->numPorts =
+      (pcinterface->uartA == pcinterface->uartB) ? 1U : PCINTERFACE_NUM_PORTS;
+  for (uint8_t i = 0U; i < pcinterface->numPorts; ++i) {
+    struct PCInterface_Port* port = &pcinterface->ports[i];
+
+    MsgFrameDecode_Init(&port->mfDecode);
+
+    port->recvStreamHandle = xStreamBufferCreateStatic(
+        PCINTERFACE_RECV_STREAM_SIZE_BYTES,
+        PCINTERFACE_RECV_STREAM_TRIGGER_LEVEL_BYTES,
+        port->recvStreamStorage,
+        &port->recvStreamStruct);
+    if (UART_STATUS_OK != UART_RegisterRecvStream(port->uart, port->recvStreamHandle)) {
+      return PCINTERFACE_STATUS_ERROR_INIT;
+    }
+
+    if (!PCInterface_BaudInit(port)) {
+      return PCINTERFACE_STATUS_ERROR_INIT;
+    }
   }
 
   REGISTER(pcinterface, PCINTERFACE_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "PCInterface_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_PCINTERFACE, LOGGING_LEVEL_DEBUG, "PCInterface_Init complete\n");
   return PCINTERFACE_STATUS_OK;
 }
 
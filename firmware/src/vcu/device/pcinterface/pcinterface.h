@@ -19,11 +19,12 @@
 #include "semphr.h"
 
 #include "depends/depends.h"
-#include "crc/crc.h"
 #include "gpio/gpio.h"
 #include "uart/uart.h"
 #include "uart/msgframeencode.h"
 #include "uart/msgframedecode.h"
+#include "telemetry/telemetry.h"
+#include "blockbuffer/blockbuffer.h"
 #include "vehicleInterface/vehicleState/vehicleState.h"
 #include "vehicleInterface/vehicleControl/vehicleControl.h"
 
@@ -44,18 +45,82 @@ typedef enum
 #define PCINTERFACE_RECV_STREAM_SIZE_BYTES 2048U
 #define PCINTERFACE_RECV_STREAM_TRIGGER_LEVEL_BYTES 1U
 
+#define PCINTERFACE_NUM_PORTS 2U /* uartA and uartB */
+#define PCINTERFACE_BAUD_MIN 9600U
+#define PCINTERFACE_BAUD_TIMEOUT_TICKS 100U /* 1s, to switch and be confirmed */
+#define PCINTERFACE_BAUD_REVERT_TICKS 10U /* 100ms, for tx to empty before reverting */
+
+#define PCINTERFACE_SUBSCRIBE_MAX_RATE 100U /* Hz, the rate of the task */
+#define PCINTERFACE_SUBSCRIBE_MAX_GROUPS 4U /* different rates subscribed */
+#define PCINTERFACE_SUBSCRIBE_MAX_FIELDS TELEMETRY_MAX_FIELDS /* per rate */
+
+typedef enum
+{
+  PCINTERFACE_FIELD_VALUE = 0U, // size bytes of vehicle state at offset
+  PCINTERFACE_FIELD_SDC,        // VehicleState_SDC_T at offset, as bits
+  PCINTERFACE_FIELD_PDM,        // VehicleState_GLV_T at offset, channel bits
+} PCInterface_FieldKind_T;
+
+// State field that can be subscribed to
+struct PCInterface_Field {
+  uint16_t fieldId; // PCCONTROLLER_FIELDID_ value
+  uint16_t offset;  // in VehicleState_Data_T
+  uint8_t size;     // bytes sent, 1 to 4
+  PCInterface_FieldKind_T kind;
+};
+
+// Fields subscribed at one rate. Each is its own telemetry stream, so a
+// tick only reads and sends the fields that are due.
+struct PCInterface_Subscription {
+  uint16_t period; // ticks between updates, 0 if unused
+  uint8_t numFields;
+  const struct PCInterface_Field* fields[PCINTERFACE_SUBSCRIBE_MAX_FIELDS];
+  Telemetry_T telemetry;
+};
+
 #define PCINTERFACE_DEBUGTERM_BUFLEN 64U
 struct PCInterface_DebugTerm {
   char buf[PCINTERFACE_DEBUGTERM_BUFLEN];
   uint16_t next;
 };
 
+typedef enum
+{
+  PCINTERFACE_BAUD_STATE_IDLE = 0U,   // Running at baudRate
+  PCINTERFACE_BAUD_STATE_SWITCHING,   // Accepted, switching once tx is idle
+  PCINTERFACE_BAUD_STATE_CONFIRMING,  // Switched, waiting for PC to confirm
+  PCINTERFACE_BAUD_STATE_REVERTING,   // Not confirmed, switching back
+} PCInterface_BaudState_T;
+
+// Baud rate negotiation state of a port
+struct PCInterface_Baud {
+  PCInterface_BaudState_T state;
+  uint32_t baudRate;    // current (confirmed) rate
+  uint32_t newBaudRate; // rate being switched to
+  uint32_t ticks;       // ticks since switch was accepted, or revert started
+};
+
+// State of one UART port. Each port has its own stream and decoder, so
+// frames arriving on both ports at once can't interleave.
+struct PCInterface_Port {
+  UART_Device_T uart;
+  struct PCInterface_Baud baud;
+
+  // Stream buffer objects for receiving uart bytes
+  uint8_t recvStreamStorage[PCINTERFACE_RECV_STREAM_SIZE_BYTES];
+  StaticStreamBuffer_t recvStreamStruct;
+  StreamBufferHandle_t recvStreamHandle;
+
+  // Message frame for decoding
+  MsgFrameDecode_T mfDecode;
+};
+
 typedef struct
 {
   UART_Device_T uartA;
   UART_Device_T uartB;
-  CRC_T* crc;
   GPIO_T* pinToggle; // toggled at process refresh rate
+  uint32_t maxBaudRate; // Max baud rate the PC may switch to (0 to disable)
 
   // ******* Internal use *******
   bool canDebugEnable; // TODO remove
@@ -71,6 +136,11 @@ typedef struct
   bool stateEnabled; // whether state pointer is set and ready
   bool controlEnabled; // whether control pointer is set and ready
 
+  // Channel stream, sent to the port that started it
+  BlockBuffer_T* channelStream; // NULL if not set
+  struct PCInterface_Port* streamPort; // NULL if not streaming
+  volatile bool streamTxBusy; // mfStreamBlockBuffer is being transmitted
+
   // Mutex lock
   SemaphoreHandle_t mutex;
   StaticSemaphore_t mutexBuffer;
@@ -85,21 +155,30 @@ typedef struct
   StaticStreamBuffer_t logStreamStruct;
   StreamBufferHandle_t logStreamHandle;
 
-  // Stream buffer objects for receiving uart bytes
-  uint8_t recvStreamStorage[PCINTERFACE_RECV_STREAM_SIZE_BYTES];
-  StaticStreamBuffer_t recvStreamStruct;
-  StreamBufferHandle_t recvStreamHandle;
+  // State for each port
+  struct PCInterface_Port ports[PCINTERFACE_NUM_PORTS];
+  uint8_t numPorts; // 1 if uartA and uartB are the same device
 
   // Message frames for encoding
-  MsgFrameEncode_T mfStateUpdate;
-  uint8_t mfStateUpdateBuffer[PCINTERFACE_MSG_STATEUPDATE_MSGLEN];
+  MsgFrameEncode_T mfStateBatch;
+  uint8_t mfStateBatchBuffer[PCINTERFACE_MSG_STATEBATCH_BUFFERLEN];
+  uint8_t* stateBatchData; // payload of the batch being built
+  uint16_t stateBatchLen; // bytes of fields in the batch
+  Telemetry_T* stateStream; // stream of the batch being built
+  Telemetry_T linkStatsTelemetry[PCINTERFACE_NUM_PORTS];
+  struct PCInterface_Subscription subscriptions[PCINTERFACE_SUBSCRIBE_MAX_GROUPS];
   MsgFrameEncode_T mfLogData;
-  uint8_t mfLogDataBuffer[PCINTERFACE_MSG_LOG_MSGLEN];
+  uint8_t mfLogDataBuffer[PCINTERFACE_MSG_LOG_BUFFERLEN];
+  MsgFrameEncode_T mfLogRecords;
+  uint8_t mfLogRecordsBuffer[PCINTERFACE_MSG_LOGRECORDS_BUFFERLEN];
   MsgFrameEncode_T mfDebugEncode;
   uint8_t mfDebugEncodeBuffer[PCINTERFACE_MSG_DEBUGTERM_BUFFERLEN];
-
-  // Message frame for decoding
-  MsgFrameDecode_T mfDecode;
+  MsgFrameEncode_T mfBaudResponse;
+  uint8_t mfBaudResponseBuffer[PCINTERFACE_MSG_BAUD_RESPONSE_BUFFERLEN];
+  MsgFrameEncode_T mfSubscribeResponse;
+  uint8_t mfSubscribeResponseBuffer[PCINTERFACE_MSG_SUBSCRIBE_RESPONSE_BUFFERLEN];
+  MsgFrameEncode_T mfStreamBlock;
+  uint8_t mfStreamBlockBuffer[PCINTERFACE_MSG_STREAMBLOCK_BUFFERLEN];
 
   REGISTERED_MODULE();
 } PCInterface_T;
@@ -139,4 +218,17 @@ PCInterface_Status_T PCInterface_SetVehicleControl(
     PCInterface_T* pcinterface,
     VehicleControl_T* control);
 
+/**
+ * @brief Sets the channel stream, which the PC can start and stop. Full
+ * blocks are sent to the PC while started.
+ *
+ * @param pcinterface PCInterface struct
+ * @param stream Stream, set up and initialized. The PC interface is its
+ * consumer.
+ * @return PCINTERFACE_STATUS_OK if successful
+ */
+PCInterface_Status_T PCInterface_SetChannelStream(
+    PCInterface_T* pcinterface,
+    BlockBuffer_T* stream);
+
 #endif // DEVICE_PCINTERFACE_PCINTERFACE_H_
@@ -3,6 +3,17 @@
  *
  * Implements logic for periodic messages
  *
+ * State fields are sent in batches, many fields to a frame, so each field
+ * costs its ID, size and value rather than a whole frame and CRC.
+ *
+ * Most fields barely change from one update to the next, so each group of
+ * fields is a telemetry stream (telemetry/telemetry.h): keyframe updates are
+ * state batches with every field, others are state deltas with only the
+ * fields that changed.
+ *
+ * Which vehicle state fields are sent, and how often, is subscribed to by the
+ * PC (subscriptions.c). A group of fields per rate.
+ *
  *  Created on: Dec 2 2022
  *      Author: Liam Flaherty
  */
@@ -16,152 +27,156 @@
 #include "uart/uart.h"
 
 #define COUNT_1HZ (uint32_t)100U
+// Link stats are sent half way between state updates, one port per tick, so
+// the messages don't all queue on the UART at once
+#define COUNT_LINKSTATS_OFFSET (uint32_t)50U
+
+extern bool PCInterface_BaudSwitchPending(PCInterface_T* pcinterface);
 
 /**
- * @brief Transmits a state field broadcast message
- * 
- * @param pcinterface 
- * @param fieldId 
- * @param fieldSize 
- * @param field 
+ * @brief Starts a new frame for the current update, a state batch if the
+ * update is a keyframe or a state delta if not
+ *
+ * @param pcinterface PCInterface object
  */
-static void sendStateField(
-    PCInterface_T* pcinterface,
-    const uint16_t fieldId,
-    const size_t fieldSize,
-    const uint32_t field)
+static void startStateFrame(PCInterface_T* pcinterface)
 {
-  if (fieldSize > 4) {
-    // state update message only supports 4 byte fields
-    return;
-  }
-
-  // Update message buffer contents
-  uint8_t* payload = MsgFrameEncode_InitFrame(&pcinterface->mfStateUpdate);
-  payload[0] = (uint8_t)((fieldId >> 8) & 0xFF);
-  payload[1] = (uint8_t)(fieldId & 0xFF);
-  payload[2] = (uint8_t)(fieldSize & 0xFF);
-  payload[3] = (uint8_t)((field >> 24) & 0xFF);
-  payload[4] = (uint8_t)((field >> 16) & 0xFF);
-  payload[5] = (uint8_t)((field >> 8) & 0xFF);
-  payload[6] = (uint8_t)(field & 0xFF);
-
-  MsgFrameEncode_UpdateCRC(&pcinterface->mfStateUpdate);
-
-  // Send to both interfaces
-  UART_SendMessage(
-      pcinterface->uartA,
-      pcinterface->mfStateUpdateBuffer,
-      PCINTERFACE_MSG_STATEUPDATE_MSGLEN);
-  UART_SendMessage(
-      pcinterface->uartB,
-      pcinterface->mfStateUpdateBuffer,
-      PCINTERFACE_MSG_STATEUPDATE_MSGLEN);
+  pcinterface->mfStateBatch.function = pcinterface->stateStream->keyframe
+      ? PCINTERFACE_MSG_STATEBATCH_FUNCTION
+      : PCINTERFACE_MSG_STATEDELTA_FUNCTION;
+  pcinterface->mfStateBatch.dataLen = PCINTERFACE_MSG_STATEBATCH_DATALEN;
+  pcinterface->stateBatchData = MsgFrameEncode_InitFrame(&pcinterface->mfStateBatch);
+  pcinterface->stateBatchLen = 0U;
 }
 
-static void sendStateFieldf(
-    PCInterface_T* pcinterface,
-    const uint16_t fieldId,
-    const float field)
+/**
+ * @brief Starts an update of a telemetry stream
+ *
+ * @param pcinterface PCInterface object
+ * @param stream Stream the fields added belong to
+ */
+static void beginStateBatch(PCInterface_T* pcinterface, Telemetry_T* stream)
 {
-  _Static_assert(sizeof(float) == sizeof(uint32_t), "impl assumes float is 32bits");
-
-  uint32_t fieldU32;
-  memcpy(&fieldU32, &field, sizeof(uint32_t));
-
-  sendStateField(pcinterface, fieldId, sizeof(uint32_t), fieldU32);
+  pcinterface->stateStream = stream;
+  Telemetry_Begin(stream);
+  startStateFrame(pcinterface);
 }
 
 /**
- * @brief Send SDC state data message
- * Not thread safe. Data must be a safe copy of state.
- * 
+ * @brief Transmits the state batch, if it has any fields, and starts the next
+ *
  * @param pcinterface PCInterface object
- * @param data Pointer to copy of state data.
  */
-static void sendStateSdc(
-    PCInterface_T* pcinterface,
-    VehicleState_SDC_T* data)
+static void sendStateBatch(PCInterface_T* pcinterface)
 {
-  uint8_t tmpSdc = 0;
-  tmpSdc |= (uint8_t)((data->bms & 0x1) << 0);
-  tmpSdc |= (uint8_t)((data->bspd & 0x1) << 1);
-  tmpSdc |= (uint8_t)((data->imd & 0x1) << 2);
-  tmpSdc |= (uint8_t)((data->out & 0x1) << 3);
-  sendStateField(
-      pcinterface,
-      PCCONTROLLER_FIELDID_SDC,
-      sizeof(tmpSdc), tmpSdc);
+  if (0U == pcinterface->stateBatchLen) {
+    return;
+  }
+
+  pcinterface->mfStateBatch.dataLen = pcinterface->stateBatchLen;
+  MsgFrameEncode_Finish(&pcinterface->mfStateBatch);
+
+  // Send to both interfaces
+  UART_Status_T statusA = UART_SendMessage(
+      pcinterface->uartA,
+      pcinterface->mfStateBatchBuffer,
+      pcinterface->mfStateBatch.msgLen);
+  UART_Status_T statusB = UART_SendMessage(
+      pcinterface->uartB,
+      pcinterface->mfStateBatchBuffer,
+      pcinterface->mfStateBatch.msgLen);
+  if (UART_STATUS_OK != statusA || UART_STATUS_OK != statusB) {
+    // PC has missed these values, resend them all next update
+    Telemetry_ForceKeyframe(pcinterface->stateStream);
+  }
+
+  startStateFrame(pcinterface);
 }
 
 /**
- * @brief Send PDM state data message
- * Not thread safe. Data must be a safe copy of state.
+ * @brief Adds a state field to the update, if it needs sending. The frame is
+ * sent first if the field might not fit.
  * 
  * @param pcinterface PCInterface object
- * @param data Pointer to copy of state data.
+ * @param fieldId PCCONTROLLER_FIELDID_ value
+ * @param fieldSize Bytes of field to send, 1 to 4
+ * @param field Value, in the low fieldSize bytes
  */
-static void sendStatePdm(
+static void addStateField(
     PCInterface_T* pcinterface,
-    VehicleState_GLV_T* data)
+    const uint16_t fieldId,
+    const size_t fieldSize,
+    const uint32_t field)
 {
-  _Static_assert(VEHICLESTATE_MAXPDM_CHANNELS <= 8, "Can't fit >8 channels in uint8_t");
+  if (fieldSize > 4 || 0U == fieldSize) {
+    // state batch only supports up to 4 byte fields
+    return;
+  }
 
-  uint8_t tmpPdm = 0;
-  for (uint8_t i = 0; i < 6; ++i) {
-    tmpPdm |= (uint8_t)((data->pdmChState[i] & 0x1) << i);
+  if (pcinterface->stateBatchLen + TELEMETRY_FIELD_MAX_LEN > PCINTERFACE_MSG_STATEBATCH_DATALEN) {
+    sendStateBatch(pcinterface);
   }
 
-  sendStateField(
-      pcinterface,
-      PCCONTROLLER_FIELDID_PDM,
-      sizeof(tmpPdm), tmpPdm);
+  const uint16_t len = Telemetry_EncodeField(
+      pcinterface->stateStream,
+      pcinterface->stateBatchData + pcinterface->stateBatchLen,
+      fieldId, (uint8_t)fieldSize, field);
+  pcinterface->stateBatchLen = (uint16_t)(pcinterface->stateBatchLen + len);
 }
 
 /**
- * @brief Send battery state data messages.
- * Not thread safe. Data must be a safe copy of state.
- * 
- * @param pcinterface PCInterface object
- * @param data Pointer to copy of state data.
+ * @brief Reads a subscribed field from the vehicle state.
+ * Vehicle state must be locked.
+ *
+ * @param field Field to read
+ * @param data Vehicle state data
+ * @return Value, in the low field->size bytes
  */
-static void sendStateBattery(
-    PCInterface_T* pcinterface,
-    VehicleState_Battery_T* data)
+static uint32_t readField(
+    const struct PCInterface_Field* field,
+    const VehicleState_Data_T* data)
 {
-  _Static_assert(sizeof(float) <= 4, "float size");
-
-  sendStateFieldf(pcinterface,
-      PCCONTROLLER_FIELDID_BATTERY_MAXCELLVOLT,
-      data->maxCellVoltage);
-  sendStateField(pcinterface,
-      PCCONTROLLER_FIELDID_BATTERY_MAXCELLVOLTID,
-      sizeof(data->maxCellVoltageCellID), data->maxCellVoltageCellID);
-  sendStateFieldf(pcinterface,
-      PCCONTROLLER_FIELDID_BATTERY_MAXCELLTEMP,
-      data->maxCellTemperature);
-  sendStateField(pcinterface,
-      PCCONTROLLER_FIELDID_BATTERY_MAXCELLTEMPID,
-      sizeof(data->minCellTemperatureCellID), data->minCellTemperatureCellID);
-  sendStateFieldf(pcinterface,
-      PCCONTROLLER_FIELDID_BATTERY_DCCURRENT,
-      data->dcCurrent);
-  sendStateFieldf(pcinterface,
-      PCCONTROLLER_FIELDID_BATTERY_DCVOLTAGE,
-      data->dcVoltage);
-  sendStateFieldf(pcinterface,
-      PCCONTROLLER_FIELDID_BATTERY_SOC,
-      data->stateOfCarge);
-  sendStateField(pcinterface,
-      PCCONTROLLER_FIELDID_BATTERY_COUNTER,
-      sizeof(data->bmsCounter), data->bmsCounter);
-  sendStateField(pcinterface,
-      PCCONTROLLER_FIELDID_BMS_FAULTINDICATOR,
-      sizeof(data->bmsFaultIndicator), data->bmsFaultIndicator);
+  const uint8_t* src = (const uint8_t*)data + field->offset;
+
+  if (PCINTERFACE_FIELD_SDC == field->kind) {
+    const VehicleState_SDC_T* sdc = (const VehicleState_SDC_T*)src;
+    uint32_t bits = 0U;
+    bits |= (uint32_t)(sdc->bms & 0x1) << 0;
+    bits |= (uint32_t)(sdc->bspd & 0x1) << 1;
+    bits |= (uint32_t)(sdc->imd & 0x1) << 2;
+    bits |= (uint32_t)(sdc->out & 0x1) << 3;
+    return bits;
+  }
+  if (PCINTERFACE_FIELD_PDM == field->kind) {
+    _Static_assert(VEHICLESTATE_MAXPDM_CHANNELS <= 8, "Can't fit >8 channels in uint8_t");
+    const VehicleState_GLV_T* glv = (const VehicleState_GLV_T*)src;
+    uint32_t bits = 0U;
+    for (uint8_t i = 0; i < 6; ++i) {
+      bits |= (uint32_t)(glv->pdmChState[i] & 0x1) << i;
+    }
+    return bits;
+  }
+
+  // Floats are sent as their bits
+  uint8_t value8;
+  uint16_t value16;
+  uint32_t value32;
+  switch (field->size) {
+    case sizeof(uint8_t):
+      memcpy(&value8, src, sizeof(value8));
+      return value8;
+    case sizeof(uint16_t):
+      memcpy(&value16, src, sizeof(value16));
+      return value16;
+    default:
+      memcpy(&value32, src, sizeof(value32));
+      return value32;
+  }
 }
 
 /**
- * @brief At 1Hz, transmit internal state
+ * @brief Transmit the subscribed state fields that are due this tick.
+ * Each rate is its own state batch or delta.
  * 
  * @param pcinterface 
  */
@@ -172,21 +187,107 @@ static void periodicStateUpdate(PCInterface_T* pcinterface)
     return;
   }
 
-  // Periodic task runs at 100Hz, but only want to tx the state at 1Hz
-  if (pcinterface->counter % COUNT_1HZ != 0U) {
+  // Read only the fields that are due, rather than copying the whole state
+  // (Don't hold a lock on the vehicle state just to transmit this data)
+  uint32_t values[PCINTERFACE_SUBSCRIBE_MAX_GROUPS][PCINTERFACE_SUBSCRIBE_MAX_FIELDS];
+  bool due[PCINTERFACE_SUBSCRIBE_MAX_GROUPS] = { false };
+  bool anyDue = false;
+  for (uint8_t g = 0U; g < PCINTERFACE_SUBSCRIBE_MAX_GROUPS; ++g) {
+    const struct PCInterface_Subscription* group = &pcinterface->subscriptions[g];
+    due[g] = (0U != group->period) && (0U == pcinterface->counter % group->period);
+    anyDue = anyDue || due[g];
+  }
+  if (!anyDue) {
     return;
   }
 
-  // Create a copy of the internal state
-  // (Don't hold a lock on the vehicle state just to transmit this data)
-  VehicleState_Data_T data;
-  if (!VehicleState_CopyState(pcinterface->state, &data)) {
+  if (!VehicleState_AccessAcquire(pcinterface->state)) {
     return;
   }
+  for (uint8_t g = 0U; g < PCINTERFACE_SUBSCRIBE_MAX_GROUPS; ++g) {
+    const struct PCInterface_Subscription* group = &pcinterface->subscriptions[g];
+    for (uint8_t i = 0U; due[g] && i < group->numFields; ++i) {
+      values[g][i] = readField(group->fields[i], &pcinterface->state->data);
+    }
+  }
+  VehicleState_AccessRelease(pcinterface->state);
 
-  sendStateSdc(pcinterface, &data.vehicle.sdc);
-  sendStatePdm(pcinterface, &data.glv);
-  sendStateBattery(pcinterface, &data.battery);
+  for (uint8_t g = 0U; g < PCINTERFACE_SUBSCRIBE_MAX_GROUPS; ++g) {
+    struct PCInterface_Subscription* group = &pcinterface->subscriptions[g];
+    if (!due[g]) {
+      continue;
+    }
+
+    beginStateBatch(pcinterface, &group->telemetry);
+    for (uint8_t i = 0U; i < group->numFields; ++i) {
+      addStateField(pcinterface,
+          group->fields[i]->fieldId,
+          group->fields[i]->size,
+          values[g][i]);
+    }
+    sendStateBatch(pcinterface);
+  }
+}
+
+/**
+ * @brief Send link statistics for one UART port, a telemetry stream per port
+ *
+ * @param pcinterface PCInterface object
+ * @param port Port index, 0 for uartA
+ * @param uart UART device to report
+ * @param fieldIdBase Field ID of the first statistic for this port
+ */
+static void sendLinkStats(
+    PCInterface_T* pcinterface,
+    uint8_t port,
+    UART_Device_T uart,
+    uint16_t fieldIdBase)
+{
+  UART_Stats_T stats;
+  if (UART_STATUS_OK != UART_GetStats(uart, &stats)) {
+    return;
+  }
+
+  const struct {
+    uint16_t fieldId;
+    uint32_t value;
+  } fields[] = {
+    { PCCONTROLLER_FIELDID_UART_RXBYTES, stats.rxBytes },
+    { PCCONTROLLER_FIELDID_UART_TXBYTES, stats.txBytes },
+    { PCCONTROLLER_FIELDID_UART_OVERRUNERRORS, stats.overrunErrors },
+    { PCCONTROLLER_FIELDID_UART_FRAMINGERRORS, stats.framingErrors },
+    { PCCONTROLLER_FIELDID_UART_NOISEERRORS, stats.noiseErrors },
+    { PCCONTROLLER_FIELDID_UART_PARITYERRORS, stats.parityErrors },
+    { PCCONTROLLER_FIELDID_UART_DMAERRORS, stats.dmaErrors },
+    { PCCONTROLLER_FIELDID_UART_RXOVERFLOW, stats.rxOverflowBytes },
+    { PCCONTROLLER_FIELDID_UART_TXDROPPED, stats.txDroppedBytes },
+    { PCCONTROLLER_FIELDID_UART_TXFULL, stats.txFullBytes },
+    { PCCONTROLLER_FIELDID_UART_TXBACKLOGPEAK, stats.txBacklogPeak },
+    { PCCONTROLLER_FIELDID_UART_TXCHAINPEAK, stats.txChainPeak },
+  };
+
+  beginStateBatch(pcinterface, &pcinterface->linkStatsTelemetry[port]);
+  for (size_t i = 0U; i < sizeof(fields) / sizeof(fields[0]); ++i) {
+    addStateField(pcinterface,
+        (uint16_t)(fieldIdBase + fields[i].fieldId),
+        sizeof(uint32_t), fields[i].value);
+  }
+  sendStateBatch(pcinterface);
+}
+
+/**
+ * @brief At 1Hz, transmit UART link statistics
+ *
+ * @param pcinterface
+ */
+static void periodicLinkStats(PCInterface_T* pcinterface)
+{
+  const uint32_t tick = pcinterface->counter % COUNT_1HZ;
+  if (COUNT_LINKSTATS_OFFSET == tick) {
+    sendLinkStats(pcinterface, 0U, pcinterface->uartA, PCCONTROLLER_FIELDID_UARTA_BASE);
+  } else if (COUNT_LINKSTATS_OFFSET + 1U == tick) {
+    sendLinkStats(pcinterface, 1U, pcinterface->uartB, PCCONTROLLER_FIELDID_UARTB_BASE);
+  }
 }
 
 /**
@@ -196,5 +297,12 @@ static void periodicStateUpdate(PCInterface_T* pcinterface)
  */
 void PCInterface_HandlePeriodic(PCInterface_T* pcinterface)
 {
+  // Updates are skipped while a port needs its transmit queue to empty to
+  // switch baud rate. Deltas continue from the last update sent.
+  if (PCInterface_BaudSwitchPending(pcinterface)) {
+    return;
+  }
+
   periodicStateUpdate(pcinterface);
+  periodicLinkStats(pcinterface);
 }
@@ -9,13 +9,6 @@
 
 #include "pcinterface.h"
 
-#include <stdio.h> /* for snprintf */
-
-#define BATCH_RECV_SIZE 8U
-
-#define PAYLOAD_OFFSET 5U
-#define HEADER_PADDING 11U /* Number of message bytes that aren't payload */
-
 /**
  * @brief Method used to pass data to debug terminal.
  * 
@@ -28,6 +21,38 @@ extern void PCInterface_DebugTermRecv(
     uint8_t* payloadBytes,
     uint16_t nBytes);
 
+/**
+ * @brief Baud rate switch handlers (see baudrate.c)
+ */
+extern void PCInterface_BaudRequest(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint8_t* payloadBytes,
+    uint16_t nBytes);
+extern void PCInterface_BaudConfirm(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint8_t* payloadBytes,
+    uint16_t nBytes);
+
+/**
+ * @brief State field subscription handler (see subscriptions.c)
+ */
+extern void PCInterface_SubscribeRequest(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint8_t* payloadBytes,
+    uint16_t nBytes);
+
+/**
+ * @brief Channel stream handler (see stream.c)
+ */
+extern void PCInterface_StreamRequest(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint8_t* payloadBytes,
+    uint16_t nBytes);
+
 
 static void handleMsgTestSdc(
     PCInterface_T* pcinterface,
@@ -41,10 +66,8 @@ static void handleMsgTestSdc(
   bool sdcAssert = !!payloadBytes[7];
   VehicleControl_SetECUError(pcinterface->control, sdcAssert);
 
-  // Construct log message
-  char buf[64] = { 0 };
-  snprintf(buf, 64, "Test command executed: set SDC ECU error to %u\n", sdcAssert);
-  Log_Print(pcinterface->log, buf);
+  Log_Info(pcinterface->log, LOGGING_MODULE_PCINTERFACE,
+      "Test command executed: set SDC ECU error to %u\n", sdcAssert);
 }
 
 static void handleMsgTestPdm(
@@ -61,44 +84,32 @@ static void handleMsgTestPdm(
     pdmReqeusts[i] = !!payloadBytes[i + 2];
   }
 
-  Log_Print(pcinterface->log, "Test command executed: set PDM states to\n");
+  Log_Info(pcinterface->log, LOGGING_MODULE_PCINTERFACE,
+      "Test command executed: set PDM states to\n");
   for (uint8_t i = 0U; i < 6; ++i) {
     VehicleControl_SetPowerChannel(pcinterface->control, i, pdmReqeusts[i]);
-
-    char buf[32] = { 0 };
-    snprintf(buf, 32, "  PDM channel %u: %u\n", i, pdmReqeusts[i]);
-    Log_Print(pcinterface->log, buf);
+    Log_Info(pcinterface->log, LOGGING_MODULE_PCINTERFACE,
+        "  PDM channel %u: %u\n", i, pdmReqeusts[i]);
   }
 }
 
 static void handleMessage(
     PCInterface_T* pcinterface, 
-    uint8_t* bytes,
-    uint16_t nBytes)
+    struct PCInterface_Port* port,
+    const MsgFrameDecode_Msg_T* msg)
 {
   if (!pcinterface->controlEnabled) {
     // PCInterface_SetVehicleControl hasn't been called yet
     return;
   }
-  if (nBytes != PCINTERFACE_MSG_COMMON_MSGLEN) {
+  if (msg->address != PCINTERFACE_MSG_DESTADDR_VCU) {
     return;
   }
 
-  uint16_t targetAddr = 0U;
-  targetAddr |= (uint16_t)((bytes[1] & 0xff) << 8);
-  targetAddr |= (uint16_t)(bytes[2] & 0xff);
-  if (targetAddr != PCINTERFACE_MSG_DESTADDR_VCU) {
-    return;
-  }
-
-  uint16_t function = 0U;
-  function |= (uint16_t)((bytes[3] & 0xff) << 8);
-  function |= (uint16_t)(bytes[4] & 0xff);
-
-  uint8_t* payload = bytes + PAYLOAD_OFFSET;
-  uint16_t payloadLen = nBytes - (uint16_t)HEADER_PADDING;
+  uint8_t* payload = msg->data;
+  uint16_t payloadLen = msg->dataLen;
 
-  switch (function) {
+  switch (msg->function) {
     case PCINTERFACE_MSG_DEBUG_TERMINAL:
       PCInterface_DebugTermRecv(pcinterface, payload, payloadLen);
       break;
@@ -110,6 +121,22 @@ static void handleMessage(
     case PCINTERFACE_MSG_TESTCMD_PDM_FUNCTION:
       handleMsgTestPdm(pcinterface, payload, payloadLen);
       break;
+
+    case PCINTERFACE_MSG_BAUD_REQUEST_FUNCTION:
+      PCInterface_BaudRequest(pcinterface, port, payload, payloadLen);
+      break;
+
+    case PCINTERFACE_MSG_BAUD_CONFIRM_FUNCTION:
+      PCInterface_BaudConfirm(pcinterface, port, payload, payloadLen);
+      break;
+
+    case PCINTERFACE_MSG_SUBSCRIBE_FUNCTION:
+      PCInterface_SubscribeRequest(pcinterface, port, payload, payloadLen);
+      break;
+
+    case PCINTERFACE_MSG_STREAM_FUNCTION:
+      PCInterface_StreamRequest(pcinterface, port, payload, payloadLen);
+      break;
     
     default:
       // do nothing
@@ -117,33 +144,39 @@ static void handleMessage(
   }
 }
 
-void PCInterface_HandleRequests(PCInterface_T* pcinterface)
+/**
+ * @brief Decodes and handles all messages received on one port
+ *
+ * @param pcinterface PCInterface struct
+ * @param port Receive port
+ */
+static void handlePortRequests(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port)
 {
-  uint8_t recvBytes[BATCH_RECV_SIZE] = { 0 };
-  while (!xStreamBufferIsEmpty(pcinterface->recvStreamHandle)) {
+  while (!xStreamBufferIsEmpty(port->recvStreamHandle)) {
+    // Receive straight into the decoder. It is empty here, as RecvMsg below
+    // decodes everything, so this is the whole buffer or up to its end.
+    uint16_t space = 0U;
+    uint8_t* recvBytes = MsgFrameDecode_GetWriteSpace(&port->mfDecode, &space);
     uint16_t nRecv = (uint16_t)xStreamBufferReceive(
-        pcinterface->recvStreamHandle,
-        &recvBytes,
-        BATCH_RECV_SIZE,
+        port->recvStreamHandle,
+        recvBytes,
+        space,
         0U); // Don't block
+    MsgFrameDecode_CommitBytes(&port->mfDecode, nRecv);
 
-    bool succ = MsgFrameDecode_RecvBytes(
-        &pcinterface->mfDecode, 
-        recvBytes,
-        nRecv);
-
-    if (succ) {
-      size_t offset = 0U;
-      bool msgDecoded = MsgFrameDecode_RecvMsg(
-          &pcinterface->mfDecode,
-          &offset);
-      if (msgDecoded) {
-        // By here, a message with a valid length & CRC has been received
-        handleMessage(
-            pcinterface,
-            pcinterface->mfDecode.data + offset,
-            pcinterface->mfDecode.msgLen);
-      }
+    MsgFrameDecode_Msg_T msg;
+    while (MsgFrameDecode_RecvMsg(&port->mfDecode, &msg)) {
+      // By here, a message with a valid length & CRC has been received
+      handleMessage(pcinterface, port, &msg);
     }
   }
 }
+
+void PCInterface_HandleRequests(PCInterface_T* pcinterface)
+{
+  for (uint8_t i = 0U; i < pcinterface->numPorts; ++i) {
+    handlePortRequests(pcinterface, &pcinterface->ports[i]);
+  }
+}
@@ -0,0 +1,124 @@
+/*
+ * stream.c
+ *
+ * Sends the channel stream to the PC.
+ *
+ * The PC starts the stream on a port, and full blocks are sent to that port
+ * only. Each block is one large frame, transmitted straight from the encode
+ * buffer rather than copied into the UART transmit pool, so blocks don't
+ * crowd out logs and state updates. While the frame is being transmitted,
+ * blocks wait in the stream. When the link is too slow for the stream, the
+ * stream fills up and drops samples (see blockbuffer/blockbuffer.h).
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "pcinterface.h"
+
+#include <string.h>
+
+extern bool PCInterface_BaudSwitchPending(PCInterface_T* pcinterface);
+
+/**
+ * @brief Called from the UART transmit complete interrupt once the block
+ * frame isn't used
+ */
+static void streamTxDone(void* context, const uint8_t* data, uint16_t len, bool sent)
+{
+  (void)data;
+  (void)len;
+  (void)sent;
+  PCInterface_T* pcinterface = (PCInterface_T*)context;
+  pcinterface->streamTxBusy = false;
+}
+
+/**
+ * @brief Block sink, sends a block as one frame to the stream port
+ * @return false if the last block frame is still being transmitted
+ */
+static bool sendStreamBlock(void* context, const uint8_t* block, uint16_t len)
+{
+  PCInterface_T* pcinterface = (PCInterface_T*)context;
+  if (pcinterface->streamTxBusy || len > PCINTERFACE_MSG_STREAMBLOCK_DATALEN) {
+    return false;
+  }
+
+  pcinterface->mfStreamBlock.dataLen = len;
+  memcpy(MsgFrameEncode_InitFrame(&pcinterface->mfStreamBlock), block, len);
+  MsgFrameEncode_Finish(&pcinterface->mfStreamBlock);
+
+  // Busy before queuing, the callback can run before UART_Transmit returns
+  pcinterface->streamTxBusy = true;
+  UART_Status_T status = UART_Transmit(
+      pcinterface->streamPort->uart,
+      pcinterface->mfStreamBlockBuffer,
+      pcinterface->mfStreamBlock.msgLen,
+      streamTxDone,
+      pcinterface);
+  if (UART_STATUS_OK != status && UART_STATUS_ERROR_TX != status) {
+    // Not queued, so the callback won't be called. Try again next time.
+    pcinterface->streamTxBusy = false;
+    return false;
+  }
+  // A block that failed to transmit is lost, like a frame lost on the link
+  return true;
+}
+
+// ------------------- Public methods -------------------
+/**
+ * @brief Sends full blocks of the channel stream, if started
+ *
+ * @param pcinterface PCInterface struct
+ */
+void PCInterface_StreamFlush(PCInterface_T* pcinterface)
+{
+  // Blocks also wait while a port needs its transmit queue to empty to
+  // switch baud rate
+  if (NULL == pcinterface->streamPort || PCInterface_BaudSwitchPending(pcinterface)) {
+    return;
+  }
+
+  BlockBuffer_Flush(pcinterface->channelStream, sendStreamBlock, pcinterface);
+}
+
+/**
+ * @brief Handles a stream request from the PC, which starts or stops the
+ * channel stream
+ *
+ * @param pcinterface PCInterface struct
+ * @param port Port the request was received on, which the stream is sent on
+ * @param payloadBytes Message payload
+ * @param nBytes Length of payloadBytes
+ */
+void PCInterface_StreamRequest(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint8_t* payloadBytes,
+    uint16_t nBytes)
+{
+  if (nBytes != PCINTERFACE_MSG_COMMON_DATALEN || NULL == pcinterface->channelStream) {
+    return;
+  }
+
+  if (0U != payloadBytes[0]) {
+    pcinterface->streamPort = port;
+    BlockBuffer_Start(pcinterface->channelStream);
+  } else {
+    BlockBuffer_Stop(pcinterface->channelStream);
+    pcinterface->streamPort = NULL;
+  }
+}
+
+PCInterface_Status_T PCInterface_SetChannelStream(
+    PCInterface_T* pcinterface,
+    BlockBuffer_T* stream)
+{
+  if (NULL == stream) {
+    return PCINTERFACE_STATUS_ERROR_DEPENDS;
+  }
+
+  pcinterface->channelStream = stream;
+
+  return PCINTERFACE_STATUS_OK;
+}
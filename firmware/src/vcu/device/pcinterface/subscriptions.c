@@ -0,0 +1,259 @@
+/*
+ * subscriptions.c
+ *
+ * Implements PC subscriptions to state fields.
+ *
+ * The PC subscribes to a field at a rate from 1 to
+ * PCINTERFACE_SUBSCRIBE_MAX_RATE Hz (or 0 to stop it). Fields are grouped by
+ * their period in ticks of the task, so each tick only reads the groups that
+ * are due (see periodicupdates.c). Rates that don't divide the task rate are
+ * sent at the nearest whole period under, e.g. 3Hz is sent every 33 ticks.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "pcinterface.h"
+
+#include <stddef.h>
+
+#include "fieldId.h"
+
+extern bool PCInterface_BaudTxHeld(const struct PCInterface_Port* port);
+
+#define STATE_FIELD(id, member) \
+  { (id), (uint16_t)offsetof(VehicleState_Data_T, member), \
+    (uint8_t)sizeof(((VehicleState_Data_T*)0)->member), PCINTERFACE_FIELD_VALUE }
+#define STATE_FIELD_BITS(id, member, kind) \
+  { (id), (uint16_t)offsetof(VehicleState_Data_T, member), 1U, (kind) }
+
+// Every field the PC can subscribe to
+static const struct PCInterface_Field mFields[] = {
+  STATE_FIELD_BITS(PCCONTROLLER_FIELDID_SDC, vehicle.sdc, PCINTERFACE_FIELD_SDC),
+  STATE_FIELD_BITS(PCCONTROLLER_FIELDID_PDM, glv, PCINTERFACE_FIELD_PDM),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_MAXCELLVOLT, battery.maxCellVoltage),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_MAXCELLVOLTID, battery.maxCellVoltageCellID),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_MAXCELLTEMP, battery.maxCellTemperature),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_MAXCELLTEMPID, battery.maxCellTemperatureCellID),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_DCCURRENT, battery.dcCurrent),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_DCVOLTAGE, battery.dcVoltage),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_SOC, battery.stateOfCarge),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_COUNTER, battery.bmsCounter),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BMS_FAULTINDICATOR, battery.bmsFaultIndicator),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_MINCELLVOLT, battery.minCellVoltage),
+  STATE_FIELD(PCCONTROLLER_FIELDID_BATTERY_MINCELLTEMP, battery.minCellTemperature),
+  STATE_FIELD(PCCONTROLLER_FIELDID_INPUT_ACCEL, inputs.accel),
+  STATE_FIELD(PCCONTROLLER_FIELDID_INPUT_BRAKEFRONT, inputs.brakePresFront),
+  STATE_FIELD(PCCONTROLLER_FIELDID_INPUT_BRAKEREAR, inputs.brakePresRear),
+  STATE_FIELD(PCCONTROLLER_FIELDID_WHEELSPEED_FRONT, vehicle.wheelspeed.wheelspeedFront),
+  STATE_FIELD(PCCONTROLLER_FIELDID_WHEELSPEED_REAR, vehicle.wheelspeed.wheelspeedRear),
+  STATE_FIELD(PCCONTROLLER_FIELDID_MOTOR_TEMPERATURE, motor.temperature),
+  STATE_FIELD(PCCONTROLLER_FIELDID_MOTOR_SPEED, motor.speed),
+  STATE_FIELD(PCCONTROLLER_FIELDID_MOTOR_TORQUE, motor.calculatedTorque),
+  STATE_FIELD(PCCONTROLLER_FIELDID_INVERTER_DCBUSVOLTAGE, inverter.dcBusVoltage),
+  STATE_FIELD(PCCONTROLLER_FIELDID_INVERTER_DCBUSCURRENT, inverter.dcBusCurrent),
+  STATE_FIELD(PCCONTROLLER_FIELDID_INVERTER_TORQUECMD, inverter.commandedTorque),
+  STATE_FIELD(PCCONTROLLER_FIELDID_INVERTER_VSMSTATE, inverter.vsmState),
+  STATE_FIELD(PCCONTROLLER_FIELDID_INVERTER_RUNFAULTS, inverter.runFaults),
+};
+#define NUM_FIELDS (sizeof(mFields) / sizeof(mFields[0]))
+
+// Sent at 1Hz from startup: the first 11 fields of the table
+#define NUM_DEFAULT_FIELDS 11U
+#define DEFAULT_RATE 1U
+
+_Static_assert(NUM_DEFAULT_FIELDS <= PCINTERFACE_SUBSCRIBE_MAX_FIELDS, "Default fields fit in a group");
+
+/**
+ * @brief Finds a field of the table
+ * @return The field, or NULL if there is no such field
+ */
+static const struct PCInterface_Field* findField(uint16_t fieldId)
+{
+  for (size_t i = 0U; i < NUM_FIELDS; ++i) {
+    if (fieldId == mFields[i].fieldId) {
+      return &mFields[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Finds the group a field is subscribed in
+ *
+ * @param index Set to the index of the field in the group
+ * @return The group, or NULL if the field isn't subscribed
+ */
+static struct PCInterface_Subscription* findSubscribed(
+    PCInterface_T* pcinterface,
+    const struct PCInterface_Field* field,
+    uint8_t* index)
+{
+  for (uint8_t g = 0U; g < PCINTERFACE_SUBSCRIBE_MAX_GROUPS; ++g) {
+    struct PCInterface_Subscription* group = &pcinterface->subscriptions[g];
+    for (uint8_t i = 0U; i < group->numFields; ++i) {
+      if (field == group->fields[i]) {
+        *index = i;
+        return group;
+      }
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Finds the group for a period, or a free group to use for it
+ * @return The group, or NULL if all groups are used by other periods
+ */
+static struct PCInterface_Subscription* findGroup(
+    PCInterface_T* pcinterface,
+    uint16_t period)
+{
+  struct PCInterface_Subscription* unused = NULL;
+  for (uint8_t g = 0U; g < PCINTERFACE_SUBSCRIBE_MAX_GROUPS; ++g) {
+    struct PCInterface_Subscription* group = &pcinterface->subscriptions[g];
+    if (period == group->period) {
+      return group;
+    }
+    if (0U == group->period && NULL == unused) {
+      unused = group;
+    }
+  }
+  return unused;
+}
+
+/**
+ * @brief Restarts the telemetry stream of a group, after its fields changed.
+ * The next update of the group is a keyframe.
+ */
+static void restartGroup(struct PCInterface_Subscription* group)
+{
+  group->telemetry.keyframePeriod = PCINTERFACE_MSG_STATEDELTA_KEYFRAME_PERIOD;
+  Telemetry_Init(&group->telemetry);
+}
+
+/**
+ * @brief Subscribes to a field
+ *
+ * @param pcinterface PCInterface struct
+ * @param fieldId PCCONTROLLER_FIELDID_ value
+ * @param rate Hz, 0 to unsubscribe
+ * @return PCINTERFACE_SUBSCRIBE_ status
+ */
+static uint8_t subscribe(PCInterface_T* pcinterface, uint16_t fieldId, uint8_t rate)
+{
+  const struct PCInterface_Field* field = findField(fieldId);
+  if (NULL == field) {
+    return PCINTERFACE_SUBSCRIBE_UNKNOWNFIELD;
+  }
+  if (rate > PCINTERFACE_SUBSCRIBE_MAX_RATE) {
+    return PCINTERFACE_SUBSCRIBE_BADRATE;
+  }
+
+  const uint16_t period = (uint16_t)((0U == rate)
+      ? 0U
+      : PCINTERFACE_SUBSCRIBE_MAX_RATE / rate);
+  uint8_t index = 0U;
+  struct PCInterface_Subscription* from = findSubscribed(pcinterface, field, &index);
+  if (NULL != from && period == from->period) {
+    return PCINTERFACE_SUBSCRIBE_OK;
+  }
+
+  struct PCInterface_Subscription* to = NULL;
+  if (0U != period) {
+    to = findGroup(pcinterface, period);
+    if (NULL == to || to->numFields >= PCINTERFACE_SUBSCRIBE_MAX_FIELDS) {
+      return PCINTERFACE_SUBSCRIBE_FULL;
+    }
+  }
+
+  if (NULL != from) {
+    from->numFields--;
+    for (uint8_t i = index; i < from->numFields; ++i) {
+      from->fields[i] = from->fields[i + 1U];
+    }
+    if (0U == from->numFields) {
+      from->period = 0U;
+    }
+    restartGroup(from);
+  }
+
+  if (NULL != to) {
+    if (0U == to->numFields) {
+      to->period = period;
+    }
+    to->fields[to->numFields++] = field;
+    restartGroup(to);
+  }
+  return PCINTERFACE_SUBSCRIBE_OK;
+}
+
+/**
+ * @brief Sends a subscribe response on one port only
+ */
+static void sendSubscribeResponse(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint16_t fieldId,
+    uint8_t rate,
+    uint8_t status)
+{
+  if (PCInterface_BaudTxHeld(port)) {
+    return;
+  }
+
+  uint8_t* payload = MsgFrameEncode_InitFrame(&pcinterface->mfSubscribeResponse);
+  payload[0] = (uint8_t)((fieldId >> 8) & 0xFF);
+  payload[1] = (uint8_t)(fieldId & 0xFF);
+  payload[2] = rate;
+  payload[3] = status;
+  MsgFrameEncode_Finish(&pcinterface->mfSubscribeResponse);
+
+  UART_SendMessage(
+      port->uart,
+      pcinterface->mfSubscribeResponseBuffer,
+      pcinterface->mfSubscribeResponse.msgLen);
+}
+
+// ------------------- Public methods -------------------
+/**
+ * @brief Clears all subscriptions, then subscribes to the default fields
+ *
+ * @param pcinterface PCInterface struct
+ */
+void PCInterface_SubscribeInit(PCInterface_T* pcinterface)
+{
+  for (uint8_t g = 0U; g < PCINTERFACE_SUBSCRIBE_MAX_GROUPS; ++g) {
+    pcinterface->subscriptions[g].period = 0U;
+    pcinterface->subscriptions[g].numFields = 0U;
+    restartGroup(&pcinterface->subscriptions[g]);
+  }
+
+  for (size_t i = 0U; i < NUM_DEFAULT_FIELDS; ++i) {
+    subscribe(pcinterface, mFields[i].fieldId, DEFAULT_RATE);
+  }
+}
+
+/**
+ * @brief Handles a subscribe request from the PC
+ *
+ * @param pcinterface PCInterface struct
+ * @param port Port the request was received on, and responded on
+ * @param payloadBytes Message payload
+ * @param nBytes Length of payloadBytes
+ */
+void PCInterface_SubscribeRequest(
+    PCInterface_T* pcinterface,
+    struct PCInterface_Port* port,
+    uint8_t* payloadBytes,
+    uint16_t nBytes)
+{
+  if (nBytes != PCINTERFACE_MSG_COMMON_DATALEN) {
+    return;
+  }
+
+  const uint16_t fieldId = (uint16_t)((payloadBytes[0] << 8) | payloadBytes[1]);
+  const uint8_t rate = payloadBytes[2];
+  const uint8_t status = subscribe(pcinterface, fieldId, rate);
+  sendSubscribeResponse(pcinterface, port, fieldId, rate, status);
+}
@@ -14,7 +14,7 @@ static Logging_T* mLog;
 PDM_Status_T PDM_Init(Logging_T* logger, PDM_T* pdm)
 {
   mLog = logger;
-  Log_Print(mLog, "PDM_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_PDM, LOGGING_LEVEL_DEBUG, "PDM_Init begin\n");
   DEPEND_ON(logger, PDM_STATUS_ERROR_DEPENDS);
   DEPEND_ON(pdm->vehicleState, PDM_STATUS_ERROR_DEPENDS);
 
@@ -30,7 +30,7 @@ PDM_Status_T PDM_Init(Logging_T* logger, PDM_T* pdm)
   pdm->initComplete = true;
 
   REGISTER(pdm, PDM_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "PDM_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_PDM, LOGGING_LEVEL_DEBUG, "PDM_Init complete\n");
   return PDM_STATUS_OK;
 }
 
@@ -75,7 +75,7 @@ static bool updateSdcInputIRQ(volatile bool* currentVal, GPIO_T* pin)
 SDC_Status_T SDC_Init(Logging_T* logger, SDC_Config_T* config)
 {
   mLog = logger;
-  Log_Print(mLog, "SDC_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_SDC, LOGGING_LEVEL_DEBUG, "SDC_Init begin\n");
   DEPEND_ON(logger, SDC_STATUS_ERROR_DEPENDS);
   DEPEND_ON(config->state, SDC_STATUS_ERROR_DEPENDS);
 
@@ -96,7 +96,7 @@ SDC_Status_T SDC_Init(Logging_T* logger, SDC_Config_T* config)
       &mTask.taskBuffer);
 
   REGISTER_STATIC(SDC, SDC_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "SDC_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_SDC, LOGGING_LEVEL_DEBUG, "SDC_Init complete\n");
   return SDC_STATUS_OK;
 }
 
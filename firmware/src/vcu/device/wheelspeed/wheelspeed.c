@@ -19,7 +19,7 @@ REGISTERED_MODULE_STATIC_DEF(WHEELSPEED);
 
 // ------------------- Private data -------------------
 static Logging_T* mLog;
-static const TickType_t mBlockTime = 10 / portTICK_PERIOD_MS; // 10ms
+static const TickType_t mBlockTime = 2000 / portTICK_PERIOD_MS; // 2s
 
 static bool isInitialized = false;
 
@@ -28,10 +28,6 @@ static struct
   TaskHandle_t taskHandle;
   StaticTask_t taskBuffer;
   StackType_t taskStack[WHEELSPEED_STACK_SIZE];
-
-  // To simplify system timers, put this on the 100Hz event,
-  // but count to 100 to do anything
-  uint16_t counter;
 } mTask;
 
 static Wheelspeed_Config_T mConfig;
@@ -113,32 +109,27 @@ static void calculateRpm(VehicleState_Wheelspeed_T* data)
 static void Wheelspeed_TaskMethod(void)
 {
   // Wait for notification to wake up
-  uint32_t notifiedValue = ulTaskNotifyTake(pdTRUE, mBlockTime);
+  uint32_t notifiedValue = TaskTimer_Wait(&mTask.taskHandle, mBlockTime);
   if (notifiedValue > 0) {
-    if (mTask.counter % 100U == 0U) {
-
-      // Update sensor reading
-      uint8_t samples[WSS_BATCH_RECV_SIZE];
-      uint16_t nRecv = (uint16_t)xStreamBufferReceive(
-          mSampleStream.sampleStreamHandle,
-          samples,
-          WSS_BATCH_RECV_SIZE,
-          0U); // Don't block
-      
-      if (nRecv > 0U) {
-        // count the 0->1 transitions for each bit
-        VehicleState_Wheelspeed_T sensorData;
-        countLowHighTransitions(samples, nRecv, &sensorData);
-        calculateRpm(&sensorData);
-
-        if (VehicleState_AccessAcquire(mConfig.state)) {
-          mConfig.state->data.vehicle.wheelspeed = sensorData;
-          VehicleState_AccessRelease(mConfig.state);
-        }
+    // Update sensor reading
+    uint8_t samples[WSS_BATCH_RECV_SIZE];
+    uint16_t nRecv = (uint16_t)xStreamBufferReceive(
+        mSampleStream.sampleStreamHandle,
+        samples,
+        WSS_BATCH_RECV_SIZE,
+        0U); // Don't block
+
+    if (nRecv > 0U) {
+      // count the 0->1 transitions for each bit
+      VehicleState_Wheelspeed_T sensorData;
+      countLowHighTransitions(samples, nRecv, &sensorData);
+      calculateRpm(&sensorData);
+
+      if (VehicleState_AccessAcquire(mConfig.state)) {
+        mConfig.state->data.vehicle.wheelspeed = sensorData;
+        VehicleState_AccessRelease(mConfig.state);
       }
-
     }
-    mTask.counter++;
   }
 }
 
@@ -158,12 +149,11 @@ Wheelspeed_Status_T Wheelspeed_Init(Wheelspeed_Config_T* config)
 {
   DEPEND_ON(config->logging, WHEELSPEED_STATUS_ERROR_DEPENDS);
   mLog = config->logging;
-  Log_Print(mLog, "Wheelspeed_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_WHEELSPEED, LOGGING_LEVEL_DEBUG, "Wheelspeed_Init begin\n");
 
   DEPEND_ON(config->state, WHEELSPEED_STATUS_ERROR_DEPENDS);
   DEPEND_ON_STATIC(TASKTIMER, WHEELSPEED_STATUS_ERROR_DEPENDS);
 
-  mTask.counter = 0U;
   mConfig = *config;
   
   // Create serial stream for received bytes
@@ -183,10 +173,10 @@ Wheelspeed_Status_T Wheelspeed_Init(Wheelspeed_Config_T* config)
       mTask.taskStack,
       &mTask.taskBuffer);
 
-  // Register the task for timer notifications every 10ms (100Hz)
+  // Register the task for timer notifications every 1s (1Hz)
   TaskTimer_Status_T statusTimer = TaskTimer_RegisterTask(
       &mTask.taskHandle,
-      TASKTIMER_FREQUENCY_100HZ);
+      TASKTIMER_FREQUENCY_1HZ);
 
   if (TASKTIMER_STATUS_OK != statusTimer) {
     return WHEELSPEED_STATUS_ERROR_INIT;
@@ -195,7 +185,7 @@ Wheelspeed_Status_T Wheelspeed_Init(Wheelspeed_Config_T* config)
   isInitialized = true;
 
   REGISTER_STATIC(WHEELSPEED, WHEELSPEED_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "Wheelspeed_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_WHEELSPEED, LOGGING_LEVEL_DEBUG, "Wheelspeed_Init complete\n");
   return WHEELSPEED_STATUS_OK;
 }
 
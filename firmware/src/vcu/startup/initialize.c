@@ -56,11 +56,15 @@ extern const char* welcomeMsg;
 static Logging_T mLog = (Logging_T){};
 static CRC_T mCrc = (CRC_T){
   .hcrc = &Mapping_CRC,
+  .hdma = &Mapping_CRC_DMA,
+  .dmaIrq = Mapping_CRC_DMAStream,
 };
-static ADC_Config_T mAdcConfig = (ADC_Config_T){
+static ADC_T mAdc = (ADC_T){
   .logger = &mLog,
   .handle = &Mapping_ADC,
-  .adcIrq = Mapping_ADC_DMAStream,
+  .slaves = { &Mapping_ADC_Slave },
+  .mode = MAPPING_ADC_MODE,
+  .twoSamplingDelay = ADC_TWOSAMPLINGDELAY_5CYCLES,
   .numChannelsUsed = MAPPING_ADC_NUM_CHANNELS,
 };
 
@@ -76,8 +80,8 @@ static GPS_T mGps = (GPS_T){
 static PCInterface_T mPCInterface = (PCInterface_T){
   .uartA = MAPPING_PCINTERFACE_UARTADEV,
   .uartB = MAPPING_PCINTERFACE_UARTBDEV,
-  .crc = &mCrc,
   .pinToggle = &Mapping_GPO_DebugToggle,
+  .maxBaudRate = MAPPING_PCINTERFACE_MAXBAUD,
 };
 static PDM_T mPdm = (PDM_T){
   .channels = pdmChannels,
@@ -102,9 +106,27 @@ static Wheelspeed_Config_T mWheelspeedConfig = {
 };
 
 // Vehicle devices & sensors
+// Inverter channels streamed to the PC: 15 samples (150ms) per block
+#define INVERTER_STREAM_SAMPLES_PER_BLOCK 15U
+#define INVERTER_STREAM_NUM_BLOCKS 4U
+static uint8_t mInverterStreamStorage[BLOCKBUFFER_STORAGE_LEN(
+    CINVERTER_STREAM_SAMPLE_LEN,
+    INVERTER_STREAM_SAMPLES_PER_BLOCK,
+    INVERTER_STREAM_NUM_BLOCKS)];
+static BlockBuffer_T mInverterStream = (BlockBuffer_T){
+  .storage = mInverterStreamStorage,
+  .sampleLen = CINVERTER_STREAM_SAMPLE_LEN,
+  .samplesPerBlock = INVERTER_STREAM_SAMPLES_PER_BLOCK,
+  .numBlocks = INVERTER_STREAM_NUM_BLOCKS,
+};
+_Static_assert(
+    BLOCKBUFFER_BLOCK_LEN(CINVERTER_STREAM_SAMPLE_LEN, INVERTER_STREAM_SAMPLES_PER_BLOCK)
+        <= PCINTERFACE_MSG_STREAMBLOCK_DATALEN,
+    "Inverter stream block fits in a frame");
 static CInverter_T mInverter = (CInverter_T){
   .canInst = MAPPING_INVERTER_CANBUS,
   .vehicleState = &mVehicleState,
+  .stream = &mInverterStream,
 };
 static BMS_T mBms = (BMS_T){
   .canInst = MAPPING_BMS_CANBUS,
@@ -113,12 +135,21 @@ static BMS_T mBms = (BMS_T){
 static DiscreteSense_T mDiscreteSense = (DiscreteSense_T){
   .logger = &mLog,
   .state = &mVehicleState,
+  .adc = &mAdc,
   .adcAccelPedalA = MAPPING_ADC_THROTTLE_1,
   .adcAccelPedalB = MAPPING_ADC_THROTTLE_2,
   .adcBrakeFront = MAPPING_ADC_BRAKE_FRONT,
   .adcBrakeRear = MAPPING_ADC_BRAKE_REAR,
+  .accelPedalWatchdog = true,
+  .adcHwAccelPedalA = MAPPING_ADC_THROTTLE_1_HW,
+  .adcHwAccelPedalB = MAPPING_ADC_THROTTLE_2_HW,
   .gpioDashboardButton = &Mapping_GPI_StartButton,
   // scaling is applied after config is loaded in init
+  // 3 sample median rejects single sample spikes on the analog inputs
+  .filterAccelPedalA = { .numStages = 1, .stages = { { .type = FILTER_TYPE_MEDIAN, .taps = 3 } } },
+  .filterAccelPedalB = { .numStages = 1, .stages = { { .type = FILTER_TYPE_MEDIAN, .taps = 3 } } },
+  .filterBrakeFront = { .numStages = 1, .stages = { { .type = FILTER_TYPE_MEDIAN, .taps = 3 } } },
+  .filterBrakeRear = { .numStages = 1, .stages = { { .type = FILTER_TYPE_MEDIAN, .taps = 3 } } },
 };
 static DashboardOut_T mDashboardOut = (DashboardOut_T){
   .output_pin = &Mapping_GPO_LED,
@@ -216,8 +247,8 @@ static void ECU_Init_Error(const char* msg);
 //------------------------------------------------------------------------------
 void ECU_Init_Error(const char* msg)
 {
-  Log_Print(&mLog, msg);
-  Log_Print(&mLog, "ECU Failed to initialize\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_ERROR, msg);
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_ERROR, "ECU Failed to initialize\n");
 
   // TODO should flash LED here and assert ECU fault pin
 
@@ -251,8 +282,8 @@ void ECU_Init_Task(void* pvParameters)
   // Initialize components
   ECU_Init_System();
 
-  Log_Print(&mLog, "\n\n\n");
-  Log_Print(&mLog, welcomeMsg);
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "\n\n\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, welcomeMsg);
 
   ECU_Init_BoardPeriph();
   ECU_Init_BoardDevs();
@@ -262,8 +293,8 @@ void ECU_Init_Task(void* pvParameters)
   ECU_Init_VehicleInterface2();
   ECU_Init_VehicleProccesses();
 
-  Log_Print(&mLog, "ECU_Init complete\n");
-  Log_Print(&mLog, "ECU_Init deleting init task\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "ECU_Init complete\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "ECU_Init deleting init task\n");
   vTaskDelete(NULL);
 }
 
@@ -273,9 +304,9 @@ static void ECU_Init_System(void)
   // Set up logging
   TRY_INIT("Log", Log_Init(&mLog), LOGGING_STATUS_OK);
 
-  Log_Print(&mLog, "###### ECU_Init_System ######\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "###### ECU_Init_System ######\n");
 
-  TRY_INIT("Task Timer", TaskTimer_Init(&mLog, &Mapping_Timer100Hz), TASKTIMER_STATUS_OK);
+  TRY_INIT("Task Timer", TaskTimer_Init(&mLog, &Mapping_Timer1kHz), TASKTIMER_STATUS_OK);
   // if (LOGGING_STATUS_OK != Log_EnableSWO(&mLog)) {
   //   ECU_Init_Error("Log_EnableSWO error\n");
   // }
@@ -293,7 +324,7 @@ static void ECU_Init_System(void)
 //------------------------------------------------------------------------------
 static void ECU_Init_BoardPeriph(void)
 {
-  Log_Print(&mLog, "###### ECU_Init_BoardPeriph ######\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "###### ECU_Init_BoardPeriph ######\n");
 
   TRY_INIT("CAN", CAN_Init(&mLog), CAN_STATUS_OK);
   TRY_INIT("CAN1 bus", CAN_Config(CAN_DEV1, &Mapping_CAN1), CAN_STATUS_OK);
@@ -301,13 +332,13 @@ static void ECU_Init_BoardPeriph(void)
   TRY_INIT("CAN1 bus", CAN_Config(CAN_DEV3, &Mapping_CAN3), CAN_STATUS_OK);
   mPCInterface.canDebugEnable = true;
 
-  TRY_INIT("ADC", ADC_Init(&mAdcConfig), ADC_STATUS_OK);
+  TRY_INIT("ADC", ADC_Init(&mAdc), ADC_STATUS_OK);
 }
 
 //------------------------------------------------------------------------------
 static void ECU_Init_BoardDevs(void)
 {
-  Log_Print(&mLog, "###### ECU_Init_BoardDevs ######\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "###### ECU_Init_BoardDevs ######\n");
 
   // TODO initialize EEPROM
 }
@@ -324,7 +355,7 @@ static void ECU_Init_LoadConfig(void)
 //------------------------------------------------------------------------------
 static void ECU_Init_VehicleInterface1(void)
 {
-  Log_Print(&mLog, "###### ECU_Init_VehicleInterface1 ######\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "###### ECU_Init_VehicleInterface1 ######\n");
 
   TRY_INIT("Vehicle State", VehicleState_Init(&mLog, &mVehicleState), VEHICLESTATE_STATUS_OK);
   if (PCInterface_SetVehicleState(&mPCInterface, &mVehicleState) != PCINTERFACE_STATUS_OK) {
@@ -335,7 +366,7 @@ static void ECU_Init_VehicleInterface1(void)
 //------------------------------------------------------------------------------
 static void ECU_Init_VehicleDevices(void)
 {
-  Log_Print(&mLog, "###### ECU_Init_VehicleDevices ######\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "###### ECU_Init_VehicleDevices ######\n");
 
   TRY_INIT("USART6 (GPS)", UART_Config(&Mapping_GPS_UART), UART_STATUS_OK);
   TRY_INIT("GPS", GPS_Init(&mLog, &mGps), GPS_STATUS_OK);
@@ -346,7 +377,11 @@ static void ECU_Init_VehicleDevices(void)
   TRY_INIT("Power Distribution Module (PDM)", PDM_Init(&mLog, &mPdm), PDM_STATUS_OK);
 
   // External devices
+  TRY_INIT("Inverter Stream", BlockBuffer_Init(&mInverterStream), true);
   TRY_INIT("Inverter", CInverter_Init(&mLog, &mInverter), CINVERTER_STATUS_OK);
+  if (PCInterface_SetChannelStream(&mPCInterface, &mInverterStream) != PCINTERFACE_STATUS_OK) {
+    ECU_Init_Error("PCInterface_SetChannelStream failed\n");
+  }
   TRY_INIT("BMS", BMS_Init(&mLog, &mBms), BMS_STATUS_OK);
 
   // load discrete sensor settings from config
@@ -377,7 +412,7 @@ static void ECU_Init_VehicleDevices(void)
 //------------------------------------------------------------------------------
 static void ECU_Init_VehicleInterface2(void)
 {
-  Log_Print(&mLog, "###### ECU_Init_VehicleInterface2 ######\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "###### ECU_Init_VehicleInterface2 ######\n");
 
   TRY_INIT("Vehicle Control", VehicleControl_Init(&mLog, &mVehicleControl), VEHICLECONTROL_STATUS_OK);
   if (PCInterface_SetVehicleControl(&mPCInterface, &mVehicleControl) != PCINTERFACE_STATUS_OK) {
@@ -388,7 +423,7 @@ static void ECU_Init_VehicleInterface2(void)
 //------------------------------------------------------------------------------
 static void ECU_Init_VehicleProccesses(void)
 {
-  Log_Print(&mLog, "###### ECU_Init_VehicleProccesses ######\n");
+  Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "###### ECU_Init_VehicleProccesses ######\n");
 
   TRY_INIT("Watchdog Trigger", WatchdogTrigger_Init(&mLog, &mWdtTrigger), WATCHDOGTRIGGER_STATUS_OK);
   TRY_INIT("Throttle Controller", ThrottleController_Init(&mLog, &mThrottleController), THROTTLECONTROLLER_STATUS_OK);
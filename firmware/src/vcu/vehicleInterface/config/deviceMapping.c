@@ -70,11 +70,13 @@ UART_DeviceConfig_T Mapping_PCInterface_UARTA = {
   .dev = MAPPING_PCINTERFACE_UARTADEV,
   .handle = &huart1,
   .txIrq = DMA2_Stream7_IRQn,
+  .uartIrq = USART1_IRQn,
 };
 UART_DeviceConfig_T Mapping_PCInterface_UARTB = {
   .dev = MAPPING_PCINTERFACE_UARTBDEV,
   .handle = &huart3,
   .txIrq = DMA1_Stream3_IRQn,
+  .uartIrq = USART3_IRQn,
 };
 
 /*
@@ -87,5 +89,6 @@ UART_DeviceConfig_T Mapping_GPS_UART = {
   .dev = MAPPING_GPS_UARTDEV,
   .handle = &huart6,
   .txIrq = DMA2_Stream6_IRQn,
+  .uartIrq = USART6_IRQn,
 };
 
@@ -22,23 +22,34 @@
 #include "main.h"
 
 /*
- * The ADC channels are read in the "rank" order defined in main.c
- * when the HAL library configures the ADC peripheral
+ * ADC1 and ADC2 run in dual regular simultaneous mode. Both ADCs convert the
+ * same rank at the same instant, with ADC2 sampling the paired input of the
+ * input sampled by ADC1 (see main.c for the rank order). This keeps redundant
+ * sensors (e.g. the two throttle pedal channels) sampled simultaneously.
+ *
+ * Logical channels are interleaved ADC1, ADC2 per rank.
  */
-#define MAPPING_ADC_NUM_CHANNELS  ((uint16_t) 12U)
-
-#define MAPPING_ADC_THROTTLE_1    ADC_CONVERSIONCHANNEL8
-#define MAPPING_ADC_THROTTLE_2    ADC_CONVERSIONCHANNEL9
-#define MAPPING_ADC_BRAKE_FRONT   ADC_CONVERSIONCHANNEL10
-#define MAPPING_ADC_BRAKE_REAR    ADC_CONVERSIONCHANNEL11
-#define MAPPING_ADC_MPIO1         ADC_CONVERSIONCHANNEL6
-#define MAPPING_ADC_MPIO2         ADC_CONVERSIONCHANNEL7
-#define MAPPING_ADC_MPIO3         ADC_CONVERSIONCHANNEL4
-#define MAPPING_ADC_MPIO4         ADC_CONVERSIONCHANNEL5
-#define MAPPING_ADC_MPIO5         ADC_CONVERSIONCHANNEL2
-#define MAPPING_ADC_MPIO6         ADC_CONVERSIONCHANNEL3
-#define MAPPING_ADC_MPIO7         ADC_CONVERSIONCHANNEL0
-#define MAPPING_ADC_MPIO8         ADC_CONVERSIONCHANNEL1
+#define MAPPING_ADC_MODE          ADC_MULTIMODE_DUAL_SIMULT
+#define MAPPING_ADC_NUM_ADCS      2U
+#define MAPPING_ADC_NUM_CHANNELS  ((uint16_t) 12U) // Ranks per ADC
+#define MAPPING_ADC_CHANNEL(rank, adcIndex) \
+  ADC_MULTIMODE_CHANNEL(rank, adcIndex, MAPPING_ADC_NUM_ADCS)
+
+#define MAPPING_ADC_THROTTLE_1    MAPPING_ADC_CHANNEL(8, 0)  // ADC1 IN8
+#define MAPPING_ADC_THROTTLE_2    MAPPING_ADC_CHANNEL(8, 1)  // ADC2 IN9
+#define MAPPING_ADC_BRAKE_FRONT   MAPPING_ADC_CHANNEL(10, 0) // ADC1 IN14
+#define MAPPING_ADC_BRAKE_REAR    MAPPING_ADC_CHANNEL(10, 1) // ADC2 IN15
+// ADC inputs of the throttle channels, for the analog watchdogs
+#define MAPPING_ADC_THROTTLE_1_HW ADC_CHANNEL_8
+#define MAPPING_ADC_THROTTLE_2_HW ADC_CHANNEL_9
+#define MAPPING_ADC_MPIO1         MAPPING_ADC_CHANNEL(6, 0)
+#define MAPPING_ADC_MPIO2         MAPPING_ADC_CHANNEL(7, 0)
+#define MAPPING_ADC_MPIO3         MAPPING_ADC_CHANNEL(4, 0)
+#define MAPPING_ADC_MPIO4         MAPPING_ADC_CHANNEL(5, 0)
+#define MAPPING_ADC_MPIO5         MAPPING_ADC_CHANNEL(2, 0)
+#define MAPPING_ADC_MPIO6         MAPPING_ADC_CHANNEL(3, 0)
+#define MAPPING_ADC_MPIO7         MAPPING_ADC_CHANNEL(0, 0)
+#define MAPPING_ADC_MPIO8         MAPPING_ADC_CHANNEL(1, 0)
 
 /*
  * PDM Config
@@ -88,6 +99,10 @@ extern GPIO_T Mapping_GPO_SDC_ECUError;
  */
 #define MAPPING_PCINTERFACE_UARTADEV  ((UART_Device_T)UART_DEV1)
 #define MAPPING_PCINTERFACE_UARTBDEV  ((UART_Device_T)UART_DEV3)
+// Max baud rate the PC can switch the ports to. USART3 runs from APB1 (54MHz)
+// with 16x oversampling, so 3.375Mbaud is the hardware limit. Rates the RS232
+// transceiver can't carry fail the handshake and fall back.
+#define MAPPING_PCINTERFACE_MAXBAUD   3000000U
 extern UART_DeviceConfig_T Mapping_PCInterface_UARTA;
 extern UART_DeviceConfig_T Mapping_PCInterface_UARTB;
 
@@ -108,11 +123,13 @@ extern UART_DeviceConfig_T Mapping_GPS_UART;
  */
 // Handles declared in main.c
 extern ADC_HandleTypeDef hadc1;
+extern ADC_HandleTypeDef hadc2;
 extern DMA_HandleTypeDef hdma_adc1;
 extern CAN_HandleTypeDef hcan1;
 extern CAN_HandleTypeDef hcan2;
 extern CAN_HandleTypeDef hcan3;
 extern CRC_HandleTypeDef hcrc;
+extern DMA_HandleTypeDef hdma_memtomem_dma2_stream4;
 extern I2C_HandleTypeDef hi2c2;
 extern I2C_HandleTypeDef hi2c4;
 extern RTC_HandleTypeDef hrtc;
@@ -123,11 +140,13 @@ extern UART_HandleTypeDef huart3;
 extern UART_HandleTypeDef huart6;
 
 #define Mapping_CRC hcrc
+#define Mapping_CRC_DMA hdma_memtomem_dma2_stream4
+#define Mapping_CRC_DMAStream DMA2_Stream4_IRQn
 #define Mapping_CAN1 hcan1
 #define Mapping_CAN2 hcan2
 #define Mapping_CAN3 hcan3
-#define Mapping_Timer100Hz htim2
+#define Mapping_Timer1kHz htim2
 #define Mapping_ADC hadc1
-#define Mapping_ADC_DMAStream DMA2_Stream0_IRQn
+#define Mapping_ADC_Slave hadc2
 
 #endif /* VEHICLEINTERFACE_CONFIG_DEVICEMAPPING_H_ */
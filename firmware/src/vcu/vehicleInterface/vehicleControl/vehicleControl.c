@@ -20,14 +20,14 @@ VehicleControl_Status_T VehicleControl_Init(
     VehicleControl_T* control)
 {
   mLog = logger;
-  Log_Print(mLog, "VehicleControl_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "VehicleControl_Init begin\n");
   DEPEND_ON_STATIC(SDC, VEHICLECONTROL_STATUS_ERROR_DEPENDS);
   DEPEND_ON(control->inverter, VEHICLECONTROL_STATUS_ERROR_DEPENDS);
   DEPEND_ON(control->pdm, VEHICLECONTROL_STATUS_ERROR_DEPENDS);
   DEPEND_ON(control->dashOut, VEHICLECONTROL_STATUS_ERROR_DEPENDS);
 
   REGISTER(control, VEHICLECONTROL_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "VehicleControl_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "VehicleControl_Init complete\n");
   return VEHICLECONTROL_STATUS_OK;
 }
 
@@ -18,7 +18,7 @@ static Logging_T* mLog;
 VehicleState_Status_T VehicleState_Init(Logging_T* logger, VehicleState_T* state)
 {
   mLog = logger;
-  Log_Print(mLog, "VehicleState_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "VehicleState_Init begin\n");
   DEPEND_ON_STATIC(TASKTIMER, VEHICLESTATE_STATUS_ERROR_DEPENDS);
 
   memset(&state->data, 0, sizeof(state->data)); // initialize data to 0
@@ -27,7 +27,7 @@ VehicleState_Status_T VehicleState_Init(Logging_T* logger, VehicleState_T* state
   state->mutex = xSemaphoreCreateMutexStatic(&state->mutexBuffer);
 
   REGISTER(state, VEHICLESTATE_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "VehicleState_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "VehicleState_Init complete\n");
   return VEHICLESTATE_STATUS_OK;
 }
 
@@ -29,6 +29,8 @@ typedef struct
   uint16_t accelRawA; // accelerator sensor A press raw sensor value
   uint16_t accelRawB; // accelerator sensor B press raw sensor value
   bool accelValid;
+  bool accelOutOfRange; // ADC watchdog saw a pedal outside of its calibrated range
+  uint32_t accelOutOfRangeTime; // HAL tick (ms) the watchdog tripped, if accelOutOfRange
 
   float brakePresFront;
   float brakePresRear;
@@ -44,7 +44,9 @@ static uint32_t isFaultAccelPedal(FaultManager_T* faultMgr, VehicleState_Data_T*
 {
   uint32_t faults = faultMgr->internal.faults;
 
-  // Accelerator outside of calibrated range
+  // Accelerator outside of calibrated range. The ADC watchdog also catches
+  // excursions between samples, but trips on a single conversion, so it's
+  // debounced with the sampled values.
   uint16_t accelRawA = data->inputs.accelRawA;
   uint16_t accelRawALimitUpper = faultMgr->vehicleConfig->inputs.accelPedal.calibrationA.rawUpper;
   uint16_t accelRawALimitLower = faultMgr->vehicleConfig->inputs.accelPedal.calibrationA.rawLower;
@@ -54,13 +56,24 @@ static uint32_t isFaultAccelPedal(FaultManager_T* faultMgr, VehicleState_Data_T*
 
   bool accelRangeCheck = handleTimedCondition(
       accelRawA > accelRawALimitUpper || accelRawA < accelRawALimitLower ||
-      accelRawB > accelRawBLimitUpper || accelRawB < accelRawBLimitLower,
+      accelRawB > accelRawBLimitUpper || accelRawB < accelRawBLimitLower ||
+      data->inputs.accelOutOfRange,
       &faultMgr->internal.accelPedalRangeTimer,
       faultMgr->internal.accelPedalRangeTimerLimit);
   if (!accelRangeCheck) {
     faults |= FAULTMGR_FAULT_ACCELPDL_RANGE;
   }
 
+  // Keep the first watchdog trip time of the excursion, until it clears or
+  // the fault latches
+  if (0U == (faultMgr->internal.faults & FAULTMGR_FAULT_ACCELPDL_RANGE)) {
+    if (0U == faultMgr->internal.accelPedalRangeTimer) {
+      faultMgr->internal.accelWatchdogTime = 0U;
+    } else if (data->inputs.accelOutOfRange && 0U == faultMgr->internal.accelWatchdogTime) {
+      faultMgr->internal.accelWatchdogTime = data->inputs.accelOutOfRangeTime;
+    }
+  }
+
   // Redundant values disagree
   float diff = fabsf(data->inputs.accelA - data->inputs.accelB);
   bool diffCheck = handleTimedCondition(
@@ -197,7 +210,7 @@ static uint32_t isLVErrorInverter(FaultManager_T* faultMgr, VehicleState_Data_T*
 void FaultManager_Init(Logging_T* logger, FaultManager_T* faultMgr)
 {
   mLog = logger;
-  Log_Print(mLog, "FaultManager_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "FaultManager_Init begin\n");
 
   memset(&faultMgr->internal, 0U, sizeof(FaultManager_Internal_T));
 
@@ -215,7 +228,7 @@ void FaultManager_Init(Logging_T* logger, FaultManager_T* faultMgr)
   faultMgr->internal.bmsFaultTimerLimit =
       (uint16_t)(faultMgr->vehicleConfig->bms.invalidDataTimeout / faultMgr->tickRateMs);
 
-  Log_Print(mLog, "FaultManager_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "FaultManager_Init complete\n");
 }
 
 FaultStatus_T FaultManager_Step(FaultManager_T* faultMgr)
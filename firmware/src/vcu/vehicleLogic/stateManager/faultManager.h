@@ -17,6 +17,7 @@
 typedef struct
 {
   uint32_t faults; // used to latch fault bits
+  uint32_t accelWatchdogTime; // HAL tick (ms) of the first ADC watchdog trip in the accel range excursion, 0 if none
 
   uint16_t accelPedalRangeTimer;
   uint16_t accelPedalRangeTimerLimit;
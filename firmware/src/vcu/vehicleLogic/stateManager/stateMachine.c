@@ -170,7 +170,7 @@ static void stateFault(VSM_T* vsm)
 void VSM_Init(Logging_T* logger, VSM_T* vsm)
 {
   mLog = logger;
-  Log_Print(mLog, "VSM_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "VSM_Init begin\n");
 
   vsm->vsmState = VSM_STATE_INIT;
   vsm->nextState = VSM_STATE_INIT;
@@ -181,7 +181,7 @@ void VSM_Init(Logging_T* logger, VSM_T* vsm)
   vsm->faultMgr.tickRateMs = vsm->tickRateMs;
   FaultManager_Init(logger, &vsm->faultMgr);
 
-  Log_Print(mLog, "VSM_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "VSM_Init complete\n");
 }
 
 void VSM_Step(VSM_T* vsm)
@@ -18,7 +18,7 @@ static const uint32_t tickRateMs = 10U;
 static void StateManagerProcessing(VehicleStateManager_T* sm)
 {
   // Wait for notification to wake up
-  uint32_t notifiedValue = ulTaskNotifyTake(pdTRUE, mBlockTime);
+  uint32_t notifiedValue = TaskTimer_Wait(&sm->taskHandle, mBlockTime);
   if (notifiedValue > 0) {
     // Run state machine
     VSM_Step(&sm->vsm);
@@ -40,7 +40,7 @@ static void StateManagerProcessing_Task(void* pvParameters)
 VehicleStateManager_Status_T VehicleStateManager_Init(Logging_T* logger, VehicleStateManager_T* sm)
 {
   mLog = logger;
-  Log_Print(mLog, "VehicleStateManager_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "VehicleStateManager_Init begin\n");
   DEPEND_ON_STATIC(TASKTIMER, STATEMANAGER_STATUS_ERROR_DEPENDS);
 
   sm->vsm.inputState = sm->inputState;
@@ -61,12 +61,15 @@ VehicleStateManager_Status_T VehicleStateManager_Init(Logging_T* logger, Vehicle
       &sm->taskBuffer);
 
   // Register the task for timer notifications every 10ms (100Hz)
-  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTask(&sm->taskHandle, TASKTIMER_FREQUENCY_100HZ);
+  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTaskPhase(
+      &sm->taskHandle,
+      TASKTIMER_FREQUENCY_100HZ,
+      VEHICLESTATEMANAGER_TASK_PHASE);
   if (TASKTIMER_STATUS_OK != statusTimer) {
     return STATEMANAGER_STATUS_ERROR_INIT;
   }
 
   REGISTER(sm, STATEMANAGER_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "VehicleStateManager_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "VehicleStateManager_Init complete\n");
   return STATEMANAGER_STATUS_OK;
 }
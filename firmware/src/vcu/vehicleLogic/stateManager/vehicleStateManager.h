@@ -31,6 +31,7 @@ typedef enum
 
 #define VEHICLESTATEMANAGER_STACK_SIZE 2000
 #define VEHICLESTATEMANAGER_TASK_PRIORITY 3
+#define VEHICLESTATEMANAGER_TASK_PHASE 4U  /* after the discrete inputs are sensed */
 
 typedef struct
 {
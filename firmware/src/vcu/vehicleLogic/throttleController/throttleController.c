@@ -43,7 +43,7 @@ static float getTorqueMagnitude(
 static void ThrottleController(ThrottleController_T* throttleControl)
 {
   // Wait for notification to wake up
-  uint32_t notifiedValue = ulTaskNotifyTake(pdTRUE, mBlockTime);
+  uint32_t notifiedValue = TaskTimer_Wait(&throttleControl->taskHandle, mBlockTime);
   if (notifiedValue > 0) {
     // Acquire data
     float accelPedal = 0.0f;
@@ -81,7 +81,7 @@ ThrottleController_Status_T ThrottleController_Init(
     ThrottleController_T* throttleControl)
 {
   mLog = logger;
-  Log_Print(mLog, "ThrottleController_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "ThrottleController_Init begin\n");
   DEPEND_ON_STATIC(TASKTIMER, THROTTLECONTROLLER_STATUS_ERROR_DEPENDS);
 
   throttleControl->torqueMapForward = &TorqueMap_Default;
@@ -103,13 +103,16 @@ ThrottleController_Status_T ThrottleController_Init(
       &throttleControl->taskBuffer);
 
   // Register the task for timer notifications every 10ms (100Hz)
-  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTask(&throttleControl->taskHandle, TASKTIMER_FREQUENCY_100HZ);
+  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTaskPhase(
+      &throttleControl->taskHandle,
+      TASKTIMER_FREQUENCY_100HZ,
+      THROTTLECONTROLLER_TASK_PHASE);
   if (TASKTIMER_STATUS_OK != statusTimer) {
     return THROTTLECONTROLLER_STATUS_ERROR_INIT;
   }
 
   REGISTER(throttleControl, THROTTLECONTROLLER_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "ThrottleController_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "ThrottleController_Init complete\n");
   return THROTTLECONTROLLER_STATUS_OK;
 }
 
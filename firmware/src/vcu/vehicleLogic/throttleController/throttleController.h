@@ -33,6 +33,7 @@ typedef enum
 
 #define THROTTLECONTROLLER_STACK_SIZE 2000
 #define THROTTLECONTROLLER_TASK_PRIORITY 3
+#define THROTTLECONTROLLER_TASK_PHASE 5U  /* after the state manager, before the inverter */
 
 typedef struct
 {
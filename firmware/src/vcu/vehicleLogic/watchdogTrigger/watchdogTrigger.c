@@ -11,22 +11,18 @@
 
 // ------------------- Private data -------------------
 static Logging_T* mLog;
-static const TickType_t mBlockTime = 100 / portTICK_PERIOD_MS; // 100ms
+static const TickType_t mBlockTime = 2000 / portTICK_PERIOD_MS; // 2s
 
 // ------------------- Private methods -------------------
 static void WatchdogTrigger(WatchdogTrigger_T* wdtTrigger)
 {
   // Wait for notification to wake up
-  uint32_t notifiedValue = ulTaskNotifyTake(pdTRUE, mBlockTime);
+  uint32_t notifiedValue = TaskTimer_Wait(&wdtTrigger->taskHandle, mBlockTime);
   if (notifiedValue > 0) {
     // TODO notify WDT
 
     // status LED blinking
-    wdtTrigger->counter++;
-    if (100U == wdtTrigger->counter) {
-      GPIO_TogglePin(wdtTrigger->blinkLED);
-      wdtTrigger->counter = 0U;
-    }
+    GPIO_TogglePin(wdtTrigger->blinkLED);
   }
 }
 
@@ -47,12 +43,10 @@ WatchdogTrigger_Status_T WatchdogTrigger_Init(
     WatchdogTrigger_T* wdtTrigger)
 {
   mLog = logger;
-  Log_Print(mLog, "WatchdogTrigger_Init begin\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "WatchdogTrigger_Init begin\n");
   DEPEND_ON(logger, WATCHDOGTRIGGER_STATUS_ERROR_DEPENDS);
   DEPEND_ON_STATIC(TASKTIMER, WATCHDOGTRIGGER_STATUS_ERROR_DEPENDS);
 
-  wdtTrigger->counter = 0U;
-
   // Create mutex lock
   wdtTrigger->mutex = xSemaphoreCreateMutexStatic(&wdtTrigger->mutexBuffer);
 
@@ -66,13 +60,13 @@ WatchdogTrigger_Status_T WatchdogTrigger_Init(
       wdtTrigger->taskStack,
       &wdtTrigger->taskBuffer);
 
-  // Register the task for timer notifications every 10ms (100Hz)
-  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTask(&wdtTrigger->taskHandle, TASKTIMER_FREQUENCY_100HZ);
+  // Register the task for timer notifications every 1s (1Hz)
+  TaskTimer_Status_T statusTimer = TaskTimer_RegisterTask(&wdtTrigger->taskHandle, TASKTIMER_FREQUENCY_1HZ);
   if (TASKTIMER_STATUS_OK != statusTimer) {
     return WATCHDOGTRIGGER_STATUS_ERROR_INIT;
   }
 
   REGISTER(wdtTrigger, WATCHDOGTRIGGER_STATUS_ERROR_DEPENDS);
-  Log_Print(mLog, "WatchdogTrigger_Init complete\n");
+  Log_Print(mLog, LOGGING_MODULE_VEHICLE, LOGGING_LEVEL_DEBUG, "WatchdogTrigger_Init complete\n");
   return WATCHDOGTRIGGER_STATUS_OK;
 }
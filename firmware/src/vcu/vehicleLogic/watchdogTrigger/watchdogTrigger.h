@@ -33,8 +33,6 @@ typedef struct {
   GPIO_T* blinkLED;
 
   // ******* Internal use *******
-  uint16_t counter;
-
   // Mutex lock
   SemaphoreHandle_t mutex;
   StaticSemaphore_t mutexBuffer;
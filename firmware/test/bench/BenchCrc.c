@@ -0,0 +1,85 @@
+/*
+ * BenchCrc.c
+ *
+ * Throughput of the software CRC (slice-by-8) against a bit at a time CRC
+ * (as in the PC tools) and a byte at a time table, for block sizes from a
+ * short frame up to a large buffer.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "bench.h"
+
+#include "crc/crc32.h"
+
+#define NUM_BYTES 16000000U // bytes per run
+#define MAX_BLOCK 65536U
+
+static uint8_t mData[MAX_BLOCK];
+
+static uint32_t crcBitwise(const uint8_t* data, size_t len)
+{
+  uint32_t crc = CRC32_INIT;
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= (uint32_t)data[i] << 24;
+    for (uint32_t bit = 0; bit < 8U; ++bit) {
+      crc = (crc & 0x80000000U) ? (crc << 1) ^ 0x04C11DB7U : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static uint32_t crcByteTable(const uint8_t* data, size_t len)
+{
+  uint32_t crc = CRC32_INIT;
+  for (size_t i = 0; i < len; ++i) {
+    crc = (crc << 8) ^ CRC32_Table[0][(crc >> 24) ^ data[i]];
+  }
+  return crc;
+}
+
+static void run(const char* name, uint32_t (*calc)(const uint8_t*, size_t), size_t blockLen, uint32_t totalBytes)
+{
+  char label[48];
+  const uint32_t iterations = totalBytes / (uint32_t)blockLen;
+  uint32_t crc = 0U;
+
+  const double startSeconds = Bench_Seconds();
+  const uint64_t start = Bench_Now();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    crc ^= calc(mData, blockLen);
+    Bench_Use(&crc);
+  }
+  const uint64_t elapsed = Bench_Now() - start;
+  const double seconds = Bench_Seconds() - startSeconds;
+
+  const double bytes = (double)iterations * (double)blockLen;
+  snprintf(label, sizeof(label), "%s, %u bytes", name, (unsigned)blockLen);
+  printf("%-32s %8.1f MB/s %8.2f %s/byte\n", label, bytes / seconds / 1e6, (double)elapsed / bytes, BENCH_UNIT);
+}
+
+int main(void)
+{
+  uint32_t lcg = 1U;
+  for (uint32_t i = 0; i < MAX_BLOCK; ++i) {
+    lcg = lcg * 1103515245U + 12345U;
+    mData[i] = (uint8_t)(lcg >> 24);
+  }
+
+  // All three must agree
+  if (crcBitwise(mData, MAX_BLOCK) != CRC32_Calculate(mData, MAX_BLOCK) ||
+      crcByteTable(mData, MAX_BLOCK) != CRC32_Calculate(mData, MAX_BLOCK)) {
+    printf("CRC mismatch\n");
+    return 1;
+  }
+
+  const size_t blocks[] = { 16U, 128U, 1024U, MAX_BLOCK };
+  for (size_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i) {
+    run("bitwise", crcBitwise, blocks[i], NUM_BYTES / 8U);
+    run("byte table", crcByteTable, blocks[i], NUM_BYTES);
+    run("slice-by-8", CRC32_Calculate, blocks[i], NUM_BYTES);
+  }
+
+  return 0;
+}
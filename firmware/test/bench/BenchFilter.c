@@ -0,0 +1,99 @@
+/*
+ * BenchFilter.c
+ *
+ * Cost of the sensor filters per sample (per channel).
+ *
+ *      Author: Liam Flaherty
+ */
+
+#include "bench.h"
+
+#include <string.h>
+
+#include "filter/filter.h"
+
+#define NUM_SAMPLES 200000U
+#define NUM_CHANNELS 4U
+
+static int32_t mInput[NUM_SAMPLES][NUM_CHANNELS];
+
+static void makeInput(void)
+{
+  // Noisy ramp with occasional spikes
+  uint32_t lcg = 1U;
+  for (uint32_t i = 0; i < NUM_SAMPLES; ++i) {
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ++ch) {
+      lcg = lcg * 1103515245U + 12345U;
+      int32_t noise = (int32_t)((lcg >> 16) & 0x3FFU) - 512;
+      int32_t spike = ((lcg >> 8) % 64U == 0U) ? 0x100000 : 0;
+      mInput[i][ch] = (int32_t)((i % 4096U) << 8) + noise + spike;
+    }
+  }
+}
+
+static void run(const char* name, const Filter_Chain_T* chain)
+{
+  static Filter_Bank_T bank;
+  memset(&bank, 0, sizeof(bank));
+  bank.numChannels = NUM_CHANNELS;
+  for (uint32_t ch = 0; ch < NUM_CHANNELS; ++ch) {
+    bank.chains[ch] = *chain;
+  }
+  if (FILTER_STATUS_OK != Filter_Init(&bank)) {
+    printf("%s: invalid config\n", name);
+    return;
+  }
+
+  // Warm up caches and branch predictors
+  int32_t out[NUM_CHANNELS];
+  for (uint32_t i = 0; i < NUM_SAMPLES / 10U; ++i) {
+    Filter_Process(&bank, mInput[i], out);
+    Bench_Use(out);
+  }
+  Filter_Reset(&bank);
+
+  uint64_t start = Bench_Now();
+  for (uint32_t i = 0; i < NUM_SAMPLES; ++i) {
+    Filter_Process(&bank, mInput[i], out);
+    Bench_Use(out);
+  }
+  uint64_t elapsed = Bench_Now() - start;
+
+  Bench_Report(name, elapsed, (uint64_t)NUM_SAMPLES * NUM_CHANNELS, "sample");
+}
+
+int main(void)
+{
+  makeInput();
+
+  const Filter_Chain_T chains[] = {
+    { .numStages = 0 },
+    { .numStages = 1, .stages = { { .type = FILTER_TYPE_IIR1, .coeff = { FILTER_Q16(0.1f) } } } },
+    { .numStages = 1, .stages = { { .type = FILTER_TYPE_IIR2, .coeff = {
+        FILTER_Q16(0.0675f), FILTER_Q16(0.1349f), FILTER_Q16(0.0675f),
+        FILTER_Q16(-1.1430f), FILTER_Q16(0.4128f) } } } },
+    { .numStages = 1, .stages = { { .type = FILTER_TYPE_MEDIAN, .taps = 3 } } },
+    { .numStages = 1, .stages = { { .type = FILTER_TYPE_MEDIAN, .taps = 9 } } },
+    { .numStages = 1, .stages = { { .type = FILTER_TYPE_SLEW, .maxStep = 0x1000 } } },
+    { .numStages = 3, .stages = {
+        { .type = FILTER_TYPE_MEDIAN, .taps = 5 },
+        { .type = FILTER_TYPE_IIR1, .coeff = { FILTER_Q16(0.25f) } },
+        { .type = FILTER_TYPE_SLEW, .maxStep = 0x1000 } } },
+  };
+  const char* names[] = {
+    "passthrough",
+    "iir1",
+    "iir2",
+    "median3",
+    "median9",
+    "slew",
+    "median5+iir1+slew",
+  };
+
+  printf("Filter, %u channels x %u samples\n", NUM_CHANNELS, NUM_SAMPLES);
+  for (size_t i = 0; i < sizeof(chains) / sizeof(chains[0]); ++i) {
+    run(names[i], &chains[i]);
+  }
+
+  return 0;
+}
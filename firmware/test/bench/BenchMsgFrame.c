@@ -0,0 +1,228 @@
+/*
+ * BenchMsgFrame.c
+ *
+ * Cost of encoding and decoding PC interface frames, and the bytes each
+ * message takes on the wire.
+ *
+ * The CRC is the software CRC (crc32.c), as on target. The COBS encode step
+ * is also timed on its own.
+ *
+ * Decoding is timed per byte received, for different receive sizes and with
+ * line noise between frames. It should cost about the same per byte in each.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "bench.h"
+
+#include <string.h>
+
+#include "uart/msgframeencode.h"
+#include "uart/msgframedecode.h"
+
+#define NUM_BYTES 2000000U // payload bytes per run
+#define RECV_CHUNK 64U // bytes per receive, like a DMA idle event
+#define NOISE_FRAME_LEN 32U
+
+static uint8_t mPayload[MSGFRAME_MAX_DATA_LEN];
+static uint8_t mEncodeBuffer[MSGFRAME_ENCODE_BUFFER_LEN(MSGFRAME_MAX_DATA_LEN)];
+static uint8_t mStream[3U * NUM_BYTES]; // fits 7 byte frames (20 on the wire)
+static MsgFrameDecode_T mDecode;
+
+static void makePayload(void)
+{
+  // Mostly small values, as in state fields and text, about 1 in 16 zero
+  uint32_t lcg = 1U;
+  for (uint32_t i = 0; i < MSGFRAME_MAX_DATA_LEN; ++i) {
+    lcg = lcg * 1103515245U + 12345U;
+    mPayload[i] = ((lcg >> 16) % 16U == 0U) ? 0U : (uint8_t)(lcg >> 24);
+  }
+}
+
+static MsgFrameEncode_T makeEncoder(uint16_t dataLen)
+{
+  MsgFrameEncode_T mf = {
+    .bufferLen = sizeof(mEncodeBuffer),
+    .dataLen = dataLen,
+    .address = 0x02U,
+    .function = 0x01U,
+    .buffer = mEncodeBuffer,
+  };
+  return mf;
+}
+
+/**
+ * @brief Encodes frames of dataLen into mStream
+ * @return Length of the stream
+ */
+static uint32_t benchEncode(uint16_t dataLen)
+{
+  char name[48];
+  MsgFrameEncode_T mf = makeEncoder(dataLen);
+  const uint32_t numFrames = NUM_BYTES / dataLen;
+  uint32_t streamLen = 0U;
+
+  uint64_t start = Bench_Now();
+  for (uint32_t i = 0; i < numFrames; ++i) {
+    memcpy(MsgFrameEncode_InitFrame(&mf), mPayload, dataLen);
+    MsgFrameEncode_Finish(&mf);
+    memcpy(mStream + streamLen, mEncodeBuffer, mf.msgLen);
+    streamLen += mf.msgLen;
+  }
+  uint64_t elapsed = Bench_Now() - start;
+
+  snprintf(name, sizeof(name), "encode %u byte frames", dataLen);
+  Bench_Report(name, elapsed, (uint64_t)numFrames * dataLen, "byte");
+  return streamLen;
+}
+
+/**
+ * @brief Decodes mStream, receiving chunk bytes at a time into the decoder
+ * @return Number of valid frames
+ */
+static uint32_t decodeStream(uint32_t streamLen, uint16_t chunk)
+{
+  MsgFrameDecode_Msg_T msg;
+  uint32_t numFrames = 0U;
+  MsgFrameDecode_Init(&mDecode);
+
+  for (uint32_t pos = 0U; pos < streamLen;) {
+    uint16_t len = 0U;
+    uint8_t* space = MsgFrameDecode_GetWriteSpace(&mDecode, &len);
+    if (len > chunk) {
+      len = chunk;
+    }
+    if (len > streamLen - pos) {
+      len = (uint16_t)(streamLen - pos);
+    }
+    memcpy(space, mStream + pos, len);
+    MsgFrameDecode_CommitBytes(&mDecode, len);
+    pos += len;
+
+    while (MsgFrameDecode_RecvMsg(&mDecode, &msg)) {
+      Bench_Use(msg.data);
+      numFrames++;
+    }
+  }
+  return numFrames;
+}
+
+static void benchDecode(uint16_t dataLen, uint32_t streamLen, uint16_t chunk)
+{
+  char name[48];
+
+  uint64_t start = Bench_Now();
+  uint32_t numFrames = decodeStream(streamLen, chunk);
+  uint64_t elapsed = Bench_Now() - start;
+
+  if (numFrames != NUM_BYTES / dataLen || 0U != mDecode.badFrames) {
+    printf("decode %u: %u frames, %u bad\n", dataLen, numFrames, mDecode.badFrames);
+  }
+  snprintf(name, sizeof(name), "decode %u byte frames by %u", dataLen, chunk);
+  Bench_Report(name, elapsed, streamLen, "wire byte");
+}
+
+/**
+ * @brief Decodes a stream of random bytes (about 1 in 16 zero) with a valid
+ * frame after each run of noise
+ */
+static void benchNoise(void)
+{
+  MsgFrameEncode_T mf = makeEncoder(NOISE_FRAME_LEN);
+  uint32_t lcg = 7U;
+  uint32_t streamLen = 0U;
+  uint32_t sentFrames = 0U;
+
+  while (streamLen < NUM_BYTES) {
+    lcg = lcg * 1103515245U + 12345U;
+    const uint32_t noiseLen = (lcg >> 16) % 256U;
+    for (uint32_t i = 0; i < noiseLen; ++i) {
+      lcg = lcg * 1103515245U + 12345U;
+      mStream[streamLen++] = ((lcg >> 16) % 16U == 0U) ? 0U : (uint8_t)(lcg >> 24);
+    }
+    mStream[streamLen++] = MSGFRAME_DELIMITER;
+
+    memcpy(MsgFrameEncode_InitFrame(&mf), mPayload, NOISE_FRAME_LEN);
+    MsgFrameEncode_Finish(&mf);
+    memcpy(mStream + streamLen, mEncodeBuffer, mf.msgLen);
+    streamLen += mf.msgLen;
+    sentFrames++;
+  }
+
+  uint64_t start = Bench_Now();
+  uint32_t numFrames = decodeStream(streamLen, RECV_CHUNK);
+  uint64_t elapsed = Bench_Now() - start;
+
+  printf("noise: %u of %u frames, %u bad frames\n", numFrames, sentFrames, mDecode.badFrames);
+  Bench_Report("decode noise and frames", elapsed, streamLen, "wire byte");
+}
+
+static void benchCobs(uint16_t len)
+{
+  char name[48];
+  const uint32_t iterations = NUM_BYTES / len;
+  const uint16_t offset = MSGFRAME_COBS_OVERHEAD(len);
+
+  uint64_t start = Bench_Now();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    memcpy(mEncodeBuffer + offset, mPayload, len);
+    Bench_Use((void*)(uintptr_t)MsgFrameEncode_Cobs(mEncodeBuffer, offset, len));
+    Bench_Use(mEncodeBuffer);
+  }
+  uint64_t elapsed = Bench_Now() - start;
+  snprintf(name, sizeof(name), "cobs encode %u bytes", len);
+  Bench_Report(name, elapsed, (uint64_t)iterations * len, "byte");
+}
+
+static void reportWire(const char* name, uint16_t dataLen, uint16_t v1Len)
+{
+  MsgFrameEncode_T mf = makeEncoder(dataLen);
+  memcpy(MsgFrameEncode_InitFrame(&mf), mPayload, dataLen);
+  MsgFrameEncode_Finish(&mf);
+  if (0U == v1Len) {
+    printf("%-32s %4u data bytes: v1  n/a, v2 %4u bytes on the wire\n",
+        name, dataLen, mf.msgLen);
+  } else {
+    printf("%-32s %4u data bytes: v1 %4u, v2 %4u bytes on the wire\n",
+        name, dataLen, v1Len, mf.msgLen);
+  }
+}
+
+int main(void)
+{
+  makePayload();
+
+  // v1 frames were fixed length: 11 bytes framing, padded data
+  printf("Wire size\n");
+  reportWire("state update, one field", 7U, 18U);
+  reportWire("state batch, 11 fields", 59U, 11U * 18U);
+  reportWire("log, short line", 20U, 43U);
+  reportWire("log, full v1 frame", 32U, 43U);
+  reportWire("log, 128 bytes", 128U, 4U * 43U);
+  reportWire("baud response", 5U, 16U);
+  reportWire("largest frame", MSGFRAME_MAX_DATA_LEN, 0U); // too big for v1
+  printf("\n");
+
+  const uint16_t sizes[] = { 7U, 32U, 128U, MSGFRAME_MAX_DATA_LEN };
+  printf("Frame codecs, %u payload bytes per run\n", NUM_BYTES);
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    uint32_t streamLen = benchEncode(sizes[i]);
+    benchDecode(sizes[i], streamLen, RECV_CHUNK);
+  }
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    benchCobs(sizes[i]);
+  }
+  printf("\n");
+
+  // Same frames, received a byte at a time up to a ring buffer at a time
+  printf("Decode by receive size\n");
+  const uint16_t chunks[] = { 1U, 16U, RECV_CHUNK, MSGFRAME_BUFFER_LEN };
+  uint32_t streamLen = benchEncode(128U);
+  for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+    benchDecode(128U, streamLen, chunks[i]);
+  }
+  benchNoise();
+
+  return 0;
+}
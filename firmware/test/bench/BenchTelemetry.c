@@ -0,0 +1,194 @@
+/*
+ * BenchTelemetry.c
+ *
+ * Link bytes per second of the vehicle state, sent as full state batches
+ * every update or as deltas with a keyframe every KEYFRAME_PERIOD updates.
+ * Bytes are counted on the wire, framing and COBS included.
+ *
+ * The state is the 11 fields of periodicupdates.c. By default it is a drive
+ * profile made up here: BMS values arrive on CAN at 10Hz, scaled like the BMS
+ * frames, and follow laps of throttle and regen. The BMS isn't in step with
+ * the VCU, so each arrival is skewed by up to a sample and they drift across
+ * the keyframes. A recorded drive can be
+ * given instead, as a CSV of 100Hz samples with a line per sample:
+ *   sdc,pdm,maxCellV,maxCellVId,maxCellT,maxCellTId,dcCurrent,dcVoltage,soc,counter,fault
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "telemetry/telemetry.h"
+#include "uart/msgframeencode.h"
+
+#define SAMPLE_HZ 100U
+#define MAX_SAMPLES (SAMPLE_HZ * 1200U) // 20 minute endurance run
+#define NUM_FIELDS 11U
+#define DATALEN 128U // PCINTERFACE_MSG_STATEBATCH_DATALEN
+#define KEYFRAME_PERIOD 10U // PCINTERFACE_MSG_STATEDELTA_KEYFRAME_PERIOD
+
+typedef struct
+{
+  uint32_t value[NUM_FIELDS];
+} Sample_T;
+
+static const uint8_t mFieldSize[NUM_FIELDS] = { 1, 1, 4, 1, 4, 1, 4, 4, 4, 1, 1 };
+static const uint8_t mFieldFloat[NUM_FIELDS] = { 0, 0, 1, 0, 1, 0, 1, 1, 1, 0, 0 };
+
+static Sample_T mSamples[MAX_SAMPLES];
+static uint32_t mNumSamples;
+static uint8_t mEncodeBuffer[MSGFRAME_ENCODE_BUFFER_LEN(DATALEN)];
+
+static uint32_t floatBits(float f)
+{
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+static float quantize(float f, float step)
+{
+  return (float)(int32_t)(f / step + (f < 0.0f ? -0.5f : 0.5f)) * step;
+}
+
+static void makeDrive(void)
+{
+  uint32_t lcg = 1U;
+  float soc = 95.0f;
+  float cellTemp = 25.0f;
+  Sample_T bms = { { 0 } };
+  uint32_t nextUpdate = 3U;
+
+  mNumSamples = MAX_SAMPLES;
+  for (uint32_t i = 0; i < mNumSamples; ++i) {
+    if (i == nextUpdate) {
+      // 80s laps: accelerate, brake with regen, corner at part throttle
+      const float t = (float)(i % (80U * SAMPLE_HZ)) / (float)SAMPLE_HZ;
+      const float phase = t - 10.0f * (float)(int32_t)(t / 10.0f);
+      float current = (phase < 5.0f) ? 180.0f : (phase < 7.0f) ? -60.0f : 40.0f;
+      lcg = lcg * 1103515245U + 12345U;
+      current += (float)((int32_t)((lcg >> 16) & 0xFFU) - 128) * 0.05f;
+
+      soc -= current * 0.1f / 3600.0f / 60.0f; // 60Ah pack
+      cellTemp += (current > 0.0f ? current : -current) * 1e-5f;
+      const float voltage = 360.0f + soc * 0.5f - current * 0.08f;
+
+      bms.value[0] = 0x0AU; // SDC
+      bms.value[1] = 0x31U; // PDM
+      bms.value[2] = floatBits(quantize(voltage / 96.0f + 0.02f, 0.001f));
+      bms.value[3] = (lcg >> 24) % 64U == 0U ? (lcg >> 8) % 96U : bms.value[3];
+      bms.value[4] = floatBits(quantize(cellTemp, 1.0f));
+      bms.value[5] = 17U;
+      bms.value[6] = floatBits(quantize(current, 0.1f));
+      bms.value[7] = floatBits(quantize(voltage, 0.1f));
+      bms.value[8] = floatBits(quantize(soc, 0.5f));
+      bms.value[9] = (bms.value[9] + 1U) & 0xFFU;
+      bms.value[10] = 0U;
+
+      // 10Hz, give or take a sample
+      nextUpdate += SAMPLE_HZ / 10U - 1U + (lcg >> 12) % 3U;
+    }
+    mSamples[i] = bms;
+  }
+}
+
+static bool readDrive(const char* path)
+{
+  FILE* f = fopen(path, "r");
+  if (NULL == f) {
+    return false;
+  }
+
+  char line[256];
+  mNumSamples = 0U;
+  while (mNumSamples < MAX_SAMPLES && NULL != fgets(line, sizeof(line), f)) {
+    char* pos = line;
+    for (uint32_t field = 0; field < NUM_FIELDS; ++field) {
+      if (mFieldFloat[field]) {
+        mSamples[mNumSamples].value[field] = floatBits(strtof(pos, &pos));
+      } else {
+        mSamples[mNumSamples].value[field] = (uint32_t)strtoul(pos, &pos, 0);
+      }
+      pos += (',' == *pos) ? 1 : 0;
+    }
+    mNumSamples++;
+  }
+  fclose(f);
+  return mNumSamples > 0U;
+}
+
+/**
+ * @brief Sends the drive at rate, encoded like periodicupdates.c
+ * @return Bytes on the wire
+ */
+static uint64_t sendDrive(uint32_t rate, uint16_t keyframePeriod, uint64_t* encodeTime)
+{
+  static Telemetry_T stream;
+  MsgFrameEncode_T mf = {
+    .bufferLen = sizeof(mEncodeBuffer),
+    .address = 0x02U,
+    .function = 0x04U,
+    .buffer = mEncodeBuffer,
+  };
+  stream.keyframePeriod = keyframePeriod;
+  Telemetry_Init(&stream);
+
+  uint64_t wireBytes = 0U;
+  uint64_t elapsed = 0U;
+  for (uint32_t i = 0; i < mNumSamples; i += SAMPLE_HZ / rate) {
+    uint64_t start = Bench_Now();
+    Telemetry_Begin(&stream);
+    uint8_t* data = MsgFrameEncode_InitFrame(&mf);
+    uint16_t len = 0U;
+    for (uint16_t field = 0; field < NUM_FIELDS; ++field) {
+      len = (uint16_t)(len + Telemetry_EncodeField(&stream, data + len,
+          (uint16_t)(field + 1U), mFieldSize[field], mSamples[i].value[field]));
+    }
+    if (len > 0U) {
+      mf.dataLen = len;
+      MsgFrameEncode_Finish(&mf);
+      wireBytes += mf.msgLen;
+    }
+    elapsed += Bench_Now() - start;
+  }
+
+  if (NULL != encodeTime) {
+    *encodeTime = elapsed;
+  }
+  return wireBytes;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc > 1) {
+    if (!readDrive(argv[1])) {
+      printf("Can't read drive %s\n", argv[1]);
+      return 1;
+    }
+    printf("Drive %s, %u s\n", argv[1], mNumSamples / SAMPLE_HZ);
+  } else {
+    makeDrive();
+    printf("Made up drive, %u s\n", mNumSamples / SAMPLE_HZ);
+  }
+
+  const double seconds = (double)mNumSamples / SAMPLE_HZ;
+  const uint32_t rates[] = { 1U, 10U, 100U };
+  for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); ++r) {
+    uint64_t encodeTime = 0U;
+    const uint64_t batch = sendDrive(rates[r], 1U, NULL);
+    const uint64_t delta = sendDrive(rates[r], KEYFRAME_PERIOD, &encodeTime);
+    printf("%3u Hz: batch %7.1f B/s, delta %7.1f B/s (%4.1f%%)\n",
+        rates[r], (double)batch / seconds, (double)delta / seconds,
+        100.0 * (double)delta / (double)batch);
+
+    char name[48];
+    snprintf(name, sizeof(name), "encode delta update at %u Hz", rates[r]);
+    Bench_Report(name, encodeTime, (mNumSamples + SAMPLE_HZ / rates[r] - 1U) / (SAMPLE_HZ / rates[r]), "update");
+  }
+
+  return 0;
+}
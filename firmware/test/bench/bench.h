@@ -0,0 +1,61 @@
+/*
+ * bench.h
+ *
+ * Helpers for host benchmarks.
+ *
+ * Cycle counts come from the CPU timestamp counter where available (x86),
+ * otherwise from a monotonic clock in nanoseconds. Numbers are for comparing
+ * implementations on the same machine; they are not target (Cortex-M7) cycles.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+static inline uint64_t Bench_Now(void)
+{
+  return __rdtsc();
+}
+#else
+#define BENCH_UNIT "ns"
+static inline uint64_t Bench_Now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+static inline double Bench_Seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Stops the compiler from optimizing away a result.
+ */
+static inline void Bench_Use(const void* p)
+{
+  __asm__ volatile("" : : "r"(p) : "memory");
+}
+
+/**
+ * @brief Prints a result line, e.g. "iir1      12.3 cycles/sample"
+ */
+static inline void Bench_Report(const char* name, uint64_t elapsed, uint64_t count, const char* per)
+{
+  printf("%-32s %8.2f %s/%s\n", name, (double)elapsed / (double)count, BENCH_UNIT, per);
+}
+
+#endif /* BENCH_H_ */
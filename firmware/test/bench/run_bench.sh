@@ -0,0 +1,17 @@
+#!/bin/bash -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd -P)"
+BUILD_DIR=${SCRIPT_DIR}/build
+
+mkdir -p ${BUILD_DIR}
+cd ${BUILD_DIR}
+
+cmake -DCMAKE_BUILD_TYPE=Release ${SCRIPT_DIR}
+make -j$(nproc)
+
+for BENCH in $(ls Bench*)
+do
+    echo "Running ${BENCH}"
+    ./${BENCH}
+    echo
+done
@@ -41,6 +41,7 @@ typedef struct
     uint8_t streamBufferData[MOCK_STREAMBUFFER_SIZE];
     size_t start;
     size_t end;
+    size_t capacity; // Max contents, 0 for no limit (see mockSetStreamBufferCapacity)
     // Must be kept the same as StreamBufferDef_t in stream_buffer.h
 } StaticStreamBuffer_t;
 
@@ -29,6 +29,7 @@ StreamBufferHandle_t xStreamBufferCreateStatic(
     (void)pucStreamBufferStorageArea;
 
     StreamBufferHandle_t handle = (StreamBufferHandle_t)pxStaticStreamBuffer;
+    handle->capacity = 0U;
 
     return handle;
 }
@@ -42,6 +43,14 @@ size_t xStreamBufferSend(
     (void)xStreamBuffer;
     (void)xTicksToWait;
 
+    if (xStreamBuffer->capacity > 0U) {
+        size_t contentsSize = xStreamBuffer->end - xStreamBuffer->start;
+        size_t freeBytes = xStreamBuffer->capacity - contentsSize;
+        if (xDataLengthBytes > freeBytes) {
+            xDataLengthBytes = freeBytes;
+        }
+    }
+
     size_t mockBufferAvailBytes = MOCK_STREAMBUFFER_SIZE - xStreamBuffer->end;
     assert(mockBufferAvailBytes >= xDataLengthBytes);
 
@@ -116,6 +125,11 @@ void mockClearStreamBufferData(StreamBufferHandle_t xStreamBuffer)
     xStreamBuffer->end = 0;
 }
 
+void mockSetStreamBufferCapacity(StreamBufferHandle_t xStreamBuffer, size_t capacity)
+{
+    xStreamBuffer->capacity = capacity;
+}
+
 size_t mockGetStreamBufferLen(StreamBufferHandle_t xStreamBuffer)
 {
     size_t size = xStreamBuffer->end - xStreamBuffer->start;
@@ -13,6 +13,8 @@
 
 // ------------------- Static data -------------------
 static uint32_t mNotifyValue = 0;
+static StaticTask_t mCurrentTask;
+static UBaseType_t mCurrentTaskNumber = 1;
 
 // ------------------- Methods -------------------
 TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode,
@@ -35,6 +37,13 @@ TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode,
     return handle;
 }
 
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    (void)xTaskToNotify;
+    mNotifyValue++;
+    return pdPASS;
+}
+
 void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t* pxHigherPriorityTaskWoken)
 {
     (void)xTaskToNotify;
@@ -50,13 +59,28 @@ uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
 
     if (pdTRUE == xClearCountOnExit) {
         mNotifyValue = 0;
-    } else {
+    } else if (mNotifyValue > 0U) {
         mNotifyValue--;
     }
 
     return retValue;
 }
 
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t)&mCurrentTask;
+}
+
+UBaseType_t uxTaskGetTaskNumber(TaskHandle_t xTask)
+{
+    return (NULL == xTask) ? 0U : mCurrentTaskNumber;
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+    return (0U == mCurrentTaskNumber) ? taskSCHEDULER_NOT_STARTED : taskSCHEDULER_RUNNING;
+}
+
 void mockSetTaskNotifyValue(uint32_t value)
 {
     mNotifyValue = value;
@@ -66,3 +90,8 @@ uint32_t mockGetTaskNotifyValue(void)
 {
     return mNotifyValue;
 }
+
+void mockSetCurrentTaskNumber(UBaseType_t number)
+{
+    mCurrentTaskNumber = number;
+}
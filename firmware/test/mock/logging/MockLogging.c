@@ -34,9 +34,11 @@ Logging_Status_T Log_EnableSWO(Logging_T* log)
     return LOGGING_STATUS_OK;
 }
 
-void Log_Print(Logging_T* logData, const char* message)
+void Log_PrintText(Logging_T* logData, Logging_Module_T module, uint8_t level, const char* message)
 {
     (void)logData;
+    (void)module;
+    (void)level;
 
     size_t len = strnlen(message, LOGGING_MAX_MSG_LEN);
     assert(len + offset + 1U <= MOCK_LOG_BUFFER_LEN);
@@ -7,11 +7,32 @@
 #include "MockStm32f7xx_hal.h"
 
 static bool dmaInterruptsEnabled = true;
+static uint32_t halTick = 0;
+static uint32_t ipsr = 0;
 
-uint32_t stubITM_SendChar(uint32_t ch)
+uint32_t SystemCoreClock = 216000000U;
+CoreDebug_Type mockCoreDebug;
+DWT_Type mockDWT;
+ITM_Type mockITM;
+
+uint32_t stubHAL_GetTick(void)
+{
+    return halTick;
+}
+
+void mockSet_HAL_GetTick(uint32_t tick)
+{
+    halTick = tick;
+}
+
+uint32_t stub__get_IPSR(void)
+{
+    return ipsr;
+}
+
+void mockSet_IPSR(uint32_t exception)
 {
-    (void)ch;
-    return 0;
+    ipsr = exception;
 }
 
 void stubDmaInterruptsSetEnabled(UART_HandleTypeDef* handle, bool en, uint32_t flags)
@@ -15,15 +15,69 @@
 #include "stm32_hal/MockStm32f7xx_hal_gpio.h"
 #include "stm32_hal/MockStm32f7xx_hal_tim.h"
 #include "stm32_hal/MockStm32f7xx_hal_crc.h"
+#include "stm32_hal/MockStm32f7xx_hal_dma.h"
 #include "stm32_hal/MockStm32f7xx_hal_cortex.h"
 
 #include <stdint.h>
 
 #define portMAX_DELAY (TickType_t) 0xffffffffUL
 
-// ITM_SendChar
-uint32_t stubITM_SendChar(uint32_t ch);
-#define ITM_SendChar stubITM_SendChar
+// ITM, each stimulus port keeps the last write of each size. Reading u32
+// gives whether the FIFO is ready, so tests set it to 1.
+typedef struct
+{
+    uint32_t u32;
+    uint16_t u16;
+    uint8_t u8;
+} MockITM_Port_T;
+
+typedef struct
+{
+    MockITM_Port_T PORT[32];
+    uint32_t TER;
+    uint32_t TCR;
+} ITM_Type;
+
+extern ITM_Type mockITM;
+#define ITM (&mockITM)
+
+#define ITM_TCR_ITMENA_Msk 1UL
+
+// Barriers
+#define __DMB() __sync_synchronize()
+
+// Core
+extern uint32_t SystemCoreClock;
+
+uint32_t stub__get_IPSR(void);
+#define __get_IPSR stub__get_IPSR
+void mockSet_IPSR(uint32_t exception);
+
+// Debug, with a cycle counter tests can set
+typedef struct
+{
+    uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+    uint32_t CTRL;
+    uint32_t CYCCNT;
+    uint32_t LAR;
+} DWT_Type;
+
+extern CoreDebug_Type mockCoreDebug;
+extern DWT_Type mockDWT;
+#define CoreDebug (&mockCoreDebug)
+#define DWT (&mockDWT)
+
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24U)
+#define DWT_CTRL_CYCCNTENA_Msk 1UL
+
+// HAL tick
+uint32_t stubHAL_GetTick(void);
+#define HAL_GetTick stubHAL_GetTick
+void mockSet_HAL_GetTick(uint32_t tick);
 
 // Peripherals
 #define CAN1    ((CAN_TypeDef*) 0UL)
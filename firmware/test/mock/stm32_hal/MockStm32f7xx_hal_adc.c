@@ -6,48 +6,174 @@
  */
 #include "MockStm32f7xx_hal_adc.h"
 
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 
+#define MOCK_ADC_MAX_HANDLES 3U
+
 // ------------------- Static data -------------------
+struct mockAdcDma {
+    const ADC_HandleTypeDef* hadc;
+    bool started;
+    uint16_t* dataPtr;
+    uint32_t dataLen; // Number of half-words in dataPtr (not number of bytes)
+    ADC_AnalogWDGConfTypeDef awdConfig;
+    bool awdInterruptEnabled;
+};
+
 static HAL_StatusTypeDef mStatusStartDMA = HAL_OK;
-static uint32_t* mDataPtr = NULL;
-static uint32_t mDataLen = 0; // Number of elements in mDataPtr (not number of bytes)
+static HAL_StatusTypeDef mStatusMultiModeConfig = HAL_OK;
+static HAL_StatusTypeDef mStatusAnalogWDGConfig = HAL_OK;
+static ADC_MultiModeTypeDef mMultiMode = {0};
+static struct mockAdcDma mAdcs[MOCK_ADC_MAX_HANDLES] = {0};
+static struct mockAdcDma* mLastStarted = NULL;
+static uint32_t mLastLength = 0;
+
+// ------------------- Private methods -------------------
+static struct mockAdcDma* getMockAdc(const ADC_HandleTypeDef* hadc)
+{
+    for (uint32_t i = 0; i < MOCK_ADC_MAX_HANDLES; ++i) {
+        if (mAdcs[i].hadc == hadc) {
+            return &mAdcs[i];
+        }
+    }
+    for (uint32_t i = 0; i < MOCK_ADC_MAX_HANDLES; ++i) {
+        if (mAdcs[i].hadc == NULL) {
+            mAdcs[i].hadc = hadc;
+            return &mAdcs[i];
+        }
+    }
+
+    assert(false);
+    return NULL;
+}
+
+static void startDma(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t numHalfWords)
+{
+    struct mockAdcDma* adc = getMockAdc(hadc);
+    adc->started = true;
+    adc->dataPtr = (uint16_t*)pData;
+    adc->dataLen = numHalfWords;
+    mLastStarted = adc;
+}
 
 // ------------------- Methods -------------------
+HAL_StatusTypeDef stubHAL_ADC_Start(ADC_HandleTypeDef* hadc)
+{
+    getMockAdc(hadc)->started = true;
+    return HAL_OK;
+}
+
 HAL_StatusTypeDef stubHAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length)
+{
+    mLastLength = Length;
+    startDma(hadc, pData, Length);
+
+    return mStatusStartDMA;
+}
+
+HAL_StatusTypeDef stubHAL_ADCEx_MultiModeConfigChannel(ADC_HandleTypeDef* hadc, ADC_MultiModeTypeDef* multimode)
 {
     (void)hadc;
+    mMultiMode = *multimode;
+    return mStatusMultiModeConfig;
+}
 
-    mDataPtr = pData;
-    mDataLen = Length;
+HAL_StatusTypeDef stubHAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length)
+{
+    // DMA mode 2 transfers two half-words per DMA item
+    uint32_t itemSize = (ADC_DMAACCESSMODE_2 == mMultiMode.DMAAccessMode) ? 2U : 1U;
+    mLastLength = Length;
+    startDma(hadc, pData, Length * itemSize);
 
     return mStatusStartDMA;
 }
 
-void mockSetADCData(uint32_t* data, uint32_t dataLength)
+HAL_StatusTypeDef stubHAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef* hadc, ADC_AnalogWDGConfTypeDef* AnalogWDGConfig)
 {
-    assert(mDataPtr != NULL);
-    assert(mDataLen >= dataLength);
+    struct mockAdcDma* adc = getMockAdc(hadc);
+    adc->awdConfig = *AnalogWDGConfig;
+    adc->awdInterruptEnabled = (ENABLE == AnalogWDGConfig->ITMode);
+    return mStatusAnalogWDGConfig;
+}
+
+void stubADCInterruptSetEnabled(ADC_HandleTypeDef* hadc, bool en, uint32_t it)
+{
+    if (ADC_IT_AWD == it) {
+        getMockAdc(hadc)->awdInterruptEnabled = en;
+    }
+}
 
-    memcpy(mDataPtr, data, dataLength * sizeof(uint32_t));
-    mDataLen = dataLength;
+void mockSetADCData(const uint16_t* data, uint32_t dataLength)
+{
+    assert(mLastStarted != NULL);
+    mockSetADCDataHandle(mLastStarted->hadc, data, dataLength);
 }
 
-void mockSetADCDataChannel(const uint32_t channel, const uint32_t val)
+void mockSetADCDataChannel(const uint32_t channel, const uint16_t val)
 {
-    assert(mDataPtr != NULL);
-    assert(channel <= mDataLen);
+    assert(mLastStarted != NULL);
+    assert(mLastStarted->dataPtr != NULL);
+    assert(channel < mLastStarted->dataLen);
 
-    mDataPtr[channel] = val;
+    mLastStarted->dataPtr[channel] = val;
+}
+
+void mockSetADCDataHandle(const ADC_HandleTypeDef* hadc, const uint16_t* data, uint32_t dataLength)
+{
+    struct mockAdcDma* adc = getMockAdc(hadc);
+    assert(adc->dataPtr != NULL);
+    assert(adc->dataLen >= dataLength);
+
+    memcpy(adc->dataPtr, data, dataLength * sizeof(uint16_t));
 }
 
 void mockClearADCClear(void)
 {
-    memset(mDataPtr, 0, mDataLen * sizeof(uint32_t));
+    for (uint32_t i = 0; i < MOCK_ADC_MAX_HANDLES; ++i) {
+        if (NULL != mAdcs[i].dataPtr) {
+            memset(mAdcs[i].dataPtr, 0, mAdcs[i].dataLen * sizeof(uint16_t));
+        }
+    }
 }
 
 void mockSet_HAL_ADC_Start_DMA_Status(HAL_StatusTypeDef status)
 {
     mStatusStartDMA = status;
 }
+
+void mockSet_HAL_ADCEx_MultiModeConfigChannel_Status(HAL_StatusTypeDef status)
+{
+    mStatusMultiModeConfig = status;
+}
+
+ADC_MultiModeTypeDef mockGet_HAL_ADCEx_MultiMode(void)
+{
+    return mMultiMode;
+}
+
+uint32_t mockGet_HAL_ADC_StartDMALength(void)
+{
+    return mLastLength;
+}
+
+bool mockGet_HAL_ADC_Started(const ADC_HandleTypeDef* hadc)
+{
+    return getMockAdc(hadc)->started;
+}
+
+void mockSet_HAL_ADC_AnalogWDGConfig_Status(HAL_StatusTypeDef status)
+{
+    mStatusAnalogWDGConfig = status;
+}
+
+ADC_AnalogWDGConfTypeDef mockGet_HAL_ADC_AnalogWDGConfig(const ADC_HandleTypeDef* hadc)
+{
+    return getMockAdc(hadc)->awdConfig;
+}
+
+bool mockGet_HAL_ADC_AWDInterruptEnabled(const ADC_HandleTypeDef* hadc)
+{
+    return getMockAdc(hadc)->awdInterruptEnabled;
+}
@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include "MockStm32f7xx_hal_def.h"
 
 #define MOCK_ADC_MAX_DATA 64
@@ -35,25 +36,100 @@ typedef struct
     ADC_InitTypeDef Init;
 } ADC_HandleTypeDef;
 
+typedef struct
+{
+    uint32_t Mode;
+    uint32_t DMAAccessMode;
+    uint32_t TwoSamplingDelay;
+} ADC_MultiModeTypeDef;
+
+typedef struct
+{
+    uint32_t WatchdogMode;
+    uint32_t HighThreshold;
+    uint32_t LowThreshold;
+    uint32_t Channel;
+    uint32_t ITMode;
+    uint32_t WatchdogNumber;
+} ADC_AnalogWDGConfTypeDef;
+
 // These are supposed to be pointers to the peripherals, but for the purposes
 // of the mock, unique numbers cast to a pointer will work fine.
 // Don't dereference them...
 #define ADC1 ((ADC_TypeDef*)0x0)
+#define ADC2 ((ADC_TypeDef*)0x1)
+#define ADC3 ((ADC_TypeDef*)0x2)
 
 
 #define ADC_DATAALIGN_RIGHT      ((uint32_t)0x00000000U)
 
+#define ADC_MODE_INDEPENDENT        ((uint32_t)0x00000000U)
+#define ADC_DUALMODE_REGSIMULT      ((uint32_t)0x00000006U)
+#define ADC_DUALMODE_INTERL         ((uint32_t)0x00000007U)
+#define ADC_TRIPLEMODE_REGSIMULT    ((uint32_t)0x00000016U)
+#define ADC_TRIPLEMODE_INTERL       ((uint32_t)0x00000017U)
+
+#define ADC_DMAACCESSMODE_DISABLED  ((uint32_t)0x00000000U)
+#define ADC_DMAACCESSMODE_1         ((uint32_t)0x00004000U)
+#define ADC_DMAACCESSMODE_2         ((uint32_t)0x00008000U)
+
+#define ADC_TWOSAMPLINGDELAY_5CYCLES ((uint32_t)0x00000000U)
+
+#define ADC_ANALOGWATCHDOG_SINGLE_REG ((uint32_t)0x00800200U)
+#define ADC_IT_AWD                  ((uint32_t)0x00000040U)
+
+#define ADC_CHANNEL_0           ((uint32_t)0x00000000U)
+#define ADC_CHANNEL_1           ((uint32_t)0x00000001U)
+#define ADC_CHANNEL_2           ((uint32_t)0x00000002U)
+#define ADC_CHANNEL_3           ((uint32_t)0x00000003U)
+#define ADC_CHANNEL_4           ((uint32_t)0x00000004U)
+#define ADC_CHANNEL_5           ((uint32_t)0x00000005U)
+#define ADC_CHANNEL_6           ((uint32_t)0x00000006U)
+#define ADC_CHANNEL_7           ((uint32_t)0x00000007U)
+#define ADC_CHANNEL_8           ((uint32_t)0x00000008U)
+#define ADC_CHANNEL_9           ((uint32_t)0x00000009U)
+#define ADC_CHANNEL_10          ((uint32_t)0x0000000AU)
+#define ADC_CHANNEL_11          ((uint32_t)0x0000000BU)
+#define ADC_CHANNEL_12          ((uint32_t)0x0000000CU)
+#define ADC_CHANNEL_13          ((uint32_t)0x0000000DU)
+#define ADC_CHANNEL_14          ((uint32_t)0x0000000EU)
+#define ADC_CHANNEL_15          ((uint32_t)0x0000000FU)
+
 
 // ================== Define methods ==================
+HAL_StatusTypeDef stubHAL_ADC_Start(ADC_HandleTypeDef* hadc);
 HAL_StatusTypeDef stubHAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length);
+HAL_StatusTypeDef stubHAL_ADCEx_MultiModeConfigChannel(ADC_HandleTypeDef* hadc, ADC_MultiModeTypeDef* multimode);
+HAL_StatusTypeDef stubHAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length);
+HAL_StatusTypeDef stubHAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef* hadc, ADC_AnalogWDGConfTypeDef* AnalogWDGConfig);
+void stubADCInterruptSetEnabled(ADC_HandleTypeDef* hadc, bool en, uint32_t it);
 
 // Replace real methods with mock stubs
+#define HAL_ADC_Start stubHAL_ADC_Start
 #define HAL_ADC_Start_DMA stubHAL_ADC_Start_DMA
+#define HAL_ADCEx_MultiModeConfigChannel stubHAL_ADCEx_MultiModeConfigChannel
+#define HAL_ADCEx_MultiModeStart_DMA stubHAL_ADCEx_MultiModeStart_DMA
+#define HAL_ADC_AnalogWDGConfig stubHAL_ADC_AnalogWDGConfig
+#define __HAL_ADC_ENABLE_IT(handle, it) stubADCInterruptSetEnabled(handle, true, it)
+#define __HAL_ADC_DISABLE_IT(handle, it) stubADCInterruptSetEnabled(handle, false, it)
 
 // ================== Mock control methods ==================
-void mockSetADCData(uint32_t* data, uint32_t dataLength);
-void mockSetADCDataChannel(const uint32_t channel, const uint32_t val);
+/**
+ * The mock DMA buffer is treated as a stream of half-word conversions (as
+ * the ADC driver configures the DMA). Data methods without a handle operate
+ * on the most recently started ADC.
+ */
+void mockSetADCData(const uint16_t* data, uint32_t dataLength);
+void mockSetADCDataChannel(const uint32_t channel, const uint16_t val);
+void mockSetADCDataHandle(const ADC_HandleTypeDef* hadc, const uint16_t* data, uint32_t dataLength);
 void mockClearADCClear(void);
 void mockSet_HAL_ADC_Start_DMA_Status(HAL_StatusTypeDef status);
+void mockSet_HAL_ADCEx_MultiModeConfigChannel_Status(HAL_StatusTypeDef status);
+ADC_MultiModeTypeDef mockGet_HAL_ADCEx_MultiMode(void);
+uint32_t mockGet_HAL_ADC_StartDMALength(void);
+bool mockGet_HAL_ADC_Started(const ADC_HandleTypeDef* hadc);
+void mockSet_HAL_ADC_AnalogWDGConfig_Status(HAL_StatusTypeDef status);
+ADC_AnalogWDGConfTypeDef mockGet_HAL_ADC_AnalogWDGConfig(const ADC_HandleTypeDef* hadc);
+bool mockGet_HAL_ADC_AWDInterruptEnabled(const ADC_HandleTypeDef* hadc);
 
 #endif
@@ -25,3 +25,16 @@ void mockSet_CRC(uint32_t crc)
 {
     mCrcValue = crc;
 }
+
+void mockFeed_CRC(CRC_TypeDef* instance, const uint8_t* data, uint32_t len)
+{
+    // Default polynomial, MSB first, byte input
+    uint32_t crc = instance->DR;
+    for (uint32_t i = 0U; i < len; ++i) {
+        crc ^= (uint32_t)data[i] << 24;
+        for (uint8_t bit = 0U; bit < 8U; ++bit) {
+            crc = (crc & 0x80000000U) ? (crc << 1) ^ 0x04C11DB7U : (crc << 1);
+        }
+    }
+    instance->DR = crc;
+}
@@ -16,8 +16,8 @@
 // ================== Define types ==================
 typedef struct
 {
-    // Empty for mock
-    uint8_t tmp;
+    uint32_t DR;
+    uint32_t INIT;
 } CRC_TypeDef;
 
 typedef struct
@@ -40,6 +40,9 @@ typedef struct
 #define CRC_INPUTDATA_FORMAT_HALFWORDS             0x00000002U  /*!< Input data in half-word format */
 #define CRC_INPUTDATA_FORMAT_WORDS                 0x00000003U  /*!< Input data in word format      */
 
+#define __HAL_CRC_INITIALCRCVALUE_CONFIG(__HANDLE__, __INIT__) ((__HANDLE__)->Instance->INIT = (__INIT__))
+#define __HAL_CRC_DR_RESET(__HANDLE__) ((__HANDLE__)->Instance->DR = (__HANDLE__)->Instance->INIT)
+
 
 // ================== Define methods ==================
 uint32_t stubHAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
@@ -50,4 +53,10 @@ uint32_t stubHAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint
 // ================== Mock control methods ==================
 void mockSet_CRC(uint32_t crc);
 
+/**
+ * @brief Writes bytes to the data register, as DMA would. Unlike
+ * HAL_CRC_Calculate, DR holds the real CRC-32/MPEG-2 afterwards.
+ */
+void mockFeed_CRC(CRC_TypeDef* instance, const uint8_t* data, uint32_t len);
+
 #endif
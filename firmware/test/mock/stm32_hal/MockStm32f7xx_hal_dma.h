@@ -0,0 +1,75 @@
+/*
+ * MockStm32f7xx_hal_dma.h
+ * Some excerpts from stm32f7xx_hal_dma.h in STM32 HAL.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#ifndef MOCK_STM32F7xx_DMA_H_
+#define MOCK_STM32F7xx_DMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MockStm32f7xx_hal_def.h"
+
+// ================== Define types ==================
+typedef struct __DMA_HandleTypeDef
+{
+    void* Instance;
+    void* Parent;
+    void (*XferCpltCallback)(struct __DMA_HandleTypeDef* hdma);
+    void (*XferErrorCallback)(struct __DMA_HandleTypeDef* hdma);
+} DMA_HandleTypeDef;
+
+// ================== Define methods ==================
+// Addresses are pointer sized so the host can follow them
+HAL_StatusTypeDef stubHAL_DMA_Start_IT(
+    DMA_HandleTypeDef* hdma,
+    uintptr_t SrcAddress,
+    uintptr_t DstAddress,
+    uint32_t DataLength);
+
+// Replace real methods with mock stubs
+#define HAL_DMA_Start_IT stubHAL_DMA_Start_IT
+
+// ================== Mock control methods ==================
+/**
+ * @brief Sets the status returned when a transfer is started. A transfer is
+ * always refused (HAL_BUSY) while one is in progress.
+ */
+void mockSet_HAL_DMA_Start_IT_Status(HAL_StatusTypeDef status);
+
+/**
+ * @brief Gets whether a transfer has been started and not completed
+ */
+bool mockGet_HAL_DMA_Busy(void);
+
+/**
+ * @brief Gets the last transfer started
+ */
+uintptr_t mockGet_HAL_DMA_SrcAddress(void);
+uintptr_t mockGet_HAL_DMA_DstAddress(void);
+uint32_t mockGet_HAL_DMA_DataLength(void);
+
+/**
+ * @brief Gets the number of transfers started
+ */
+uint32_t mockGet_HAL_DMA_StartCount(void);
+
+/**
+ * @brief Completes the transfer in progress, as from the DMA interrupt
+ */
+void mockComplete_HAL_DMA(DMA_HandleTypeDef* hdma);
+
+/**
+ * @brief Fails the transfer in progress, as from the DMA interrupt
+ */
+void mockError_HAL_DMA(DMA_HandleTypeDef* hdma);
+
+/**
+ * @brief Clears transfer state between tests
+ */
+void mockReset_HAL_DMA(void);
+
+#endif
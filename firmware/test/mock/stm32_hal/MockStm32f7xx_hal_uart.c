@@ -32,10 +32,39 @@ static HAL_StatusTypeDef mStatusReceiveToIdle_DMA = HAL_OK;
 static uint8_t uartDataBuf[MOCK_UART_BUFFER_SIZE] = { 0 };
 static size_t uartDataBufLen = 0U;
 
+// Circular DMA reception
+#define MOCK_UART_MAX_RX 8
+typedef struct
+{
+    UART_HandleTypeDef* huart;
+    uint8_t* buf;
+    uint16_t size;
+    uint16_t pos; // DMA write position
+    uint32_t starts;
+    uint32_t baudRate; // Set by HAL_UART_Init
+} MockUartRx_T;
+static MockUartRx_T mRx[MOCK_UART_MAX_RX] = { 0 };
+
+static MockUartRx_T* getRx(UART_HandleTypeDef* huart)
+{
+    for (size_t i = 0; i < MOCK_UART_MAX_RX; ++i) {
+        if (mRx[i].huart == huart || NULL == mRx[i].huart) {
+            mRx[i].huart = huart;
+            return &mRx[i];
+        }
+    }
+    assert(false);
+    return NULL;
+}
+
 // ------------------- Methods -------------------
 HAL_StatusTypeDef stubHAL_UART_Init(UART_HandleTypeDef *huart)
 {
-    (void)huart;
+    if (HAL_OK == mStatusInit) {
+        getRx(huart)->baudRate = huart->Init.BaudRate;
+        huart->gState = HAL_UART_STATE_READY;
+        huart->RxState = HAL_UART_STATE_READY;
+    }
 
     return mStatusInit;
 }
@@ -87,11 +116,13 @@ HAL_StatusTypeDef stubHAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pD
 
 HAL_StatusTypeDef stubHAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
 {
-    (void)huart;
 
     assert(Size <= MOCK_UART_BUFFER_SIZE);
     memcpy(uartDataBuf, pData, Size);
     uartDataBufLen = Size;
+    if (HAL_OK == mStatusTransmit_DMA) {
+        huart->gState = HAL_UART_STATE_BUSY_TX;
+    }
 
     return mStatusTransmit_DMA;
 }
@@ -135,14 +166,18 @@ HAL_StatusTypeDef stubHAL_UART_Abort(UART_HandleTypeDef *huart)
 
 HAL_StatusTypeDef stubHAL_UART_AbortTransmit(UART_HandleTypeDef *huart)
 {
-    (void)huart;
+    if (HAL_OK == mStatusAbortTransmit) {
+        huart->gState = HAL_UART_STATE_READY;
+    }
 
     return mStatusAbortTransmit;
 }
 
 HAL_StatusTypeDef stubHAL_UART_AbortReceive(UART_HandleTypeDef *huart)
 {
-    (void)huart;
+    if (HAL_OK == mStatusAbortReceive) {
+        huart->RxState = HAL_UART_STATE_READY;
+    }
 
     return mStatusAbortReceive;
 }
@@ -170,9 +205,14 @@ HAL_StatusTypeDef stubHAL_UART_AbortReceive_IT(UART_HandleTypeDef *huart)
 
 HAL_StatusTypeDef stubHAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t rxBufSize)
 {
-    (void)huart;
-    (void)pData;
-    (void)rxBufSize;
+    if (HAL_OK == mStatusReceiveToIdle_DMA) {
+        MockUartRx_T* rx = getRx(huart);
+        rx->buf = pData;
+        rx->size = rxBufSize;
+        rx->pos = 0U;
+        rx->starts++;
+        huart->RxState = HAL_UART_STATE_BUSY_RX;
+    }
 
     return mStatusReceiveToIdle_DMA;
 }
@@ -311,3 +351,50 @@ uint8_t* mockGet_HAL_UART_Data(void)
 {
     return uartDataBuf;
 }
+
+// Weak default, as in the HAL, for tests not including the UART driver
+__attribute__((weak)) void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t rxBufSize)
+{
+    (void)huart;
+    (void)rxBufSize;
+}
+
+void mockRecv_HAL_UARTEx_DMA(
+    UART_HandleTypeDef* huart,
+    const void* data,
+    size_t len,
+    bool idle)
+{
+    MockUartRx_T* rx = getRx(huart);
+    if (HAL_UART_STATE_BUSY_RX != huart->RxState) {
+        return;
+    }
+
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < len; ++i) {
+        rx->buf[rx->pos] = bytes[i];
+        rx->pos++;
+
+        if (rx->pos == rx->size / 2U) {
+            HAL_UARTEx_RxEventCallback(huart, rx->size / 2U);
+        } else if (rx->pos == rx->size) {
+            rx->pos = 0U; // circular
+            HAL_UARTEx_RxEventCallback(huart, rx->size);
+        }
+    }
+
+    // HAL only signals idle part way through the buffer
+    if (idle && rx->pos > 0U) {
+        HAL_UARTEx_RxEventCallback(huart, rx->pos);
+    }
+}
+
+uint32_t mockGet_HAL_UART_BaudRate(UART_HandleTypeDef* huart)
+{
+    return getRx(huart)->baudRate;
+}
+
+uint32_t mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(UART_HandleTypeDef* huart)
+{
+    return getRx(huart)->starts;
+}
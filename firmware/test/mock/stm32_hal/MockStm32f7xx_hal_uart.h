@@ -20,11 +20,34 @@ typedef struct
     uint8_t tmp;
 } USART_TypeDef;
 
+typedef uint32_t HAL_UART_StateTypeDef;
+
+typedef struct
+{
+    uint32_t BaudRate;
+} UART_InitTypeDef;
+
 typedef struct 
 {
     USART_TypeDef* Instance;
+    UART_InitTypeDef Init;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t ErrorCode;
 } UART_HandleTypeDef;
 
+#define HAL_UART_STATE_RESET   0x00000000U
+#define HAL_UART_STATE_READY   0x00000020U
+#define HAL_UART_STATE_BUSY_TX 0x00000021U
+#define HAL_UART_STATE_BUSY_RX 0x00000022U
+
+#define HAL_UART_ERROR_NONE 0x00000000U
+#define HAL_UART_ERROR_PE   0x00000001U
+#define HAL_UART_ERROR_NE   0x00000002U
+#define HAL_UART_ERROR_FE   0x00000004U
+#define HAL_UART_ERROR_ORE  0x00000008U
+#define HAL_UART_ERROR_DMA  0x00000010U
+
 // These are supposed to be pointers to the peripherals, but for the purposes
 // of the mock, unique numbers cast to a pointer will work fine.
 // Don't dereference them...
@@ -130,4 +153,33 @@ size_t mockGet_HAL_UART_Len(void);
  */
 uint8_t* mockGet_HAL_UART_Data(void);
 
+/**
+ * @brief Emulates bytes arriving on a UART receiving with
+ * HAL_UARTEx_ReceiveToIdle_DMA in circular DMA mode. Bytes are written to the
+ * receive buffer, and HAL_UARTEx_RxEventCallback is invoked on half transfer
+ * and transfer complete, as the hardware would.
+ * Bytes are dropped if reception isn't active (as on an overrun).
+ *
+ * @param huart UART handle
+ * @param data Bytes received
+ * @param len Number of bytes
+ * @param idle Line goes idle after the bytes (invokes the idle event)
+ */
+void mockRecv_HAL_UARTEx_DMA(
+    UART_HandleTypeDef* huart,
+    const void* data,
+    size_t len,
+    bool idle);
+
+/**
+ * @brief Gets the number of times DMA reception was started on a UART
+ */
+/**
+ * @brief Gets the baud rate the UART was last initialized with
+ * (HAL_UART_Init). 0 if not initialized since the mock was reset.
+ */
+uint32_t mockGet_HAL_UART_BaudRate(UART_HandleTypeDef* huart);
+
+uint32_t mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(UART_HandleTypeDef* huart);
+
 #endif
@@ -26,6 +26,7 @@ struct StreamBufferDef_t
     uint8_t streamBufferData[MOCK_STREAMBUFFER_SIZE];
     size_t start;
     size_t end;
+    size_t capacity; // Max contents, 0 for no limit (see mockSetStreamBufferCapacity)
     // must be kept the same as StaticStreamBuffer_t in FreeRTOS.h
 };
 typedef struct StreamBufferDef_t* StreamBufferHandle_t;
@@ -79,6 +80,15 @@ void mockSetStreamBufferData(
  */
 void mockClearStreamBufferData(StreamBufferHandle_t xStreamBuffer);
 
+/**
+ * @brief Limit how much data the stream buffer can hold. Sends only
+ * write as much as fits, like the real stream buffer.
+ *
+ * @param xStreamBuffer Stream buffer
+ * @param capacity Max number of bytes held. 0 for no limit.
+ */
+void mockSetStreamBufferCapacity(StreamBufferHandle_t xStreamBuffer, size_t capacity);
+
 /**
  * @brief Gets the number of elements sent to stream buffer.
  * 
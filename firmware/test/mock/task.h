@@ -19,6 +19,10 @@ typedef struct tskTaskControlBlock* TaskHandle_t;
 
 typedef void (*TaskFunction_t)( void * );
 
+#define taskSCHEDULER_SUSPENDED   ( ( BaseType_t ) 0 )
+#define taskSCHEDULER_NOT_STARTED ( ( BaseType_t ) 1 )
+#define taskSCHEDULER_RUNNING     ( ( BaseType_t ) 2 )
+
 // ================== Define methods ==================
 TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode,
                                 const char* const pcName,
@@ -27,10 +31,20 @@ TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode,
                                 UBaseType_t uxPriority,
                                 StackType_t* const puxStackBuffer,
                                 StaticTask_t* const pxTaskBuffer);
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify);
 void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t* pxHigherPriorityTaskWoken);
 uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+UBaseType_t uxTaskGetTaskNumber(TaskHandle_t xTask);
+BaseType_t xTaskGetSchedulerState(void);
 
 void mockSetTaskNotifyValue(uint32_t value);
 uint32_t mockGetTaskNotifyValue(void);
 
+/**
+ * @brief Sets the number of the running task, 0 for before the scheduler
+ * starts
+ */
+void mockSetCurrentTaskNumber(UBaseType_t number);
+
 #endif
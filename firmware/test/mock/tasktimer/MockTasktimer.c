@@ -14,11 +14,18 @@ REGISTERED_MODULE_STATIC_DEF(TASKTIMER);
 // ------------------- Static data -------------------
 static TaskTimer_Status_T mStatus_TaskTimer_Init = TASKTIMER_STATUS_OK;
 static TaskTimer_Status_T mStatus_TaskTimer_RegisterTask = TASKTIMER_STATUS_OK;
+static const TaskTimer_Stats_T* mStats = NULL;
+static uint16_t mNumStats = 0U;
+static bool mStatsReset = false;
+
+const char* const TaskTimer_FrequencyNames[TASKTIMER_FREQUENCY_COUNT] = {
+    "1kHz", "100Hz", "10Hz", "1Hz",
+};
 
 // ------------------- Methods -------------------
-TaskTimer_Status_T TaskTimer_Init(Logging_T* logger, TIM_HandleTypeDef* htim)
+TaskTimer_Status_T TaskTimer_Init(Logging_T* logger, TIM_HandleTypeDef* htim1kHz)
 {
-    (void)htim;
+    (void)htim1kHz;
     DEPEND_ON(logger, TASKTIMER_STATUS_ERROR_DEPENDS);
     REGISTER_STATIC(TASKTIMER, TASKTIMER_STATUS_ERROR_DEPENDS);
     return mStatus_TaskTimer_Init;
@@ -31,6 +38,40 @@ TaskTimer_Status_T TaskTimer_RegisterTask(TaskHandle_t* task, const TaskTimer_Fr
     return mStatus_TaskTimer_RegisterTask;
 }
 
+TaskTimer_Status_T TaskTimer_RegisterTaskPhase(
+    TaskHandle_t* task,
+    const TaskTimer_Frequency_T timer,
+    const uint16_t phase)
+{
+    (void)phase;
+    return TaskTimer_RegisterTask(task, timer);
+}
+
+uint32_t TaskTimer_Wait(TaskHandle_t* task, TickType_t blockTime)
+{
+    (void)task;
+    return ulTaskNotifyTake(pdTRUE, blockTime);
+}
+
+uint16_t TaskTimer_NumTasks(void)
+{
+    return mNumStats;
+}
+
+bool TaskTimer_GetStats(uint16_t index, TaskTimer_Stats_T* stats)
+{
+    if (index >= mNumStats) {
+        return false;
+    }
+    *stats = mStats[index];
+    return true;
+}
+
+void TaskTimer_ResetStats(void)
+{
+    mStatsReset = true;
+}
+
 void TaskTimer_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
 {
     (void)htim;
@@ -51,3 +92,15 @@ void mockSet_TaskTimer_RegisterTask_Status(TaskTimer_Status_T status)
 {
     mStatus_TaskTimer_RegisterTask = status;
 }
+
+void mockSet_TaskTimer_Stats(const TaskTimer_Stats_T* stats, uint16_t numTasks)
+{
+    mStats = stats;
+    mNumStats = numTasks;
+    mStatsReset = false;
+}
+
+bool mockGet_TaskTimer_StatsReset(void)
+{
+    return mStatsReset;
+}
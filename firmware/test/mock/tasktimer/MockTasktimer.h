@@ -14,5 +14,7 @@
 // ============= Mock control methods =============
 void mockSet_TaskTimer_Init_Status(TaskTimer_Status_T status);
 void mockSet_TaskTimer_RegisterTask_Status(TaskTimer_Status_T status);
+void mockSet_TaskTimer_Stats(const TaskTimer_Stats_T* stats, uint16_t numTasks);
+bool mockGet_TaskTimer_StatsReset(void);
 
 #endif // _MOCK_TIME_TASKTIMER_TASKTIMER_H_
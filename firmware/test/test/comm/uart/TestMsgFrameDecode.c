@@ -1,6 +1,6 @@
 /*
  * TestMsgFrameDecode.c
- * 
+ *
  *  Created on: 25 Apr 2022
  *      Author: Liam Flaherty
  */
@@ -14,15 +14,19 @@
 
 // source code under test
 #include "uart/msgframedecode.c"
-
-static const uint16_t MSG_LEN = 11U;
+#include "uart/msgframeencode.h"
 
 static Logging_T testLog;
-static CRC_T mCrc;
-static CRC_HandleTypeDef hcrc;
 
 static MsgFrameDecode_T mMsgFrame;
 
+#define RECV_CHUNK 300U
+
+// Seq 0x07, addr 0x102, function 0x304, data AA 00 00 BB, CRC 0xBFFF284F
+static uint8_t msg1[] =
+    {0x02, 0x07, 0x07, 0x04, 0x01, 0x02, 0x03, 0x04, 0xAA, 0x01, 0x06, 0xBB, 0xBF, 0xFF, 0x28, 0x4F, 0x00};
+static const uint8_t msg1Data[] = {0xAA, 0x00, 0x00, 0xBB};
+
 TEST_GROUP(COMM_MSGFRAMEDECODE);
 
 TEST_SETUP(COMM_MSGFRAMEDECODE)
@@ -31,21 +35,15 @@ TEST_SETUP(COMM_MSGFRAMEDECODE)
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_Init(&testLog));
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_EnableSWO(&testLog));
     mockLogClear();
-    hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
-    mCrc.hcrc = &hcrc;
-    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_Init(&testLog, &mCrc));
 
     // set up testing code
-    memset(mMsgFrame.data, 0U, MSGFRAME_BUFFER_LEN * sizeof(uint8_t));
-    mMsgFrame.msgLen = MSG_LEN;
-    mMsgFrame.crc = &mCrc;
-    bool succ = MsgFrameDecode_Init(&mMsgFrame);
-
-    TEST_ASSERT_TRUE(succ);
-    TEST_ASSERT_EQUAL(MSG_LEN, mMsgFrame.msgLen);
-    TEST_ASSERT_EQUAL(0U, mMsgFrame.start);
-    TEST_ASSERT_EQUAL(0U, mMsgFrame.end);
-    TEST_ASSERT_EQUAL(MSGFRAME_BUFFER_LEN, mMsgFrame.availableBytes);
+    memset(mMsgFrame.ring, 0U, MSGFRAME_BUFFER_LEN * sizeof(uint8_t));
+    MsgFrameDecode_Init(&mMsgFrame);
+
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.head);
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.tail);
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.blockCode);
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.badFrames);
 }
 
 TEST_TEAR_DOWN(COMM_MSGFRAMEDECODE)
@@ -53,193 +51,320 @@ TEST_TEAR_DOWN(COMM_MSGFRAMEDECODE)
     // Empty
 }
 
-TEST(COMM_MSGFRAMEDECODE, TestInitTooLong)
+static void assertMsg1(const MsgFrameDecode_Msg_T* msg)
 {
-    MsgFrameDecode_T mf2;
-    mf2.msgLen = 1045U;
-    mf2.crc = &mCrc;
-
-    TEST_ASSERT_FALSE(MsgFrameDecode_Init(&mf2));
+    TEST_ASSERT_EQUAL(0x07, msg->seq);
+    TEST_ASSERT_EQUAL(0x102, msg->address);
+    TEST_ASSERT_EQUAL(0x304, msg->function);
+    TEST_ASSERT_EQUAL(sizeof(msg1Data), msg->dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg1Data, msg->data, sizeof(msg1Data));
 }
 
 TEST(COMM_MSGFRAMEDECODE, TestMsgRecvBytes)
 {
-    mockSet_CRC(0x4FCD556FU);
-    bool succ;
-
-    // Receive first message
-    uint8_t msg1[] = {':', 0x01, 0x02, 0x03, 0x04, 0x4F, 0xCD, 0x55, 0x6F, '\r', '\n'};
-    size_t msg1Len = sizeof(msg1) / sizeof(uint8_t);
-
-    succ = MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, (uint16_t)msg1Len);
-
-    uint16_t expectedStart = 0U;
-    uint16_t expectedEnd = (uint16_t)msg1Len;
-    uint16_t expectedBufferRemaining = MSGFRAME_BUFFER_LEN - (uint16_t)msg1Len;
-    uint8_t expectedBuffer1[] = {':', 0x01, 0x02, 0x03, 0x04, 0x4F, 0xCD, 0x55, 0x6F, '\r', '\n'};
-    size_t expectedBuffer1Len = sizeof(expectedBuffer1) / sizeof(uint8_t);
-    TEST_ASSERT_TRUE(succ);
-    TEST_ASSERT_EQUAL(MSG_LEN, mMsgFrame.msgLen);
-    TEST_ASSERT_EQUAL(expectedStart, mMsgFrame.start);
-    TEST_ASSERT_EQUAL(expectedEnd, mMsgFrame.end);
-    TEST_ASSERT_EQUAL(expectedBufferRemaining, mMsgFrame.availableBytes);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedBuffer1, mMsgFrame.data, expectedBuffer1Len);
-
-    // Receive some new bad data
-    uint8_t msg2[] = {0x55, ':', '\r'};
-    size_t msg2Len = sizeof(msg2) / sizeof(uint8_t);
-
-    succ = MsgFrameDecode_RecvBytes(&mMsgFrame, msg2, (uint16_t)msg2Len);
-
-    expectedStart += 0U;
-    expectedEnd += (uint16_t)msg2Len;
-    expectedBufferRemaining -= (uint16_t)msg2Len;
-    uint8_t expectedBuffer2[] = {':', 0x01, 0x02, 0x03, 0x04, 0x4F, 0xCD, 0x55, 0x6F, '\r', '\n',
-                                 0x55, ':', '\r'};
-    size_t expectedBuffer2Len = sizeof(expectedBuffer2) / sizeof(uint8_t);
-    TEST_ASSERT_TRUE(succ);
-    TEST_ASSERT_EQUAL(MSG_LEN, mMsgFrame.msgLen);
-    TEST_ASSERT_EQUAL(expectedStart, mMsgFrame.start);
-    TEST_ASSERT_EQUAL(expectedEnd, mMsgFrame.end);
-    TEST_ASSERT_EQUAL(expectedBufferRemaining, mMsgFrame.availableBytes);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedBuffer2, mMsgFrame.data, expectedBuffer2Len);
-
-    // Receive another valid message
-    uint8_t msg3[] = {':', 0x01, 0x02, 0x03, 0x04, 0x4F, 0xCD, 0x55, 0x6F, '\r', '\n'};
-    size_t msg3Len = sizeof(msg3) / sizeof(uint8_t);
-
-    succ = MsgFrameDecode_RecvBytes(&mMsgFrame, msg3, (uint16_t)msg3Len);
-
-    expectedStart += 0U;
-    expectedEnd += (uint16_t)msg3Len;
-    expectedBufferRemaining -= (uint16_t)msg3Len;
-    uint8_t expectedBuffer3[] = {':', 0x01, 0x02, 0x03, 0x04, 0x4F, 0xCD, 0x55, 0x6F, '\r', '\n',
-                                 0x55, ':', '\r',
-                                 ':', 0x01, 0x02, 0x03, 0x04, 0x4F, 0xCD, 0x55, 0x6F, '\r', '\n'};
-    size_t expectedBuffer3Len = sizeof(expectedBuffer3) / sizeof(uint8_t);
-    TEST_ASSERT_TRUE(succ);
-    TEST_ASSERT_EQUAL(MSG_LEN, mMsgFrame.msgLen);
-    TEST_ASSERT_EQUAL(expectedStart, mMsgFrame.start);
-    TEST_ASSERT_EQUAL(expectedEnd, mMsgFrame.end);
-    TEST_ASSERT_EQUAL(expectedBufferRemaining, mMsgFrame.availableBytes);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedBuffer3, mMsgFrame.data, expectedBuffer3Len);
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.tail);
+    TEST_ASSERT_EQUAL(sizeof(msg1), mMsgFrame.head);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg1, mMsgFrame.ring, sizeof(msg1));
 }
 
 TEST(COMM_MSGFRAMEDECODE, TestMsgRecvMsg)
 {
-    mockSet_CRC(0x4FCD556FU);
-
-    // DMA might receive one message and some other bytes
-    uint8_t msg1[] = {':', 0x01, 0x02, 0x03, 0x04, 0x4F, 0xCD, 0x55, 0x6F, '\r', '\n'};
-    size_t msg1Len = sizeof(msg1) / sizeof(uint8_t);
-    uint8_t msg2[] = {0x55, ':', '\r'};
-    size_t msg2Len = sizeof(msg2) / sizeof(uint8_t);
+    // DMA might receive one message and part of the next
+    uint8_t partial[] = {0x55, 0x01, 0x03};
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, partial, sizeof(partial)));
 
-    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, (uint16_t)msg1Len));
-    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg2, (uint16_t)msg2Len));
-
-    size_t offset;
-    bool recv;
+    MsgFrameDecode_Msg_T msg;
 
     // first attempt should work
-    recv = MsgFrameDecode_RecvMsg(&mMsgFrame, &offset);
-    TEST_ASSERT_TRUE(recv);
-    TEST_ASSERT_EQUAL(0U, offset);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg1, &mMsgFrame.data[offset], MSG_LEN);
-
-    // second shouldn't give a valid message, but the bytes should be shifted down
-    recv = MsgFrameDecode_RecvMsg(&mMsgFrame, &offset);
-    TEST_ASSERT_FALSE(recv);
-
-    TEST_ASSERT_EQUAL(0U, mMsgFrame.start);
-    TEST_ASSERT_EQUAL(msg2Len, mMsgFrame.end);
-    TEST_ASSERT_EQUAL(MSGFRAME_BUFFER_LEN - (uint16_t)msg2Len, mMsgFrame.availableBytes);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg2, mMsgFrame.data, msg2Len);
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    assertMsg1(&msg);
 
+    // second shouldn't give a valid message, but the partial one is decoded so far
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    TEST_ASSERT_EQUAL(mMsgFrame.head, mMsgFrame.tail);
+    TEST_ASSERT_EQUAL(0x55U, mMsgFrame.blockCode);
+    TEST_ASSERT_EQUAL(2U, mMsgFrame.rawLen);
 
-    // now put another valid message after the random bytes
-    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, (uint16_t)msg1Len));
+    // the partial message never finishes, and is dropped at the delimiter
+    uint8_t delim = 0x00;
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, &delim, 1U));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
 
-    recv = MsgFrameDecode_RecvMsg(&mMsgFrame, &offset);
-    TEST_ASSERT_TRUE(recv);
-    TEST_ASSERT_EQUAL(3U, offset);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg1, &mMsgFrame.data[offset], MSG_LEN);
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    assertMsg1(&msg);
+    TEST_ASSERT_EQUAL(1U, mMsgFrame.badFrames);
 
     // buffer should be empty after another call
-    recv = MsgFrameDecode_RecvMsg(&mMsgFrame, &offset);
-    TEST_ASSERT_FALSE(recv);
-    TEST_ASSERT_EQUAL(0U, mMsgFrame.start);
-    TEST_ASSERT_EQUAL(0U, mMsgFrame.end);
-    TEST_ASSERT_EQUAL(MSGFRAME_BUFFER_LEN, mMsgFrame.availableBytes);
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    TEST_ASSERT_EQUAL(mMsgFrame.head, mMsgFrame.tail);
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.blockCode);
 }
 
-TEST(COMM_MSGFRAMEDECODE, TestMsgBadCrc)
+TEST(COMM_MSGFRAMEDECODE, TestMsgByteByByte)
 {
-    mockSet_CRC(0x4FCD556FU);
-
-    uint8_t msgBadCrc[] = {':', 0x01, 0x02, 0x03, 0x04, 0xFF, 0xFF, 0xFF, 0xFF, '\r', '\n'};
-    size_t msgBadCrcLen = sizeof(msgBadCrc) / sizeof(uint8_t);
-    uint8_t msgGoodCrc[] = {':', 0x01, 0x02, 0x03, 0x04, 0x4F, 0xCD, 0x55, 0x6F, '\r', '\n'};
-    size_t msgGoodCrcLen = sizeof(msgGoodCrc) / sizeof(uint8_t);
-
-    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msgBadCrc, (uint16_t)msgBadCrcLen));
+    MsgFrameDecode_Msg_T msg;
+    for (size_t i = 0; i < sizeof(msg1) - 1U; ++i) {
+        TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, &msg1[i], 1U));
+        TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    }
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, &msg1[sizeof(msg1) - 1U], 1U));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    assertMsg1(&msg);
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.badFrames);
+}
 
-    size_t offset;
-    bool recv;
+TEST(COMM_MSGFRAMEDECODE, TestMsgBadCrc)
+{
+    MsgFrameDecode_Msg_T msg;
 
     // message with bad CRC should ignore message
-    recv = MsgFrameDecode_RecvMsg(&mMsgFrame, &offset);
-    TEST_ASSERT_FALSE(recv);
-
-    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msgGoodCrc, (uint16_t)msgGoodCrcLen));
+    uint8_t badCrc[sizeof(msg1)];
+    memcpy(badCrc, msg1, sizeof(msg1));
+    badCrc[15] ^= 0x01;
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, badCrc, sizeof(badCrc)));
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    TEST_ASSERT_EQUAL(1U, mMsgFrame.badFrames);
 
     // message with ok CRC should work
-    recv = MsgFrameDecode_RecvMsg(&mMsgFrame, &offset);
-    TEST_ASSERT_TRUE(recv);
-    TEST_ASSERT_EQUAL(11U, offset);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(msgGoodCrc, &mMsgFrame.data[offset], MSG_LEN);
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    assertMsg1(&msg);
 
     // check cleanup works ok
-    recv = MsgFrameDecode_RecvMsg(&mMsgFrame, &offset);
-    TEST_ASSERT_FALSE(recv);
-    TEST_ASSERT_EQUAL(0U, mMsgFrame.start);
-    TEST_ASSERT_EQUAL(0U, mMsgFrame.end);
-    TEST_ASSERT_EQUAL(MSGFRAME_BUFFER_LEN, mMsgFrame.availableBytes);
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    TEST_ASSERT_EQUAL(2U * sizeof(msg1), mMsgFrame.tail);
+    TEST_ASSERT_EQUAL(2U * sizeof(msg1), mMsgFrame.head);
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.blockCode);
+}
+
+TEST(COMM_MSGFRAMEDECODE, TestMsgBadLength)
+{
+    MsgFrameDecode_Msg_T msg;
+
+    // Length field says 5 bytes of data, there are 4
+    uint8_t badLen[sizeof(msg1)];
+    memcpy(badLen, msg1, sizeof(msg1));
+    badLen[3] = 0x05;
+
+    // Too short to be a frame
+    uint8_t tooShort[] = {0x03, 0x11, 0x22, 0x00};
+
+    // Consecutive delimiters are skipped without counting
+    uint8_t delims[] = {0x00, 0x00};
+
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, badLen, sizeof(badLen)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, tooShort, sizeof(tooShort)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, delims, sizeof(delims)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    assertMsg1(&msg);
+    TEST_ASSERT_EQUAL(2U, mMsgFrame.badFrames);
 }
 
 TEST(COMM_MSGFRAMEDECODE, TestRecvTooManyBytes)
 {
     uint8_t testByte1 = 0xAB;
     uint8_t testByte2 = 0xEF;
+    MsgFrameDecode_Msg_T msg;
 
     // Fill up buffer ok
     for (uint16_t i = 0; i < MSGFRAME_BUFFER_LEN; ++i) {
         TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, &testByte1, sizeof(uint8_t)));
     }
 
-    // Buffer should all be the correct bytes
+    // Shouldn't be able to receive any more bytes
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvBytes(&mMsgFrame, &testByte2, sizeof(uint8_t)));
+
+    // Buffer shouldn't have changed
     for (uint16_t i = 0; i < MSGFRAME_BUFFER_LEN; ++i) {
-        TEST_ASSERT_EQUAL(testByte1, mMsgFrame.data[i]);
+        TEST_ASSERT_EQUAL(testByte1, mMsgFrame.ring[i]);
     }
 
-    // Shouldn't be able to receive any more bytes
+    // Decoding frees the whole buffer, though the frame isn't finished
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.badFrames);
+    TEST_ASSERT_EQUAL(mMsgFrame.head, mMsgFrame.tail);
+
+    // Now longer than the largest frame, so it fails at its delimiter
     for (uint16_t i = 0; i < MSGFRAME_BUFFER_LEN; ++i) {
-        TEST_ASSERT_FALSE(MsgFrameDecode_RecvBytes(&mMsgFrame, &testByte2, sizeof(uint8_t)));
+        TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, &testByte2, sizeof(uint8_t)));
     }
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    TEST_ASSERT_TRUE(mMsgFrame.invalid);
+
+    // Then back in sync
+    uint8_t delim = 0x00;
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, &delim, sizeof(uint8_t)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    assertMsg1(&msg);
+    TEST_ASSERT_EQUAL(1U, mMsgFrame.badFrames);
+}
 
-    // Buffer shouldn't have changed
-    for (uint16_t i = 0; i < MSGFRAME_BUFFER_LEN; ++i) {
-        TEST_ASSERT_EQUAL(testByte1, mMsgFrame.data[i]);
+TEST(COMM_MSGFRAMEDECODE, TestCobsInvalid)
+{
+    MsgFrameDecode_Msg_T msg;
+
+    // Code says 4 bytes follow, the delimiter comes after 2
+    uint8_t overrun[] = {0x05, 0x11, 0x22, 0x00};
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, overrun, sizeof(overrun)));
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    TEST_ASSERT_EQUAL(1U, mMsgFrame.badFrames);
+
+    // The delimiter ends the bad frame, so the next one is found
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, overrun, sizeof(overrun)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    assertMsg1(&msg);
+    TEST_ASSERT_EQUAL(2U, mMsgFrame.badFrames);
+}
+
+TEST(COMM_MSGFRAMEDECODE, TestRingWrap)
+{
+    MsgFrameDecode_Msg_T msg;
+
+    // Line idle (delimiters) up to just before the end of the ring
+    uint8_t delims[MSGFRAME_BUFFER_LEN - 8U];
+    memset(delims, MSGFRAME_DELIMITER, sizeof(delims));
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, delims, sizeof(delims)));
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+
+    // Frame is split over the end of the ring
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg1, &mMsgFrame.ring[sizeof(delims)], 8U);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&msg1[8], mMsgFrame.ring, sizeof(msg1) - 8U);
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    assertMsg1(&msg);
+
+    // Indices run past 16 bits
+    for (uint16_t i = 0; i < 4000U; ++i) {
+        TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
+        TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+        assertMsg1(&msg);
+        TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    }
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.badFrames);
+}
+
+TEST(COMM_MSGFRAMEDECODE, TestWriteSpace)
+{
+    MsgFrameDecode_Msg_T msg;
+    uint16_t len = 0U;
+
+    // Empty, the whole ring
+    uint8_t* space = MsgFrameDecode_GetWriteSpace(&mMsgFrame, &len);
+    TEST_ASSERT_EQUAL_PTR(mMsgFrame.ring, space);
+    TEST_ASSERT_EQUAL(MSGFRAME_BUFFER_LEN, len);
+
+    memset(space, MSGFRAME_DELIMITER, MSGFRAME_BUFFER_LEN - 9U);
+    MsgFrameDecode_CommitBytes(&mMsgFrame, MSGFRAME_BUFFER_LEN - 9U);
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+
+    // Up to the end of the ring
+    space = MsgFrameDecode_GetWriteSpace(&mMsgFrame, &len);
+    TEST_ASSERT_EQUAL_PTR(&mMsgFrame.ring[MSGFRAME_BUFFER_LEN - 9U], space);
+    TEST_ASSERT_EQUAL(9U, len);
+    memcpy(space, msg1, len);
+    MsgFrameDecode_CommitBytes(&mMsgFrame, len);
+
+    // Then from the start, up to the bytes not yet decoded
+    space = MsgFrameDecode_GetWriteSpace(&mMsgFrame, &len);
+    TEST_ASSERT_EQUAL_PTR(mMsgFrame.ring, space);
+    TEST_ASSERT_EQUAL(MSGFRAME_BUFFER_LEN - 9U, len);
+    memcpy(space, &msg1[9], sizeof(msg1) - 9U);
+    MsgFrameDecode_CommitBytes(&mMsgFrame, sizeof(msg1) - 9U);
+
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+    assertMsg1(&msg);
+    TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+}
+
+TEST(COMM_MSGFRAMEDECODE, TestNoise)
+{
+    // Line noise between frames, each frame after a delimiter is found
+    MsgFrameDecode_Msg_T msg;
+    uint8_t noise[300];
+    uint32_t lcg = 1U;
+    uint16_t numMsgs = 0U;
+
+    for (uint16_t frame = 0; frame < 100U; ++frame) {
+        lcg = lcg * 1103515245U + 12345U;
+        const uint16_t noiseLen = (uint16_t)((lcg >> 16) % sizeof(noise));
+        for (uint16_t i = 0; i < noiseLen; ++i) {
+            lcg = lcg * 1103515245U + 12345U;
+            noise[i] = (uint8_t)(lcg >> 24);
+        }
+        noise[noiseLen] = MSGFRAME_DELIMITER;
+
+        TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, noise, (uint16_t)(noiseLen + 1U)));
+        TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, msg1, sizeof(msg1)));
+        while (MsgFrameDecode_RecvMsg(&mMsgFrame, &msg)) {
+            assertMsg1(&msg);
+            numMsgs++;
+        }
+    }
+    TEST_ASSERT_EQUAL(100U, numMsgs);
+    TEST_ASSERT_TRUE(mMsgFrame.badFrames > 0U);
+}
+
+TEST(COMM_MSGFRAMEDECODE, TestRoundTrip)
+{
+    // Every length, with data that has runs of zeros and long non-zero runs
+    static uint8_t buffer[MSGFRAME_ENCODE_BUFFER_LEN(MSGFRAME_MAX_DATA_LEN)];
+    static uint8_t expected[MSGFRAME_MAX_DATA_LEN];
+    MsgFrameEncode_T enc = {
+        .bufferLen = sizeof(buffer),
+        .address = 0x0201,
+        .function = 0x0403,
+        .buffer = buffer,
+    };
+    MsgFrameDecode_Msg_T msg;
+    uint32_t lcg = 1U;
+
+    for (uint16_t len = 1U; len <= MSGFRAME_MAX_DATA_LEN; ++len) {
+        enc.dataLen = len;
+        uint8_t* data = MsgFrameEncode_InitFrame(&enc);
+        for (uint16_t i = 0; i < len; ++i) {
+            lcg = lcg * 1103515245U + 12345U;
+            expected[i] = ((lcg >> 20) % 8U == 0U) ? 0U : (uint8_t)(lcg >> 24);
+            data[i] = expected[i];
+        }
+        MsgFrameEncode_Finish(&enc);
+
+        // Longest frames don't fit in the ring, they are decoded as they arrive
+        uint16_t pos = 0U;
+        while (enc.msgLen - pos > RECV_CHUNK) {
+            TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, buffer + pos, RECV_CHUNK));
+            TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+            pos = (uint16_t)(pos + RECV_CHUNK);
+        }
+        TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mMsgFrame, buffer + pos, (uint16_t)(enc.msgLen - pos)));
+        TEST_ASSERT_TRUE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
+        TEST_ASSERT_EQUAL(len, msg.dataLen);
+        TEST_ASSERT_EQUAL((uint8_t)(len - 1U), msg.seq);
+        TEST_ASSERT_EQUAL(0x0201, msg.address);
+        TEST_ASSERT_EQUAL(0x0403, msg.function);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, msg.data, len);
+        TEST_ASSERT_FALSE(MsgFrameDecode_RecvMsg(&mMsgFrame, &msg));
     }
+    TEST_ASSERT_EQUAL(0U, mMsgFrame.badFrames);
 }
 
 TEST_GROUP_RUNNER(COMM_MSGFRAMEDECODE)
 {
-    RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestInitTooLong);
     RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestMsgRecvBytes);
     RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestMsgRecvMsg);
+    RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestMsgByteByByte);
     RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestMsgBadCrc);
+    RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestMsgBadLength);
     RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestRecvTooManyBytes);
+    RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestCobsInvalid);
+    RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestRingWrap);
+    RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestWriteSpace);
+    RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestNoise);
+    RUN_TEST_CASE(COMM_MSGFRAMEDECODE, TestRoundTrip);
 }
 
 #define INVOKE_TEST COMM_MSGFRAMEDECODE
@@ -1,6 +1,6 @@
 /*
  * TestMsgFrameEncode.c
- * 
+ *
  *  Created on: 31 Jul 2022
  *      Author: Liam Flaherty
  */
@@ -15,12 +15,13 @@
 // source code under test
 #include "uart/msgframeencode.c"
 
-#define MSG_LEN 15U
 #define DATA_LEN 4U
+#define BUFFER_LEN MSGFRAME_ENCODE_BUFFER_LEN(DATA_LEN)
 
 static Logging_T testLog;
-static CRC_T mCrc;
-static CRC_HandleTypeDef hcrc;
+
+static uint8_t msgBuffer[BUFFER_LEN];
+static MsgFrameEncode_T msg;
 
 TEST_GROUP(COMM_MSGFRAMEENCODE);
 
@@ -30,9 +31,15 @@ TEST_SETUP(COMM_MSGFRAMEENCODE)
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_Init(&testLog));
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_EnableSWO(&testLog));
     mockLogClear();
-    hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
-    mCrc.hcrc = &hcrc;
-    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_Init(&testLog, &mCrc));
+
+    // Construct msg object
+    memset(msgBuffer, 0U, sizeof(msgBuffer));
+    memset(&msg, 0U, sizeof(msg));
+    msg.address = 0x102U;
+    msg.function = 0x304U;
+    msg.dataLen = DATA_LEN;
+    msg.buffer = msgBuffer;
+    msg.bufferLen = BUFFER_LEN;
 }
 
 TEST_TEAR_DOWN(COMM_MSGFRAMEENCODE)
@@ -42,52 +49,112 @@ TEST_TEAR_DOWN(COMM_MSGFRAMEENCODE)
 
 TEST(COMM_MSGFRAMEENCODE, TestInitFrame)
 {
-    // Construct msg object
-    uint8_t msgBuffer[MSG_LEN] = { 0U };
-    MsgFrameEncode_T msg;
-    msg.address = 0x102U;
-    msg.function = 0x304U;
-    msg.msgLen = MSG_LEN;
-    msg.dataLen = DATA_LEN;
-    msg.buffer = msgBuffer;
-    msg.crc = &mCrc;
-
+    msg.seq = 0x55U;
     uint8_t* msgData = MsgFrameEncode_InitFrame(&msg);
-    TEST_ASSERT_POINTERS_EQUAL(msgData, msgBuffer + 5U);
+    TEST_ASSERT_POINTERS_EQUAL(msgData, msgBuffer + MSGFRAME_ENCODE_OFFSET + MSGFRAME_HEADER_LEN);
 
-    uint8_t expectedMsgBuffer[MSG_LEN] =
-        {':', 0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, '\r', '\n'};
-        //    ^--Func--^  ^--Addr--^  ^--------Data--------^  ^---------CRC--------^  ^msg end-^
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedMsgBuffer, msgBuffer, MSG_LEN);
+    uint8_t expectedFrame[MSGFRAME_HEADER_LEN] =
+        {0x55, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04};
+        // Seq ^--Len---^  ^--Addr--^  ^--Func--^  (length is set when finished)
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedFrame, msgBuffer + MSGFRAME_ENCODE_OFFSET, MSGFRAME_HEADER_LEN);
 }
 
-TEST(COMM_MSGFRAMEENCODE, TestUpdateCrc)
+TEST(COMM_MSGFRAMEENCODE, TestFinish)
 {
-    // Construct msg object
-    uint8_t msgBuffer[MSG_LEN] = 
-        {':', 0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, '\r', '\n'};
-        //    ^--Func--^  ^--Addr--^  ^--------Data--------^  ^---------CRC--------^  ^msg end-^
-    MsgFrameEncode_T msg;
-    msg.address = 0x102U;
-    msg.function = 0x304U;
-    msg.msgLen = MSG_LEN;
+    uint8_t* msgData = MsgFrameEncode_InitFrame(&msg);
+    msgData[0] = 0xAA;
+    msgData[1] = 0x00;
+    msgData[2] = 0x00;
+    msgData[3] = 0xBB;
+
+    MsgFrameEncode_Finish(&msg);
+
+    // Frame is Seq Len Addr Func Data CRC:
+    //   00 | 00 04 | 01 02 | 03 04 | AA 00 00 BB | 5A 3A 84 AB
+    // COBS replaces each zero with the distance to the next one
+    uint8_t expectedMsg[] =
+        {0x01, 0x01, 0x07, 0x04, 0x01, 0x02, 0x03, 0x04, 0xAA, 0x01, 0x06, 0xBB, 0x5A, 0x3A, 0x84, 0xAB, 0x00};
+    TEST_ASSERT_EQUAL(sizeof(expectedMsg), msg.msgLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedMsg, msgBuffer, sizeof(expectedMsg));
+
+    // Sequence number moves on for the next frame
+    TEST_ASSERT_EQUAL(1U, msg.seq);
+    MsgFrameEncode_InitFrame(&msg);
+    TEST_ASSERT_EQUAL(1U, msgBuffer[MSGFRAME_ENCODE_OFFSET]);
+}
+
+TEST(COMM_MSGFRAMEENCODE, TestFinishVariableLength)
+{
+    // Data length can be set after the data is written
     msg.dataLen = DATA_LEN;
-    msg.buffer = msgBuffer;
-    msg.crc = &mCrc;
+    uint8_t* msgData = MsgFrameEncode_InitFrame(&msg);
+    msgData[0] = 0x11;
+    msg.dataLen = 1U;
+
+    MsgFrameEncode_Finish(&msg);
 
-    mockSet_CRC(0x4019276DU);
-    uint8_t expectedMsgBuffer[MSG_LEN] = 
-        {':', 0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x00, 0x00, 0x40, 0x19, 0x27, 0x6D, '\r', '\n'};
-        //    ^--Func--^  ^--Addr--^  ^--------Data--------^  ^---------CRC--------^  ^msg end-^
+    uint8_t expectedMsg[] =
+        {0x01, 0x01, 0x0B, 0x01, 0x01, 0x02, 0x03, 0x04, 0x11, 0x88, 0xA6, 0xEB, 0x92, 0x00};
+    TEST_ASSERT_EQUAL(sizeof(expectedMsg), msg.msgLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedMsg, msgBuffer, sizeof(expectedMsg));
+}
 
-    MsgFrameEncode_UpdateCRC(&msg);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedMsgBuffer, msgBuffer, MSG_LEN);
+TEST(COMM_MSGFRAMEENCODE, TestCobs)
+{
+    // Vectors from the COBS paper/wikipedia, data placed at the worst case offset
+    struct {
+        uint8_t in[8];
+        uint16_t inLen;
+        uint8_t out[9];
+        uint16_t outLen;
+    } vectors[] = {
+        { { 0x00 }, 1, { 0x01, 0x01 }, 2 },
+        { { 0x00, 0x00 }, 2, { 0x01, 0x01, 0x01 }, 3 },
+        { { 0x11, 0x22, 0x00, 0x33 }, 4, { 0x03, 0x11, 0x22, 0x02, 0x33 }, 5 },
+        { { 0x11, 0x22, 0x33, 0x44 }, 4, { 0x05, 0x11, 0x22, 0x33, 0x44 }, 5 },
+        { { 0x11, 0x00, 0x00, 0x00 }, 4, { 0x02, 0x11, 0x01, 0x01, 0x01 }, 5 },
+    };
+
+    for (size_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); ++v) {
+        uint8_t buf[16] = { 0 };
+        const uint16_t offset = MSGFRAME_COBS_OVERHEAD(vectors[v].inLen);
+        memcpy(buf + offset, vectors[v].in, vectors[v].inLen);
+        TEST_ASSERT_EQUAL(vectors[v].outLen, MsgFrameEncode_Cobs(buf, offset, vectors[v].inLen));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(vectors[v].out, buf, vectors[v].outLen);
+    }
+}
+
+TEST(COMM_MSGFRAMEENCODE, TestCobsLongRun)
+{
+    // 600 non-zero bytes: blocks of 254 need a code byte without an implied zero
+    static uint8_t buf[700];
+    const uint16_t len = 600U;
+    const uint16_t offset = MSGFRAME_COBS_OVERHEAD(len);
+    for (uint16_t i = 0; i < len; ++i) {
+        buf[offset + i] = (uint8_t)(1U + i % 255U);
+    }
+
+    uint16_t outLen = MsgFrameEncode_Cobs(buf, offset, len);
+    TEST_ASSERT_EQUAL(len + 3U, outLen);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, buf[0]);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, buf[255]);
+    TEST_ASSERT_EQUAL_UINT8(600U - 2U*254U + 1U, buf[510]);
+    for (uint16_t i = 0; i < outLen; ++i) {
+        TEST_ASSERT_TRUE(0U != buf[i]);
+    }
+    for (uint16_t i = 0; i < len; ++i) {
+        const uint16_t pos = (uint16_t)(1U + i + i / 254U);
+        TEST_ASSERT_EQUAL_UINT8(1U + i % 255U, buf[pos]);
+    }
 }
 
 TEST_GROUP_RUNNER(COMM_MSGFRAMEENCODE)
 {
     RUN_TEST_CASE(COMM_MSGFRAMEENCODE, TestInitFrame);
-    RUN_TEST_CASE(COMM_MSGFRAMEENCODE, TestUpdateCrc);
+    RUN_TEST_CASE(COMM_MSGFRAMEENCODE, TestFinish);
+    RUN_TEST_CASE(COMM_MSGFRAMEENCODE, TestFinishVariableLength);
+    RUN_TEST_CASE(COMM_MSGFRAMEENCODE, TestCobs);
+    RUN_TEST_CASE(COMM_MSGFRAMEENCODE, TestCobsLongRun);
 }
 
 #define INVOKE_TEST COMM_MSGFRAMEENCODE
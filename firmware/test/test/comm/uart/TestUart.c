@@ -28,8 +28,39 @@ static UART_DeviceConfig_T configUart = {
   .dev = UART_DEV1,
   .handle = &husart1,
   .txIrq = DMA2_Stream1_IRQn,
+  .uartIrq = USART1_IRQn,
 };
 
+// Receive stream
+static uint8_t mRecvStorage[MOCK_STREAMBUFFER_SIZE];
+static StaticStreamBuffer_t mRecvStreamStruct;
+static StreamBufferHandle_t mRecvStream;
+
+// Zero copy transmit completions
+#define MAX_TX_CALLBACKS 8
+static struct {
+    void* context;
+    const uint8_t* data;
+    uint16_t len;
+    bool sent;
+} mTxCallbacks[MAX_TX_CALLBACKS];
+static size_t mNumTxCallbacks;
+
+static void txCallback(void* context, const uint8_t* data, uint16_t len, bool sent)
+{
+    TEST_ASSERT_LESS_THAN(MAX_TX_CALLBACKS, mNumTxCallbacks);
+    mTxCallbacks[mNumTxCallbacks].context = context;
+    mTxCallbacks[mNumTxCallbacks].data = data;
+    mTxCallbacks[mNumTxCallbacks].len = len;
+    mTxCallbacks[mNumTxCallbacks].sent = sent;
+    mNumTxCallbacks++;
+}
+
+static uint32_t txPending(void)
+{
+    return interfaces[UART_DEV1].txHead - interfaces[UART_DEV1].txTail;
+}
+
 TEST_GROUP(COMM_UART);
 
 TEST_SETUP(COMM_UART)
@@ -37,6 +68,9 @@ TEST_SETUP(COMM_UART)
     mockSet_HAL_DMA_IT_Enabled(true);
     mockSet_HAL_UART_All_Status(HAL_OK);
     mockClear_HAL_UART_Data();
+    mNumTxCallbacks = 0;
+    husart1.gState = HAL_UART_STATE_READY;
+    husart1.ErrorCode = HAL_UART_ERROR_NONE;
 
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_Init(&testLog));
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_EnableSWO(&testLog));
@@ -44,6 +78,7 @@ TEST_SETUP(COMM_UART)
 
     // Enable interrupts (important for test as UART code enables and disables these)
     HAL_NVIC_EnableIRQ(configUart.txIrq);
+    HAL_NVIC_EnableIRQ(configUart.uartIrq);
 
     // Perform init
     TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Init(&testLog));
@@ -60,13 +95,16 @@ TEST_SETUP(COMM_UART)
 
     // clear again for the following test
     mockLogClear();
-    mockClearStreamBufferData(interfaces[UART_DEV1].txPendingStreamHandle);
+    mRecvStream = xStreamBufferCreateStatic(
+        sizeof(mRecvStorage), 1U, mRecvStorage, &mRecvStreamStruct);
+    mockClearStreamBufferData(mRecvStream);
 }
 
 TEST_TEAR_DOWN(COMM_UART)
 {
-    // UART should always leave IRQ enabled after use
+    // UART should always leave IRQs enabled after use
     TEST_ASSERT_TRUE(mockGet_HAL_Cortex_IRQEnabled(configUart.txIrq));
+    TEST_ASSERT_TRUE(mockGet_HAL_Cortex_IRQEnabled(configUart.uartIrq));
     mockLogClear();
 }
 
@@ -77,16 +115,16 @@ TEST(COMM_UART, TestInitOk)
 
 TEST(COMM_UART, TestTx)
 {
-    size_t streamBufferDataLen = 16;
-    uint8_t streamBufferData[16] = { 0 };
-
     // Test data:
     uint8_t msg1[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
     uint8_t msg2[] = {0x07, 0x08, 0x09, 0x0A, 0x0B};
     uint8_t msg3[] = {0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12};
+    uint8_t msg4[] = {0x13, 0x14};
+    uint8_t msg3_4Combined[] = {0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14};
     uint16_t msg1Len = sizeof(msg1);
     uint16_t msg2Len = sizeof(msg2);
     uint16_t msg3Len = sizeof(msg3);
+    uint16_t msg4Len = sizeof(msg4);
 
     // internal value should start at 0
     TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
@@ -98,7 +136,7 @@ TEST(COMM_UART, TestTx)
     TEST_ASSERT_TRUE(interfaces[UART_DEV1].txInProgress);
     TEST_ASSERT_EQUAL(msg1Len, mockGet_HAL_UART_Len());
     TEST_ASSERT_EQUAL_UINT8_ARRAY(msg1, mockGet_HAL_UART_Data(), msg1Len);
-    TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
+    TEST_ASSERT_EQUAL(1U, txPending());
 
     // Allow the DMA tx to complete
     mockClear_HAL_UART_Data();
@@ -106,7 +144,8 @@ TEST(COMM_UART, TestTx)
 
     // Transfer should be complete
     TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
-    TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
+    TEST_ASSERT_EQUAL(0U, txPending());
+    TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
 
     // Send a second message
     TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg2, msg2Len));
@@ -115,26 +154,31 @@ TEST(COMM_UART, TestTx)
     TEST_ASSERT_TRUE(interfaces[UART_DEV1].txInProgress);
     TEST_ASSERT_EQUAL(msg2Len, mockGet_HAL_UART_Len());
     TEST_ASSERT_EQUAL_UINT8_ARRAY(msg2, mockGet_HAL_UART_Data(), msg2Len);
-    TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
 
-    // Sending a new message while DMA is still going should enqueue it
+    // Sending new messages while DMA is still going should queue them
+    // (without blocking)
     TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg3, msg3Len));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg4, msg4Len));
     TEST_ASSERT_TRUE(interfaces[UART_DEV1].txInProgress);
     TEST_ASSERT_EQUAL(msg2Len, mockGet_HAL_UART_Len());
     TEST_ASSERT_EQUAL_UINT8_ARRAY(msg2, mockGet_HAL_UART_Data(), msg2Len);
-    TEST_ASSERT_EQUAL(msg3Len, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
-    mockGetStreamBufferData(interfaces[UART_DEV1].txPendingStreamHandle, streamBufferData, streamBufferDataLen);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg3, streamBufferData, msg3Len);
+    TEST_ASSERT_EQUAL(3U, txPending());
 
     // Allow the 2nd DMA tx to complete
     mockClear_HAL_UART_Data();
     HAL_UART_TxCpltCallback(&husart1);
-    mockClearStreamBufferData(interfaces[UART_DEV1].txPendingStreamHandle);
 
-    // data in stream buffer should send now
+    // Queued messages are sent back to back in one transfer
     TEST_ASSERT_TRUE(interfaces[UART_DEV1].txInProgress);
-    TEST_ASSERT_EQUAL(msg3Len, mockGet_HAL_UART_Len());
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg3, mockGet_HAL_UART_Data(), msg3Len);
+    TEST_ASSERT_EQUAL(sizeof(msg3_4Combined), mockGet_HAL_UART_Len());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg3_4Combined, mockGet_HAL_UART_Data(), sizeof(msg3_4Combined));
+    TEST_ASSERT_EQUAL(2U, txPending());
+
+    mockClear_HAL_UART_Data();
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
+    TEST_ASSERT_EQUAL(0U, txPending());
+    TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
 }
 
 TEST(COMM_UART, TestTxFail)
@@ -154,7 +198,7 @@ TEST(COMM_UART, TestTxFail)
     TEST_ASSERT_EQUAL(UART_STATUS_ERROR_TX, UART_SendMessage(UART_DEV1, msg1, msg1Len));
 
     TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
-    TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
+    TEST_ASSERT_EQUAL(0U, txPending());
     TEST_ASSERT_EQUAL(msg1Len, mockGet_HAL_UART_Len());
 
     // Now test queued data fails (let first message go through)
@@ -162,14 +206,14 @@ TEST(COMM_UART, TestTxFail)
     TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg2, msg2Len));
 
     TEST_ASSERT_TRUE(interfaces[UART_DEV1].txInProgress);
-    TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
+    TEST_ASSERT_EQUAL(1U, txPending());
     TEST_ASSERT_EQUAL(msg2Len, mockGet_HAL_UART_Len());
 
     // Add the queued data
     TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg3, msg3Len));
 
     TEST_ASSERT_TRUE(interfaces[UART_DEV1].txInProgress);
-    TEST_ASSERT_EQUAL(msg3Len, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
+    TEST_ASSERT_EQUAL(2U, txPending());
     TEST_ASSERT_EQUAL(msg2Len, mockGet_HAL_UART_Len());
 
     // Handle a failed send from the ISR...
@@ -178,6 +222,157 @@ TEST(COMM_UART, TestTxFail)
     HAL_UART_TxCpltCallback(&husart1);
 
     TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
+    TEST_ASSERT_EQUAL(0U, txPending());
+    TEST_ASSERT_EQUAL(interfaces[UART_DEV1].txPoolHead, interfaces[UART_DEV1].txPoolTail);
+}
+
+TEST(COMM_UART, TestTxZeroCopy)
+{
+    static const uint8_t msg1[] = {0x01, 0x02, 0x03};
+    static const uint8_t msg2[] = {0x04, 0x05};
+    int context1 = 1;
+    int context2 = 2;
+
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Transmit(UART_DEV1, msg1, sizeof(msg1), txCallback, &context1));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Transmit(UART_DEV1, msg2, sizeof(msg2), txCallback, &context2));
+    TEST_ASSERT_EQUAL(0U, mNumTxCallbacks);
+
+    // Buffer is used directly, not copied to the pool
+    TEST_ASSERT_EQUAL_PTR(msg1, interfaces[UART_DEV1].txQueue[0].data);
+    TEST_ASSERT_EQUAL(0U, interfaces[UART_DEV1].txPoolHead);
+    TEST_ASSERT_EQUAL(sizeof(msg1), mockGet_HAL_UART_Len());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg1, mockGet_HAL_UART_Data(), sizeof(msg1));
+
+    // Completion releases the first buffer, and chains the second
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_EQUAL(1U, mNumTxCallbacks);
+    TEST_ASSERT_EQUAL_PTR(&context1, mTxCallbacks[0].context);
+    TEST_ASSERT_EQUAL_PTR(msg1, mTxCallbacks[0].data);
+    TEST_ASSERT_EQUAL(sizeof(msg1), mTxCallbacks[0].len);
+    TEST_ASSERT_TRUE(mTxCallbacks[0].sent);
+    TEST_ASSERT_EQUAL(sizeof(msg2), mockGet_HAL_UART_Len());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg2, mockGet_HAL_UART_Data(), sizeof(msg2));
+
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_EQUAL(2U, mNumTxCallbacks);
+    TEST_ASSERT_EQUAL_PTR(&context2, mTxCallbacks[1].context);
+    TEST_ASSERT_TRUE(mTxCallbacks[1].sent);
+    TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
+
+    // Failure to start is reported through the callback too
+    mockSet_HAL_UART_Transmit_DMA_Status(HAL_ERROR);
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_TX, UART_Transmit(UART_DEV1, msg1, sizeof(msg1), txCallback, &context1));
+    TEST_ASSERT_EQUAL(3U, mNumTxCallbacks);
+    TEST_ASSERT_FALSE(mTxCallbacks[2].sent);
+}
+
+TEST(COMM_UART, TestTxFull)
+{
+    uint8_t msg[UART_TX_POOL_LEN / 2U] = { 0 };
+
+    // Fill the pool
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, sizeof(msg)));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, sizeof(msg)));
+    TEST_ASSERT_FALSE(UART_TxSpaceAvailable(UART_DEV1, 1U));
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_TX_FULL, UART_SendMessage(UART_DEV1, msg, 1U));
+    TEST_ASSERT_FALSE(UART_TxSpaceAvailable(UART_DEV1, UART_TX_POOL_LEN + 1U));
+
+    // Longer than the whole pool can never be queued
+    uint8_t big[UART_TX_POOL_LEN + 1U] = { 0 };
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_LEN, UART_SendMessage(UART_DEV1, big, sizeof(big)));
+
+    // Zero copy messages don't need pool space
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Transmit(UART_DEV1, msg, 1U, NULL, NULL));
+
+    // Drain
+    HAL_UART_TxCpltCallback(&husart1);
+    HAL_UART_TxCpltCallback(&husart1);
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
+    TEST_ASSERT_EQUAL(0U, txPending());
+
+    // Fill the descriptor queue
+    for (uint32_t i = 0; i < UART_TX_QUEUE_LEN; ++i) {
+        TEST_ASSERT_TRUE(UART_TxSpaceAvailable(UART_DEV1, 1U));
+        TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, 1U));
+    }
+    TEST_ASSERT_FALSE(UART_TxSpaceAvailable(UART_DEV1, 1U));
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_TX_FULL, UART_SendMessage(UART_DEV1, msg, 1U));
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_TX_FULL, UART_Transmit(UART_DEV1, msg, 1U, txCallback, NULL));
+    TEST_ASSERT_EQUAL(0U, mNumTxCallbacks);
+}
+
+TEST(COMM_UART, TestTxPoolWrap)
+{
+    uint8_t msg1[400];
+    uint8_t msg2[400];
+    uint8_t msg3[400];
+    memset(msg1, 0x11, sizeof(msg1));
+    memset(msg2, 0x22, sizeof(msg2));
+    memset(msg3, 0x33, sizeof(msg3));
+
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg1, sizeof(msg1)));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg2, sizeof(msg2)));
+
+    // msg3 doesn't fit at the end of the pool, and the start is in use
+    TEST_ASSERT_FALSE(UART_TxSpaceAvailable(UART_DEV1, sizeof(msg3)));
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_TX_FULL, UART_SendMessage(UART_DEV1, msg3, sizeof(msg3)));
+
+    // msg1 sent, msg2 sending. Now msg3 wraps to the start of the pool
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg2, mockGet_HAL_UART_Data(), sizeof(msg2));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg3, sizeof(msg3)));
+    TEST_ASSERT_EQUAL_PTR(interfaces[UART_DEV1].txPool, interfaces[UART_DEV1].txQueue[2].data);
+
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_EQUAL(sizeof(msg3), mockGet_HAL_UART_Len());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg3, mockGet_HAL_UART_Data(), sizeof(msg3));
+
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
+    TEST_ASSERT_EQUAL(interfaces[UART_DEV1].txPoolHead, interfaces[UART_DEV1].txPoolTail);
+}
+
+TEST(COMM_UART, TestTxSustained)
+{
+    // Producer queues a burst of state messages every tick, the interrupt
+    // drains them. All bytes must go out in order, in fewer DMA transfers
+    // than messages.
+    uint8_t expected = 0U;
+    uint8_t next = 0U;
+    uint32_t numTransfers = 0U;
+    uint32_t numMessages = 0U;
+
+    for (uint32_t tick = 0; tick < 200U; ++tick) {
+        for (uint32_t i = 0; i < 11U; ++i) {
+            uint8_t msg[18];
+            for (size_t j = 0; j < sizeof(msg); ++j) {
+                msg[j] = next++;
+            }
+            TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, sizeof(msg)));
+            numMessages++;
+
+            // Hardware completes a transfer part way through the burst
+            if (5U == i || 10U == i) {
+                while (mockGet_HAL_UART_Len() > 0U) {
+                    numTransfers++;
+                    for (size_t j = 0; j < mockGet_HAL_UART_Len(); ++j) {
+                        TEST_ASSERT_EQUAL_UINT8(expected, mockGet_HAL_UART_Data()[j]);
+                        expected++;
+                    }
+                    mockClear_HAL_UART_Data();
+                    HAL_UART_TxCpltCallback(&husart1);
+                    if (5U == i) {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(next, expected);
+    TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
+    TEST_ASSERT_LESS_THAN(numMessages / 2U, numTransfers);
 }
 
 TEST(COMM_UART, TestRx)
@@ -192,34 +387,354 @@ TEST(COMM_UART, TestRx)
     uint16_t msg2Len = sizeof(msg2);
     uint16_t msg1_2CombinedLen = sizeof(msg1_2Combined);
 
-    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SetRecvStream(UART_DEV1, interfaces[UART_DEV1].txPendingStreamHandle));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_RegisterRecvStream(UART_DEV1, mRecvStream));
 
-    TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
+    TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(mRecvStream));
     
     // Receive first message
-    memcpy(interfaces[UART_DEV1].uartDmaRx, msg1, msg1Len); // copy into DMA buffer
-    HAL_UARTEx_RxEventCallback(&husart1, msg1Len);
+    mockRecv_HAL_UARTEx_DMA(&husart1, msg1, msg1Len, true);
 
-    TEST_ASSERT_EQUAL(msg1Len, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
-    mockGetStreamBufferData(interfaces[UART_DEV1].txPendingStreamHandle, mockStreamBufferData, mockStreamBufferDataLen);
+    TEST_ASSERT_EQUAL(msg1Len, mockGetStreamBufferLen(mRecvStream));
+    mockGetStreamBufferData(mRecvStream, mockStreamBufferData, mockStreamBufferDataLen);
     TEST_ASSERT_EQUAL_UINT8_ARRAY(msg1, mockStreamBufferData, msg1Len);
 
     // Receive second message
-    memcpy(interfaces[UART_DEV1].uartDmaRx, msg2, msg2Len);
-    HAL_UARTEx_RxEventCallback(&husart1, msg2Len);
+    mockRecv_HAL_UARTEx_DMA(&husart1, msg2, msg2Len, true);
 
-    TEST_ASSERT_EQUAL(msg1_2CombinedLen, mockGetStreamBufferLen(interfaces[UART_DEV1].txPendingStreamHandle));
-    mockGetStreamBufferData(interfaces[UART_DEV1].txPendingStreamHandle, mockStreamBufferData, mockStreamBufferDataLen);
+    TEST_ASSERT_EQUAL(msg1_2CombinedLen, mockGetStreamBufferLen(mRecvStream));
+    mockGetStreamBufferData(mRecvStream, mockStreamBufferData, mockStreamBufferDataLen);
     TEST_ASSERT_EQUAL_UINT8_ARRAY(msg1_2Combined, mockStreamBufferData, msg1_2CombinedLen);
 }
 
+TEST(COMM_UART, TestRxMultipleStreams)
+{
+    uint8_t msg[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+    uint8_t mockStreamBufferData[32] = { 0 };
+    size_t mockStreamBufferDataLen = sizeof(mockStreamBufferData);
+    static uint8_t storage[UART_MAX_RECV_STREAMS][32];
+    static StaticStreamBuffer_t streamStructs[UART_MAX_RECV_STREAMS];
+    StreamBufferHandle_t streams[UART_MAX_RECV_STREAMS];
+
+    // Not registered yet
+    uint32_t overflow = 0U;
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_NOT_FOUND, UART_GetRecvStreamOverflow(UART_DEV1, mRecvStream, &overflow));
+
+    for (size_t i = 0; i < UART_MAX_RECV_STREAMS; ++i) {
+        streams[i] = xStreamBufferCreateStatic(
+            sizeof(storage[i]), 1U, storage[i], &streamStructs[i]);
+        mockClearStreamBufferData(streams[i]);
+        TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_RegisterRecvStream(UART_DEV1, streams[i]));
+    }
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_MAX_STREAMS, UART_RegisterRecvStream(UART_DEV1, mRecvStream));
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_INVALID_DEV, UART_RegisterRecvStream(UART_NUM_INTERFACES, mRecvStream));
+    TEST_ASSERT_EQUAL(UART_STATUS_NOT_READY, UART_RegisterRecvStream(UART_DEV2, mRecvStream));
+
+    // Second stream can only take part of the data
+    mockSetStreamBufferCapacity(streams[1], 5U);
+
+    mockRecv_HAL_UARTEx_DMA(&husart1, msg, sizeof(msg), true);
+
+    for (size_t i = 0; i < UART_MAX_RECV_STREAMS; ++i) {
+        size_t expectedLen = (1U == i) ? 5U : sizeof(msg);
+        uint32_t expectedOverflow = (1U == i) ? 3U : 0U;
+
+        TEST_ASSERT_EQUAL(expectedLen, mockGetStreamBufferLen(streams[i]));
+        mockGetStreamBufferData(streams[i], mockStreamBufferData, mockStreamBufferDataLen);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, mockStreamBufferData, expectedLen);
+
+        TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetRecvStreamOverflow(UART_DEV1, streams[i], &overflow));
+        TEST_ASSERT_EQUAL(expectedOverflow, overflow);
+    }
+}
+
+TEST(COMM_UART, TestRxCircular)
+{
+    uint8_t rxData[UART_MAX_DMA_LEN + 64];
+    uint8_t expected[UART_MAX_DMA_LEN + 64];
+    for (size_t i = 0; i < sizeof(expected); ++i) {
+        expected[i] = (uint8_t)(i * 7U);
+    }
+    StreamBufferHandle_t sb = mRecvStream;
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_RegisterRecvStream(UART_DEV1, sb));
+    uint32_t dmaStarts = mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1);
+
+    // Message ending on idle part way into the buffer
+    mockRecv_HAL_UARTEx_DMA(&husart1, expected, 100, true);
+    TEST_ASSERT_EQUAL(100, mockGetStreamBufferLen(sb));
+
+    // Data without an idle is forwarded at half & full transfer
+    mockRecv_HAL_UARTEx_DMA(&husart1, &expected[100], UART_MAX_DMA_LEN / 2U - 100U, false);
+    TEST_ASSERT_EQUAL(UART_MAX_DMA_LEN / 2U, mockGetStreamBufferLen(sb));
+    mockRecv_HAL_UARTEx_DMA(&husart1, &expected[UART_MAX_DMA_LEN / 2U], 10, false);
+    TEST_ASSERT_EQUAL(UART_MAX_DMA_LEN / 2U, mockGetStreamBufferLen(sb));
+
+    // Message wraps around the end of the buffer
+    mockRecv_HAL_UARTEx_DMA(
+        &husart1,
+        &expected[UART_MAX_DMA_LEN / 2U + 10U],
+        sizeof(expected) - UART_MAX_DMA_LEN / 2U - 10U,
+        true);
+    TEST_ASSERT_EQUAL(sizeof(expected), mockGetStreamBufferLen(sb));
+    mockGetStreamBufferData(sb, rxData, sizeof(rxData));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, rxData, sizeof(expected));
+
+    // Repeated events at the same position don't duplicate data
+    HAL_UARTEx_RxEventCallback(&husart1, 64);
+    TEST_ASSERT_EQUAL(sizeof(expected), mockGetStreamBufferLen(sb));
+
+    // DMA was never restarted
+    TEST_ASSERT_EQUAL(dmaStarts, mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1));
+}
+
+TEST(COMM_UART, TestRxSustained)
+{
+    // 2s of back to back traffic at 921600 baud (92160 bytes/s), in bursts
+    // separated by occasional idle lines. Receiving task drains the stream
+    // every 1ms. No bytes may be lost or duplicated.
+    const uint32_t bytesPerMs = 92U;
+    const uint32_t durationMs = 2000U;
+    StreamBufferHandle_t sb = mRecvStream;
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_RegisterRecvStream(UART_DEV1, sb));
+    uint32_t dmaStarts = mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1);
+
+    uint8_t txByte = 0U;
+    uint8_t rxByte = 0U;
+    uint32_t lcg = 1U;
+    uint32_t totalRx = 0U;
+    for (uint32_t ms = 0; ms < durationMs; ++ms) {
+        uint8_t chunk[128];
+        for (uint32_t i = 0; i < bytesPerMs; ++i) {
+            chunk[i] = txByte++;
+        }
+
+        // split the ms worth of data at a random point
+        lcg = lcg * 1103515245U + 12345U;
+        uint32_t split = (lcg >> 16) % bytesPerMs;
+        bool idle = ((lcg >> 8) & 0x3U) == 0U;
+        mockRecv_HAL_UARTEx_DMA(&husart1, chunk, split, false);
+        mockRecv_HAL_UARTEx_DMA(&husart1, &chunk[split], bytesPerMs - split, idle);
+
+        // receiving task
+        uint8_t received[UART_MAX_DMA_LEN];
+        size_t numReceived = xStreamBufferReceive(sb, received, sizeof(received), 0);
+        for (size_t i = 0; i < numReceived; ++i) {
+            TEST_ASSERT_EQUAL_UINT8(rxByte, received[i]);
+            rxByte++;
+        }
+        totalRx += (uint32_t)numReceived;
+        mockClearStreamBufferData(sb);
+    }
+
+    // Flush the remainder with an idle line
+    mockRecv_HAL_UARTEx_DMA(&husart1, NULL, 0, true);
+    totalRx += (uint32_t)mockGetStreamBufferLen(sb);
+
+    TEST_ASSERT_EQUAL_UINT32(bytesPerMs * durationMs, totalRx);
+    TEST_ASSERT_EQUAL(dmaStarts, mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1));
+}
+
+TEST(COMM_UART, TestErrorCallbackTx)
+{
+    static const uint8_t msg1[] = {0x01, 0x02, 0x03};
+    static const uint8_t msg2[] = {0x04, 0x05};
+
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Transmit(UART_DEV1, msg1, sizeof(msg1), txCallback, NULL));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Transmit(UART_DEV1, msg2, sizeof(msg2), txCallback, NULL));
+
+    // Error not affecting transmit
+    HAL_UART_ErrorCallback(&husart1);
+    TEST_ASSERT_EQUAL(0U, mNumTxCallbacks);
+    TEST_ASSERT_EQUAL(2U, txPending());
+
+    // Transmit DMA error ends the transfer. Dropped and next started.
+    husart1.gState = HAL_UART_STATE_READY;
+    HAL_UART_ErrorCallback(&husart1);
+    TEST_ASSERT_EQUAL(1U, mNumTxCallbacks);
+    TEST_ASSERT_FALSE(mTxCallbacks[0].sent);
+    TEST_ASSERT_EQUAL_PTR(msg1, mTxCallbacks[0].data);
+    TEST_ASSERT_TRUE(interfaces[UART_DEV1].txInProgress);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg2, mockGet_HAL_UART_Data(), sizeof(msg2));
+
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_EQUAL(2U, mNumTxCallbacks);
+    TEST_ASSERT_TRUE(mTxCallbacks[1].sent);
+}
+
 TEST(COMM_UART, TestErrorCallback)
 {
-    interfaces[UART_DEV1].txInProgress = true;
+    uint32_t dmaStarts = mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1);
+
+    // Reception still active (e.g. framing error) is left running
+    HAL_UART_ErrorCallback(&husart1);
+
+    TEST_ASSERT_EQUAL(dmaStarts, mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1));
+
+    // Reception aborted by the HAL (e.g. overrun) is restarted
+    interfaces[UART_DEV1].rxReadPos = 10U;
+    husart1.RxState = HAL_UART_STATE_READY;
+    HAL_UART_ErrorCallback(&husart1);
+
+    TEST_ASSERT_EQUAL(dmaStarts + 1U, mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1));
+    TEST_ASSERT_EQUAL(HAL_UART_STATE_BUSY_RX, husart1.RxState);
+    TEST_ASSERT_EQUAL(0U, interfaces[UART_DEV1].rxReadPos);
+}
+
+TEST(COMM_UART, TestStats)
+{
+    uint8_t msg[10] = { 0 };
+    UART_Stats_T stats;
+
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_INVALID_DEV, UART_GetStats(UART_NUM_INTERFACES, &stats));
+    TEST_ASSERT_EQUAL(UART_STATUS_NOT_READY, UART_GetStats(UART_DEV2, &stats));
+
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetStats(UART_DEV1, &stats));
+    TEST_ASSERT_EQUAL(0U, stats.rxBytes);
+    TEST_ASSERT_EQUAL(0U, stats.txBytes);
+    TEST_ASSERT_EQUAL(0U, stats.txBacklogPeak);
+    TEST_ASSERT_EQUAL(0U, stats.txChainPeak);
+
+    // Receive into a stream that can only take part of it
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_RegisterRecvStream(UART_DEV1, mRecvStream));
+    mockSetStreamBufferCapacity(mRecvStream, 6U);
+    mockRecv_HAL_UARTEx_DMA(&husart1, msg, sizeof(msg), true);
+
+    // Three messages queued at once, chained from the interrupt
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, 4U));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Transmit(UART_DEV1, msg, 3U, NULL, NULL));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Transmit(UART_DEV1, msg, 2U, NULL, NULL));
+    HAL_UART_TxCpltCallback(&husart1);
+
+    // Transmit DMA error on the 2nd
+    husart1.ErrorCode = HAL_UART_ERROR_DMA;
+    husart1.gState = HAL_UART_STATE_READY;
+    HAL_UART_ErrorCallback(&husart1);
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
 
+    // Receive errors
+    husart1.ErrorCode = HAL_UART_ERROR_ORE | HAL_UART_ERROR_FE;
     HAL_UART_ErrorCallback(&husart1);
+    husart1.ErrorCode = HAL_UART_ERROR_NE | HAL_UART_ERROR_PE;
+    HAL_UART_ErrorCallback(&husart1);
+    husart1.ErrorCode = HAL_UART_ERROR_ORE;
+    HAL_UART_ErrorCallback(&husart1);
+    husart1.ErrorCode = HAL_UART_ERROR_NONE;
+
+    // Rejected message
+    mockSet_HAL_UART_Transmit_DMA_Status(HAL_BUSY);
+    for (uint32_t i = 0; i < UART_TX_QUEUE_LEN; ++i) {
+        UART_Transmit(UART_DEV1, msg, 1U, NULL, NULL);
+    }
+    interfaces[UART_DEV1].txInProgress = true; // stuck, so nothing is released
+    for (uint32_t i = 0; i < UART_TX_QUEUE_LEN; ++i) {
+        UART_Transmit(UART_DEV1, msg, 1U, NULL, NULL);
+    }
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_TX_FULL, UART_SendMessage(UART_DEV1, msg, 7U));
+
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetStats(UART_DEV1, &stats));
+    TEST_ASSERT_EQUAL(10U, stats.rxBytes);
+    TEST_ASSERT_EQUAL(4U, stats.rxOverflowBytes);
+    TEST_ASSERT_EQUAL(4U + 2U, stats.txBytes);
+    TEST_ASSERT_EQUAL(3U + UART_TX_QUEUE_LEN, stats.txDroppedBytes);
+    TEST_ASSERT_EQUAL(7U, stats.txFullBytes);
+    TEST_ASSERT_EQUAL(UART_TX_QUEUE_LEN, stats.txBacklogPeak);
+    TEST_ASSERT_EQUAL(3U, stats.txChainPeak);
+    TEST_ASSERT_EQUAL(2U, stats.overrunErrors);
+    TEST_ASSERT_EQUAL(1U, stats.framingErrors);
+    TEST_ASSERT_EQUAL(1U, stats.noiseErrors);
+    TEST_ASSERT_EQUAL(1U, stats.parityErrors);
+    TEST_ASSERT_EQUAL(1U, stats.dmaErrors);
+
+    interfaces[UART_DEV1].txInProgress = false;
+}
+
+TEST(COMM_UART, TestBaudRate)
+{
+    uint8_t msg[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    uint32_t baudRate = 0U;
+
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_INVALID_DEV, UART_SetBaudRate(UART_NUM_INTERFACES, 9600U));
+    TEST_ASSERT_EQUAL(UART_STATUS_NOT_READY, UART_SetBaudRate(UART_DEV2, 9600U));
+    TEST_ASSERT_EQUAL(UART_STATUS_NOT_READY, UART_GetBaudRate(UART_DEV2, &baudRate));
 
+    husart1.Init.BaudRate = 115200U;
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetBaudRate(UART_DEV1, &baudRate));
+    TEST_ASSERT_EQUAL(115200U, baudRate);
+
+    // Not while anything is still to be sent
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, 4U));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, 4U));
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_BUSY, UART_SetBaudRate(UART_DEV1, 921600U));
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_BUSY, UART_SetBaudRate(UART_DEV1, 921600U));
+    HAL_UART_TxCpltCallback(&husart1);
+
+    // Part way through the receive buffer
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_RegisterRecvStream(UART_DEV1, mRecvStream));
+    mockRecv_HAL_UARTEx_DMA(&husart1, msg, 3U, true);
+    TEST_ASSERT_EQUAL(3U, mockGetStreamBufferLen(mRecvStream));
+    const uint32_t starts = mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1);
+
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SetBaudRate(UART_DEV1, 921600U));
+    TEST_ASSERT_EQUAL(921600U, mockGet_HAL_UART_BaudRate(&husart1));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetBaudRate(UART_DEV1, &baudRate));
+    TEST_ASSERT_EQUAL(921600U, baudRate);
+    TEST_ASSERT_EQUAL(starts + 1U, mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1));
+
+    // Reception restarts from the start of the buffer
+    mockRecv_HAL_UARTEx_DMA(&husart1, msg + 3U, 4U, true);
+    uint8_t recvd[7] = { 0 };
+    TEST_ASSERT_EQUAL(7U, mockGetStreamBufferLen(mRecvStream));
+    TEST_ASSERT_TRUE(mockGetStreamBufferData(mRecvStream, recvd, sizeof(recvd)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, recvd, sizeof(recvd));
+
+    // Peripheral rejects the rate, stays at the old one
+    mockSet_HAL_UART_Init_Status(HAL_ERROR);
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_CONFIG, UART_SetBaudRate(UART_DEV1, 20000000U));
+    mockSet_HAL_UART_Init_Status(HAL_OK);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetBaudRate(UART_DEV1, &baudRate));
+    TEST_ASSERT_EQUAL(921600U, baudRate);
+    TEST_ASSERT_EQUAL(starts + 2U, mockGet_HAL_UARTEx_ReceiveToIdle_DMA_Starts(&husart1));
+}
+
+TEST(COMM_UART, TestFlushTx)
+{
+    uint8_t msg[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    int context = 0;
+
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_INVALID_DEV, UART_FlushTx(UART_NUM_INTERFACES));
+    TEST_ASSERT_EQUAL(UART_STATUS_NOT_READY, UART_FlushTx(UART_DEV2));
+
+    // One in progress, two queued, one of them zero copy
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, 4U));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, 3U));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Transmit(UART_DEV1, msg, 2U, txCallback, &context));
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR_BUSY, UART_SetBaudRate(UART_DEV1, 921600U));
+
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_FlushTx(UART_DEV1));
     TEST_ASSERT_FALSE(interfaces[UART_DEV1].txInProgress);
+    TEST_ASSERT_EQUAL(0U, txPending());
+    TEST_ASSERT_EQUAL(interfaces[UART_DEV1].txPoolHead, interfaces[UART_DEV1].txPoolTail);
+    TEST_ASSERT_EQUAL(HAL_UART_STATE_READY, husart1.gState);
+    TEST_ASSERT_EQUAL(1U, mNumTxCallbacks);
+    TEST_ASSERT_FALSE(mTxCallbacks[0].sent);
+
+    UART_Stats_T stats;
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetStats(UART_DEV1, &stats));
+    TEST_ASSERT_EQUAL(9U, stats.txDroppedBytes);
+    TEST_ASSERT_EQUAL(0U, stats.txBytes);
+
+    // Free to change rate and send again
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SetBaudRate(UART_DEV1, 921600U));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(UART_DEV1, msg, 4U));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, mockGet_HAL_UART_Data(), 4U);
+    HAL_UART_TxCpltCallback(&husart1);
+    TEST_ASSERT_EQUAL(0U, txPending());
+
+    // Nothing to drop
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_FlushTx(UART_DEV1));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetStats(UART_DEV1, &stats));
+    TEST_ASSERT_EQUAL(9U, stats.txDroppedBytes);
 }
 
 TEST_GROUP_RUNNER(COMM_UART)
@@ -227,8 +742,19 @@ TEST_GROUP_RUNNER(COMM_UART)
     RUN_TEST_CASE(COMM_UART, TestInitOk);
     RUN_TEST_CASE(COMM_UART, TestTx);
     RUN_TEST_CASE(COMM_UART, TestTxFail);
+    RUN_TEST_CASE(COMM_UART, TestTxZeroCopy);
+    RUN_TEST_CASE(COMM_UART, TestTxFull);
+    RUN_TEST_CASE(COMM_UART, TestTxPoolWrap);
+    RUN_TEST_CASE(COMM_UART, TestTxSustained);
     RUN_TEST_CASE(COMM_UART, TestRx);
+    RUN_TEST_CASE(COMM_UART, TestRxMultipleStreams);
+    RUN_TEST_CASE(COMM_UART, TestRxCircular);
+    RUN_TEST_CASE(COMM_UART, TestRxSustained);
+    RUN_TEST_CASE(COMM_UART, TestErrorCallbackTx);
     RUN_TEST_CASE(COMM_UART, TestErrorCallback);
+    RUN_TEST_CASE(COMM_UART, TestStats);
+    RUN_TEST_CASE(COMM_UART, TestBaudRate);
+    RUN_TEST_CASE(COMM_UART, TestFlushTx);
 }
 
 #define INVOKE_TEST COMM_UART
@@ -48,14 +48,22 @@ static ADC_HandleTypeDef hadc1 = {
         .NbrOfConversion = NUM_CHANNELS,
     }
 };
+static ADC_HandleTypeDef hadc2 = {
+    .Instance = ADC2,
+    .Init = (ADC_InitTypeDef){
+        .ContinuousConvMode = ENABLE,
+        .DataAlign = ADC_DATAALIGN_RIGHT,
+        .NbrOfConversion = NUM_CHANNELS / 2,
+    }
+};
 
 // Modules
 static Logging_T testLog;
 static VehicleState_T testVehicleState;
-static ADC_Config_T testADCConfig = {
+static ADC_T testADC = {
     .logger = &testLog,
     .handle = &hadc1,
-    .adcIrq = DMA2_Stream0_IRQn,
+    .mode = ADC_MULTIMODE_INDEPENDENT,
     .numChannelsUsed = NUM_CHANNELS,
 };
 static DiscreteSense_T testDiscreteSense = {
@@ -63,6 +71,7 @@ static DiscreteSense_T testDiscreteSense = {
     .logger = &testLog,
     .state = &testVehicleState,
     // Config
+    .adc = &testADC,
     .adcAccelPedalA = adcChAccelPedalA,
     .adcAccelPedalB = adcChAccelPedalB,
     .adcBrakeFront = adcChBrakePedalFront,
@@ -94,6 +103,7 @@ static DiscreteSense_T testDiscreteSense = {
 // TODO move these to mock
 extern void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc);
 extern void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc);
+extern void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef* hadc);
 
 static void resetInputs(void)
 {
@@ -133,7 +143,12 @@ TEST_SETUP(DEVICE_DISCRETESENSE)
     mockSet_TaskTimer_RegisterTask_Status(TASKTIMER_STATUS_OK);
 
     // Init ADC
-    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&testADCConfig));
+    hadc1.Init.NbrOfConversion = NUM_CHANNELS;
+    testADC.mode = ADC_MULTIMODE_INDEPENDENT;
+    testADC.numChannelsUsed = NUM_CHANNELS;
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&testADC));
+    testDiscreteSense.accelPedalWatchdog = false;
+    testDiscreteSense.filterBrakeFront.numStages = 0;
 
     // Init vehicle state
     TEST_ASSERT_EQUAL(
@@ -187,20 +202,130 @@ TEST(DEVICE_DISCRETESENSE, UpdateNormal)
 
     TEST_ASSERT_EQUAL(10, testVehicleState.data.inputs.accelRawA);
     TEST_ASSERT_EQUAL(1020, testVehicleState.data.inputs.accelRawB);
-    TEST_ASSERT_EQUAL_FLOAT(0.01f, testVehicleState.data.inputs.accelA);
-    TEST_ASSERT_EQUAL_FLOAT(0.02f, testVehicleState.data.inputs.accelB);
-    TEST_ASSERT_EQUAL_FLOAT(0.015f, testVehicleState.data.inputs.accel);
+    // Q16 fixed-point scaling
+    TEST_ASSERT_EQUAL_FLOAT(655.0f / 65536.0f, testVehicleState.data.inputs.accelA);
+    TEST_ASSERT_EQUAL_FLOAT(1311.0f / 65536.0f, testVehicleState.data.inputs.accelB);
+    TEST_ASSERT_EQUAL_FLOAT(983.0f / 65536.0f, testVehicleState.data.inputs.accel);
     TEST_ASSERT_TRUE(testVehicleState.data.inputs.accelValid);
     TEST_ASSERT_EQUAL(2100, testVehicleState.data.inputs.brakeRawFront);
     TEST_ASSERT_EQUAL(3120, testVehicleState.data.inputs.brakeRawRear);
-    TEST_ASSERT_EQUAL_FLOAT(0.1f, testVehicleState.data.inputs.brakePresFront);
-    TEST_ASSERT_EQUAL_FLOAT(0.12f, testVehicleState.data.inputs.brakePresRear);
+    TEST_ASSERT_EQUAL_FLOAT(6554.0f / 65536.0f, testVehicleState.data.inputs.brakePresFront);
+    TEST_ASSERT_EQUAL_FLOAT(7864.0f / 65536.0f, testVehicleState.data.inputs.brakePresRear);
+}
+
+TEST(DEVICE_DISCRETESENSE, FilterMedian)
+{
+    testDiscreteSense.filterBrakeFront = (Filter_Chain_T){
+        .numStages = 1,
+        .stages = { { .type = FILTER_TYPE_MEDIAN, .taps = 3 } },
+    };
+    TEST_ASSERT_EQUAL(DISCRETESENSE_STATUS_OK, DiscreteSense_Init(&testDiscreteSense));
+
+    const uint16_t brakeFrontRaw[] = { 2100, 2100, 2900, 2100, 2100, 2200, 2200 };
+    const uint16_t brakeFrontRawExpected[] = { 2100, 2100, 2100, 2100, 2100, 2100, 2200 };
+    const float brakeFrontExpected[] = {
+        6554.0f / 65536.0f,
+        6554.0f / 65536.0f,
+        6554.0f / 65536.0f, // spike rejected
+        6554.0f / 65536.0f,
+        6554.0f / 65536.0f,
+        6554.0f / 65536.0f,
+        13107.0f / 65536.0f, // step passed after 2 samples
+    };
+
+    for (uint16_t i = 0; i < sizeof(brakeFrontRaw) / sizeof(brakeFrontRaw[0]); ++i) {
+        mockSetADCDataChannel(adcChBrakePedalFront, brakeFrontRaw[i]);
+        HAL_ADC_ConvHalfCpltCallback(&hadc1);
+        HAL_ADC_ConvCpltCallback(&hadc1);
+
+        mockSetTaskNotifyValue(1);
+        DiscreteSense_TaskMethod(&testDiscreteSense);
+
+        // The raw value checked for range faults is filtered too
+        TEST_ASSERT_EQUAL(brakeFrontRawExpected[i], testVehicleState.data.inputs.brakeRawFront);
+        TEST_ASSERT_EQUAL_FLOAT(brakeFrontExpected[i], testVehicleState.data.inputs.brakePresFront);
+    }
+}
+
+TEST(DEVICE_DISCRETESENSE, FilterInvalid)
+{
+    testDiscreteSense.filterBrakeFront = (Filter_Chain_T){
+        .numStages = 1,
+        .stages = { { .type = FILTER_TYPE_MEDIAN, .taps = 4 } },
+    };
+    mockLogClear();
+    TEST_ASSERT_EQUAL(DISCRETESENSE_STATUS_ERROR_INIT, DiscreteSense_Init(&testDiscreteSense));
+
+    const char* expectedLogging =
+        "DiscreteSense_Init begin\n"
+        "DiscreteSense_Init invalid filter\n";
+    TEST_ASSERT_EQUAL_STRING(expectedLogging, mockLogGet());
+}
+
+TEST(DEVICE_DISCRETESENSE, WatchdogInitError)
+{
+    // Both pedals are sampled by ADC1, which only has one watchdog
+    testDiscreteSense.accelPedalWatchdog = true;
+    mockLogClear();
+    TEST_ASSERT_EQUAL(DISCRETESENSE_STATUS_ERROR_INIT, DiscreteSense_Init(&testDiscreteSense));
+
+    const char* expectedLogging =
+        "DiscreteSense_Init begin\n"
+        "ADC_ConfigWatchdog watchdog already in use\n"
+        "DiscreteSense_Init ADC watchdog config failed\n";
+    TEST_ASSERT_EQUAL_STRING(expectedLogging, mockLogGet());
+}
+
+TEST(DEVICE_DISCRETESENSE, WatchdogAccelPedal)
+{
+    // Sample the pedals simultaneously on ADC1 & ADC2 (channels 0 & 1)
+    hadc1.Init.NbrOfConversion = NUM_CHANNELS / 2;
+    testADC.numChannelsUsed = NUM_CHANNELS / 2;
+    testADC.mode = ADC_MULTIMODE_DUAL_SIMULT;
+    testADC.slaves[0] = &hadc2;
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&testADC));
+
+    testDiscreteSense.accelPedalWatchdog = true;
+    testDiscreteSense.adcHwAccelPedalA = ADC_CHANNEL_8;
+    testDiscreteSense.adcHwAccelPedalB = ADC_CHANNEL_9;
+    TEST_ASSERT_EQUAL(DISCRETESENSE_STATUS_OK, DiscreteSense_Init(&testDiscreteSense));
+
+    // Window is the pedal scaling
+    ADC_AnalogWDGConfTypeDef awdConfig = mockGet_HAL_ADC_AnalogWDGConfig(&hadc2);
+    TEST_ASSERT_EQUAL(ADC_CHANNEL_9, awdConfig.Channel);
+    TEST_ASSERT_EQUAL(1000, awdConfig.LowThreshold);
+    TEST_ASSERT_EQUAL(2000, awdConfig.HighThreshold);
+
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    HAL_ADC_ConvCpltCallback(&hadc1);
+
+    mockSetTaskNotifyValue(1);
+    DiscreteSense_TaskMethod(&testDiscreteSense);
+    TEST_ASSERT_FALSE(testVehicleState.data.inputs.accelOutOfRange);
+
+    // Pedal B goes out of range between task ticks
+    mockSet_HAL_GetTick(1234U);
+    HAL_ADC_LevelOutOfWindowCallback(&hadc2);
+    mockSet_HAL_GetTick(1240U);
+    mockSetTaskNotifyValue(1);
+    DiscreteSense_TaskMethod(&testDiscreteSense);
+    TEST_ASSERT_TRUE(testVehicleState.data.inputs.accelOutOfRange);
+    TEST_ASSERT_EQUAL_UINT32(1234U, testVehicleState.data.inputs.accelOutOfRangeTime);
+
+    // Back in range
+    mockSetTaskNotifyValue(1);
+    DiscreteSense_TaskMethod(&testDiscreteSense);
+    TEST_ASSERT_FALSE(testVehicleState.data.inputs.accelOutOfRange);
 }
 
 TEST_GROUP_RUNNER(DEVICE_DISCRETESENSE)
 {
     RUN_TEST_CASE(DEVICE_DISCRETESENSE, InitOk);
     RUN_TEST_CASE(DEVICE_DISCRETESENSE, UpdateNormal);
+    RUN_TEST_CASE(DEVICE_DISCRETESENSE, FilterMedian);
+    RUN_TEST_CASE(DEVICE_DISCRETESENSE, FilterInvalid);
+    RUN_TEST_CASE(DEVICE_DISCRETESENSE, WatchdogInitError);
+    RUN_TEST_CASE(DEVICE_DISCRETESENSE, WatchdogAccelPedal);
 }
 
 #define INVOKE_TEST DEVICE_DISCRETESENSE
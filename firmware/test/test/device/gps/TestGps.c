@@ -40,6 +40,7 @@ static UART_DeviceConfig_T configUart = {
     .dev = UART_DEV1,
     .handle = &husart,
     .txIrq = DMA2_Stream1_IRQn,
+    .uartIrq = USART1_IRQn,
 };
 static VehicleState_T mVehicleState;
 static GPS_T mGps;
@@ -119,9 +120,8 @@ TEST(DEVICE_GPS, GpsReceiveGPGGA)
     TEST_ASSERT_EQUAL(0, mVehicleState.data.vehicle.gps.nSatellites);
 
     // Load in mock data
-    memcpy(interfaces[UART_DEV1].uartDmaRx, msg, msgLen); // copy into DMA buffer
     mockSet_HAL_UART_Data(msg, msgLen);
-    HAL_UARTEx_RxEventCallback(&husart, msgLen);
+    mockRecv_HAL_UARTEx_DMA(&husart, msg, msgLen, true);
 
     mockSetTaskNotifyValue(1); // to wake up
     GPS_TaskMethod(&mGps);
@@ -38,6 +38,32 @@ static Logging_T testLog;
 static VehicleState_T testVehicleState;
 static CInverter_T testInverter;
 
+// Channel stream, a block of 2 samples
+#define STREAM_SAMPLES_PER_BLOCK 2U
+#define STREAM_BLOCK_LEN BLOCKBUFFER_BLOCK_LEN(CINVERTER_STREAM_SAMPLE_LEN, STREAM_SAMPLES_PER_BLOCK)
+static uint8_t testStreamStorage[STREAM_BLOCK_LEN];
+static BlockBuffer_T testStream;
+static uint8_t testStreamBlock[STREAM_BLOCK_LEN];
+
+static bool streamSink(void* context, const uint8_t* block, uint16_t len)
+{
+    (void)context;
+    TEST_ASSERT_EQUAL(STREAM_BLOCK_LEN, len);
+    memcpy(testStreamBlock, block, len);
+    return true;
+}
+
+static float streamChannel(uint16_t sample, CInverter_Channel_T channel)
+{
+    const uint8_t* in = &testStreamBlock[BLOCKBUFFER_HEADER_LEN +
+        sample * CINVERTER_STREAM_SAMPLE_LEN + channel * 4U];
+    uint32_t bits = ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) |
+        ((uint32_t)in[2] << 8) | (uint32_t)in[3];
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
 static void resetInputs(void)
 {
     // TODO add support for INV_ERR pin
@@ -86,6 +112,7 @@ TEST_SETUP(DEVICE_CINVERTER)
     // Init inverter
     testInverter.canInst = inverterCanBus;
     testInverter.vehicleState = &testVehicleState;
+    testInverter.stream = NULL;
     CInverter_Status_T status = CInverter_Init(&testLog, &testInverter);
     TEST_ASSERT_EQUAL(CINVERTER_STATUS_OK, status);
 
@@ -621,6 +648,73 @@ TEST(DEVICE_CINVERTER, RecvModulationIndexFluxWeakingInformation)
     TEST_ASSERT_EQUAL_FLOAT(201.7f, testVehicleState.data.inverter.iqCommand);
 }
 
+TEST(DEVICE_CINVERTER, StreamChannels)
+{
+    testStream.storage = testStreamStorage;
+    testStream.sampleLen = CINVERTER_STREAM_SAMPLE_LEN;
+    testStream.samplesPerBlock = STREAM_SAMPLES_PER_BLOCK;
+    testStream.numBlocks = 1U;
+    TEST_ASSERT_TRUE(BlockBuffer_Init(&testStream));
+    testInverter.stream = &testStream;
+
+    // Nothing is sampled until the stream is started
+    mockSetTaskNotifyValue(1);
+    InverterProcessing(&testInverter);
+    BlockBuffer_Start(&testStream);
+
+    testVehicleState.data.motor.phaseACurrent = 12.5f;
+    testVehicleState.data.motor.phaseCCurrent = -7.25f;
+    testVehicleState.data.motor.speed = -3200;
+    testVehicleState.data.inverter.vq = 96.0f;
+    mockSetTaskNotifyValue(1);
+    InverterProcessing(&testInverter);
+
+    // Received data is in the sample of the same tick
+    uint8_t recvMsg[] = {
+        0x62, 0x00, // Modulation index = 0.98
+        0x91, 0x01, // Flux weakening output = 40.1 A
+        0x0B, 0xFE, // Id command = -50.1 A
+        0xE1, 0x07  // Iq command = 201.7 A
+    };
+    mockAddHALCANRxMessage(0x0AD, recvMsg, 8);
+    HAL_CAN_RxFifo0MsgPendingCallback(&hcan);
+    mockSetTaskNotifyValue(1);
+    InverterProcessing(&testInverter);
+
+    // Not sampled without a tick
+    mockSetTaskNotifyValue(0);
+    InverterProcessing(&testInverter);
+    TEST_ASSERT_EQUAL(0U, testStream.dropped);
+
+    TEST_ASSERT_EQUAL(1U, BlockBuffer_Flush(&testStream, streamSink, NULL));
+    const uint8_t header[BLOCKBUFFER_HEADER_LEN] = { 0 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(header, testStreamBlock, sizeof(header));
+    TEST_ASSERT_EQUAL_FLOAT(12.5f, streamChannel(0U, CINVERTER_CHANNEL_PHASEA_CURRENT));
+    TEST_ASSERT_EQUAL_FLOAT(-7.25f, streamChannel(0U, CINVERTER_CHANNEL_PHASEC_CURRENT));
+    TEST_ASSERT_EQUAL_FLOAT(96.0f, streamChannel(0U, CINVERTER_CHANNEL_VQ));
+    TEST_ASSERT_EQUAL_FLOAT(-3200.0f, streamChannel(0U, CINVERTER_CHANNEL_MOTOR_SPEED));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, streamChannel(0U, CINVERTER_CHANNEL_MODULATION_INDEX));
+    TEST_ASSERT_EQUAL_FLOAT(0.98f, streamChannel(1U, CINVERTER_CHANNEL_MODULATION_INDEX));
+    TEST_ASSERT_EQUAL_FLOAT(-50.1f, streamChannel(1U, CINVERTER_CHANNEL_ID_COMMAND));
+    TEST_ASSERT_EQUAL_FLOAT(201.7f, streamChannel(1U, CINVERTER_CHANNEL_IQ_COMMAND));
+    TEST_ASSERT_EQUAL_FLOAT(12.5f, streamChannel(1U, CINVERTER_CHANNEL_PHASEA_CURRENT));
+
+    // A sample that can't be read is dropped, not skipped
+    mockSemaphoreSetLocked(testVehicleState.mutex, true);
+    mockSetTaskNotifyValue(1);
+    InverterProcessing(&testInverter);
+    mockSemaphoreSetLocked(testVehicleState.mutex, false);
+    TEST_ASSERT_EQUAL(1U, testStream.dropped);
+
+    // Stopped, the vehicle state isn't read at all
+    BlockBuffer_Stop(&testStream);
+    mockSemaphoreSetLocked(testVehicleState.mutex, true);
+    mockSetTaskNotifyValue(1);
+    InverterProcessing(&testInverter);
+    mockSemaphoreSetLocked(testVehicleState.mutex, false);
+    TEST_ASSERT_EQUAL(1U, testStream.dropped);
+}
+
 TEST_GROUP_RUNNER(DEVICE_CINVERTER)
 {
     RUN_TEST_CASE(DEVICE_CINVERTER, InitOk);
@@ -644,6 +738,7 @@ TEST_GROUP_RUNNER(DEVICE_CINVERTER)
     RUN_TEST_CASE(DEVICE_CINVERTER, RecvFaultCodes);
     RUN_TEST_CASE(DEVICE_CINVERTER, RecvTorqueTimerInformation);
     RUN_TEST_CASE(DEVICE_CINVERTER, RecvModulationIndexFluxWeakingInformation);
+    RUN_TEST_CASE(DEVICE_CINVERTER, StreamChannels);
 }
 
 #define INVOKE_TEST DEVICE_CINVERTER
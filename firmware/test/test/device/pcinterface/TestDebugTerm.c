@@ -38,6 +38,9 @@
 #include "device/pcinterface/pcinterface.c"
 #include "device/pcinterface/periodicupdates.c"
 #include "device/pcinterface/requests.c"
+#include "device/pcinterface/baudrate.c"
+#include "device/pcinterface/subscriptions.c"
+#include "device/pcinterface/stream.c"
 #include "device/pcinterface/debugterm.c"
 #include "device/pcinterface/debugtermcommands.c"
 #include "logging/logging.c"  // also need this to use mock impls
@@ -48,8 +51,6 @@ static Logging_T testLog;
 static GPIO_TypeDef gpioBankA;
 static GPIO_T mPinToggle = { .GPIOx = &gpioBankA, .GPIO_Pin = 1U };
 
-static CRC_HandleTypeDef hcrc;
-static CRC_T mCrc;
 static UART_HandleTypeDef husartA = {
     .Instance = USART1,
 };
@@ -60,11 +61,13 @@ static UART_DeviceConfig_T configUartA = {
   .dev = UART_DEV1,
   .handle = &husartA,
   .txIrq = DMA2_Stream1_IRQn,
+  .uartIrq = USART1_IRQn,
 };
 static UART_DeviceConfig_T configUartB = {
   .dev = UART_DEV3,
   .handle = &husartB,
   .txIrq = DMA2_Stream2_IRQn,
+  .uartIrq = USART3_IRQn,
 };
 
 static VehicleState_T mVehicleState;
@@ -74,15 +77,6 @@ static VehicleControl_T mVehicleControl;
 
 static PCInterface_T mPCInterface;
 
-// Number of state update messages are sent in succession
-const uint32_t STATEUPDATE_NUMMSGS_SDC = 1;
-const uint32_t STATEUPDATE_NUMMSGS_PDM = 1;
-const uint32_t STATEUPDATE_NUMMSGS_BATTERY = 9;
-const uint32_t STATEUPDATE_NUMMSGS =
-        STATEUPDATE_NUMMSGS_SDC +
-        STATEUPDATE_NUMMSGS_PDM +
-        STATEUPDATE_NUMMSGS_BATTERY;
-
 #define TEST_BUF_LEN 65535
 static uint8_t dataBuf[TEST_BUF_LEN] = { 0 };
 
@@ -116,40 +110,49 @@ static size_t flushSerialData(uint8_t* buffer, const size_t bufferSize)
 
 static size_t expectDebugLogMsg(const char* msg, const uint8_t* buf, const size_t bufLen)
 {
+    static MsgFrameDecode_T mfDecode;
+    MsgFrameDecode_Init(&mfDecode);
+
     size_t msgOffset = 0;
     size_t bufOffset = 0;
     size_t msgLenRemaining = strnlen(msg, DEBUGTERM_MAX_MSG_LEN);
-    while (msgLenRemaining > 0) {
-        TEST_ASSERT_GREATER_OR_EQUAL(bufOffset + PCINTERFACE_MSG_PACKET_BYTES, bufLen);
-
-        // Obtain packet
-        TEST_ASSERT_EQUAL(':', buf[bufOffset+0]);
-        TEST_ASSERT_EQUAL(PCINTERFACE_MSG_DEBUG_TERMINAL, buf[bufOffset+4]);
-
-        uint16_t payloadLen = 0;
-        payloadLen |= (uint16_t)buf[bufOffset+5];
-        payloadLen |= (uint16_t)(buf[bufOffset+6] << 8);
-        
-        TEST_ASSERT_EQUAL('\r', buf[bufOffset+7+payloadLen+4]);
-        TEST_ASSERT_EQUAL('\n', buf[bufOffset+7+payloadLen+5]);
-
-        // This should be a debug log message
-        TEST_ASSERT_GREATER_OR_EQUAL_MESSAGE(payloadLen, msgLenRemaining, "Received less characters than expected");
-        TEST_ASSERT_GREATER_OR_EQUAL(payloadLen, bufLen);
-        TEST_ASSERT_EQUAL_STRING_LEN(msg + msgOffset, buf + bufOffset + 7, payloadLen);
-
-        uint16_t packetLen = payloadLen + 13; // 11 header bytes + 2 payload len bytes
-        bufOffset += packetLen;
-        msgOffset += payloadLen;
-        msgLenRemaining -= payloadLen;
+    MsgFrameDecode_Msg_T frame;
+    while (msgLenRemaining > 0 && bufOffset < bufLen) {
+        // Feed the decoder as much as it can take
+        uint16_t chunkLen = 0U;
+        uint8_t* space = MsgFrameDecode_GetWriteSpace(&mfDecode, &chunkLen);
+        if (bufLen - bufOffset < chunkLen) {
+            chunkLen = (uint16_t)(bufLen - bufOffset);
+        }
+        memcpy(space, buf + bufOffset, chunkLen);
+        MsgFrameDecode_CommitBytes(&mfDecode, chunkLen);
+        bufOffset += chunkLen;
+
+        while (msgLenRemaining > 0 && MsgFrameDecode_RecvMsg(&mfDecode, &frame)) {
+            TEST_ASSERT_EQUAL(PCINTERFACE_MSG_DEBUG_TERMINAL, frame.function);
+
+            uint16_t payloadLen = 0;
+            payloadLen |= (uint16_t)frame.data[0];
+            payloadLen |= (uint16_t)(frame.data[1] << 8);
+            TEST_ASSERT_EQUAL(payloadLen + 2U, frame.dataLen);
+
+            // This should be a debug log message
+            TEST_ASSERT_GREATER_OR_EQUAL_MESSAGE(payloadLen, msgLenRemaining, "Received less characters than expected");
+            TEST_ASSERT_EQUAL_STRING_LEN(msg + msgOffset, frame.data + 2, payloadLen);
+
+            msgOffset += payloadLen;
+            msgLenRemaining -= payloadLen;
+        }
     }
 
+    TEST_ASSERT_EQUAL(0U, msgLenRemaining);
+    TEST_ASSERT_EQUAL(0U, mfDecode.badFrames);
     return bufOffset;
 }
 
 /**
- * @brief Constructs debug serial messages and sets the payload to the given
- * command.
+ * @brief Constructs a debug serial message with the given command as the
+ * payload.
  * Works through UART implementation to load the command into the UART driver.
  * 
  * @param cmd Command string, including "\\n".
@@ -157,29 +160,20 @@ static size_t expectDebugLogMsg(const char* msg, const uint8_t* buf, const size_
  */
 static void sendCmdStrToSerial(char* cmd, int cmdLen)
 {
-    // Set the CRC that the "hardware" calculates
-    mockSet_CRC(0x12345678);
-
-    // Construct packet with empy payload
-    uint8_t testMsg[] = {
-        ':',       // Start
-        0x00, 0x01, // Receiver addr: VCU
-        0x00, 0x09, // Function: Debug term
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Payload (will populate this further down)
-        0x12, 0x34, 0x56, 0x78, // CRC
-        '\r', '\n'
-    };
-    uint16_t testMsgLen = sizeof(testMsg)*sizeof(uint8_t);
-    _Static_assert(sizeof(testMsg) == PCINTERFACE_MSG_COMMON_MSGLEN, "message length");
-
-    for (int i = 0; i < cmdLen; i += 8) {
-        // copy the cmd to a set of uart messages
-        memcpy(testMsg + 5, cmd + i, 8);
-
-        // UART recieve on DMA:
-        memcpy(interfaces[UART_DEV1].uartDmaRx, testMsg, testMsgLen); // copy into DMA buffer
-        HAL_UARTEx_RxEventCallback(&husartA, testMsgLen);
-    }
+    static uint8_t buffer[MSGFRAME_ENCODE_BUFFER_LEN(64U)];
+    static MsgFrameEncode_T mfEncode;
+
+    assert(cmdLen > 0 && cmdLen <= 64);
+    mfEncode.bufferLen = sizeof(buffer);
+    mfEncode.dataLen = (uint16_t)cmdLen;
+    mfEncode.address = PCINTERFACE_MSG_DESTADDR_VCU;
+    mfEncode.function = PCINTERFACE_MSG_DEBUG_TERMINAL;
+    mfEncode.buffer = buffer;
+    memcpy(MsgFrameEncode_InitFrame(&mfEncode), cmd, (size_t)cmdLen);
+    MsgFrameEncode_Finish(&mfEncode);
+
+    // UART recieve on DMA:
+    mockRecv_HAL_UARTEx_DMA(&husartA, buffer, mfEncode.msgLen, true);
 }
 
 TEST_GROUP(DEVICE_PCINTERFACE_DEBUGTERM);
@@ -191,15 +185,13 @@ TEST_SETUP(DEVICE_PCINTERFACE_DEBUGTERM)
     // Init logging
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_Init(&testLog));
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_EnableSWO(&testLog));
+    // Init messages are debug
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK,
+        Log_SetLevel(&testLog, LOGGING_MODULE_PCINTERFACE, LOGGING_LEVEL_DEBUG));
 
     mockSet_TaskTimer_Init_Status(TASKTIMER_STATUS_OK);
     mockSet_TaskTimer_RegisterTask_Status(TASKTIMER_STATUS_OK);
 
-    // Init CRC
-    hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
-    mCrc.hcrc = &hcrc;
-    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_Init(&testLog, &mCrc));
-
     // Init UART
     HAL_NVIC_EnableIRQ(configUartA.txIrq);
     HAL_NVIC_EnableIRQ(configUartB.txIrq);
@@ -230,7 +222,6 @@ TEST_SETUP(DEVICE_PCINTERFACE_DEBUGTERM)
     memset(&mPCInterface, 0U, sizeof(PCInterface_T));
     mPCInterface.uartA = UART_DEV1;
     mPCInterface.uartB = UART_DEV3;
-    mPCInterface.crc = &mCrc;
     mPCInterface.pinToggle = &mPinToggle;
 
     PCInterface_Status_T status = PCInterface_Init(&testLog, &mPCInterface);
@@ -250,7 +241,6 @@ TEST_SETUP(DEVICE_PCINTERFACE_DEBUGTERM)
 
     // clear again for coming tests (because init prints)
     mockClearStreamBufferData(mPCInterface.logStreamHandle);
-    mockClearStreamBufferData(interfaces[UART_DEV1].txPendingStreamHandle);
     mockClear_HAL_UART_Data();
     mockClearPrintf();
     mockReset_VehicleControl();
@@ -264,11 +254,6 @@ TEST_TEAR_DOWN(DEVICE_PCINTERFACE_DEBUGTERM)
     TEST_ASSERT_TRUE(mockGet_HAL_Cortex_IRQEnabled(configUartA.txIrq));
     TEST_ASSERT_TRUE(mockGet_HAL_Cortex_IRQEnabled(configUartB.txIrq));
     mockClear_HAL_UART_Data();
-    for (int i = 0; i < UART_NUM_INTERFACES; ++i) {
-        if (interfaces[i].txPendingStreamHandle) {
-            mockClearStreamBufferData(interfaces[i].txPendingStreamHandle);
-        }
-    }
 }
 
 TEST(DEVICE_PCINTERFACE_DEBUGTERM, InitOk)
@@ -421,6 +406,84 @@ TEST(DEVICE_PCINTERFACE_DEBUGTERM, CmdSetSdc)
     TEST_ASSERT_FALSE(mockGet_VehicleControl_ECUError());
 }
 
+TEST(DEVICE_PCINTERFACE_DEBUGTERM, CmdLogLevel)
+{
+    char cmd[64];
+    int cmdLen;
+    size_t responseLen;
+
+    cmdLen = snprintf(cmd, 64, "loglevel inverter debug\n");
+    sendCmdStrToSerial(cmd, cmdLen);
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    TEST_ASSERT_EQUAL(LOGGING_LEVEL_DEBUG, Log_GetLevel(&testLog, LOGGING_MODULE_INVERTER));
+    TEST_ASSERT_EQUAL(LOGGING_LEVEL_INFO, Log_GetLevel(&testLog, LOGGING_MODULE_BMS));
+
+    responseLen = flushSerialData(dataBuf, TEST_BUF_LEN);
+    expectDebugLogMsg("  general      info\n", dataBuf, responseLen);
+
+    cmdLen = snprintf(cmd, 64, "loglevel all off\n");
+    sendCmdStrToSerial(cmd, cmdLen);
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    for (uint8_t i = 0U; i < LOGGING_NUM_MODULES; ++i) {
+        TEST_ASSERT_EQUAL(LOGGING_LEVEL_OFF, Log_GetLevel(&testLog, (Logging_Module_T)i));
+    }
+    flushSerialData(dataBuf, TEST_BUF_LEN);
+
+    // Nothing changes on errors
+    cmdLen = snprintf(cmd, 64, "loglevel inverter loud\n");
+    sendCmdStrToSerial(cmd, cmdLen);
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    responseLen = flushSerialData(dataBuf, TEST_BUF_LEN);
+    expectDebugLogMsg("Unknown level\n", dataBuf, responseLen);
+
+    cmdLen = snprintf(cmd, 64, "loglevel engine info\n");
+    sendCmdStrToSerial(cmd, cmdLen);
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    responseLen = flushSerialData(dataBuf, TEST_BUF_LEN);
+    expectDebugLogMsg("Unknown module\n", dataBuf, responseLen);
+    TEST_ASSERT_EQUAL(LOGGING_LEVEL_OFF, Log_GetLevel(&testLog, LOGGING_MODULE_INVERTER));
+}
+
+TEST(DEVICE_PCINTERFACE_DEBUGTERM, CmdTasks)
+{
+    char cmd[64];
+    int cmdLen;
+    size_t responseLen;
+
+    TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+    const TaskTimer_Stats_T stats[] = {
+        { &handle, TASKTIMER_FREQUENCY_100HZ, 2U, 1234U, 12U, 40U, 310U },
+        { &handle, TASKTIMER_FREQUENCY_1HZ, 3U, 5U, 9U, 15U, 80U },
+    };
+    mockSet_TaskTimer_Stats(stats, 2U);
+
+    cmdLen = snprintf(cmd, 64, "tasks\n");
+    sendCmdStrToSerial(cmd, cmdLen);
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    responseLen = flushSerialData(dataBuf, TEST_BUF_LEN);
+    expectDebugLogMsg(
+        "  task  freq  phase     jobs  lat min  lat max   jitter     wcrt\n"
+        "     1 100Hz      2     1234       12       40       28      310\n"
+        "     1   1Hz      3        5        9       15        6       80\n",
+        dataBuf, responseLen);
+    TEST_ASSERT_FALSE(mockGet_TaskTimer_StatsReset());
+
+    cmdLen = snprintf(cmd, 64, "tasks reset\n");
+    sendCmdStrToSerial(cmd, cmdLen);
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    responseLen = flushSerialData(dataBuf, TEST_BUF_LEN);
+    expectDebugLogMsg("Task timing reset\n", dataBuf, responseLen);
+    TEST_ASSERT_TRUE(mockGet_TaskTimer_StatsReset());
+
+    mockSet_TaskTimer_Stats(NULL, 0U);
+}
+
 TEST_GROUP_RUNNER(DEVICE_PCINTERFACE_DEBUGTERM)
 {
     RUN_TEST_CASE(DEVICE_PCINTERFACE_DEBUGTERM, InitOk);
@@ -428,6 +491,8 @@ TEST_GROUP_RUNNER(DEVICE_PCINTERFACE_DEBUGTERM)
     RUN_TEST_CASE(DEVICE_PCINTERFACE_DEBUGTERM, CmdHelp);
     RUN_TEST_CASE(DEVICE_PCINTERFACE_DEBUGTERM, CmdSetPdm);
     RUN_TEST_CASE(DEVICE_PCINTERFACE_DEBUGTERM, CmdSetSdc);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE_DEBUGTERM, CmdLogLevel);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE_DEBUGTERM, CmdTasks);
 }
 
 #define INVOKE_TEST DEVICE_PCINTERFACE_DEBUGTERM
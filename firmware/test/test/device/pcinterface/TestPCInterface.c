@@ -38,6 +38,9 @@
 #include "device/pcinterface/pcinterface.c"
 #include "device/pcinterface/periodicupdates.c"
 #include "device/pcinterface/requests.c"
+#include "device/pcinterface/baudrate.c"
+#include "device/pcinterface/subscriptions.c"
+#include "device/pcinterface/stream.c"
 #include "device/pcinterface/debugterm.c"
 #include "device/pcinterface/debugtermcommands.c"
 #include "logging/logging.c"  // also need this to use mock impls
@@ -48,8 +51,6 @@ static Logging_T testLog;
 static GPIO_TypeDef gpioBankA;
 static GPIO_T mPinToggle = { .GPIOx = &gpioBankA, .GPIO_Pin = 1U };
 
-static CRC_HandleTypeDef hcrc;
-static CRC_T mCrc;
 static UART_HandleTypeDef husartA = {
     .Instance = USART1,
 };
@@ -60,11 +61,13 @@ static UART_DeviceConfig_T configUartA = {
   .dev = UART_DEV1,
   .handle = &husartA,
   .txIrq = DMA2_Stream1_IRQn,
+  .uartIrq = USART1_IRQn,
 };
 static UART_DeviceConfig_T configUartB = {
   .dev = UART_DEV3,
   .handle = &husartB,
   .txIrq = DMA2_Stream2_IRQn,
+  .uartIrq = USART3_IRQn,
 };
 
 static VehicleState_T mVehicleState;
@@ -74,14 +77,83 @@ static VehicleControl_T mVehicleControl;
 
 static PCInterface_T mPCInterface;
 
-// Number of state update messages are sent in succession
-const uint32_t STATEUPDATE_NUMMSGS_SDC = 1;
-const uint32_t STATEUPDATE_NUMMSGS_PDM = 1;
-const uint32_t STATEUPDATE_NUMMSGS_BATTERY = 9;
-const uint32_t STATEUPDATE_NUMMSGS =
-        STATEUPDATE_NUMMSGS_SDC +
-        STATEUPDATE_NUMMSGS_PDM +
-        STATEUPDATE_NUMMSGS_BATTERY;
+// State fields are sent together in one batch: SDC, PDM, 5 float and 4 byte
+// sized battery fields, each with a 3 byte header
+#define STATEBATCH_DATALEN (11U*3U + 2U*1U + 5U*4U + 4U*1U)
+#define STATEBATCH_FRAMELEN MSGFRAME_MAX_ENCODED_LEN(STATEBATCH_DATALEN)
+
+// A frame decoded from the UART output
+typedef struct {
+    uint8_t seq;
+    uint16_t address;
+    uint16_t function;
+    uint16_t dataLen;
+    uint8_t data[MSGFRAME_MAX_DATA_LEN];
+} TxFrame_T;
+
+static MsgFrameDecode_T mTxDecode;
+static MsgFrameEncode_T mRxEncode;
+static uint8_t mRxEncodeBuffer[MSGFRAME_ENCODE_BUFFER_LEN(PCINTERFACE_MSG_COMMON_DATALEN)];
+
+/**
+ * @brief Decodes transmitted bytes, which must be whole valid frames
+ *
+ * @returns Number of frames decoded into frames
+ */
+static uint16_t decodeTx(
+    const uint8_t* bytes,
+    size_t len,
+    TxFrame_T* frames,
+    uint16_t maxFrames)
+{
+    MsgFrameDecode_Init(&mTxDecode);
+    TEST_ASSERT_TRUE(MsgFrameDecode_RecvBytes(&mTxDecode, (uint8_t*)bytes, (uint16_t)len));
+
+    uint16_t numFrames = 0U;
+    MsgFrameDecode_Msg_T msg;
+    while (MsgFrameDecode_RecvMsg(&mTxDecode, &msg)) {
+        TEST_ASSERT_TRUE(numFrames < maxFrames);
+        TEST_ASSERT_TRUE(msg.dataLen <= sizeof(frames[numFrames].data));
+        frames[numFrames].seq = msg.seq;
+        frames[numFrames].address = msg.address;
+        frames[numFrames].function = msg.function;
+        frames[numFrames].dataLen = msg.dataLen;
+        memcpy(frames[numFrames].data, msg.data, msg.dataLen);
+        numFrames++;
+    }
+
+    TEST_ASSERT_EQUAL(0U, mTxDecode.badFrames);
+    TEST_ASSERT_EQUAL(0U, mTxDecode.blockCode); // nothing left over
+    return numFrames;
+}
+
+/**
+ * @brief Frames a message from the PC to the VCU
+ *
+ * @returns Length of the frame in mRxEncodeBuffer
+ */
+static uint16_t encodeRx(uint16_t function, const uint8_t* data, uint16_t dataLen)
+{
+    mRxEncode.bufferLen = sizeof(mRxEncodeBuffer);
+    mRxEncode.dataLen = dataLen;
+    mRxEncode.address = PCINTERFACE_MSG_DESTADDR_VCU;
+    mRxEncode.function = function;
+    mRxEncode.buffer = mRxEncodeBuffer;
+    memcpy(MsgFrameEncode_InitFrame(&mRxEncode), data, dataLen);
+    MsgFrameEncode_Finish(&mRxEncode);
+    return mRxEncode.msgLen;
+}
+
+// Frames a message from the PC and receives it on a port
+static void recvFrame(
+    UART_HandleTypeDef* husart,
+    uint16_t function,
+    const uint8_t* data,
+    uint16_t dataLen)
+{
+    const uint16_t len = encodeRx(function, data, dataLen);
+    mockRecv_HAL_UARTEx_DMA(husart, mRxEncodeBuffer, len, true);
+}
 
 /**
  * @brief The state message is often the first to send - at 1Hz, but it is sent
@@ -96,23 +168,131 @@ static size_t expectStateMsg(void)
     // The first message will be queued but once we trigger the UART to
     // tx more, in this test it will put *all* remaining queued bytes onto
     // the UART line.
-    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEUPDATE_MSGLEN, mockGet_HAL_UART_Len());
-    // Flush the first message to expose the second
+    TxFrame_T frame;
+    TEST_ASSERT_EQUAL(STATEBATCH_FRAMELEN, mockGet_HAL_UART_Len());
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEBATCH_FUNCTION, frame.function);
+    // Flush the state batch to expose what follows
+    mockClear_HAL_UART_Data();
+    HAL_UART_TxCpltCallback(&husartA);
+
+    // The whole state is in the one frame
+    return 0U;
+}
+
+// Runs the baud rate parts of a task tick, in the same order as the task.
+// (Periodic updates go to both ports and would hide port A's output.)
+static void runTick(void)
+{
+    PCInterface_HandleBaudSwitch(&mPCInterface);
+    PCInterface_HandleRequests(&mPCInterface);
+}
+
+// Completes every transmit queued on port A
+static void drainTxA(void)
+{
+    while (mockGet_HAL_UART_Len() > 0U) {
+        mockClear_HAL_UART_Data();
+        HAL_UART_TxCpltCallback(&husartA);
+    }
+}
+
+// Subscribe request (0x105) for a field at a rate
+static void recvSubscribeMsg(uint16_t fieldId, uint8_t rate)
+{
+    const uint8_t payload[PCINTERFACE_MSG_COMMON_DATALEN] = {
+        (uint8_t)(fieldId >> 8), (uint8_t)(fieldId & 0xFF), rate,
+    };
+    recvFrame(&husartA, PCINTERFACE_MSG_SUBSCRIBE_FUNCTION, payload, sizeof(payload));
+}
+
+// Checks the subscribe response is on port A, then sends the next message
+static void expectSubscribeResponse(uint16_t fieldId, uint8_t rate, uint8_t status)
+{
+    const uint8_t expected[] = {
+        (uint8_t)(fieldId >> 8), (uint8_t)(fieldId & 0xFF), rate, status,
+    };
+    TxFrame_T frame;
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_SUBSCRIBE_RESPONSE_FUNCTION, frame.function);
+    TEST_ASSERT_EQUAL(sizeof(expected), frame.dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, frame.data, sizeof(expected));
     mockClear_HAL_UART_Data();
     HAL_UART_TxCpltCallback(&husartA);
+}
 
-    size_t remainingBytes = 0;
-    if (STATEUPDATE_NUMMSGS > 1) {
-        uint16_t remainingMsgs = (uint16_t)STATEUPDATE_NUMMSGS - 1;
-        remainingBytes = remainingMsgs * PCINTERFACE_MSG_STATEUPDATE_MSGLEN;
+// Channel stream of 4 byte samples, 2 per block
+#define STREAM_SAMPLE_LEN 4U
+#define STREAM_SAMPLES_PER_BLOCK 2U
+#define STREAM_NUM_BLOCKS 2U
+#define STREAM_BLOCK_LEN BLOCKBUFFER_BLOCK_LEN(STREAM_SAMPLE_LEN, STREAM_SAMPLES_PER_BLOCK)
+static uint8_t mStreamStorage[BLOCKBUFFER_STORAGE_LEN(
+    STREAM_SAMPLE_LEN, STREAM_SAMPLES_PER_BLOCK, STREAM_NUM_BLOCKS)];
+static BlockBuffer_T mStream;
+
+// Stream request (0x106) on a port
+static void recvStreamMsg(UART_HandleTypeDef* husart, uint8_t enable)
+{
+    const uint8_t payload[PCINTERFACE_MSG_COMMON_DATALEN] = { enable };
+    recvFrame(husart, PCINTERFACE_MSG_STREAM_FUNCTION, payload, sizeof(payload));
+}
 
-        TEST_ASSERT_GREATER_OR_EQUAL(remainingBytes, mockGet_HAL_UART_Len());
-        // Flush the first message to expose the second
-        // mockClear_HAL_UART_Data();
-        // HAL_UART_TxCpltCallback(&husartA);
+// Puts samples numbered from first, each sample is its number 4 times
+static void putStreamSamples(uint8_t first, uint8_t count, bool expectPut)
+{
+    for (uint8_t i = 0U; i < count; ++i) {
+        uint8_t sample[STREAM_SAMPLE_LEN];
+        memset(sample, first + i, sizeof(sample));
+        TEST_ASSERT_EQUAL(expectPut, BlockBuffer_Put(&mStream, sample));
     }
+}
+
+// Checks the transmitted frame is a stream block
+static void expectStreamBlock(uint32_t firstSample, uint8_t dropped, uint8_t first)
+{
+    uint8_t expected[STREAM_BLOCK_LEN] = {
+        0x00, 0x00, 0x00, (uint8_t)firstSample, // First sample
+        0x00, 0x00, 0x00, dropped, // Dropped
+    };
+    memset(&expected[BLOCKBUFFER_HEADER_LEN], first, STREAM_SAMPLE_LEN);
+    memset(&expected[BLOCKBUFFER_HEADER_LEN + STREAM_SAMPLE_LEN], first + 1U, STREAM_SAMPLE_LEN);
+
+    TxFrame_T frame;
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STREAMBLOCK_FUNCTION, frame.function);
+    TEST_ASSERT_EQUAL(sizeof(expected), frame.dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, frame.data, sizeof(expected));
+}
+
+// Baud rate request (0x103) or confirm (0x104) for the given rate
+static void recvBaudMsg(uint8_t function, uint32_t baudRate)
+{
+    const uint8_t payload[PCINTERFACE_MSG_COMMON_DATALEN] = {
+        (uint8_t)(baudRate >> 24), (uint8_t)(baudRate >> 16),
+        (uint8_t)(baudRate >> 8), (uint8_t)baudRate, // Rate
+        0x00, 0x00, 0x00, 0x00, // Empty payload bytes
+    };
+    recvFrame(&husartA, (uint16_t)(0x100U | function), payload, sizeof(payload));
+}
 
-    return remainingBytes;
+// Checks the first transmitted message is a baud response
+static void expectBaudResponse(uint32_t baudRate, uint8_t status)
+{
+    const uint8_t expected[] = {
+        (uint8_t)(baudRate >> 24), (uint8_t)(baudRate >> 16),
+        (uint8_t)(baudRate >> 8), (uint8_t)baudRate, // Rate
+        status,
+    };
+    _Static_assert(sizeof(expected) == PCINTERFACE_MSG_BAUD_RESPONSE_DATALEN, "message length");
+    const size_t frameLen = MSGFRAME_MAX_ENCODED_LEN(PCINTERFACE_MSG_BAUD_RESPONSE_DATALEN);
+
+    TxFrame_T frame;
+    TEST_ASSERT_GREATER_OR_EQUAL(frameLen, mockGet_HAL_UART_Len());
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), frameLen, &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_DESTADDR_PC, frame.address);
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_BAUD_RESPONSE_FUNCTION, frame.function);
+    TEST_ASSERT_EQUAL(sizeof(expected), frame.dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, frame.data, sizeof(expected));
 }
 
 TEST_GROUP(DEVICE_PCINTERFACE);
@@ -124,18 +304,21 @@ TEST_SETUP(DEVICE_PCINTERFACE)
     // Init logging
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_Init(&testLog));
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_EnableSWO(&testLog));
+    // Init messages are debug
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK,
+        Log_SetLevel(&testLog, LOGGING_MODULE_PCINTERFACE, LOGGING_LEVEL_DEBUG));
 
     mockSet_TaskTimer_Init_Status(TASKTIMER_STATUS_OK);
     mockSet_TaskTimer_RegisterTask_Status(TASKTIMER_STATUS_OK);
 
-    // Init CRC
-    hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
-    mCrc.hcrc = &hcrc;
-    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_Init(&testLog, &mCrc));
-
     // Init UART
     HAL_NVIC_EnableIRQ(configUartA.txIrq);
     HAL_NVIC_EnableIRQ(configUartB.txIrq);
+    // Peripherals are initialised by main
+    husartA.Init.BaudRate = 115200U;
+    husartB.Init.BaudRate = 115200U;
+    TEST_ASSERT_EQUAL(HAL_OK, HAL_UART_Init(&husartA));
+    TEST_ASSERT_EQUAL(HAL_OK, HAL_UART_Init(&husartB));
     TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Init(&testLog));
     TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Config(&configUartA));
     TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_Config(&configUartB));
@@ -163,8 +346,8 @@ TEST_SETUP(DEVICE_PCINTERFACE)
     memset(&mPCInterface, 0U, sizeof(PCInterface_T));
     mPCInterface.uartA = UART_DEV1;
     mPCInterface.uartB = UART_DEV3;
-    mPCInterface.crc = &mCrc;
     mPCInterface.pinToggle = &mPinToggle;
+    mPCInterface.maxBaudRate = 1000000U;
 
     PCInterface_Status_T status = PCInterface_Init(&testLog, &mPCInterface);
     TEST_ASSERT_EQUAL(PCINTERFACE_STATUS_OK, status);
@@ -183,7 +366,6 @@ TEST_SETUP(DEVICE_PCINTERFACE)
 
     // clear again for coming tests (because init prints)
     mockClearStreamBufferData(mPCInterface.logStreamHandle);
-    mockClearStreamBufferData(interfaces[UART_DEV1].txPendingStreamHandle);
     mockClear_HAL_UART_Data();
     mockClearPrintf();
     mockReset_VehicleControl();
@@ -226,69 +408,46 @@ TEST(DEVICE_PCINTERFACE, TestNoMessages)
         PCInterface_TaskMethod(&mPCInterface);
     }
 
-    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEUPDATE_MSGLEN, mockGet_HAL_UART_Len());
+    TEST_ASSERT_EQUAL(STATEBATCH_FRAMELEN, mockGet_HAL_UART_Len());
 }
 
 TEST(DEVICE_PCINTERFACE, TestLogSerialShortMsg)
 {
-    const char simpleMsg[] = "Hello!\n"; // less than 32 data chars
-    assert(sizeof(simpleMsg) <= 32U);
-
-    mockSet_CRC(0xAABBCCDD);
-    const uint8_t expectedUart[PCINTERFACE_MSG_LOG_MSGLEN] = {
-        ':',  // Start byte
-        0x00, 0x02,     // Receiver address: Debug PC
-        0x00, 0x02,     // Message ID: log message
-        'H', 'e', 'l', 'l', 'o', '!', '\n',
-        0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, // Zero padding for unused bytes
-        0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,
-        0U, 0U, 0U, 0U, 0U,
-        0xAA, 0xBB, 0xCC, 0xDD, // CRC bytes (mock bytes here)
-        '\r', '\n'      // End of message frame
-    };
+    const char simpleMsg[] = "Hello!\n";
+    const uint16_t msgLen = (uint16_t)(sizeof(simpleMsg) - 1U);
 
-    Log_Print(&testLog, simpleMsg);
+    Log_Print(&testLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, simpleMsg);
 
     // serial should be flushed
     mockSetTaskNotifyValue(1); // to wake up
     PCInterface_TaskMethod(&mPCInterface);
 
-    // Expecting: A state update message, and a log message
+    // Expecting: A state update message, and a log message only as long as
+    // the text
     size_t stateBytes = expectStateMsg();
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedUart, mPCInterface.mfLogDataBuffer, PCINTERFACE_MSG_LOG_MSGLEN);
-    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_LOG_MSGLEN, mockGet_HAL_UART_Len() - stateBytes);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedUart, mockGet_HAL_UART_Data() + stateBytes, PCINTERFACE_MSG_LOG_MSGLEN);
+    TEST_ASSERT_EQUAL(MSGFRAME_MAX_ENCODED_LEN(msgLen), mockGet_HAL_UART_Len() - stateBytes);
+
+    TxFrame_T frame;
+    TEST_ASSERT_EQUAL(1U, decodeTx(
+        mockGet_HAL_UART_Data() + stateBytes,
+        mockGet_HAL_UART_Len() - stateBytes,
+        &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_DESTADDR_PC, frame.address);
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_LOG_FUNCTION, frame.function);
+    TEST_ASSERT_EQUAL(msgLen, frame.dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(simpleMsg, frame.data, msgLen);
 }
 
 TEST(DEVICE_PCINTERFACE, TestLogSerialLongMsg)
 {
-    // A log message that needs to be split into two message (i.e. longer than 32)
-    const char longMsg[] = "Never gonna give you up\n"
-                           "Never gonna let you down\n";
-    assert(sizeof(longMsg) > 32U);
-
-    mockSet_CRC(0xAABBCCDD);
-    uint8_t expectedUart1[PCINTERFACE_MSG_LOG_MSGLEN] = { 0 };
-    uint8_t expectedUart2[PCINTERFACE_MSG_LOG_MSGLEN] = { 0 };
-
-    expectedUart1[0] = ':';
-    expectedUart1[2] = 0x02; // Receiver address: Debug PC
-    expectedUart1[4] = 0x02; // Message ID: log message
-    memcpy(expectedUart1 + 5, longMsg, 32);
-    expectedUart1[37] = 0xAA; // CRC
-    expectedUart1[38] = 0xBB;
-    expectedUart1[39] = 0xCC;
-    expectedUart1[40] = 0xDD;
-    expectedUart1[41] = '\r'; // End of message frame
-    expectedUart1[42] = '\n';
-
-    // construst msg2 expect from buffer
-    memcpy(expectedUart2, expectedUart1, PCINTERFACE_MSG_LOG_MSGLEN);
-    memset(expectedUart2 + 5, 0U, PCINTERFACE_MSG_LOG_DATALEN); // clear data
-    size_t remainingBytes = sizeof(longMsg) - 32;
-    memcpy(expectedUart2 + 5, longMsg + 32, remainingBytes);
-
-    Log_Print(&testLog, longMsg);
+    // A log message that needs to be split into two messages
+    const char longMsg[] = "Never gonna give you up, never gonna let you down\n"
+                           "Never gonna run around and desert you\n"
+                           "Never gonna make you cry, never gonna say goodbye\n";
+    const uint16_t msgLen = (uint16_t)(sizeof(longMsg) - 1U);
+    assert(msgLen > PCINTERFACE_MSG_LOG_DATALEN);
+
+    Log_Print(&testLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, longMsg);
 
     // Stepping through to 100ms should trigger transmission
     for (uint16_t i = 0; i < 10; ++i) {
@@ -301,125 +460,341 @@ TEST(DEVICE_PCINTERFACE, TestLogSerialLongMsg)
     size_t stateBytes = expectStateMsg();
     // The state message is immediately sent, but the log messages are queued
     // and transmitted together after that.
-    TEST_ASSERT_EQUAL(2*PCINTERFACE_MSG_LOG_MSGLEN, mockGet_HAL_UART_Len() - stateBytes);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedUart1,
-            mockGet_HAL_UART_Data() + stateBytes,
-            PCINTERFACE_MSG_LOG_MSGLEN);
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedUart2,
-            mockGet_HAL_UART_Data() + stateBytes + PCINTERFACE_MSG_LOG_MSGLEN,
-            PCINTERFACE_MSG_LOG_MSGLEN);
+    TxFrame_T frames[2];
+    TEST_ASSERT_EQUAL(2U, decodeTx(
+        mockGet_HAL_UART_Data() + stateBytes,
+        mockGet_HAL_UART_Len() - stateBytes,
+        frames, 2U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_LOG_FUNCTION, frames[0].function);
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_LOG_DATALEN, frames[0].dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(longMsg, frames[0].data, PCINTERFACE_MSG_LOG_DATALEN);
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_LOG_FUNCTION, frames[1].function);
+    TEST_ASSERT_EQUAL(msgLen - PCINTERFACE_MSG_LOG_DATALEN, frames[1].dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(longMsg + PCINTERFACE_MSG_LOG_DATALEN,
+            frames[1].data,
+            msgLen - PCINTERFACE_MSG_LOG_DATALEN);
+    TEST_ASSERT_EQUAL((uint8_t)(frames[0].seq + 1U), frames[1].seq);
 
     // Prompt UART to send next message...
     mockClear_HAL_UART_Data();
     HAL_UART_TxCpltCallback(&husartA);
-    mockClearStreamBufferData(interfaces[UART_DEV1].txPendingStreamHandle);
 
     // 2nd message should be on UART now, with no further queued messages
     TEST_ASSERT_EQUAL(0, mockGet_HAL_UART_Len());
 }
 
-TEST(DEVICE_PCINTERFACE, PeriodicStateUpdates)
+TEST(DEVICE_PCINTERFACE, TestLogRecords)
 {
-    // Just what the CRC hardware produces, doesn't really matter what the
-    // test sets it to here.
-    mockSet_CRC(0x12345678);
+    mockSetCurrentTaskNumber(3U);
+    mockDWT.CYCCNT += 250U * (SystemCoreClock / 1000000U); // 250us after init
+    Log_Printf(&testLog, "Record %u\n", 0x1234U);
+    Log_Printf(&testLog, "Record\n");
+
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+
+    // Expecting: A state update message, and both records in one message
+    size_t stateBytes = expectStateMsg();
+    TxFrame_T frame;
+    TEST_ASSERT_EQUAL(1U, decodeTx(
+        mockGet_HAL_UART_Data() + stateBytes,
+        mockGet_HAL_UART_Len() - stateBytes,
+        &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_DESTADDR_PC, frame.address);
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_LOGRECORDS_FUNCTION, frame.function);
+    TEST_ASSERT_EQUAL(2U * LOGGING_RECORD_HEADER_LEN + 4U, frame.dataLen);
+
+    // Args, source, time
+    const uint8_t expectedArgs[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0xFA, 0x00, 0x00, 0x12, 0x34 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedArgs, &frame.data[2], sizeof(expectedArgs));
+    TEST_ASSERT_EQUAL_STRING("Record %u\n", &__start_logfmt[(frame.data[0] << 8) | frame.data[1]]);
+    TEST_ASSERT_EQUAL(0U, frame.data[14]);
+    TEST_ASSERT_EQUAL_STRING("Record\n", &__start_logfmt[(frame.data[12] << 8) | frame.data[13]]);
+}
 
+TEST(DEVICE_PCINTERFACE, PeriodicStateUpdates)
+{
     // Set some SDC state to tx
     mVehicleState.data.vehicle.sdc.bspd = true;
     mVehicleState.data.vehicle.sdc.out = true;
     mVehicleState.data.glv.pdmChState[0] = true;
     mVehicleState.data.glv.pdmChState[4] = true;
     mVehicleState.data.glv.pdmChState[5] = true;
-
-    const uint8_t expectedMsgSDC[] = {
-        ':',       // Start
-        0x00, 0x02, // Receiver addr
-        0x00, 0x01, // Function
-        0x00, 0x01, // Payload: field ID: SDC
-        0x01,       // Payload: field size
-        0x00, 0x00, 0x00, 0x0A, // Payload: SDC bits
-        0x12, 0x34, 0x56, 0x78, // CRC
-        '\r', '\n'
+    mVehicleState.data.battery.dcVoltage = 400.0f;
+    mVehicleState.data.battery.bmsCounter = 0x42U;
+
+    // Each field is ID, size, then size bytes of value
+    const uint8_t expectedMsg[] = {
+        0x00, 0x01, 0x01, 0x0A, // SDC bits
+        0x00, 0x02, 0x01, 0x31, // PDM bits
+        0x00, 0x03, 0x04, 0x00, 0x00, 0x00, 0x00, // Max cell voltage
+        0x00, 0x04, 0x01, 0x00, // Max cell voltage ID
+        0x00, 0x05, 0x04, 0x00, 0x00, 0x00, 0x00, // Max cell temp
+        0x00, 0x06, 0x01, 0x00, // Max cell temp ID
+        0x00, 0x07, 0x04, 0x00, 0x00, 0x00, 0x00, // DC current
+        0x00, 0x08, 0x04, 0x43, 0xC8, 0x00, 0x00, // DC voltage, 400.0f
+        0x00, 0x09, 0x04, 0x00, 0x00, 0x00, 0x00, // SOC
+        0x00, 0x0A, 0x01, 0x42, // BMS counter
+        0x00, 0x0B, 0x01, 0x00, // BMS fault
     };
-    _Static_assert(sizeof(expectedMsgSDC) == PCINTERFACE_MSG_STATEUPDATE_MSGLEN, "State update msg length");
-
-    const uint8_t expectedMsgPDM[] = {
-        ':',       // Start
-        0x00, 0x02, // Receiver addr
-        0x00, 0x01, // Function
-        0x00, 0x02, // Payload: field ID: PDM
-        0x01,       // Payload: field size
-        0x00, 0x00, 0x00, 0x31, // Payload: PDM bits
-        0x12, 0x34, 0x56, 0x78, // CRC
-        '\r', '\n'
+    _Static_assert(sizeof(expectedMsg) == STATEBATCH_DATALEN, "State batch length");
+
+    // invoke PC controller's periodic task (state is sent on the first tick)
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+
+    // The whole state is one frame
+    TxFrame_T frames[2];
+    TEST_ASSERT_EQUAL(STATEBATCH_FRAMELEN, mockGet_HAL_UART_Len());
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), frames, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_DESTADDR_PC, frames[0].address);
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEBATCH_FUNCTION, frames[0].function);
+    TEST_ASSERT_EQUAL(0U, frames[0].seq);
+    TEST_ASSERT_EQUAL(sizeof(expectedMsg), frames[0].dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedMsg, frames[0].data, sizeof(expectedMsg));
+
+    // Nothing else queued for the state
+    mockClear_HAL_UART_Data();
+    HAL_UART_TxCpltCallback(&husartA);
+    TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
+
+    // Next state is sent 1s later, only the fields that changed
+    mVehicleState.data.battery.dcVoltage = 401.0f;
+    mVehicleState.data.battery.bmsCounter = 0x41U;
+    const uint8_t expectedDelta[] = {
+        0x08, 0x80, 0x80, 0x04, // DC voltage, +0x8000 zigzagged
+        0x0A, 0x01, // BMS counter, -1 zigzagged
     };
-    _Static_assert(sizeof(expectedMsgPDM) == PCINTERFACE_MSG_STATEUPDATE_MSGLEN, "State update msg length");
+    for (uint16_t i = 1U; i < 100U; ++i) {
+        mockSetTaskNotifyValue(1); // to wake up
+        PCInterface_TaskMethod(&mPCInterface);
+        while (mockGet_HAL_UART_Len() > 0U) {
+            mockClear_HAL_UART_Data();
+            HAL_UART_TxCpltCallback(&husartA);
+        }
+    }
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), frames, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEDELTA_FUNCTION, frames[0].function);
+    TEST_ASSERT_EQUAL(sizeof(expectedDelta), frames[0].dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedDelta, frames[0].data, sizeof(expectedDelta));
+    // The sequence number counts state batches and deltas, including link
+    // stats for each port in between, so the PC can tell one was missed
+    TEST_ASSERT_EQUAL(3U, frames[0].seq);
+}
 
-    // invoke PC controller's periodic task
-    for (int i = 0; i < 100; ++i) {
+TEST(DEVICE_PCINTERFACE, PeriodicStateKeyframes)
+{
+    // The whole state is sent every keyframe period, changed or not
+    for (uint16_t s = 0U; s <= PCINTERFACE_MSG_STATEDELTA_KEYFRAME_PERIOD; ++s) {
         mockSetTaskNotifyValue(1); // to wake up
         PCInterface_TaskMethod(&mPCInterface);
+        if (0U == s % PCINTERFACE_MSG_STATEDELTA_KEYFRAME_PERIOD) {
+            TxFrame_T frame;
+            TEST_ASSERT_EQUAL(STATEBATCH_FRAMELEN, mockGet_HAL_UART_Len());
+            TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), &frame, 1U));
+            TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEBATCH_FUNCTION, frame.function);
+            TEST_ASSERT_EQUAL(STATEBATCH_DATALEN, frame.dataLen);
+        } else {
+            // Nothing changed, nothing to send
+            TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
+        }
+
+        for (uint16_t i = 1U; i < 100U; ++i) {
+            while (mockGet_HAL_UART_Len() > 0U) {
+                mockClear_HAL_UART_Data();
+                HAL_UART_TxCpltCallback(&husartA);
+            }
+            mockSetTaskNotifyValue(1); // to wake up
+            PCInterface_TaskMethod(&mPCInterface);
+        }
+        while (mockGet_HAL_UART_Len() > 0U) {
+            mockClear_HAL_UART_Data();
+            HAL_UART_TxCpltCallback(&husartA);
+        }
     }
+}
+
+TEST(DEVICE_PCINTERFACE, SubscribeField)
+{
+    mVehicleState.data.motor.speed = 0x04D2;
 
-    // First message
-    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEUPDATE_MSGLEN, mockGet_HAL_UART_Len());
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedMsgSDC,
-        mockGet_HAL_UART_Data(),
-        PCINTERFACE_MSG_STATEUPDATE_MSGLEN);
+    // Default state on the first tick
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    drainTxA();
 
-    // Copy the pending bytes to the bus
-    mockClear_HAL_UART_Data();
-    HAL_UART_TxCpltCallback(&husartA);
+    // Motor speed at 100Hz is sent from the next tick, as its own batch
+    recvSubscribeMsg(PCCONTROLLER_FIELDID_MOTOR_SPEED, 100U);
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    expectSubscribeResponse(PCCONTROLLER_FIELDID_MOTOR_SPEED, 100U, PCINTERFACE_SUBSCRIBE_OK);
+
+    const uint8_t expectedKey[] = { 0x00, 0x21, 0x02, 0x04, 0xD2 };
+    TxFrame_T frame;
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEBATCH_FUNCTION, frame.function);
+    TEST_ASSERT_EQUAL(sizeof(expectedKey), frame.dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedKey, frame.data, sizeof(expectedKey));
+    drainTxA();
+
+    // Then every tick it changes
+    mVehicleState.data.motor.speed = 0x04D3;
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    const uint8_t expectedDelta[] = { 0x21, 0x02 };
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEDELTA_FUNCTION, frame.function);
+    TEST_ASSERT_EQUAL(sizeof(expectedDelta), frame.dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedDelta, frame.data, sizeof(expectedDelta));
+    drainTxA();
+
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
 
-    const size_t numMessages = STATEUPDATE_NUMMSGS - 1;
-    TEST_ASSERT_EQUAL(numMessages*PCINTERFACE_MSG_STATEUPDATE_MSGLEN, mockGet_HAL_UART_Len());
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedMsgPDM,
-        mockGet_HAL_UART_Data(),
-        PCINTERFACE_MSG_STATEUPDATE_MSGLEN);
+    // Unsubscribed, it isn't sent again
+    recvSubscribeMsg(PCCONTROLLER_FIELDID_MOTOR_SPEED, 0U);
+    mVehicleState.data.motor.speed = 0x04D4;
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    expectSubscribeResponse(PCCONTROLLER_FIELDID_MOTOR_SPEED, 0U, PCINTERFACE_SUBSCRIBE_OK);
+    TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
 }
 
-TEST(DEVICE_PCINTERFACE, TestCommandSDC)
+TEST(DEVICE_PCINTERFACE, SubscribeUnsubscribeDefault)
+{
+    // Default fields can be unsubscribed too
+    recvSubscribeMsg(PCCONTROLLER_FIELDID_SDC, 0U);
+    runTick();
+    expectSubscribeResponse(PCCONTROLLER_FIELDID_SDC, 0U, PCINTERFACE_SUBSCRIBE_OK);
+
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+    TxFrame_T frame;
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEBATCH_FUNCTION, frame.function);
+    TEST_ASSERT_EQUAL(STATEBATCH_DATALEN - 4U, frame.dataLen);
+    TEST_ASSERT_EQUAL_UINT8(PCCONTROLLER_FIELDID_PDM, frame.data[1]);
+}
+
+TEST(DEVICE_PCINTERFACE, SubscribeErrors)
+{
+    recvSubscribeMsg(0x7777U, 10U);
+    runTick();
+    expectSubscribeResponse(0x7777U, 10U, PCINTERFACE_SUBSCRIBE_UNKNOWNFIELD);
+
+    recvSubscribeMsg(PCCONTROLLER_FIELDID_MOTOR_SPEED, PCINTERFACE_SUBSCRIBE_MAX_RATE + 1U);
+    runTick();
+    expectSubscribeResponse(PCCONTROLLER_FIELDID_MOTOR_SPEED,
+        PCINTERFACE_SUBSCRIBE_MAX_RATE + 1U, PCINTERFACE_SUBSCRIBE_BADRATE);
+
+    // 1Hz is used by the defaults, 3 more rates fit
+    _Static_assert(4U == PCINTERFACE_SUBSCRIBE_MAX_GROUPS, "rates subscribed below");
+    const uint8_t rates[] = { 2U, 4U, 5U };
+    const uint16_t fieldIds[] = {
+        PCCONTROLLER_FIELDID_INPUT_ACCEL,
+        PCCONTROLLER_FIELDID_INPUT_BRAKEFRONT,
+        PCCONTROLLER_FIELDID_INPUT_BRAKEREAR,
+    };
+    for (size_t i = 0U; i < sizeof(rates); ++i) {
+        recvSubscribeMsg(fieldIds[i], rates[i]);
+        runTick();
+        expectSubscribeResponse(fieldIds[i], rates[i], PCINTERFACE_SUBSCRIBE_OK);
+    }
+    recvSubscribeMsg(PCCONTROLLER_FIELDID_WHEELSPEED_FRONT, 10U);
+    runTick();
+    expectSubscribeResponse(PCCONTROLLER_FIELDID_WHEELSPEED_FRONT, 10U, PCINTERFACE_SUBSCRIBE_FULL);
+
+    // Another field at a rate already used still fits
+    recvSubscribeMsg(PCCONTROLLER_FIELDID_WHEELSPEED_FRONT, 5U);
+    runTick();
+    expectSubscribeResponse(PCCONTROLLER_FIELDID_WHEELSPEED_FRONT, 5U, PCINTERFACE_SUBSCRIBE_OK);
+
+    // Moving the only 2Hz field frees the rate
+    recvSubscribeMsg(PCCONTROLLER_FIELDID_INPUT_ACCEL, 4U);
+    runTick();
+    expectSubscribeResponse(PCCONTROLLER_FIELDID_INPUT_ACCEL, 4U, PCINTERFACE_SUBSCRIBE_OK);
+    recvSubscribeMsg(PCCONTROLLER_FIELDID_WHEELSPEED_REAR, 10U);
+    runTick();
+    expectSubscribeResponse(PCCONTROLLER_FIELDID_WHEELSPEED_REAR, 10U, PCINTERFACE_SUBSCRIBE_OK);
+}
+
+TEST(DEVICE_PCINTERFACE, PeriodicLinkStats)
 {
-    // Set the CRC that the "hardware" calculates
-    mockSet_CRC(0x12345678);
+    // Some traffic and errors to report
+    uint8_t rxData[5] = { 0 };
+    mockRecv_HAL_UARTEx_DMA(&husartA, rxData, sizeof(rxData), true);
+    husartA.ErrorCode = HAL_UART_ERROR_FE | HAL_UART_ERROR_NE;
+    HAL_UART_ErrorCallback(&husartA);
+    husartA.ErrorCode = HAL_UART_ERROR_NONE;
+
+    const uint8_t expectedRxBytes[] = {
+        0x01, 0x00, // Field ID: UART A rx bytes
+        0x04,       // Field size
+        0x00, 0x00, 0x00, 0x05, // Count
+    };
+    const uint16_t fieldLen = sizeof(expectedRxBytes);
+    const uint16_t numStats = 12U;
+
+    // Run up to just before the link stats are due, sending everything
+    for (int i = 0; i < 50; ++i) {
+        mockSetTaskNotifyValue(1); // to wake up
+        PCInterface_TaskMethod(&mPCInterface);
+        while (mockGet_HAL_UART_Len() > 0U) {
+            mockClear_HAL_UART_Data();
+            HAL_UART_TxCpltCallback(&husartA);
+        }
+    }
+
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+
+    // All of the port's stats are in one batch
+    TxFrame_T frame;
+    TEST_ASSERT_EQUAL(MSGFRAME_MAX_ENCODED_LEN(numStats*fieldLen), mockGet_HAL_UART_Len());
+    TEST_ASSERT_EQUAL(1U, decodeTx(mockGet_HAL_UART_Data(), mockGet_HAL_UART_Len(), &frame, 1U));
+    TEST_ASSERT_EQUAL(PCINTERFACE_MSG_STATEBATCH_FUNCTION, frame.function);
+    TEST_ASSERT_EQUAL(numStats*fieldLen, frame.dataLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedRxBytes, frame.data, sizeof(expectedRxBytes));
+
+    // Framing errors (3rd field after tx bytes) and noise errors
+    TEST_ASSERT_EQUAL_UINT8(0x03, frame.data[3U*fieldLen + 1U]);
+    TEST_ASSERT_EQUAL_UINT8(0x01, frame.data[3U*fieldLen + 6U]);
+    TEST_ASSERT_EQUAL_UINT8(0x04, frame.data[4U*fieldLen + 1U]);
+    TEST_ASSERT_EQUAL_UINT8(0x01, frame.data[4U*fieldLen + 6U]);
+}
 
-    uint8_t testMsg[] = {
-        ':',       // Start
-        0x00, 0x01, // Receiver addr: VCU
-        0x01, 0x01, // Function: Test Cmd, Set SDC output
+TEST(DEVICE_PCINTERFACE, TestCommandSDC)
+{
+    uint8_t payload[] = {
         0x00, 0x00, 0x00, 0x00, // Empty payload bytes
         0x00, 0x00, 0x00,       // Empty payload bytes
-        0x00, // Payload: error output state
-        0x12, 0x34, 0x56, 0x78, // CRC
-        '\r', '\n'
+        0x00, // Error output state
     };
-    uint16_t testMsgLen = sizeof(testMsg)*sizeof(uint8_t);
-    _Static_assert(sizeof(testMsg) == PCINTERFACE_MSG_COMMON_MSGLEN, "message length");
+    _Static_assert(sizeof(payload) == PCINTERFACE_MSG_COMMON_DATALEN, "message length");
 
     // UART recieve on DMA:
-    memcpy(interfaces[UART_DEV1].uartDmaRx, testMsg, testMsgLen); // copy into DMA buffer
-    HAL_UARTEx_RxEventCallback(&husartA, testMsgLen);
+    recvFrame(&husartA, PCINTERFACE_MSG_TESTCMD_SDC_FUNCTION, payload, sizeof(payload));
     mockSetTaskNotifyValue(1); // to wake up
     PCInterface_TaskMethod(&mPCInterface);
 
     TEST_ASSERT_FALSE(mockGet_VehicleControl_ECUError());
 
     // Toggle error on and run again
-    // (note that this only works because we're faking the hardware CRC)
-    testMsg[12] = 0x01;
+    payload[7] = 0x01;
 
-    memcpy(interfaces[UART_DEV1].uartDmaRx, testMsg, testMsgLen); // copy into DMA buffer
-    HAL_UARTEx_RxEventCallback(&husartA, testMsgLen);
+    recvFrame(&husartA, PCINTERFACE_MSG_TESTCMD_SDC_FUNCTION, payload, sizeof(payload));
     mockSetTaskNotifyValue(1); // to wake up
     PCInterface_TaskMethod(&mPCInterface);
 
     TEST_ASSERT_TRUE(mockGet_VehicleControl_ECUError());
 
     // And toggle it back off...
-    testMsg[12] = 0x00;
+    payload[7] = 0x00;
 
-    memcpy(interfaces[UART_DEV1].uartDmaRx, testMsg, testMsgLen); // copy into DMA buffer
-    HAL_UARTEx_RxEventCallback(&husartA, testMsgLen);
+    recvFrame(&husartA, PCINTERFACE_MSG_TESTCMD_SDC_FUNCTION, payload, sizeof(payload));
     mockSetTaskNotifyValue(1); // to wake up
     PCInterface_TaskMethod(&mPCInterface);
 
@@ -428,24 +803,14 @@ TEST(DEVICE_PCINTERFACE, TestCommandSDC)
 
 TEST(DEVICE_PCINTERFACE, TestCommandPDM)
 {
-    // Set the CRC that the "hardware" calculates
-    mockSet_CRC(0x12345678);
-
-    uint8_t testMsg[] = {
-        ':',       // Start
-        0x00, 0x01, // Receiver addr: VCU
-        0x01, 0x02, // Function: Test Cmd, Set PDM output
+    uint8_t payload[] = {
         0x00, 0x00, // Empty bytes
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Payload: PDM channels
-        0x12, 0x34, 0x56, 0x78, // CRC
-        '\r', '\n'
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // PDM channels
     };
-    uint16_t testMsgLen = sizeof(testMsg)*sizeof(uint8_t);
-    _Static_assert(sizeof(testMsg) == PCINTERFACE_MSG_COMMON_MSGLEN, "message length");
+    _Static_assert(sizeof(payload) == PCINTERFACE_MSG_COMMON_DATALEN, "message length");
 
     // UART recieve on DMA:
-    memcpy(interfaces[UART_DEV1].uartDmaRx, testMsg, testMsgLen); // copy into DMA buffer
-    HAL_UARTEx_RxEventCallback(&husartA, testMsgLen);
+    recvFrame(&husartA, PCINTERFACE_MSG_TESTCMD_PDM_FUNCTION, payload, sizeof(payload));
     mockSetTaskNotifyValue(1); // to wake up
     PCInterface_TaskMethod(&mPCInterface);
 
@@ -455,18 +820,10 @@ TEST(DEVICE_PCINTERFACE, TestCommandPDM)
 
     for (uint8_t i = 0; i < 6; ++i) {
         // Toggle PDM on and run again
-        // (note that this only works because we're faking the hardware CRC)
-        testMsg[7] = 0x00;
-        testMsg[8] = 0x00;
-        testMsg[9] = 0x00;
-        testMsg[10] = 0x00;
-        testMsg[11] = 0x00;
-        testMsg[12] = 0x00;
-
-        testMsg[i + 7U] = 0x01; // PDM i
-
-        memcpy(interfaces[UART_DEV1].uartDmaRx, testMsg, testMsgLen); // copy into DMA buffer
-        HAL_UARTEx_RxEventCallback(&husartA, testMsgLen);
+        memset(payload + 2, 0U, 6U);
+        payload[i + 2U] = 0x01; // PDM i
+
+        recvFrame(&husartA, PCINTERFACE_MSG_TESTCMD_PDM_FUNCTION, payload, sizeof(payload));
         mockSetTaskNotifyValue(1); // to wake up
         PCInterface_TaskMethod(&mPCInterface);
 
@@ -479,15 +836,9 @@ TEST(DEVICE_PCINTERFACE, TestCommandPDM)
     }
 
     // And toggle it back off...
-    testMsg[7] = 0x00;
-    testMsg[8] = 0x00;
-    testMsg[9] = 0x00;
-    testMsg[10] = 0x00;
-    testMsg[11] = 0x00;
-    testMsg[12] = 0x00;
-
-    memcpy(interfaces[UART_DEV1].uartDmaRx, testMsg, testMsgLen); // copy into DMA buffer
-    HAL_UARTEx_RxEventCallback(&husartA, testMsgLen);
+    memset(payload + 2, 0U, 6U);
+
+    recvFrame(&husartA, PCINTERFACE_MSG_TESTCMD_PDM_FUNCTION, payload, sizeof(payload));
     mockSetTaskNotifyValue(1); // to wake up
     PCInterface_TaskMethod(&mPCInterface);
 
@@ -496,6 +847,300 @@ TEST(DEVICE_PCINTERFACE, TestCommandPDM)
     }
 }
 
+TEST(DEVICE_PCINTERFACE, TestCommandBadFrames)
+{
+    const uint8_t payload[] = {
+        0x00, 0x00, // Empty bytes
+        0x00, 0x01, 0x00, 0x00, 0x00, 0x00, // PDM channels
+    };
+
+    // Line noise, then a frame cut short by a reset of the PC end
+    const uint8_t noise[] = { 0x55, 0xAA, 0x00, 0x07, 0x01, 0x02 };
+    mockRecv_HAL_UARTEx_DMA(&husartA, noise, sizeof(noise), true);
+    const uint8_t delimiter = MSGFRAME_DELIMITER;
+    mockRecv_HAL_UARTEx_DMA(&husartA, &delimiter, 1U, true);
+
+    // Next frame is picked up straight away
+    recvFrame(&husartA, PCINTERFACE_MSG_TESTCMD_PDM_FUNCTION, payload, sizeof(payload));
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+
+    TEST_ASSERT_TRUE(mockGet_VehicleControl_PDMChannel(1));
+    TEST_ASSERT_EQUAL(2U, mPCInterface.ports[0].mfDecode.badFrames);
+}
+
+TEST(DEVICE_PCINTERFACE, TestCommandBothPorts)
+{
+    const uint8_t payloadPdm[] = {
+        0x00, 0x00, // Empty bytes
+        0x00, 0x00, 0x01, 0x00, 0x00, 0x00, // PDM channels
+    };
+    const uint8_t payloadSdc[] = {
+        0x00, 0x00, 0x00, 0x00, // Empty payload bytes
+        0x00, 0x00, 0x00,       // Empty payload bytes
+        0x01, // Error output state
+    };
+    _Static_assert(sizeof(payloadPdm) == PCINTERFACE_MSG_COMMON_DATALEN, "message length");
+    _Static_assert(sizeof(payloadSdc) == PCINTERFACE_MSG_COMMON_DATALEN, "message length");
+
+    uint8_t testMsgPdm[MSGFRAME_MAX_ENCODED_LEN(PCINTERFACE_MSG_COMMON_DATALEN)];
+    uint8_t testMsgSdc[MSGFRAME_MAX_ENCODED_LEN(PCINTERFACE_MSG_COMMON_DATALEN)];
+    TEST_ASSERT_EQUAL(sizeof(testMsgPdm), encodeRx(
+        PCINTERFACE_MSG_TESTCMD_PDM_FUNCTION, payloadPdm, sizeof(payloadPdm)));
+    memcpy(testMsgPdm, mRxEncodeBuffer, sizeof(testMsgPdm));
+    TEST_ASSERT_EQUAL(sizeof(testMsgSdc), encodeRx(
+        PCINTERFACE_MSG_TESTCMD_SDC_FUNCTION, payloadSdc, sizeof(payloadSdc)));
+    memcpy(testMsgSdc, mRxEncodeBuffer, sizeof(testMsgSdc));
+    const uint16_t split = 7U;
+
+    // Frames arrive on both ports at the same time, in pieces
+    mockRecv_HAL_UARTEx_DMA(&husartA, testMsgPdm, split, true);
+    mockRecv_HAL_UARTEx_DMA(&husartB, testMsgSdc, split, true);
+    mockRecv_HAL_UARTEx_DMA(&husartA, testMsgPdm + split, sizeof(testMsgPdm) - split, true);
+    mockRecv_HAL_UARTEx_DMA(&husartB, testMsgSdc + split, sizeof(testMsgSdc) - split, true);
+    mockSetTaskNotifyValue(1); // to wake up
+    PCInterface_TaskMethod(&mPCInterface);
+
+    // Both decoded
+    TEST_ASSERT_TRUE(mockGet_VehicleControl_PDMChannel(2));
+    TEST_ASSERT_TRUE(mockGet_VehicleControl_ECUError());
+
+    // Nothing was dropped by either stream
+    for (uint8_t i = 0U; i < PCINTERFACE_NUM_PORTS; ++i) {
+        uint32_t overflow = 1U;
+        TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetRecvStreamOverflow(
+            mPCInterface.ports[i].uart, mPCInterface.ports[i].recvStreamHandle, &overflow));
+        TEST_ASSERT_EQUAL(0U, overflow);
+        TEST_ASSERT_EQUAL(0U, mPCInterface.ports[i].mfDecode.badFrames);
+    }
+}
+
+TEST(DEVICE_PCINTERFACE, BaudSwitch)
+{
+    // Accepted at the old rate
+    recvBaudMsg(0x03, 460800U);
+    runTick();
+    expectBaudResponse(460800U, PCINTERFACE_BAUD_ACCEPTED);
+    TEST_ASSERT_EQUAL(115200U, mockGet_HAL_UART_BaudRate(&husartA));
+
+    // Not switched until the response has gone out
+    runTick();
+    TEST_ASSERT_EQUAL(115200U, mockGet_HAL_UART_BaudRate(&husartA));
+    drainTxA();
+    runTick();
+    TEST_ASSERT_EQUAL(460800U, mockGet_HAL_UART_BaudRate(&husartA));
+    TEST_ASSERT_EQUAL(115200U, mockGet_HAL_UART_BaudRate(&husartB));
+    drainTxA();
+
+    // A second request while switching is refused
+    recvBaudMsg(0x03, 921600U);
+    runTick();
+    expectBaudResponse(921600U, PCINTERFACE_BAUD_BUSY);
+    drainTxA();
+
+    // Confirmed at the new rate
+    mockClearPrintf();
+    recvBaudMsg(0x04, 460800U);
+    runTick();
+    expectBaudResponse(460800U, PCINTERFACE_BAUD_CONFIRMED);
+    TEST_ASSERT_EQUAL_STRING("PCInterface: baud rate switched\n", printfOut);
+    drainTxA();
+
+    // Stays switched
+    for (uint32_t i = 0U; i < 2U*PCINTERFACE_BAUD_TIMEOUT_TICKS; ++i) {
+        runTick();
+        drainTxA();
+    }
+    TEST_ASSERT_EQUAL(460800U, mockGet_HAL_UART_BaudRate(&husartA));
+}
+
+TEST(DEVICE_PCINTERFACE, BaudSwitchRejected)
+{
+    recvBaudMsg(0x03, 2000000U);
+    runTick();
+    expectBaudResponse(2000000U, PCINTERFACE_BAUD_REJECTED);
+    drainTxA();
+
+    recvBaudMsg(0x03, 1200U);
+    runTick();
+    expectBaudResponse(1200U, PCINTERFACE_BAUD_REJECTED);
+    drainTxA();
+
+    runTick();
+    TEST_ASSERT_EQUAL(115200U, mockGet_HAL_UART_BaudRate(&husartA));
+}
+
+TEST(DEVICE_PCINTERFACE, BaudSwitchNotConfirmed)
+{
+    recvBaudMsg(0x03, 460800U);
+    runTick();
+    drainTxA();
+    runTick();
+    TEST_ASSERT_EQUAL(460800U, mockGet_HAL_UART_BaudRate(&husartA));
+
+    // PC never confirms, so go back to the old rate
+    mockClearPrintf();
+    for (uint32_t i = 0U; i <= PCINTERFACE_BAUD_TIMEOUT_TICKS; ++i) {
+        drainTxA();
+        runTick();
+    }
+    TEST_ASSERT_EQUAL(115200U, mockGet_HAL_UART_BaudRate(&husartA));
+    TEST_ASSERT_EQUAL_STRING("PCInterface: baud rate not confirmed, reverted\n", printfOut);
+    drainTxA();
+
+    // And can switch again
+    recvBaudMsg(0x03, 230400U);
+    runTick();
+    expectBaudResponse(230400U, PCINTERFACE_BAUD_ACCEPTED);
+}
+
+TEST(DEVICE_PCINTERFACE, BaudSwitchFailed)
+{
+    recvBaudMsg(0x03, 460800U);
+    runTick();
+    drainTxA();
+
+    // Peripheral won't take the rate, stays at the old one
+    mockClearPrintf();
+    mockSet_HAL_UART_Init_Status(HAL_ERROR);
+    runTick();
+    mockSet_HAL_UART_Init_Status(HAL_OK);
+    TEST_ASSERT_EQUAL(115200U, mockGet_HAL_UART_BaudRate(&husartA));
+    TEST_ASSERT_EQUAL_STRING("PCInterface: baud rate switch failed\n", printfOut);
+}
+
+TEST(DEVICE_PCINTERFACE, BaudSwitchHoldsOutput)
+{
+    recvBaudMsg(0x03, 460800U);
+    runTick();
+    TEST_ASSERT_TRUE(PCInterface_BaudSwitchPending(&mPCInterface));
+
+    // Nothing more is queued while the response goes out, on either port
+    PCInterface_HandlePeriodic(&mPCInterface);
+    DebugPrint(&mPCInterface, "held\n");
+    recvSubscribeMsg(PCCONTROLLER_FIELDID_SDC, 10U);
+    runTick();
+    expectBaudResponse(460800U, PCINTERFACE_BAUD_ACCEPTED);
+    UART_Stats_T stats;
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetStats(mPCInterface.uartB, &stats));
+    TEST_ASSERT_EQUAL(0U, stats.txBytes + stats.txBacklogPeak);
+
+    mockClear_HAL_UART_Data();
+    HAL_UART_TxCpltCallback(&husartA);
+    TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
+    runTick();
+    TEST_ASSERT_EQUAL(460800U, mockGet_HAL_UART_BaudRate(&husartA));
+    TEST_ASSERT_FALSE(PCInterface_BaudSwitchPending(&mPCInterface));
+}
+
+TEST(DEVICE_PCINTERFACE, BaudRevertDropsTx)
+{
+    uint8_t msg[16] = { 0 };
+
+    recvBaudMsg(0x03, 460800U);
+    runTick();
+    drainTxA();
+    runTick();
+    TEST_ASSERT_EQUAL(460800U, mockGet_HAL_UART_BaudRate(&husartA));
+
+    // Sent at the new rate, but the PC has gone and it never completes
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_SendMessage(mPCInterface.uartA, msg, sizeof(msg)));
+    uint32_t ticks = 0U;
+    while (PCINTERFACE_BAUD_STATE_REVERTING != mPCInterface.ports[0].baud.state) {
+        TEST_ASSERT_TRUE(ticks++ <= PCINTERFACE_BAUD_TIMEOUT_TICKS);
+        runTick();
+    }
+    TEST_ASSERT_TRUE(PCInterface_BaudSwitchPending(&mPCInterface));
+
+    // Waits for it to go out, up to the deadline
+    mockClearPrintf();
+    for (uint32_t i = 1U; i < PCINTERFACE_BAUD_REVERT_TICKS; ++i) {
+        runTick();
+    }
+    TEST_ASSERT_EQUAL(460800U, mockGet_HAL_UART_BaudRate(&husartA));
+
+    // Then drops it and reverts
+    runTick();
+    TEST_ASSERT_EQUAL(115200U, mockGet_HAL_UART_BaudRate(&husartA));
+    TEST_ASSERT_EQUAL_STRING("PCInterface: baud rate not confirmed, reverted\n", printfOut);
+    TEST_ASSERT_FALSE(PCInterface_BaudSwitchPending(&mPCInterface));
+    UART_Stats_T stats;
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetStats(mPCInterface.uartA, &stats));
+    TEST_ASSERT_EQUAL(sizeof(msg), stats.txDroppedBytes);
+}
+
+TEST(DEVICE_PCINTERFACE, StreamBlocks)
+{
+    mStream.storage = mStreamStorage;
+    mStream.sampleLen = STREAM_SAMPLE_LEN;
+    mStream.samplesPerBlock = STREAM_SAMPLES_PER_BLOCK;
+    mStream.numBlocks = STREAM_NUM_BLOCKS;
+    TEST_ASSERT_TRUE(BlockBuffer_Init(&mStream));
+    TEST_ASSERT_EQUAL(PCINTERFACE_STATUS_OK, PCInterface_SetChannelStream(&mPCInterface, &mStream));
+
+    // Not sampled until the PC starts the stream
+    putStreamSamples(0U, 1U, false);
+    recvStreamMsg(&husartB, 1U);
+    runTick();
+    putStreamSamples(0U, 2U * STREAM_SAMPLES_PER_BLOCK, true);
+
+    // A block per frame, on the port that started the stream
+    UART_Stats_T statsA;
+    UART_Stats_T statsB;
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetStats(UART_DEV1, &statsA));
+    PCInterface_StreamFlush(&mPCInterface);
+    expectStreamBlock(0U, 0U, 0U);
+
+    // The next block waits for the frame to be transmitted
+    mockClear_HAL_UART_Data();
+    PCInterface_StreamFlush(&mPCInterface);
+    TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
+    HAL_UART_TxCpltCallback(&husartB);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetStats(UART_DEV3, &statsB));
+    TEST_ASSERT_EQUAL(MSGFRAME_MAX_ENCODED_LEN(STREAM_BLOCK_LEN), statsB.txBytes);
+
+    // Until then the stream fills up and drops samples
+    putStreamSamples(4U, STREAM_SAMPLES_PER_BLOCK, true);
+    putStreamSamples(6U, 3U, false);
+    PCInterface_StreamFlush(&mPCInterface);
+    expectStreamBlock(2U, 0U, 2U);
+    mockClear_HAL_UART_Data();
+    HAL_UART_TxCpltCallback(&husartB);
+    putStreamSamples(9U, STREAM_SAMPLES_PER_BLOCK, true);
+    PCInterface_StreamFlush(&mPCInterface);
+    expectStreamBlock(4U, 0U, 4U);
+    mockClear_HAL_UART_Data();
+    HAL_UART_TxCpltCallback(&husartB);
+    PCInterface_StreamFlush(&mPCInterface);
+    expectStreamBlock(9U, 3U, 9U); // samples 6 to 8 were dropped
+    mockClear_HAL_UART_Data();
+    HAL_UART_TxCpltCallback(&husartB);
+
+    // Nothing went to port A
+    UART_Stats_T stats;
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, UART_GetStats(UART_DEV1, &stats));
+    TEST_ASSERT_EQUAL(statsA.txBytes, stats.txBytes);
+
+    // Stopped
+    recvStreamMsg(&husartB, 0U);
+    runTick();
+    putStreamSamples(11U, STREAM_SAMPLES_PER_BLOCK, false);
+    PCInterface_StreamFlush(&mPCInterface);
+    TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
+}
+
+TEST(DEVICE_PCINTERFACE, StreamNotSet)
+{
+    // Ignored without a channel stream
+    recvStreamMsg(&husartA, 1U);
+    runTick();
+    TEST_ASSERT_NULL(mPCInterface.streamPort);
+    PCInterface_StreamFlush(&mPCInterface);
+    TEST_ASSERT_EQUAL(0U, mockGet_HAL_UART_Len());
+
+    TEST_ASSERT_EQUAL(PCINTERFACE_STATUS_ERROR_DEPENDS, PCInterface_SetChannelStream(&mPCInterface, NULL));
+}
+
 TEST_GROUP_RUNNER(DEVICE_PCINTERFACE)
 {
     RUN_TEST_CASE(DEVICE_PCINTERFACE, InitOk);
@@ -503,9 +1148,25 @@ TEST_GROUP_RUNNER(DEVICE_PCINTERFACE)
     RUN_TEST_CASE(DEVICE_PCINTERFACE, TestNoMessages);
     RUN_TEST_CASE(DEVICE_PCINTERFACE, TestLogSerialShortMsg);
     RUN_TEST_CASE(DEVICE_PCINTERFACE, TestLogSerialLongMsg);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, TestLogRecords);
     RUN_TEST_CASE(DEVICE_PCINTERFACE, PeriodicStateUpdates);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, PeriodicStateKeyframes);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, SubscribeField);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, SubscribeUnsubscribeDefault);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, SubscribeErrors);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, PeriodicLinkStats);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, StreamBlocks);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, StreamNotSet);
     RUN_TEST_CASE(DEVICE_PCINTERFACE, TestCommandSDC);
     RUN_TEST_CASE(DEVICE_PCINTERFACE, TestCommandPDM);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, TestCommandBadFrames);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, TestCommandBothPorts);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, BaudSwitch);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, BaudSwitchRejected);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, BaudSwitchNotConfirmed);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, BaudSwitchFailed);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, BaudSwitchHoldsOutput);
+    RUN_TEST_CASE(DEVICE_PCINTERFACE, BaudRevertDropsTx);
 }
 
 #define INVOKE_TEST DEVICE_PCINTERFACE
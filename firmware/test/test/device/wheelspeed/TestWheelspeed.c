@@ -199,11 +199,8 @@ TEST(DEVICE_WHEELSPEED, HighRPM)
         Wheelspeed_TIM_IRQHandler(&htim2);
     }
 
-    // Need to spin the task 100 times since it's a 1Hz task on a 100Hz timer
-    for (uint16_t i = 0; i < 100U; ++i) {
-        mockSetTaskNotifyValue(1); // to wake up
-        Wheelspeed_TaskMethod();
-    }
+    mockSetTaskNotifyValue(1); // to wake up
+    Wheelspeed_TaskMethod();
 
     TEST_ASSERT_EQUAL(2001, testVehicleState.data.vehicle.wheelspeed.wheelspeedFront);
     TEST_ASSERT_EQUAL(2001, testVehicleState.data.vehicle.wheelspeed.wheelspeedRear);
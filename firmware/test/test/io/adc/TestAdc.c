@@ -29,23 +29,49 @@ static ADC_HandleTypeDef hadc1 = {
         .NbrOfConversion = 0, // configured in each test
     }
 };
-static ADC_Config_T adcConfig = {
+static ADC_HandleTypeDef hadc2 = {
+    .Instance = ADC2,
+    .Init = (ADC_InitTypeDef){
+        .ContinuousConvMode = ENABLE,
+        .DataAlign = ADC_DATAALIGN_RIGHT,
+        .NbrOfConversion = 0, // configured in each test
+    }
+};
+static ADC_HandleTypeDef hadc3 = {
+    .Instance = ADC3,
+    .Init = (ADC_InitTypeDef){
+        .ContinuousConvMode = ENABLE,
+        .DataAlign = ADC_DATAALIGN_RIGHT,
+        .NbrOfConversion = 0, // configured in each test
+    }
+};
+static ADC_T adcConfig = {
     .logger = &testLog,
     .handle = &hadc1,
-    .adcIrq = DMA2_Stream0_IRQn,
+    .mode = ADC_MULTIMODE_INDEPENDENT,
     .numChannelsUsed = 0, // configured in each test
 };
 
 // HAL interrupts:
 extern void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc);
 extern void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc);
+extern void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef* hadc);
 
 static void setTestNumChannels(uint16_t testNumChannels)
 {
     hadc1.Init.NbrOfConversion = testNumChannels;
+    hadc2.Init.NbrOfConversion = testNumChannels;
+    hadc3.Init.NbrOfConversion = testNumChannels;
     adcConfig.numChannelsUsed = testNumChannels;
 }
 
+static void setTestMode(ADC_MultiMode_T mode)
+{
+    adcConfig.mode = mode;
+    adcConfig.slaves[0] = &hadc2;
+    adcConfig.slaves[1] = &hadc3;
+}
+
 TEST_GROUP(IO_ADC);
 
 TEST_SETUP(IO_ADC)
@@ -57,6 +83,9 @@ TEST_SETUP(IO_ADC)
 
     // Reset number of channels for test
     setTestNumChannels(0);
+    adcConfig.mode = ADC_MULTIMODE_INDEPENDENT;
+    adcConfig.slaves[0] = NULL;
+    adcConfig.slaves[1] = NULL;
 }
 
 TEST_TEAR_DOWN(IO_ADC)
@@ -83,7 +112,7 @@ TEST(IO_ADC, TestAdcInitOk)
 TEST(IO_ADC, TestAdcInitTooManyChannels)
 {
     // Reset number of channels for test
-    setTestNumChannels(ADC_MAX_NUM_CHANNELS+1);
+    setTestNumChannels(ADC_MAX_NUM_RANKS+1);
     ADC_Status_T status = ADC_Init(&adcConfig);
 
     TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_CHANNEL_COUNT, status);
@@ -96,7 +125,7 @@ TEST(IO_ADC, TestAdcInitTooManyChannels)
 TEST(IO_ADC, TestAdcConfigOk)
 {
     // Perform init
-    setTestNumChannels(ADC_MAX_NUM_CHANNELS);
+    setTestNumChannels(ADC_MAX_NUM_RANKS);
     TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
 
     const char* expectedLogging = 
@@ -107,7 +136,7 @@ TEST(IO_ADC, TestAdcConfigOk)
 
 TEST(IO_ADC, TestAdcConfigDmaError)
 {
-    setTestNumChannels(ADC_MAX_NUM_CHANNELS);
+    setTestNumChannels(ADC_MAX_NUM_RANKS);
     mockSet_HAL_ADC_Start_DMA_Status(HAL_ERROR);
 
     // Perform init
@@ -122,19 +151,19 @@ TEST(IO_ADC, TestAdcConfigDmaError)
 TEST(IO_ADC, TestAdcGetNotReady)
 {
     // Perform init
-    setTestNumChannels(ADC_MAX_NUM_CHANNELS);
+    setTestNumChannels(ADC_MAX_NUM_RANKS);
     TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
 
     // Attempt to get
-    for (uint16_t i = 0; i < ADC_MAX_NUM_CHANNELS; ++i) {
+    for (uint16_t i = 0; i < ADC_MAX_NUM_RANKS; ++i) {
         uint16_t adcVal = 0xFFFF;
-        TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_DATANOTREADY, ADC_Get(i, &adcVal));
+        TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_DATANOTREADY, ADC_Get(&adcConfig, i, &adcVal));
         TEST_ASSERT_EQUAL(0, adcVal);
     }
 
     // Get invalid value
     uint16_t adcVal = 0xFFFF;
-    ADC_Status_T status = ADC_Get(ADC_MAX_NUM_CHANNELS+1, &adcVal);
+    ADC_Status_T status = ADC_Get(&adcConfig, ADC_MAX_NUM_RANKS, &adcVal);
     TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_INVALID_CHANNEL, status);
     TEST_ASSERT_EQUAL(0, adcVal);
 }
@@ -142,20 +171,19 @@ TEST(IO_ADC, TestAdcGetNotReady)
 TEST(IO_ADC, TestAdcInterruptHalf)
 {
     // Perform init
-    setTestNumChannels(ADC_MAX_NUM_CHANNELS);
+    setTestNumChannels(ADC_MAX_NUM_RANKS);
     TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
     mockClearADCClear();
 
     // pretend that a few conversions have happened already...
-    copyBufferAValid = true;
-    copyBufferBValid = true;
+    adcConfig.sequence = 1U;
 
     // HAL_ADC_ConvHalfCpltCallback should do nothing to API
     HAL_ADC_ConvHalfCpltCallback(&hadc1);
 
-    for (uint16_t i = 0; i < ADC_MAX_NUM_CHANNELS; ++i) {
+    for (uint16_t i = 0; i < ADC_MAX_NUM_RANKS; ++i) {
         uint16_t adcVal = 0xFFFF;
-        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(i, &adcVal));
+        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(&adcConfig, i, &adcVal));
         TEST_ASSERT_EQUAL(0, adcVal);
     }
 }
@@ -168,7 +196,7 @@ TEST(IO_ADC, TestAdcDataSingle)
     TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
 
     // set data
-    uint32_t dataRaw[5] = {1, 4095, 100, 0, 0x1FFF};
+    uint16_t dataRaw[5] = {1, 4095, 100, 0, 0x1FFF};
     mockSetADCData(dataRaw, 5);
 
     // Raise interrupts
@@ -176,9 +204,9 @@ TEST(IO_ADC, TestAdcDataSingle)
     HAL_ADC_ConvHalfCpltCallback(&hadc1);
     HAL_ADC_ConvCpltCallback(&hadc1);
 
-    for (uint16_t i = 0; i < numChannels; ++i) {
+    for (uint16_t i = 0; i < testNumChannels; ++i) {
         uint16_t adcVal = 0xFFFF;
-        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(i, &adcVal));
+        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(&adcConfig, i, &adcVal));
         TEST_ASSERT_EQUAL(dataRaw[i], adcVal);
     }
 }
@@ -193,7 +221,7 @@ TEST(IO_ADC, TestAdcDataMultipleSamples)
     TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
 
     // set data
-    uint32_t dataRaw1[5] = {1, 4095, 100, 0, 0x1FFF};
+    uint16_t dataRaw1[5] = {1, 4095, 100, 0, 0x1FFF};
     mockSetADCData(dataRaw1, 5);
 
     // Raise interrupts
@@ -203,39 +231,349 @@ TEST(IO_ADC, TestAdcDataMultipleSamples)
 
     // now before the data is read with the public API, start a new DMA transfer
     // (this should switch to copy buffer B)
-    uint32_t dataRaw2[5] = {2, 3, 4, 5, 6};
+    uint16_t dataRaw2[5] = {2, 3, 4, 5, 6};
     mockSetADCData(dataRaw2, 5);
     HAL_ADC_ConvHalfCpltCallback(&hadc1);
 
-    for (uint16_t i = 0; i < numChannels; ++i) {
+    for (uint16_t i = 0; i < testNumChannels; ++i) {
         uint16_t adcVal = 0xFFFF;
-        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(i, &adcVal));
+        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(&adcConfig, i, &adcVal));
         TEST_ASSERT_EQUAL(dataRaw1[i], adcVal);
     }
 
     // finish that DMA transfer
     HAL_ADC_ConvCpltCallback(&hadc1);
     // and start another one (to swich back to copy buffer A)
-    uint32_t dataRaw3[5] = {7, 8, 9, 10, 11};
+    uint16_t dataRaw3[5] = {7, 8, 9, 10, 11};
     mockSetADCData(dataRaw3, 5);
     HAL_ADC_ConvHalfCpltCallback(&hadc1);
 
-    for (uint16_t i = 0; i < numChannels; ++i) {
+    for (uint16_t i = 0; i < testNumChannels; ++i) {
         uint16_t adcVal = 0xFFFF;
-        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(i, &adcVal));
+        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(&adcConfig, i, &adcVal));
         TEST_ASSERT_EQUAL(dataRaw2[i], adcVal);
     }
 
     // finish that DMA transfer
     HAL_ADC_ConvCpltCallback(&hadc1);
 
-    for (uint16_t i = 0; i < numChannels; ++i) {
+    for (uint16_t i = 0; i < testNumChannels; ++i) {
         uint16_t adcVal = 0xFFFF;
-        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(i, &adcVal));
+        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(&adcConfig, i, &adcVal));
         TEST_ASSERT_EQUAL(dataRaw3[i], adcVal);
     }
 }
 
+TEST(IO_ADC, TestAdcDualSimultaneous)
+{
+    uint16_t testNumChannels = 3;
+    setTestNumChannels(testNumChannels);
+    setTestMode(ADC_MULTIMODE_DUAL_SIMULT);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
+
+    // Common ADC settings & slave started
+    ADC_MultiModeTypeDef multimode = mockGet_HAL_ADCEx_MultiMode();
+    TEST_ASSERT_EQUAL(ADC_DUALMODE_REGSIMULT, multimode.Mode);
+    TEST_ASSERT_EQUAL(ADC_DMAACCESSMODE_2, multimode.DMAAccessMode);
+    TEST_ASSERT_TRUE(mockGet_HAL_ADC_Started(&hadc2));
+    // Each DMA word holds one conversion from each ADC
+    TEST_ASSERT_EQUAL(3, mockGet_HAL_ADC_StartDMALength());
+
+    // DMA data is interleaved ADC1, ADC2 per rank
+    uint16_t dataRaw[6] = {100, 200, 101, 201, 102, 202};
+    mockSetADCData(dataRaw, 6);
+
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    HAL_ADC_ConvCpltCallback(&hadc1);
+
+    for (uint16_t rank = 0; rank < testNumChannels; ++rank) {
+        uint16_t adcVal1 = 0xFFFF;
+        uint16_t adcVal2 = 0xFFFF;
+        TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+            ADC_Get(&adcConfig, ADC_MULTIMODE_CHANNEL(rank, 0, 2), &adcVal1));
+        TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+            ADC_Get(&adcConfig, ADC_MULTIMODE_CHANNEL(rank, 1, 2), &adcVal2));
+        TEST_ASSERT_EQUAL(100 + rank, adcVal1);
+        TEST_ASSERT_EQUAL(200 + rank, adcVal2);
+    }
+
+    // Out of range for the group
+    uint16_t adcVal = 0xFFFF;
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_INVALID_CHANNEL,
+        ADC_Get(&adcConfig, ADC_CONVERSIONCHANNEL6, &adcVal));
+}
+
+TEST(IO_ADC, TestAdcTripleModes)
+{
+    // Simultaneous uses half-word DMA items
+    setTestNumChannels(3);
+    setTestMode(ADC_MULTIMODE_TRIPLE_SIMULT);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
+    TEST_ASSERT_EQUAL(ADC_TRIPLEMODE_REGSIMULT, mockGet_HAL_ADCEx_MultiMode().Mode);
+    TEST_ASSERT_EQUAL(ADC_DMAACCESSMODE_1, mockGet_HAL_ADCEx_MultiMode().DMAAccessMode);
+    TEST_ASSERT_EQUAL(9, mockGet_HAL_ADC_StartDMALength());
+    TEST_ASSERT_TRUE(mockGet_HAL_ADC_Started(&hadc3));
+
+    uint16_t dataRaw[9] = {10, 20, 30, 11, 21, 31, 12, 22, 32};
+    mockSetADCData(dataRaw, 9);
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    HAL_ADC_ConvCpltCallback(&hadc1);
+
+    uint16_t adcVal = 0xFFFF;
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+        ADC_Get(&adcConfig, ADC_MULTIMODE_CHANNEL(1, 2, 3), &adcVal));
+    TEST_ASSERT_EQUAL(31, adcVal);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+        ADC_Get(&adcConfig, ADC_MULTIMODE_CHANNEL(2, 0, 3), &adcVal));
+    TEST_ASSERT_EQUAL(12, adcVal);
+
+    // Interleaved transfers pairs of conversions, so needs an even number
+    mockLogClear();
+    setTestMode(ADC_MULTIMODE_TRIPLE_INTERL);
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_CHANNEL_COUNT, ADC_Init(&adcConfig));
+
+    setTestNumChannels(4);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
+    TEST_ASSERT_EQUAL(ADC_DMAACCESSMODE_2, mockGet_HAL_ADCEx_MultiMode().DMAAccessMode);
+    TEST_ASSERT_EQUAL(6, mockGet_HAL_ADC_StartDMALength());
+}
+
+TEST(IO_ADC, TestAdcMultiModeHwConfig)
+{
+    // Slave handle missing
+    setTestNumChannels(4);
+    setTestMode(ADC_MULTIMODE_DUAL_SIMULT);
+    adcConfig.slaves[0] = NULL;
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_HW_CONFIG, ADC_Init(&adcConfig));
+
+    // Slave sequence length inconsistent with master
+    setTestMode(ADC_MULTIMODE_DUAL_SIMULT);
+    hadc2.Init.NbrOfConversion = 3;
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_HW_CONFIG, ADC_Init(&adcConfig));
+
+    // Common register config fails
+    setTestNumChannels(4);
+    mockSet_HAL_ADCEx_MultiModeConfigChannel_Status(HAL_ERROR);
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_HW_CONFIG, ADC_Init(&adcConfig));
+    mockSet_HAL_ADCEx_MultiModeConfigChannel_Status(HAL_OK);
+}
+
+TEST(IO_ADC, TestAdcMultipleInstances)
+{
+    static ADC_T adcB = {
+        .logger = &testLog,
+        .handle = &hadc2,
+        .mode = ADC_MULTIMODE_INDEPENDENT,
+    };
+
+    setTestNumChannels(2);
+    adcB.numChannelsUsed = 2;
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcB));
+
+    uint16_t dataA[2] = {1, 2};
+    uint16_t dataB[2] = {3, 4};
+    mockSetADCDataHandle(&hadc1, dataA, 2);
+    mockSetADCDataHandle(&hadc2, dataB, 2);
+
+    // Only complete the conversions of instance B
+    HAL_ADC_ConvHalfCpltCallback(&hadc2);
+    HAL_ADC_ConvCpltCallback(&hadc2);
+
+    uint16_t adcVal = 0xFFFF;
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_DATANOTREADY, ADC_Get(&adcConfig, 0, &adcVal));
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(&adcB, 1, &adcVal));
+    TEST_ASSERT_EQUAL(4, adcVal);
+
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    HAL_ADC_ConvCpltCallback(&hadc1);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Get(&adcConfig, 1, &adcVal));
+    TEST_ASSERT_EQUAL(2, adcVal);
+}
+
+TEST(IO_ADC, TestAdcGetChannels)
+{
+    setTestNumChannels(5);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
+
+    const ADC_Channel_T channels[3] = {
+        ADC_CONVERSIONCHANNEL4, ADC_CONVERSIONCHANNEL0, ADC_CONVERSIONCHANNEL3
+    };
+    uint16_t vals[3] = {0xFFFF, 0xFFFF, 0xFFFF};
+    uint32_t timestamp = 0xFFFFFFFF;
+
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_DATANOTREADY,
+        ADC_GetChannels(&adcConfig, channels, vals, 3, &timestamp));
+    TEST_ASSERT_EQUAL(0, vals[0]);
+
+    uint16_t dataRaw[5] = {1, 2, 3, 4, 5};
+    mockSetADCData(dataRaw, 5);
+    mockSet_HAL_GetTick(1234);
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    HAL_ADC_ConvCpltCallback(&hadc1);
+
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+        ADC_GetChannels(&adcConfig, channels, vals, 3, &timestamp));
+    TEST_ASSERT_EQUAL(5, vals[0]);
+    TEST_ASSERT_EQUAL(1, vals[1]);
+    TEST_ASSERT_EQUAL(4, vals[2]);
+    TEST_ASSERT_EQUAL(1234, timestamp);
+
+    // Timestamp is optional
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+        ADC_GetChannels(&adcConfig, channels, vals, 3, NULL));
+
+    // Any invalid channel fails the whole read
+    const ADC_Channel_T badChannels[2] = {
+        ADC_CONVERSIONCHANNEL0, ADC_CONVERSIONCHANNEL5
+    };
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_INVALID_CHANNEL,
+        ADC_GetChannels(&adcConfig, badChannels, vals, 2, NULL));
+    TEST_ASSERT_EQUAL(0, vals[0]);
+    TEST_ASSERT_EQUAL(0, vals[1]);
+
+    mockSet_HAL_GetTick(0);
+}
+
+TEST(IO_ADC, TestAdcGetAll)
+{
+    setTestNumChannels(3);
+    setTestMode(ADC_MULTIMODE_DUAL_SIMULT);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
+
+    ADC_Snapshot_T snapshot;
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_DATANOTREADY, ADC_GetAll(&adcConfig, &snapshot));
+    TEST_ASSERT_EQUAL(0, snapshot.numChannels);
+
+    for (uint16_t cycle = 1; cycle <= 5; ++cycle) {
+        uint16_t dataRaw[6];
+        for (uint16_t i = 0; i < 6; ++i) {
+            dataRaw[i] = (uint16_t)(cycle * 100 + i);
+        }
+        mockSetADCData(dataRaw, 6);
+        mockSet_HAL_GetTick(cycle * 10U);
+        HAL_ADC_ConvHalfCpltCallback(&hadc1);
+        HAL_ADC_ConvCpltCallback(&hadc1);
+
+        TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_GetAll(&adcConfig, &snapshot));
+        TEST_ASSERT_EQUAL(6, snapshot.numChannels);
+        TEST_ASSERT_EQUAL(cycle, snapshot.sequence);
+        TEST_ASSERT_EQUAL(cycle * 10U, snapshot.timestamp);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(dataRaw, snapshot.values, 6);
+    }
+
+    mockSet_HAL_GetTick(0);
+}
+
+TEST(IO_ADC, TestAdcReadConsistency)
+{
+    setTestNumChannels(4);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
+
+    // Reader started on set 1
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    HAL_ADC_ConvCpltCallback(&hadc1);
+    const uint32_t seqStart = adcConfig.sequence;
+    TEST_ASSERT_TRUE(readConsistent(&adcConfig, seqStart));
+
+    // Set 2 published - buffer of set 1 untouched
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    HAL_ADC_ConvCpltCallback(&hadc1);
+    TEST_ASSERT_TRUE(readConsistent(&adcConfig, seqStart));
+
+    // Set 3 published, and set 4 is now being copied to set 1's buffer
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    HAL_ADC_ConvCpltCallback(&hadc1);
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    TEST_ASSERT_FALSE(readConsistent(&adcConfig, seqStart));
+
+    // Sequence wraps without changing buffer order or returning to 0
+    TEST_ASSERT_EQUAL(ADC_NUM_SAMPLE_BUFFERS, nextSequence(UINT32_MAX - 1U));
+    TEST_ASSERT_EQUAL(((UINT32_MAX - 1U) % ADC_NUM_SAMPLE_BUFFERS + 1U) % ADC_NUM_SAMPLE_BUFFERS,
+        nextSequence(UINT32_MAX - 1U) % ADC_NUM_SAMPLE_BUFFERS);
+}
+
+TEST(IO_ADC, TestAdcWatchdog)
+{
+    setTestNumChannels(4);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
+
+    // Invalid channel
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_INVALID_CHANNEL,
+        ADC_ConfigWatchdog(&adcConfig, ADC_CONVERSIONCHANNEL4, ADC_CHANNEL_4, 100, 200));
+
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+        ADC_ConfigWatchdog(&adcConfig, ADC_CONVERSIONCHANNEL2, ADC_CHANNEL_8, 100, 3900));
+    ADC_AnalogWDGConfTypeDef awdConfig = mockGet_HAL_ADC_AnalogWDGConfig(&hadc1);
+    TEST_ASSERT_EQUAL(ADC_ANALOGWATCHDOG_SINGLE_REG, awdConfig.WatchdogMode);
+    TEST_ASSERT_EQUAL(ADC_CHANNEL_8, awdConfig.Channel);
+    TEST_ASSERT_EQUAL(100, awdConfig.LowThreshold);
+    TEST_ASSERT_EQUAL(3900, awdConfig.HighThreshold);
+    TEST_ASSERT_TRUE(mockGet_HAL_ADC_AWDInterruptEnabled(&hadc1));
+
+    // Only one watchdog per ADC. Reconfiguring the same channel is ok.
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_WATCHDOG,
+        ADC_ConfigWatchdog(&adcConfig, ADC_CONVERSIONCHANNEL3, ADC_CHANNEL_9, 100, 3900));
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+        ADC_ConfigWatchdog(&adcConfig, ADC_CONVERSIONCHANNEL2, ADC_CHANNEL_8, 200, 3800));
+
+    // No event yet
+    uint32_t timestamp = 0xFFFFFFFF;
+    TEST_ASSERT_FALSE(ADC_GetWatchdogEvent(&adcConfig, ADC_CONVERSIONCHANNEL2, &timestamp));
+    TEST_ASSERT_EQUAL(0xFFFFFFFF, timestamp);
+
+    // Out of window. The interrupt is disabled until the event is collected,
+    // and the time of the first event is kept.
+    mockSet_HAL_GetTick(55);
+    HAL_ADC_LevelOutOfWindowCallback(&hadc1);
+    TEST_ASSERT_FALSE(mockGet_HAL_ADC_AWDInterruptEnabled(&hadc1));
+    mockSet_HAL_GetTick(56);
+    HAL_ADC_LevelOutOfWindowCallback(&hadc1);
+
+    TEST_ASSERT_FALSE(ADC_GetWatchdogEvent(&adcConfig, ADC_CONVERSIONCHANNEL3, &timestamp));
+    TEST_ASSERT_TRUE(ADC_GetWatchdogEvent(&adcConfig, ADC_CONVERSIONCHANNEL2, &timestamp));
+    TEST_ASSERT_EQUAL(55, timestamp);
+    TEST_ASSERT_TRUE(mockGet_HAL_ADC_AWDInterruptEnabled(&hadc1));
+
+    // Event is cleared once collected
+    TEST_ASSERT_FALSE(ADC_GetWatchdogEvent(&adcConfig, ADC_CONVERSIONCHANNEL2, NULL));
+
+    mockSet_HAL_GetTick(0);
+}
+
+TEST(IO_ADC, TestAdcWatchdogMultiMode)
+{
+    setTestNumChannels(2);
+    setTestMode(ADC_MULTIMODE_DUAL_SIMULT);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_Init(&adcConfig));
+
+    // Redundant pair on the same rank are on different ADCs
+    const ADC_Channel_T channelA = ADC_MULTIMODE_CHANNEL(1, 0, 2);
+    const ADC_Channel_T channelB = ADC_MULTIMODE_CHANNEL(1, 1, 2);
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+        ADC_ConfigWatchdog(&adcConfig, channelA, ADC_CHANNEL_8, 100, 200));
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK,
+        ADC_ConfigWatchdog(&adcConfig, channelB, ADC_CHANNEL_9, 300, 400));
+    TEST_ASSERT_EQUAL(ADC_CHANNEL_8, mockGet_HAL_ADC_AnalogWDGConfig(&hadc1).Channel);
+    TEST_ASSERT_EQUAL(ADC_CHANNEL_9, mockGet_HAL_ADC_AnalogWDGConfig(&hadc2).Channel);
+    TEST_ASSERT_EQUAL(300, mockGet_HAL_ADC_AnalogWDGConfig(&hadc2).LowThreshold);
+
+    // Slave ADC interrupt maps to its channel
+    HAL_ADC_LevelOutOfWindowCallback(&hadc2);
+    TEST_ASSERT_FALSE(ADC_GetWatchdogEvent(&adcConfig, channelA, NULL));
+    TEST_ASSERT_TRUE(ADC_GetWatchdogEvent(&adcConfig, channelB, NULL));
+
+    // Unknown handle is ignored
+    HAL_ADC_LevelOutOfWindowCallback(&hadc3);
+    TEST_ASSERT_FALSE(ADC_GetWatchdogEvent(&adcConfig, channelA, NULL));
+
+    // HAL config failure
+    mockSet_HAL_ADC_AnalogWDGConfig_Status(HAL_ERROR);
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_WATCHDOG,
+        ADC_ConfigWatchdog(&adcConfig, channelA, ADC_CHANNEL_8, 100, 200));
+    mockSet_HAL_ADC_AnalogWDGConfig_Status(HAL_OK);
+}
+
 TEST(IO_ADC, TestAdcScaling)
 {
     ADC_Scaling_T scaling = {
@@ -276,6 +614,67 @@ TEST(IO_ADC, TestAdcScaling)
     TEST_ASSERT_EQUAL_FLOAT(64.535f, ADC_ApplyScaling(&scaling, 0xFFFF));
 }
 
+TEST(IO_ADC, TestAdcScalingTable)
+{
+    const ADC_Scaling_T scalings[5] = {
+        { .lowerScaling = 1000, .upperScaling = 2000, .saturate = true },
+        { .lowerScaling = 1000, .upperScaling = 2000, .saturate = false },
+        { .lowerScaling = 3000, .upperScaling = 1000, .saturate = true }, // inverted
+        { .lowerScaling = 0, .upperScaling = 4095, .saturate = false },
+        { .lowerScaling = 3000, .upperScaling = 1000, .saturate = true },
+    };
+    ADC_ScalingTable_T table;
+    TEST_ASSERT_EQUAL(ADC_STATUS_OK, ADC_CompileScaling(&table, scalings, 5));
+    TEST_ASSERT_EQUAL(5, table.numEntries);
+    TEST_ASSERT_EQUAL(4294967, table.gain[0]);
+    TEST_ASSERT_EQUAL(-2147484, table.gain[2]);
+
+    // Bit-exact expected results
+    const uint16_t raw[5] = {1500, 999, 2500, 4095, 0};
+    const int32_t expectedQ16[5] = {32768, -66, 16384, 65536, 65536};
+    int32_t outQ16[5];
+    float outFloat[5];
+    ADC_ApplyScalingTable(&table, raw, outQ16, outFloat);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(expectedQ16, outQ16, 5);
+    for (uint16_t i = 0; i < 5; ++i) {
+        TEST_ASSERT_TRUE((float)expectedQ16[i] / 65536.0f == outFloat[i]);
+    }
+
+    // Either output is optional
+    float outFloat2[5];
+    ADC_ApplyScalingTable(&table, raw, NULL, outFloat2);
+    TEST_ASSERT_EQUAL_MEMORY(outFloat, outFloat2, sizeof(outFloat));
+    ADC_ApplyScalingTable(&table, raw, outQ16, NULL);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(expectedQ16, outQ16, 5);
+
+    // Within Q16 resolution of the float scaling over the whole range
+    for (uint16_t r = 0; r <= 4095; ++r) {
+        const uint16_t rawSweep[5] = {r, r, r, r, r};
+        ADC_ApplyScalingTable(&table, rawSweep, NULL, outFloat);
+        for (uint16_t i = 0; i < 5; ++i) {
+            TEST_ASSERT_FLOAT_WITHIN(1.0f / 32768.0f,
+                ADC_ApplyScaling(&scalings[i], r), outFloat[i]);
+        }
+    }
+}
+
+TEST(IO_ADC, TestAdcScalingTableInvalid)
+{
+    ADC_ScalingTable_T table;
+
+    // Range too narrow
+    const ADC_Scaling_T narrow[2] = {
+        { .lowerScaling = 1000, .upperScaling = 2000, .saturate = true },
+        { .lowerScaling = 1000, .upperScaling = 998, .saturate = true },
+    };
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_SCALING, ADC_CompileScaling(&table, narrow, 2));
+    TEST_ASSERT_EQUAL(0, table.numEntries);
+
+    // Too many entries
+    TEST_ASSERT_EQUAL(ADC_STATUS_ERROR_SCALING,
+        ADC_CompileScaling(&table, narrow, ADC_MAX_NUM_CHANNELS + 1));
+}
+
 TEST_GROUP_RUNNER(IO_ADC)
 {
     RUN_TEST_CASE(IO_ADC, TestAdcInitOk);
@@ -284,8 +683,20 @@ TEST_GROUP_RUNNER(IO_ADC)
     RUN_TEST_CASE(IO_ADC, TestAdcConfigDmaError);
     RUN_TEST_CASE(IO_ADC, TestAdcGetNotReady);
     RUN_TEST_CASE(IO_ADC, TestAdcInterruptHalf);
+    RUN_TEST_CASE(IO_ADC, TestAdcDataSingle);
     RUN_TEST_CASE(IO_ADC, TestAdcDataMultipleSamples);
+    RUN_TEST_CASE(IO_ADC, TestAdcDualSimultaneous);
+    RUN_TEST_CASE(IO_ADC, TestAdcTripleModes);
+    RUN_TEST_CASE(IO_ADC, TestAdcMultiModeHwConfig);
+    RUN_TEST_CASE(IO_ADC, TestAdcMultipleInstances);
+    RUN_TEST_CASE(IO_ADC, TestAdcGetChannels);
+    RUN_TEST_CASE(IO_ADC, TestAdcGetAll);
+    RUN_TEST_CASE(IO_ADC, TestAdcReadConsistency);
+    RUN_TEST_CASE(IO_ADC, TestAdcWatchdog);
+    RUN_TEST_CASE(IO_ADC, TestAdcWatchdogMultiMode);
     RUN_TEST_CASE(IO_ADC, TestAdcScaling);
+    RUN_TEST_CASE(IO_ADC, TestAdcScalingTable);
+    RUN_TEST_CASE(IO_ADC, TestAdcScalingTableInvalid);
 }
 
 #define INVOKE_TEST IO_ADC
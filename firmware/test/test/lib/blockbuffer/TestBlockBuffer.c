@@ -0,0 +1,240 @@
+/*
+ * TestBlockBuffer.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "unity.h"
+#include "unity_fixture.h"
+
+#include <string.h>
+
+// source code under test
+#include "blockbuffer/blockbuffer.c"
+
+#define SAMPLE_LEN 2U
+#define SAMPLES_PER_BLOCK 3U
+#define NUM_BLOCKS 2U
+#define BLOCK_LEN BLOCKBUFFER_BLOCK_LEN(SAMPLE_LEN, SAMPLES_PER_BLOCK)
+#define MAX_SUNK 4U
+
+static uint8_t mStorage[BLOCKBUFFER_STORAGE_LEN(SAMPLE_LEN, SAMPLES_PER_BLOCK, NUM_BLOCKS)];
+static BlockBuffer_T mBuf;
+
+// Blocks taken by the sink
+static uint8_t mSunk[MAX_SUNK][BLOCK_LEN];
+static uint16_t mNumSunk;
+static uint16_t mSinkSpace; // blocks the sink takes before refusing
+
+static bool sink(void* context, const uint8_t* block, uint16_t len)
+{
+    TEST_ASSERT_EQUAL_PTR(&mBuf, context);
+    TEST_ASSERT_EQUAL(BLOCK_LEN, len);
+    if (0U == mSinkSpace) {
+        return false;
+    }
+    TEST_ASSERT_TRUE(mNumSunk < MAX_SUNK);
+    memcpy(mSunk[mNumSunk++], block, len);
+    mSinkSpace--;
+    return true;
+}
+
+// Puts samples numbered from first, each sample is its number twice
+static void putSamples(uint8_t first, uint8_t count, bool expectPut)
+{
+    for (uint8_t i = 0U; i < count; ++i) {
+        const uint8_t sample[SAMPLE_LEN] = { (uint8_t)(first + i), (uint8_t)(first + i) };
+        TEST_ASSERT_EQUAL(expectPut, BlockBuffer_Put(&mBuf, sample));
+    }
+}
+
+// Checks a sunk block holds its header, and samples numbered from first
+static void expectBlock(uint16_t index, uint32_t firstSample, uint32_t dropped, uint8_t first)
+{
+    uint8_t expected[BLOCK_LEN] = {
+        (uint8_t)(firstSample >> 24), (uint8_t)(firstSample >> 16),
+        (uint8_t)(firstSample >> 8), (uint8_t)firstSample,
+        (uint8_t)(dropped >> 24), (uint8_t)(dropped >> 16),
+        (uint8_t)(dropped >> 8), (uint8_t)dropped,
+    };
+    for (uint8_t i = 0U; i < SAMPLES_PER_BLOCK; ++i) {
+        expected[BLOCKBUFFER_HEADER_LEN + i * SAMPLE_LEN] = (uint8_t)(first + i);
+        expected[BLOCKBUFFER_HEADER_LEN + i * SAMPLE_LEN + 1U] = (uint8_t)(first + i);
+    }
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, mSunk[index], BLOCK_LEN);
+}
+
+TEST_GROUP(LIB_BLOCKBUFFER);
+
+TEST_SETUP(LIB_BLOCKBUFFER)
+{
+    memset(&mBuf, 0, sizeof(mBuf));
+    memset(mStorage, 0, sizeof(mStorage));
+    memset(mSunk, 0, sizeof(mSunk));
+    mNumSunk = 0U;
+    mSinkSpace = MAX_SUNK;
+
+    mBuf.storage = mStorage;
+    mBuf.sampleLen = SAMPLE_LEN;
+    mBuf.samplesPerBlock = SAMPLES_PER_BLOCK;
+    mBuf.numBlocks = NUM_BLOCKS;
+    TEST_ASSERT_TRUE(BlockBuffer_Init(&mBuf));
+}
+
+TEST_TEAR_DOWN(LIB_BLOCKBUFFER)
+{
+    // Empty
+}
+
+TEST(LIB_BLOCKBUFFER, TestInitInvalid)
+{
+    mBuf.numBlocks = 3U;
+    TEST_ASSERT_FALSE(BlockBuffer_Init(&mBuf));
+    mBuf.numBlocks = 0U;
+    TEST_ASSERT_FALSE(BlockBuffer_Init(&mBuf));
+    mBuf.numBlocks = NUM_BLOCKS;
+
+    mBuf.sampleLen = 0U;
+    TEST_ASSERT_FALSE(BlockBuffer_Init(&mBuf));
+    mBuf.sampleLen = 0x8000U; // block over 64k
+    TEST_ASSERT_FALSE(BlockBuffer_Init(&mBuf));
+    mBuf.sampleLen = SAMPLE_LEN;
+
+    mBuf.samplesPerBlock = 0U;
+    TEST_ASSERT_FALSE(BlockBuffer_Init(&mBuf));
+    mBuf.samplesPerBlock = SAMPLES_PER_BLOCK;
+
+    mBuf.storage = NULL;
+    TEST_ASSERT_FALSE(BlockBuffer_Init(&mBuf));
+}
+
+TEST(LIB_BLOCKBUFFER, TestStoppedTakesNothing)
+{
+    putSamples(0U, 2U * SAMPLES_PER_BLOCK, false);
+    TEST_ASSERT_EQUAL(0U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    TEST_ASSERT_EQUAL(0U, mBuf.dropped);
+}
+
+TEST(LIB_BLOCKBUFFER, TestWholeBlocks)
+{
+    BlockBuffer_Start(&mBuf);
+
+    // A partial block isn't flushed
+    putSamples(10U, SAMPLES_PER_BLOCK - 1U, true);
+    TEST_ASSERT_EQUAL(0U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+
+    putSamples(12U, 1U, true);
+    putSamples(13U, SAMPLES_PER_BLOCK, true);
+    TEST_ASSERT_EQUAL(2U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    expectBlock(0U, 0U, 0U, 10U);
+    expectBlock(1U, SAMPLES_PER_BLOCK, 0U, 13U);
+
+    // Flushed blocks are reused
+    putSamples(16U, SAMPLES_PER_BLOCK, true);
+    TEST_ASSERT_EQUAL(1U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    expectBlock(2U, 2U * SAMPLES_PER_BLOCK, 0U, 16U);
+}
+
+TEST(LIB_BLOCKBUFFER, TestDropWhenFull)
+{
+    BlockBuffer_Start(&mBuf);
+    putSamples(0U, NUM_BLOCKS * SAMPLES_PER_BLOCK, true);
+
+    // No block to start, samples are dropped until one is flushed
+    putSamples(6U, 2U, false);
+    TEST_ASSERT_EQUAL(2U, mBuf.dropped);
+
+    mSinkSpace = 1U;
+    TEST_ASSERT_EQUAL(1U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    putSamples(8U, SAMPLES_PER_BLOCK, true);
+
+    mSinkSpace = MAX_SUNK;
+    TEST_ASSERT_EQUAL(2U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    expectBlock(0U, 0U, 0U, 0U);
+    expectBlock(1U, SAMPLES_PER_BLOCK, 0U, 3U);
+    expectBlock(2U, 8U, 2U, 8U); // samples 6 and 7 were dropped
+}
+
+TEST(LIB_BLOCKBUFFER, TestDropByProducer)
+{
+    TEST_ASSERT_FALSE(BlockBuffer_IsRunning(&mBuf));
+    BlockBuffer_Drop(&mBuf);
+    TEST_ASSERT_EQUAL(0U, mBuf.dropped);
+
+    BlockBuffer_Start(&mBuf);
+    TEST_ASSERT_TRUE(BlockBuffer_IsRunning(&mBuf));
+    putSamples(0U, SAMPLES_PER_BLOCK, true);
+
+    // Sample 5 is dropped, which takes 3 and 4 with it
+    putSamples(3U, 2U, true);
+    BlockBuffer_Drop(&mBuf);
+    TEST_ASSERT_EQUAL(3U, mBuf.dropped);
+    putSamples(6U, SAMPLES_PER_BLOCK, true);
+
+    TEST_ASSERT_EQUAL(2U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    expectBlock(0U, 0U, 0U, 0U);
+    expectBlock(1U, 6U, 3U, 6U);
+}
+
+TEST(LIB_BLOCKBUFFER, TestSinkRefuses)
+{
+    BlockBuffer_Start(&mBuf);
+    putSamples(0U, SAMPLES_PER_BLOCK, true);
+
+    // The block stays until the sink takes it
+    mSinkSpace = 0U;
+    TEST_ASSERT_EQUAL(0U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    TEST_ASSERT_EQUAL(0U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+
+    mSinkSpace = MAX_SUNK;
+    TEST_ASSERT_EQUAL(1U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    expectBlock(0U, 0U, 0U, 0U);
+    TEST_ASSERT_EQUAL(0U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+}
+
+TEST(LIB_BLOCKBUFFER, TestStopStart)
+{
+    BlockBuffer_Start(&mBuf);
+    putSamples(0U, SAMPLES_PER_BLOCK + 1U, true);
+
+    // Full blocks can still be flushed, the partial block is discarded
+    BlockBuffer_Stop(&mBuf);
+    putSamples(4U, 1U, false);
+    TEST_ASSERT_EQUAL(1U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    expectBlock(0U, 0U, 0U, 0U);
+
+    BlockBuffer_Start(&mBuf);
+    putSamples(20U, SAMPLES_PER_BLOCK, true);
+    TEST_ASSERT_EQUAL(1U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+    expectBlock(1U, SAMPLES_PER_BLOCK + 1U, 0U, 20U);
+}
+
+TEST(LIB_BLOCKBUFFER, TestStartDiscardsBlocks)
+{
+    BlockBuffer_Start(&mBuf);
+    putSamples(0U, SAMPLES_PER_BLOCK, true);
+    BlockBuffer_Stop(&mBuf);
+
+    BlockBuffer_Start(&mBuf);
+    TEST_ASSERT_EQUAL(0U, BlockBuffer_Flush(&mBuf, sink, &mBuf));
+
+    // Every block is free again
+    putSamples(3U, NUM_BLOCKS * SAMPLES_PER_BLOCK, true);
+    TEST_ASSERT_EQUAL(0U, mBuf.dropped);
+}
+
+TEST_GROUP_RUNNER(LIB_BLOCKBUFFER)
+{
+    RUN_TEST_CASE(LIB_BLOCKBUFFER, TestInitInvalid);
+    RUN_TEST_CASE(LIB_BLOCKBUFFER, TestStoppedTakesNothing);
+    RUN_TEST_CASE(LIB_BLOCKBUFFER, TestWholeBlocks);
+    RUN_TEST_CASE(LIB_BLOCKBUFFER, TestDropWhenFull);
+    RUN_TEST_CASE(LIB_BLOCKBUFFER, TestDropByProducer);
+    RUN_TEST_CASE(LIB_BLOCKBUFFER, TestSinkRefuses);
+    RUN_TEST_CASE(LIB_BLOCKBUFFER, TestStopStart);
+    RUN_TEST_CASE(LIB_BLOCKBUFFER, TestStartDiscardsBlocks);
+}
+
+#define INVOKE_TEST LIB_BLOCKBUFFER
+#include "test_main.h"
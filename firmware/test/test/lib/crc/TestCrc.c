@@ -12,6 +12,7 @@
 #include "stm32_hal/MockStm32f7xx_hal.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "task.h"
 
 #include "logging/MockLogging.h"
 
@@ -19,7 +20,10 @@
 #include "crc/crc.c"
 
 static Logging_T testLog;
+static CRC_TypeDef crcInstance;
 static CRC_HandleTypeDef hcrc;
+static DMA_HandleTypeDef hdma;
+static uint8_t mData[3U * CRC_DMA_MAX_LEN];
 
 static CRC_T mCrc;
 
@@ -32,6 +36,16 @@ TEST_SETUP(LIB_CRC)
     TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_EnableSWO(&testLog));
     mockLogClear();
     hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+    hcrc.Instance = &crcInstance;
+    mCrc.hcrc = &hcrc;
+    mCrc.hdma = &hdma;
+    mCrc.dmaIrq = DMA2_Stream4_IRQn;
+    HAL_NVIC_EnableIRQ(DMA2_Stream4_IRQn);
+    mockReset_HAL_DMA();
+    mockSetTaskNotifyValue(0U);
+    for (uint32_t i = 0; i < sizeof(mData); ++i) {
+        mData[i] = (uint8_t)(i * 7U);
+    }
 
     // start CRC
     CRC_Status_T status = CRC_Init(&testLog, &mCrc);
@@ -42,6 +56,31 @@ TEST_SETUP(LIB_CRC)
 TEST_TEAR_DOWN(LIB_CRC)
 {
     TEST_ASSERT_FALSE(mockSempahoreGetLocked(mCrc.mutex));
+    TEST_ASSERT_TRUE(mockGet_HAL_Cortex_IRQEnabled(DMA2_Stream4_IRQn));
+}
+
+/**
+ * @brief Runs the DMA transfer in progress through the mock CRC unit, then
+ * completes it as the DMA interrupt would
+ */
+static void completeDma(void)
+{
+    TEST_ASSERT_TRUE(mockGet_HAL_DMA_Busy());
+    TEST_ASSERT_EQUAL_PTR(&crcInstance.DR, (void*)mockGet_HAL_DMA_DstAddress());
+    mockFeed_CRC(
+        &crcInstance,
+        (const uint8_t*)mockGet_HAL_DMA_SrcAddress(),
+        mockGet_HAL_DMA_DataLength());
+    mockComplete_HAL_DMA(&hdma);
+}
+
+static void makeRequest(CRC_Request_T* req, const uint8_t* data, uint32_t len)
+{
+    memset(req, 0U, sizeof(*req));
+    req->data = data;
+    req->len = len;
+    req->task = (TaskHandle_t)1U;
+    CRC32_Begin(&req->ctx);
 }
 
 TEST(LIB_CRC, TestInitOk)
@@ -69,6 +108,40 @@ TEST(LIB_CRC, TestCrcOK)
     
     TEST_ASSERT_TRUE(ret);
     TEST_ASSERT_EQUAL(testCrc, crc);
+    TEST_ASSERT_EQUAL_HEX32(CRC32_INIT, crcInstance.INIT);
+}
+
+TEST(LIB_CRC, TestUpdateOK)
+{
+    uint8_t tempBuffer[4] = {1, 2, 3, 4};
+    CRC32_Ctx_T ctx;
+    CRC32_Begin(&ctx);
+
+    // First block starts from the initial value
+    mockSet_CRC(0x12345678U);
+    TEST_ASSERT_TRUE(CRC_Update(&mCrc, &ctx, tempBuffer, sizeof(tempBuffer), 10U));
+    TEST_ASSERT_EQUAL_HEX32(CRC32_INIT, crcInstance.INIT);
+    TEST_ASSERT_EQUAL_HEX32(0x12345678U, CRC32_Finish(&ctx));
+
+    // Next carries on from the running CRC
+    mockSet_CRC(0xAABBCCDDU);
+    TEST_ASSERT_TRUE(CRC_Update(&mCrc, &ctx, tempBuffer, sizeof(tempBuffer), 10U));
+    TEST_ASSERT_EQUAL_HEX32(0x12345678U, crcInstance.INIT);
+    TEST_ASSERT_EQUAL_HEX32(0xAABBCCDDU, CRC32_Finish(&ctx));
+}
+
+TEST(LIB_CRC, TestUpdateMutexTimeout)
+{
+    uint8_t tempBuffer[4] = {1, 2, 3, 4};
+    CRC32_Ctx_T ctx;
+    CRC32_Begin(&ctx);
+    mockSet_CRC(0x12345678U);
+    mockSemaphoreSetLocked(mCrc.mutex, true);
+
+    TEST_ASSERT_FALSE(CRC_Update(&mCrc, &ctx, tempBuffer, sizeof(tempBuffer), 10U));
+    TEST_ASSERT_EQUAL_HEX32(CRC32_INIT, CRC32_Finish(&ctx));
+
+    mockSemaphoreSetLocked(mCrc.mutex, false);
 }
 
 TEST(LIB_CRC, TestMutexTimeout)
@@ -96,11 +169,217 @@ TEST(LIB_CRC, TestMutexTimeout)
     mockSemaphoreSetLocked(mCrc.mutex, false);
 }
 
+TEST(LIB_CRC, TestAsyncOK)
+{
+    CRC_Request_T req;
+    makeRequest(&req, mData, 1000U);
+
+    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &req, 10U));
+    TEST_ASSERT_FALSE(req.done);
+    TEST_ASSERT_EQUAL(1000U, mockGet_HAL_DMA_DataLength());
+    TEST_ASSERT_EQUAL(0U, mockGetTaskNotifyValue());
+
+    completeDma();
+    TEST_ASSERT_TRUE(req.done);
+    TEST_ASSERT_EQUAL(1U, mockGetTaskNotifyValue());
+    TEST_ASSERT_TRUE(CRC_WaitAsync(&req, 10U));
+    TEST_ASSERT_EQUAL_HEX32(CRC32_Calculate(mData, 1000U), CRC32_Finish(&req.ctx));
+    TEST_ASSERT_FALSE(mockGet_HAL_DMA_Busy());
+    TEST_ASSERT_FALSE(mCrc.asyncRunning);
+}
+
+TEST(LIB_CRC, TestAsyncCarriesOn)
+{
+    // Same as CRC_Update, the request carries on from its ctx
+    CRC_Request_T req;
+    makeRequest(&req, mData + 100U, 200U);
+    CRC32_Update(&req.ctx, mData, 100U);
+
+    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &req, 10U));
+    completeDma();
+    TEST_ASSERT_TRUE(req.ok);
+    TEST_ASSERT_EQUAL_HEX32(CRC32_Calculate(mData, 300U), CRC32_Finish(&req.ctx));
+}
+
+TEST(LIB_CRC, TestAsyncQueued)
+{
+    // Requests from different callers run in order, each notified when done
+    CRC_Request_T reqs[3];
+    const uint32_t lens[3] = { 10U, 4096U, 1U };
+    for (uint8_t i = 0U; i < 3U; ++i) {
+        makeRequest(&reqs[i], mData + i, lens[i]);
+        TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &reqs[i], 10U));
+    }
+    TEST_ASSERT_EQUAL(1U, mockGet_HAL_DMA_StartCount());
+
+    for (uint8_t i = 0U; i < 3U; ++i) {
+        TEST_ASSERT_FALSE(reqs[i].done);
+        TEST_ASSERT_EQUAL_PTR(mData + i, (void*)mockGet_HAL_DMA_SrcAddress());
+        completeDma();
+        TEST_ASSERT_TRUE(reqs[i].done);
+        TEST_ASSERT_TRUE(reqs[i].ok);
+        TEST_ASSERT_EQUAL(i + 1U, mockGetTaskNotifyValue());
+        TEST_ASSERT_EQUAL_HEX32(CRC32_Calculate(mData + i, lens[i]), CRC32_Finish(&reqs[i].ctx));
+    }
+    TEST_ASSERT_FALSE(mockGet_HAL_DMA_Busy());
+    TEST_ASSERT_EQUAL(3U, mockGet_HAL_DMA_StartCount());
+}
+
+TEST(LIB_CRC, TestAsyncChunked)
+{
+    // DMA moves at most CRC_DMA_MAX_LEN bytes per transfer
+    CRC_Request_T req;
+    makeRequest(&req, mData, sizeof(mData) - 10U);
+    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &req, 10U));
+
+    TEST_ASSERT_EQUAL(CRC_DMA_MAX_LEN, mockGet_HAL_DMA_DataLength());
+    completeDma();
+    TEST_ASSERT_FALSE(req.done);
+    TEST_ASSERT_EQUAL_PTR(mData + CRC_DMA_MAX_LEN, (void*)mockGet_HAL_DMA_SrcAddress());
+    completeDma();
+    TEST_ASSERT_FALSE(req.done);
+    TEST_ASSERT_EQUAL(CRC_DMA_MAX_LEN - 10U, mockGet_HAL_DMA_DataLength());
+    completeDma();
+
+    TEST_ASSERT_TRUE(req.done);
+    TEST_ASSERT_EQUAL(1U, mockGetTaskNotifyValue());
+    TEST_ASSERT_EQUAL_HEX32(CRC32_Calculate(mData, sizeof(mData) - 10U), CRC32_Finish(&req.ctx));
+}
+
+TEST(LIB_CRC, TestAsyncQueueFull)
+{
+    CRC_Request_T reqs[CRC_ASYNC_QUEUE_LEN + 1U];
+    for (uint8_t i = 0U; i < CRC_ASYNC_QUEUE_LEN; ++i) {
+        makeRequest(&reqs[i], mData, 16U);
+        TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &reqs[i], 10U));
+    }
+    makeRequest(&reqs[CRC_ASYNC_QUEUE_LEN], mData, 16U);
+    TEST_ASSERT_EQUAL(CRC_STATUS_ERROR_BUSY, CRC_CalculateAsync(&mCrc, &reqs[CRC_ASYNC_QUEUE_LEN], 10U));
+
+    // Space again once one finishes
+    completeDma();
+    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &reqs[CRC_ASYNC_QUEUE_LEN], 10U));
+    for (uint8_t i = 0U; i < CRC_ASYNC_QUEUE_LEN; ++i) {
+        completeDma();
+    }
+    for (uint8_t i = 0U; i <= CRC_ASYNC_QUEUE_LEN; ++i) {
+        TEST_ASSERT_TRUE(reqs[i].ok);
+    }
+    TEST_ASSERT_EQUAL(CRC_ASYNC_QUEUE_LEN + 1U, mockGetTaskNotifyValue());
+}
+
+TEST(LIB_CRC, TestAsyncMutexTimeout)
+{
+    CRC_Request_T req;
+    makeRequest(&req, mData, 16U);
+    mockSemaphoreSetLocked(mCrc.mutex, true);
+
+    TEST_ASSERT_EQUAL(CRC_STATUS_ERROR_BUSY, CRC_CalculateAsync(&mCrc, &req, 10U));
+    TEST_ASSERT_FALSE(mockGet_HAL_DMA_Busy());
+
+    mockSemaphoreSetLocked(mCrc.mutex, false);
+}
+
+TEST(LIB_CRC, TestAsyncNoDma)
+{
+    CRC_Request_T req;
+    makeRequest(&req, mData, 16U);
+    mCrc.hdma = NULL;
+
+    TEST_ASSERT_EQUAL(CRC_STATUS_ERROR, CRC_CalculateAsync(&mCrc, &req, 10U));
+}
+
+TEST(LIB_CRC, TestAsyncError)
+{
+    // A failed transfer finishes its request, and the next still runs
+    CRC_Request_T reqs[2];
+    makeRequest(&reqs[0], mData, 16U);
+    makeRequest(&reqs[1], mData, 16U);
+    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &reqs[0], 10U));
+    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &reqs[1], 10U));
+
+    mockError_HAL_DMA(&hdma);
+    TEST_ASSERT_TRUE(reqs[0].done);
+    TEST_ASSERT_FALSE(reqs[0].ok);
+    TEST_ASSERT_FALSE(CRC_WaitAsync(&reqs[0], 10U));
+    TEST_ASSERT_EQUAL_HEX32(CRC32_INIT, reqs[0].ctx.crc);
+
+    completeDma();
+    TEST_ASSERT_TRUE(CRC_WaitAsync(&reqs[1], 10U));
+}
+
+TEST(LIB_CRC, TestAsyncStartFails)
+{
+    CRC_Request_T req;
+    makeRequest(&req, mData, 16U);
+    mockSet_HAL_DMA_Start_IT_Status(HAL_ERROR);
+
+    // Queued, but finished straight away
+    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &req, 10U));
+    TEST_ASSERT_TRUE(req.done);
+    TEST_ASSERT_FALSE(req.ok);
+    TEST_ASSERT_EQUAL(1U, mockGetTaskNotifyValue());
+    TEST_ASSERT_FALSE(mCrc.asyncRunning);
+}
+
+TEST(LIB_CRC, TestAsyncWaitTimeout)
+{
+    CRC_Request_T req;
+    makeRequest(&req, mData, 16U);
+    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &req, 10U));
+
+    // Some other notification wakes the task, then nothing
+    mockSetTaskNotifyValue(1U);
+    TEST_ASSERT_FALSE(CRC_WaitAsync(&req, 10U));
+    TEST_ASSERT_FALSE(req.done);
+
+    completeDma();
+    TEST_ASSERT_TRUE(CRC_WaitAsync(&req, 10U));
+}
+
+TEST(LIB_CRC, TestSyncDuringAsync)
+{
+    // The unit is busy with DMA, so synchronous calls use software
+    CRC_Request_T req;
+    makeRequest(&req, mData, 1000U);
+    TEST_ASSERT_EQUAL(CRC_STATUS_OK, CRC_CalculateAsync(&mCrc, &req, 10U));
+    crcInstance.INIT = 0x5555U;
+    mockSet_CRC(0x12345678U);
+
+    uint32_t crc = 0U;
+    TEST_ASSERT_TRUE(CRC_Calculate(&mCrc, (void*)mData, 64U, 10U, &crc));
+    TEST_ASSERT_EQUAL_HEX32(CRC32_Calculate(mData, 64U), crc);
+
+    CRC32_Ctx_T ctx;
+    CRC32_Begin(&ctx);
+    TEST_ASSERT_TRUE(CRC_Update(&mCrc, &ctx, mData, 64U, 10U));
+    TEST_ASSERT_EQUAL_HEX32(CRC32_Calculate(mData, 64U), CRC32_Finish(&ctx));
+    TEST_ASSERT_EQUAL_HEX32(0x5555U, crcInstance.INIT);
+
+    // Hardware again once the DMA is done
+    completeDma();
+    TEST_ASSERT_TRUE(CRC_Calculate(&mCrc, (void*)mData, 64U, 10U, &crc));
+    TEST_ASSERT_EQUAL_HEX32(0x12345678U, crc);
+}
+
 TEST_GROUP_RUNNER(LIB_CRC)
 {
     RUN_TEST_CASE(LIB_CRC, TestInitOk);
     RUN_TEST_CASE(LIB_CRC, TestCrcOK);
     RUN_TEST_CASE(LIB_CRC, TestMutexTimeout);
+    RUN_TEST_CASE(LIB_CRC, TestUpdateOK);
+    RUN_TEST_CASE(LIB_CRC, TestUpdateMutexTimeout);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncOK);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncCarriesOn);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncQueued);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncChunked);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncQueueFull);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncMutexTimeout);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncNoDma);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncError);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncStartFails);
+    RUN_TEST_CASE(LIB_CRC, TestAsyncWaitTimeout);
+    RUN_TEST_CASE(LIB_CRC, TestSyncDuringAsync);
 }
 
 #define INVOKE_TEST LIB_CRC
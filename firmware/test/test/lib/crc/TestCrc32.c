@@ -0,0 +1,121 @@
+/*
+ * TestCrc32.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "unity.h"
+#include "unity_fixture.h"
+
+#include <string.h>
+
+// source code under test
+#include "crc/crc32.c"
+
+static uint8_t mData[1024 + 8];
+
+/**
+ * @brief Bit at a time, the same as crc32mpeg2 in tools/ecu-config
+ */
+static uint32_t referenceCrc(const uint8_t* data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= (uint32_t)data[i] << 24;
+        for (uint8_t bit = 0; bit < 8U; ++bit) {
+            crc = (crc & 0x80000000U) ? (crc << 1) ^ 0x04C11DB7U : crc << 1;
+        }
+    }
+    return crc;
+}
+
+TEST_GROUP(LIB_CRC32);
+
+TEST_SETUP(LIB_CRC32)
+{
+    uint32_t lcg = 1U;
+    for (size_t i = 0; i < sizeof(mData); ++i) {
+        lcg = lcg * 1103515245U + 12345U;
+        mData[i] = (uint8_t)(lcg >> 24);
+    }
+}
+
+TEST_TEAR_DOWN(LIB_CRC32)
+{
+    // Empty
+}
+
+TEST(LIB_CRC32, TestKnownValues)
+{
+    // Values from crc32mpeg2 in tools/ecu-config
+    const uint8_t check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0x0376E6E7U, CRC32_Calculate(check, sizeof(check) - 1U));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFFU, CRC32_Calculate(check, 0U));
+
+    static uint8_t counting[1024];
+    for (size_t i = 0; i < sizeof(counting); ++i) {
+        counting[i] = (uint8_t)i;
+    }
+    TEST_ASSERT_EQUAL_HEX32(0x1A5C3E13U, CRC32_Calculate(counting, sizeof(counting)));
+}
+
+TEST(LIB_CRC32, TestMatchesReference)
+{
+    // Every length and alignment around the 8 byte steps
+    for (size_t offset = 0; offset < 8U; ++offset) {
+        for (size_t len = 0; len <= 64U; ++len) {
+            TEST_ASSERT_EQUAL_HEX32(referenceCrc(mData + offset, len), CRC32_Calculate(mData + offset, len));
+        }
+    }
+    TEST_ASSERT_EQUAL_HEX32(referenceCrc(mData + 3, 1024U), CRC32_Calculate(mData + 3, 1024U));
+}
+
+TEST(LIB_CRC32, TestIncremental)
+{
+    const uint32_t expected = referenceCrc(mData, 300U);
+
+    // Split anywhere
+    for (size_t split = 0; split <= 300U; ++split) {
+        CRC32_Ctx_T ctx;
+        CRC32_Begin(&ctx);
+        CRC32_Update(&ctx, mData, split);
+        CRC32_Update(&ctx, mData + split, 300U - split);
+        TEST_ASSERT_EQUAL_HEX32(expected, CRC32_Finish(&ctx));
+    }
+
+    // A byte at a time
+    CRC32_Ctx_T ctx;
+    CRC32_Begin(&ctx);
+    for (size_t i = 0; i < 300U; ++i) {
+        CRC32_Update(&ctx, &mData[i], 1U);
+    }
+    TEST_ASSERT_EQUAL_HEX32(expected, CRC32_Finish(&ctx));
+}
+
+TEST(LIB_CRC32, TestResidue)
+{
+    // Message followed by its CRC, most significant byte first
+    uint8_t msg[20];
+    memcpy(msg, mData, 16U);
+    const uint32_t crc = CRC32_Calculate(msg, 16U);
+    msg[16] = (uint8_t)(crc >> 24);
+    msg[17] = (uint8_t)(crc >> 16);
+    msg[18] = (uint8_t)(crc >> 8);
+    msg[19] = (uint8_t)(crc >> 0);
+    TEST_ASSERT_EQUAL_HEX32(CRC32_RESIDUE, CRC32_Calculate(msg, sizeof(msg)));
+
+    msg[5] ^= 0x10;
+    TEST_ASSERT_TRUE(CRC32_RESIDUE != CRC32_Calculate(msg, sizeof(msg)));
+}
+
+TEST_GROUP_RUNNER(LIB_CRC32)
+{
+    RUN_TEST_CASE(LIB_CRC32, TestKnownValues);
+    RUN_TEST_CASE(LIB_CRC32, TestMatchesReference);
+    RUN_TEST_CASE(LIB_CRC32, TestIncremental);
+    RUN_TEST_CASE(LIB_CRC32, TestResidue);
+}
+
+#define INVOKE_TEST LIB_CRC32
+#include "test_main.h"
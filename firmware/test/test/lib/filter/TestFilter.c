@@ -0,0 +1,252 @@
+/*
+ * TestFilter.c
+ *
+ *      Author: Liam Flaherty
+ */
+
+#include "unity.h"
+#include "unity_fixture.h"
+
+#include <string.h>
+
+// source code under test
+#include "filter/filter.c"
+
+#define Q16(x) ((int32_t)((x) * 65536))
+
+static Filter_Bank_T mBank;
+
+static void setSingleStage(Filter_Stage_T stage)
+{
+    memset(&mBank, 0, sizeof(mBank));
+    mBank.numChannels = 1;
+    mBank.chains[0].numStages = 1;
+    mBank.chains[0].stages[0] = stage;
+    TEST_ASSERT_EQUAL(FILTER_STATUS_OK, Filter_Init(&mBank));
+}
+
+static int32_t process(int32_t x)
+{
+    int32_t y;
+    Filter_Process(&mBank, &x, &y);
+    return y;
+}
+
+TEST_GROUP(LIB_FILTER);
+
+TEST_SETUP(LIB_FILTER)
+{
+    memset(&mBank, 0, sizeof(mBank));
+}
+
+TEST_TEAR_DOWN(LIB_FILTER)
+{
+}
+
+TEST(LIB_FILTER, Passthrough)
+{
+    mBank.numChannels = 2;
+    TEST_ASSERT_EQUAL(FILTER_STATUS_OK, Filter_Init(&mBank));
+    TEST_ASSERT_EQUAL(0, mBank.stateWords);
+
+    int32_t in[2] = { Q16(1), -Q16(3) };
+    int32_t out[2];
+    Filter_Process(&mBank, in, out);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(in, out, 2);
+}
+
+TEST(LIB_FILTER, InitInvalid)
+{
+    mBank.numChannels = FILTER_MAX_CHANNELS + 1;
+    TEST_ASSERT_EQUAL(FILTER_STATUS_ERROR_CONFIG, Filter_Init(&mBank));
+
+    mBank.numChannels = 1;
+    mBank.chains[0].numStages = FILTER_MAX_STAGES + 1;
+    TEST_ASSERT_EQUAL(FILTER_STATUS_ERROR_CONFIG, Filter_Init(&mBank));
+
+    const Filter_Stage_T invalid[] = {
+        { .type = FILTER_TYPE_IIR1, .coeff = { 0 } },
+        { .type = FILTER_TYPE_IIR1, .coeff = { Q16(1) + 1 } },
+        { .type = FILTER_TYPE_MEDIAN, .taps = 0 },
+        { .type = FILTER_TYPE_MEDIAN, .taps = 4 },
+        { .type = FILTER_TYPE_MEDIAN, .taps = FILTER_MEDIAN_MAX_TAPS + 2 },
+        { .type = FILTER_TYPE_SLEW, .maxStep = 0 },
+        { .type = (Filter_Type_T)99 },
+    };
+    mBank.chains[0].numStages = 1;
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        mBank.chains[0].stages[0] = invalid[i];
+        TEST_ASSERT_EQUAL(FILTER_STATUS_ERROR_CONFIG, Filter_Init(&mBank));
+    }
+}
+
+TEST(LIB_FILTER, IIR1Step)
+{
+    setSingleStage((Filter_Stage_T){ .type = FILTER_TYPE_IIR1, .coeff = { FILTER_Q16(0.5f) } });
+
+    // First sample initializes the state
+    TEST_ASSERT_EQUAL_INT32(Q16(1), process(Q16(1)));
+    TEST_ASSERT_EQUAL_INT32(Q16(1), process(Q16(1)));
+
+    // Halves the error each sample
+    TEST_ASSERT_EQUAL_INT32(Q16(3), process(Q16(5)));
+    TEST_ASSERT_EQUAL_INT32(Q16(4), process(Q16(5)));
+    TEST_ASSERT_EQUAL_INT32(Q16(4.5), process(Q16(5)));
+
+    // Converges to the input
+    for (uint16_t i = 0; i < 40; ++i) {
+        process(-Q16(2));
+    }
+    TEST_ASSERT_EQUAL_INT32(-Q16(2), process(-Q16(2)));
+}
+
+TEST(LIB_FILTER, IIR2)
+{
+    // Second order low pass, fc = 0.1fs (Butterworth, bilinear transform)
+    const float b0 = 0.06745527f;
+    const float b1 = 0.13491055f;
+    const float a1 = -1.1429805f;
+    const float a2 = 0.4128016f;
+    setSingleStage((Filter_Stage_T){
+        .type = FILTER_TYPE_IIR2,
+        .coeff = { FILTER_Q16(b0), FILTER_Q16(b1), FILTER_Q16(b0), FILTER_Q16(a1), FILTER_Q16(a2) },
+    });
+
+    // Steady state
+    TEST_ASSERT_EQUAL_INT32(0, process(0));
+    TEST_ASSERT_EQUAL_INT32(0, process(0));
+
+    // Step response matches floating point reference
+    float x1 = 0.0f, x2 = 0.0f, y1 = 0.0f, y2 = 0.0f;
+    for (uint16_t i = 0; i < 50; ++i) {
+        const float x = 100.0f;
+        float y = b0 * x + b1 * x1 + b0 * x2 - a1 * y1 - a2 * y2;
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+
+        int32_t yFixed = process(Q16(100));
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, y, (float)yFixed / 65536.0f);
+    }
+}
+
+TEST(LIB_FILTER, MedianSpike)
+{
+    setSingleStage((Filter_Stage_T){ .type = FILTER_TYPE_MEDIAN, .taps = 5 });
+
+    const int32_t in[] = { 10, 10, 500, -400, 10, 11, 12, 13, 13, 13 };
+    const int32_t expected[] = { 10, 10, 10, 10, 10, 10, 11, 11, 12, 13 };
+    for (size_t i = 0; i < sizeof(in) / sizeof(in[0]); ++i) {
+        TEST_ASSERT_EQUAL_INT32(expected[i], process(in[i]));
+    }
+}
+
+TEST(LIB_FILTER, MedianReference)
+{
+    const uint16_t taps = 7;
+    setSingleStage((Filter_Stage_T){ .type = FILTER_TYPE_MEDIAN, .taps = taps });
+
+    // Compare to sorting the window, with repeated values
+    int32_t history[7];
+    uint32_t lcg = 12345U;
+    for (uint16_t i = 0; i < 500; ++i) {
+        lcg = lcg * 1103515245U + 12345U;
+        int32_t x = (int32_t)((lcg >> 16) % 16U) - 8;
+
+        if (0 == i) {
+            for (uint16_t j = 0; j < taps; ++j) {
+                history[j] = x;
+            }
+        }
+        history[i % taps] = x;
+
+        int32_t sorted[7];
+        memcpy(sorted, history, sizeof(sorted));
+        for (uint16_t j = 1; j < taps; ++j) {
+            for (uint16_t k = j; k > 0 && sorted[k - 1] > sorted[k]; --k) {
+                int32_t tmp = sorted[k];
+                sorted[k] = sorted[k - 1];
+                sorted[k - 1] = tmp;
+            }
+        }
+
+        TEST_ASSERT_EQUAL_INT32(sorted[taps / 2], process(x));
+    }
+}
+
+TEST(LIB_FILTER, SlewLimit)
+{
+    setSingleStage((Filter_Stage_T){ .type = FILTER_TYPE_SLEW, .maxStep = Q16(1) });
+
+    TEST_ASSERT_EQUAL_INT32(Q16(2), process(Q16(2)));
+    TEST_ASSERT_EQUAL_INT32(Q16(3), process(Q16(10)));
+    TEST_ASSERT_EQUAL_INT32(Q16(3.5), process(Q16(3.5)));
+    TEST_ASSERT_EQUAL_INT32(Q16(2.5), process(-Q16(10)));
+
+    // No overflow at extremes
+    setSingleStage((Filter_Stage_T){ .type = FILTER_TYPE_SLEW, .maxStep = INT32_MAX });
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, process(INT32_MIN));
+    TEST_ASSERT_EQUAL_INT32(-1, process(INT32_MAX));
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX - 1, process(INT32_MAX));
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, process(INT32_MAX));
+}
+
+TEST(LIB_FILTER, ChainMultiChannel)
+{
+    // Channel 0: median then slew limit. Channel 1: low pass. Channel 2: none.
+    mBank.numChannels = 3;
+    mBank.chains[0] = (Filter_Chain_T){
+        .numStages = 2,
+        .stages = {
+            { .type = FILTER_TYPE_MEDIAN, .taps = 3 },
+            { .type = FILTER_TYPE_SLEW, .maxStep = 5 },
+        },
+    };
+    mBank.chains[1] = (Filter_Chain_T){
+        .numStages = 1,
+        .stages = { { .type = FILTER_TYPE_IIR1, .coeff = { FILTER_Q16(0.5f) } } },
+    };
+    TEST_ASSERT_EQUAL(FILTER_STATUS_OK, Filter_Init(&mBank));
+    TEST_ASSERT_EQUAL(FILTER_MEDIAN_STATE_WORDS(3) + 1 + 1, mBank.stateWords);
+
+    const int32_t in[][3] = {
+        { 0, 0, 7 },
+        { 100, 64, 8 },
+        { 100, 64, 9 },
+        { 100, 64, 10 },
+    };
+    const int32_t expected[][3] = {
+        { 0, 0, 7 },
+        { 0, 32, 8 },
+        { 5, 48, 9 },
+        { 10, 56, 10 },
+    };
+    for (size_t i = 0; i < 4; ++i) {
+        int32_t out[3];
+        Filter_Process(&mBank, in[i], out);
+        TEST_ASSERT_EQUAL_INT32_ARRAY(expected[i], out, 3);
+    }
+
+    // Reset re-initializes from the next sample
+    Filter_Reset(&mBank);
+    const int32_t resetIn[3] = { -20, -20, 0 };
+    int32_t out[3];
+    Filter_Process(&mBank, resetIn, out);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(resetIn, out, 3);
+}
+
+TEST_GROUP_RUNNER(LIB_FILTER)
+{
+    RUN_TEST_CASE(LIB_FILTER, Passthrough);
+    RUN_TEST_CASE(LIB_FILTER, InitInvalid);
+    RUN_TEST_CASE(LIB_FILTER, IIR1Step);
+    RUN_TEST_CASE(LIB_FILTER, IIR2);
+    RUN_TEST_CASE(LIB_FILTER, MedianSpike);
+    RUN_TEST_CASE(LIB_FILTER, MedianReference);
+    RUN_TEST_CASE(LIB_FILTER, SlewLimit);
+    RUN_TEST_CASE(LIB_FILTER, ChainMultiChannel);
+}
+
+#define INVOKE_TEST LIB_FILTER
+#include "test_main.h"
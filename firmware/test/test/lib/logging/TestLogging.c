@@ -20,6 +20,9 @@
 #include "task.h"
 #include "stream_buffer.h"
 
+// Debug logs are compiled out
+#define LOGGING_BUILD_LEVEL LOGGING_LEVEL_INFO
+
 // source code under test
 #include "logging/logging.c"
 
@@ -29,6 +32,25 @@ static StreamBufferHandle_t mSerialStream = (StreamBufferHandle_t)&mStreamBufSta
 
 #define STREAM_BUFFER_MAX_LEN 512
 
+// Format string a deferred record was printed with
+static const char* recordFormat(const uint8_t* record)
+{
+    return &__start_logfmt[(record[0] << 8) | record[1]];
+}
+
+static uint32_t recordArg(const uint8_t* record, uint8_t i)
+{
+    const uint8_t* arg = &record[LOGGING_RECORD_HEADER_LEN + 4U * i];
+    return ((uint32_t)arg[0] << 24) | ((uint32_t)arg[1] << 16) |
+           ((uint32_t)arg[2] << 8) | (uint32_t)arg[3];
+}
+
+static uint32_t recordTime(const uint8_t* record)
+{
+    return ((uint32_t)record[4] << 24) | ((uint32_t)record[5] << 16) |
+           ((uint32_t)record[6] << 8) | (uint32_t)record[7];
+}
+
 TEST_GROUP(LIB_LOGGING);
 
 TEST_SETUP(LIB_LOGGING)
@@ -53,7 +75,7 @@ TEST(LIB_LOGGING, TestInit)
 TEST(LIB_LOGGING, TestNoLog)
 {
     // No output streams
-    Log_Print(&mLog, "Log message\n");
+    Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "Log message\n");
     TEST_ASSERT_EQUAL(0U, printfOutSize);
     TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(mSerialStream));
 }
@@ -66,7 +88,7 @@ TEST(LIB_LOGGING, TestLogSWO)
     char sampleMsg[] = "Log message\n";
     size_t sampleMsgLen = sizeof(sampleMsg) - 1U; // logging shouldn't send the '\0' char
 
-    Log_Print(&mLog, "Log message\n");
+    Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "Log message\n");
 
     TEST_ASSERT_EQUAL(sampleMsgLen, printfOutSize);
     TEST_ASSERT_EQUAL_STRING(sampleMsg, printfOut);
@@ -82,7 +104,7 @@ TEST(LIB_LOGGING, TestLogSerial)
     char sampleMsg[] = "Log message\n";
     size_t sampleMsgLen = sizeof(sampleMsg) - 1U; // logging shouldn't send the '\0' char
 
-    Log_Print(&mLog, "Log message\n");
+    Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "Log message\n");
 
     TEST_ASSERT_EQUAL(0U, printfOutSize);
     TEST_ASSERT_EQUAL(sampleMsgLen, mockGetStreamBufferLen(mSerialStream));
@@ -118,7 +140,7 @@ TEST(LIB_LOGGING, TestLogBusy)
     mockSemaphoreSetLocked(mLog.mutex, true);
 
     // No data outputs, despite output enabled
-    Log_Print(&mLog, "Log message\n");
+    Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, "Log message\n");
     TEST_ASSERT_EQUAL(0U, printfOutSize);
     TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(mSerialStream));
 
@@ -139,7 +161,7 @@ TEST(LIB_LOGGING, TestLogLongMessages)
         longMessage[i] = 'X';
     }
 
-    Log_Print(&mLog, longMessage);
+    Log_Print(&mLog, LOGGING_MODULE_GENERAL, LOGGING_LEVEL_INFO, longMessage);
 
     // SWO
     char expectedPrintf[] = "[Skipping truncated message on SWO]\n";
@@ -154,6 +176,302 @@ TEST(LIB_LOGGING, TestLogLongMessages)
     TEST_ASSERT_EQUAL_CHAR_ARRAY(longMessage, streamBufferData, 256);
 }
 
+TEST(LIB_LOGGING, TestPrintfRecord)
+{
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_EnableSWO(&mLog));
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK,
+                      Log_SetSerialStream(&mLog, mSerialStream));
+
+    const float current = 1.5f;
+    Log_Printf(&mLog, "Channel %d: %u at %.2f A\n", -2, 7U, current);
+
+    // Nothing is formatted on the target
+    TEST_ASSERT_EQUAL(0U, printfOutSize);
+    TEST_ASSERT_EQUAL(0U, mockGetStreamBufferLen(mSerialStream));
+
+    uint8_t record[LOGGING_RECORD_MAX_LEN] = { 0 };
+    TEST_ASSERT_EQUAL(LOGGING_RECORD_HEADER_LEN + 12U,
+                      Log_ReadRecords(&mLog, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_STRING("Channel %d: %u at %.2f A\n", recordFormat(record));
+    TEST_ASSERT_EQUAL(3U, record[2]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFE, recordArg(record, 0U));
+    TEST_ASSERT_EQUAL_HEX32(7U, recordArg(record, 1U));
+    TEST_ASSERT_EQUAL_HEX32(0x3FC00000, recordArg(record, 2U)); // 1.5f
+
+    TEST_ASSERT_EQUAL(0U, Log_ReadRecords(&mLog, record, sizeof(record)));
+}
+
+TEST(LIB_LOGGING, TestPrintfArgs)
+{
+    Log_Printf(&mLog, "No args\n");
+    Log_Printf(&mLog, "%f %c %llu\n", 0.25, 'x', 0x100000005ULL);
+
+    uint8_t records[2U * LOGGING_RECORD_MAX_LEN] = { 0 };
+    TEST_ASSERT_EQUAL(2U * LOGGING_RECORD_HEADER_LEN + 12U,
+                      Log_ReadRecords(&mLog, records, sizeof(records)));
+    TEST_ASSERT_EQUAL_STRING("No args\n", recordFormat(records));
+    TEST_ASSERT_EQUAL(0U, records[2]);
+
+    const uint8_t* record = &records[LOGGING_RECORD_HEADER_LEN];
+    TEST_ASSERT_EQUAL_STRING("%f %c %llu\n", recordFormat(record));
+    TEST_ASSERT_EQUAL(3U, record[2]);
+    TEST_ASSERT_EQUAL_HEX32(0x3E800000, recordArg(record, 0U)); // doubles as floats
+    TEST_ASSERT_EQUAL_HEX32('x', recordArg(record, 1U));
+    TEST_ASSERT_EQUAL_HEX32(5U, recordArg(record, 2U)); // low 32 bits
+}
+
+TEST(LIB_LOGGING, TestReadWholeRecords)
+{
+    for (uint8_t i = 0U; i < 3U; ++i) {
+        Log_Printf(&mLog, "Record %u\n", i);
+    }
+    const uint16_t recordLen = LOGGING_RECORD_HEADER_LEN + 4U;
+
+    // Only whole records are read
+    uint8_t records[3U * LOGGING_RECORD_MAX_LEN] = { 0 };
+    TEST_ASSERT_EQUAL(0U, Log_ReadRecords(&mLog, records, (uint16_t)(recordLen - 1U)));
+    TEST_ASSERT_EQUAL(recordLen, Log_ReadRecords(&mLog, records, (uint16_t)(2U * recordLen - 1U)));
+    TEST_ASSERT_EQUAL(0U, recordArg(records, 0U));
+    TEST_ASSERT_EQUAL(2U * recordLen, Log_ReadRecords(&mLog, records, sizeof(records)));
+    TEST_ASSERT_EQUAL(1U, recordArg(records, 0U));
+    TEST_ASSERT_EQUAL(2U, recordArg(&records[recordLen], 0U));
+}
+
+TEST(LIB_LOGGING, TestRecordsFull)
+{
+    // Records wrap around the buffer, and are dropped whole when full
+    const uint32_t fit = LOGGING_RECORD_BUFFER_LEN / (RECORD_MARKER_LEN + LOGGING_RECORD_MAX_LEN);
+    for (uint32_t i = 0U; i < fit + 2U; ++i) {
+        Log_Printf(&mLog, "%u %u %u %u %u %u\n", i, i, i, i, i, i);
+    }
+    TEST_ASSERT_EQUAL(2U, mLog.recordsDropped);
+
+    uint8_t record[LOGGING_RECORD_MAX_LEN] = { 0 };
+    for (uint32_t i = 0U; i < fit; ++i) {
+        TEST_ASSERT_EQUAL(LOGGING_RECORD_MAX_LEN,
+                          Log_ReadRecords(&mLog, record, sizeof(record)));
+        TEST_ASSERT_EQUAL(i, recordArg(record, 5U));
+        Log_Printf(&mLog, "%u %u %u %u %u %u\n", i, i, i, i, i, fit + i);
+    }
+    for (uint32_t i = 0U; i < fit; ++i) {
+        TEST_ASSERT_EQUAL(LOGGING_RECORD_MAX_LEN,
+                          Log_ReadRecords(&mLog, record, sizeof(record)));
+        TEST_ASSERT_EQUAL(fit + i, recordArg(record, 5U));
+    }
+    TEST_ASSERT_EQUAL(2U, mLog.recordsDropped);
+}
+
+TEST(LIB_LOGGING, TestRecordNotCommitted)
+{
+    // A writer reserves a record, and is interrupted before committing it
+    const uint8_t pending[] = {
+        0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2A,
+    };
+    uint32_t at = 0U;
+    TEST_ASSERT_TRUE(reserveRecord(&mLog, sizeof(pending), &at));
+
+    // Records after it are kept until it is committed
+    Log_Printf(&mLog, "After\n");
+    uint8_t records[2U * LOGGING_RECORD_MAX_LEN] = { 0 };
+    TEST_ASSERT_EQUAL(0U, Log_ReadRecords(&mLog, records, sizeof(records)));
+
+    commitRecord(&mLog, at, pending, sizeof(pending));
+    TEST_ASSERT_EQUAL(sizeof(pending) + LOGGING_RECORD_HEADER_LEN,
+                      Log_ReadRecords(&mLog, records, sizeof(records)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pending, records, sizeof(pending));
+    TEST_ASSERT_EQUAL_STRING("After\n", recordFormat(&records[sizeof(pending)]));
+}
+
+TEST(LIB_LOGGING, TestRecordMarkersCleared)
+{
+    // Fill the buffer with arguments that each look like a marker and the
+    // start of a record with no arguments
+    const uint32_t marker = RECORD_COMMITTED << 24;
+    const uint32_t entryLen = RECORD_MARKER_LEN + LOGGING_RECORD_MAX_LEN;
+    const uint32_t argsAt = RECORD_MARKER_LEN + LOGGING_RECORD_HEADER_LEN;
+    uint8_t record[LOGGING_RECORD_MAX_LEN] = { 0 };
+    for (uint32_t i = 0U; i < LOGGING_RECORD_BUFFER_LEN / entryLen; ++i) {
+        Log_Printf(&mLog, "%u %u %u %u %u %u\n", marker, marker, marker, marker, marker, marker);
+        TEST_ASSERT_EQUAL(LOGGING_RECORD_MAX_LEN, Log_ReadRecords(&mLog, record, sizeof(record)));
+    }
+
+    // After wrapping, shorter records move the next one onto old arguments
+    uint32_t at = mLog.recordHead;
+    while (at < LOGGING_RECORD_BUFFER_LEN ||
+           (at - LOGGING_RECORD_BUFFER_LEN) % entryLen < argsAt ||
+           0U != ((at - LOGGING_RECORD_BUFFER_LEN) % entryLen - argsAt) % 4U) {
+        Log_Printf(&mLog, "\n");
+        TEST_ASSERT_EQUAL(LOGGING_RECORD_HEADER_LEN, Log_ReadRecords(&mLog, record, sizeof(record)));
+        at = mLog.recordHead;
+    }
+
+    // Reserved but not committed, so not read
+    TEST_ASSERT_TRUE(reserveRecord(&mLog, 2U * LOGGING_RECORD_HEADER_LEN, &at));
+    TEST_ASSERT_EQUAL(0U, Log_ReadRecords(&mLog, record, sizeof(record)));
+}
+
+TEST(LIB_LOGGING, TestRecordSource)
+{
+    mockSetCurrentTaskNumber(0U); // scheduler not started
+    Log_Printf(&mLog, "Init\n");
+    mockSetCurrentTaskNumber(4U);
+    Log_Printf(&mLog, "Task\n");
+    mockSet_IPSR(16U + 37U); // USART1 interrupt
+    Log_Printf(&mLog, "Interrupt\n");
+    mockSet_IPSR(0U);
+    mockSetCurrentTaskNumber(1U);
+
+    uint8_t records[3U * LOGGING_RECORD_MAX_LEN] = { 0 };
+    TEST_ASSERT_EQUAL(3U * LOGGING_RECORD_HEADER_LEN,
+                      Log_ReadRecords(&mLog, records, sizeof(records)));
+    TEST_ASSERT_EQUAL(0U, records[3]);
+    TEST_ASSERT_EQUAL(4U, records[LOGGING_RECORD_HEADER_LEN + 3U]);
+    TEST_ASSERT_EQUAL(LOGGING_SOURCE_ISR | 53U, records[2U * LOGGING_RECORD_HEADER_LEN + 3U]);
+}
+
+TEST(LIB_LOGGING, TestRecordTime)
+{
+    const uint32_t cyclesPerUs = SystemCoreClock / 1000000U;
+    uint8_t record[LOGGING_RECORD_MAX_LEN] = { 0 };
+    TEST_ASSERT_TRUE(0U != (mockDWT.CTRL & DWT_CTRL_CYCCNTENA_Msk));
+
+    // Microseconds since init
+    mockDWT.CYCCNT += 1500U * cyclesPerUs + cyclesPerUs - 1U;
+    Log_Printf(&mLog, "Time\n");
+    TEST_ASSERT_EQUAL(LOGGING_RECORD_HEADER_LEN, Log_ReadRecords(&mLog, record, sizeof(record)));
+    TEST_ASSERT_EQUAL(1500U, recordTime(record));
+
+    // Kept past the cycle counter wrapping, as long as the time base is moved
+    // on, and part microseconds aren't lost when it is
+    for (uint32_t i = 0U; i < 25U; ++i) {
+        mockDWT.CYCCNT += 1000000U * cyclesPerUs;
+        Log_UpdateTime(&mLog);
+    }
+    mockDWT.CYCCNT += 1U;
+    Log_Printf(&mLog, "Time\n");
+    TEST_ASSERT_EQUAL(LOGGING_RECORD_HEADER_LEN, Log_ReadRecords(&mLog, record, sizeof(record)));
+    TEST_ASSERT_EQUAL(25001501U, recordTime(record));
+}
+
+TEST(LIB_LOGGING, TestRecordTraced)
+{
+    mockITM.TCR = ITM_TCR_ITMENA_Msk;
+    mockITM.TER = 1U << TRACE_PORT_EVENT;
+    mockITM.PORT[TRACE_PORT_EVENT].u32 = 1U; // FIFO ready
+
+    // Only with SWO enabled
+    Log_Printf(&mLog, "Traced %u\n", 0x11223344U);
+    TEST_ASSERT_EQUAL(1U, mockITM.PORT[TRACE_PORT_EVENT].u32);
+
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_EnableSWO(&mLog));
+    mockSetCurrentTaskNumber(5U);
+    mockDWT.CYCCNT += SystemCoreClock; // time word isn't 0, which reads as FIFO full
+    Log_Printf(&mLog, "Traced %u\n", 0x11223344U);
+    mockSetCurrentTaskNumber(1U);
+    TEST_ASSERT_EQUAL_HEX8(5U, mockITM.PORT[TRACE_PORT_EVENT].u8);
+    TEST_ASSERT_EQUAL_HEX32(0x44332211, mockITM.PORT[TRACE_PORT_EVENT].u32);
+
+    // Records are still sent to the PC
+    uint8_t records[2U * LOGGING_RECORD_MAX_LEN] = { 0 };
+    TEST_ASSERT_EQUAL(2U * (LOGGING_RECORD_HEADER_LEN + 4U),
+                      Log_ReadRecords(&mLog, records, sizeof(records)));
+    mockITM.TER = 0U;
+}
+
+// Counts evaluations of a log argument
+static uint32_t mArgsEvaluated;
+static uint32_t countedArg(void)
+{
+    return ++mArgsEvaluated;
+}
+
+TEST(LIB_LOGGING, TestLevels)
+{
+    mArgsEvaluated = 0U;
+    uint8_t records[2U * LOGGING_RECORD_MAX_LEN] = { 0 };
+
+    // Info by default
+    TEST_ASSERT_EQUAL(LOGGING_LEVEL_INFO, Log_GetLevel(&mLog, LOGGING_MODULE_INVERTER));
+    Log_Info(&mLog, LOGGING_MODULE_INVERTER, "Info %u\n", countedArg());
+    TEST_ASSERT_EQUAL(1U, mArgsEvaluated);
+    TEST_ASSERT_EQUAL(LOGGING_RECORD_HEADER_LEN + 4U,
+                      Log_ReadRecords(&mLog, records, sizeof(records)));
+    TEST_ASSERT_EQUAL_STRING("Info %u\n", recordFormat(records));
+
+    // Levels above the module's aren't logged, or their arguments evaluated
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK,
+                      Log_SetLevel(&mLog, LOGGING_MODULE_INVERTER, LOGGING_LEVEL_WARN));
+    TEST_ASSERT_EQUAL(LOGGING_LEVEL_WARN, Log_GetLevel(&mLog, LOGGING_MODULE_INVERTER));
+    Log_Info(&mLog, LOGGING_MODULE_INVERTER, "Info %u\n", countedArg());
+    Log_Error(&mLog, LOGGING_MODULE_INVERTER, "Error %u\n", countedArg());
+    TEST_ASSERT_EQUAL(2U, mArgsEvaluated);
+    TEST_ASSERT_EQUAL(LOGGING_RECORD_HEADER_LEN + 4U,
+                      Log_ReadRecords(&mLog, records, sizeof(records)));
+    TEST_ASSERT_EQUAL_STRING("Error %u\n", recordFormat(records));
+
+    // Other modules keep their level
+    Log_Info(&mLog, LOGGING_MODULE_BMS, "Info\n");
+    TEST_ASSERT_EQUAL(LOGGING_RECORD_HEADER_LEN,
+                      Log_ReadRecords(&mLog, records, sizeof(records)));
+
+    // Debug is above the build level, so never logged, and the module's
+    // level is limited to the build level
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK,
+                      Log_SetLevel(&mLog, LOGGING_MODULE_BMS, LOGGING_LEVEL_DEBUG));
+    TEST_ASSERT_EQUAL(LOGGING_LEVEL_INFO, Log_GetLevel(&mLog, LOGGING_MODULE_BMS));
+    Log_Debug(&mLog, LOGGING_MODULE_BMS, "Debug %u\n", countedArg());
+    TEST_ASSERT_EQUAL(2U, mArgsEvaluated);
+
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK,
+                      Log_SetLevel(&mLog, LOGGING_MODULE_BMS, LOGGING_LEVEL_OFF));
+    Log_Error(&mLog, LOGGING_MODULE_BMS, "Error\n");
+    TEST_ASSERT_EQUAL(0U, Log_ReadRecords(&mLog, records, sizeof(records)));
+}
+
+TEST(LIB_LOGGING, TestTextLevels)
+{
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK, Log_EnableSWO(&mLog));
+
+    // Info is logged by default
+    Log_Print(&mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_INFO, "CAN info\n");
+    Log_Print(&mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_WARN, "CAN warn\n");
+    TEST_ASSERT_EQUAL_STRING("CAN info\nCAN warn\n", printfOut);
+
+    // Filtered per module, the same as deferred logs
+    mockClearPrintf();
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK,
+                      Log_SetLevel(&mLog, LOGGING_MODULE_UART, LOGGING_LEVEL_ERROR));
+    Log_Print(&mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_INFO, "CAN info\n");
+    Log_Print(&mLog, LOGGING_MODULE_UART, LOGGING_LEVEL_WARN, "UART warn\n");
+    Log_Print(&mLog, LOGGING_MODULE_UART, LOGGING_LEVEL_ERROR, "UART error\n");
+    TEST_ASSERT_EQUAL_STRING("CAN info\nUART error\n", printfOut);
+
+    // Debug is above the build level, so never printed even when the module
+    // asks for it
+    mockClearPrintf();
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_OK,
+                      Log_SetLevel(&mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_DEBUG));
+    Log_Print(&mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_DEBUG, "CAN_Init begin\n");
+    TEST_ASSERT_EQUAL(0U, printfOutSize);
+
+    // Invalid modules and levels print nothing
+    mockClearPrintf();
+    Log_Print(&mLog, LOGGING_NUM_MODULES, LOGGING_LEVEL_ERROR, "Invalid\n");
+    Log_PrintText(&mLog, LOGGING_MODULE_CAN, LOGGING_NUM_LEVELS, "Invalid\n");
+    Log_Print(&mLog, LOGGING_MODULE_CAN, LOGGING_LEVEL_OFF, "Invalid\n");
+    TEST_ASSERT_EQUAL(0U, printfOutSize);
+}
+
+TEST(LIB_LOGGING, TestLevelsInvalid)
+{
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_LOG_ERROR,
+                      Log_SetLevel(&mLog, LOGGING_NUM_MODULES, LOGGING_LEVEL_INFO));
+    TEST_ASSERT_EQUAL(LOGGING_STATUS_LOG_ERROR,
+                      Log_SetLevel(&mLog, LOGGING_MODULE_BMS, LOGGING_NUM_LEVELS));
+    TEST_ASSERT_EQUAL(LOGGING_LEVEL_INFO, Log_GetLevel(&mLog, LOGGING_MODULE_BMS));
+    TEST_ASSERT_EQUAL(LOGGING_LEVEL_OFF, Log_GetLevel(&mLog, LOGGING_NUM_MODULES));
+}
+
 TEST_GROUP_RUNNER(LIB_LOGGING)
 {
     RUN_TEST_CASE(LIB_LOGGING, TestInit);
@@ -164,6 +482,18 @@ TEST_GROUP_RUNNER(LIB_LOGGING)
     RUN_TEST_CASE(LIB_LOGGING, TestSetSerialStreamBusy);
     RUN_TEST_CASE(LIB_LOGGING, TestLogBusy);
     RUN_TEST_CASE(LIB_LOGGING, TestLogLongMessages);
+    RUN_TEST_CASE(LIB_LOGGING, TestPrintfRecord);
+    RUN_TEST_CASE(LIB_LOGGING, TestPrintfArgs);
+    RUN_TEST_CASE(LIB_LOGGING, TestReadWholeRecords);
+    RUN_TEST_CASE(LIB_LOGGING, TestRecordsFull);
+    RUN_TEST_CASE(LIB_LOGGING, TestRecordNotCommitted);
+    RUN_TEST_CASE(LIB_LOGGING, TestRecordMarkersCleared);
+    RUN_TEST_CASE(LIB_LOGGING, TestRecordSource);
+    RUN_TEST_CASE(LIB_LOGGING, TestRecordTime);
+    RUN_TEST_CASE(LIB_LOGGING, TestRecordTraced);
+    RUN_TEST_CASE(LIB_LOGGING, TestLevels);
+    RUN_TEST_CASE(LIB_LOGGING, TestTextLevels);
+    RUN_TEST_CASE(LIB_LOGGING, TestLevelsInvalid);
 }
 
 #define INVOKE_TEST LIB_LOGGING
@@ -0,0 +1,208 @@
+/*
+ * TestTelemetry.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "unity.h"
+#include "unity_fixture.h"
+
+#include <string.h>
+
+// source code under test
+#include "telemetry/telemetry.c"
+
+#define KEYFRAME_PERIOD 4U
+
+static Telemetry_T mStream;
+static uint8_t mOut[TELEMETRY_FIELD_MAX_LEN];
+
+TEST_GROUP(LIB_TELEMETRY);
+
+TEST_SETUP(LIB_TELEMETRY)
+{
+    memset(&mStream, 0, sizeof(mStream));
+    memset(mOut, 0, sizeof(mOut));
+    mStream.keyframePeriod = KEYFRAME_PERIOD;
+    Telemetry_Init(&mStream);
+}
+
+TEST_TEAR_DOWN(LIB_TELEMETRY)
+{
+    // Empty
+}
+
+TEST(LIB_TELEMETRY, TestVarint)
+{
+    struct {
+        uint32_t value;
+        uint8_t out[5];
+        uint16_t len;
+    } vectors[] = {
+        { 0U, { 0x00 }, 1 },
+        { 1U, { 0x01 }, 1 },
+        { 127U, { 0x7F }, 1 },
+        { 128U, { 0x80, 0x01 }, 2 },
+        { 300U, { 0xAC, 0x02 }, 2 },
+        { 0xFFFFFFFFU, { 0xFF, 0xFF, 0xFF, 0xFF, 0x0F }, 5 },
+    };
+
+    for (size_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); ++v) {
+        uint8_t out[5] = { 0 };
+        TEST_ASSERT_EQUAL(vectors[v].len, Telemetry_PutVarint(out, vectors[v].value));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(vectors[v].out, out, vectors[v].len);
+    }
+}
+
+TEST(LIB_TELEMETRY, TestZigzag)
+{
+    TEST_ASSERT_EQUAL_HEX32(0U, Telemetry_Zigzag(0U));
+    TEST_ASSERT_EQUAL_HEX32(1U, Telemetry_Zigzag((uint32_t)-1));
+    TEST_ASSERT_EQUAL_HEX32(2U, Telemetry_Zigzag(1U));
+    TEST_ASSERT_EQUAL_HEX32(3U, Telemetry_Zigzag((uint32_t)-2));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFEU, Telemetry_Zigzag(0x7FFFFFFFU));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFFU, Telemetry_Zigzag(0x80000000U));
+}
+
+TEST(LIB_TELEMETRY, TestKeyframe)
+{
+    // First update is a keyframe with absolute values
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+
+    const uint8_t expected1[] = { 0x00, 0x07, 0x01, 0x2A };
+    TEST_ASSERT_EQUAL(sizeof(expected1), Telemetry_EncodeField(&mStream, mOut, 0x0007U, 1U, 0x2AU));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected1, mOut, sizeof(expected1));
+
+    const uint8_t expected4[] = { 0x01, 0x00, 0x04, 0x43, 0xC8, 0x00, 0x00 };
+    TEST_ASSERT_EQUAL(sizeof(expected4), Telemetry_EncodeField(&mStream, mOut, 0x0100U, 4U, 0x43C80000U));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected4, mOut, sizeof(expected4));
+
+    // Value is cut to the field size
+    const uint8_t expected2[] = { 0x00, 0x08, 0x02, 0x34, 0x56 };
+    TEST_ASSERT_EQUAL(sizeof(expected2), Telemetry_EncodeField(&mStream, mOut, 0x0008U, 2U, 0x123456U));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected2, mOut, sizeof(expected2));
+
+    // Unsupported sizes
+    TEST_ASSERT_EQUAL(0U, Telemetry_EncodeField(&mStream, mOut, 0x0009U, 0U, 1U));
+    TEST_ASSERT_EQUAL(0U, Telemetry_EncodeField(&mStream, mOut, 0x0009U, 5U, 1U));
+}
+
+TEST(LIB_TELEMETRY, TestDeltaOnlyChanged)
+{
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+    Telemetry_EncodeField(&mStream, mOut, 0x0001U, 4U, 1000U);
+    Telemetry_EncodeField(&mStream, mOut, 0x0002U, 4U, 5U);
+
+    // Unchanged fields aren't sent
+    TEST_ASSERT_FALSE(Telemetry_Begin(&mStream));
+    TEST_ASSERT_EQUAL(0U, Telemetry_EncodeField(&mStream, mOut, 0x0001U, 4U, 1000U));
+
+    // Changed fields are the ID and zigzag difference
+    const uint8_t expectedUp[] = { 0x02, 0x06 }; // +3
+    TEST_ASSERT_EQUAL(sizeof(expectedUp), Telemetry_EncodeField(&mStream, mOut, 0x0002U, 4U, 8U));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedUp, mOut, sizeof(expectedUp));
+
+    // Difference is from the last value sent
+    TEST_ASSERT_FALSE(Telemetry_Begin(&mStream));
+    const uint8_t expectedDown[] = { 0x01, 0xC7, 0x01 }; // -100
+    TEST_ASSERT_EQUAL(sizeof(expectedDown), Telemetry_EncodeField(&mStream, mOut, 0x0001U, 4U, 900U));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedDown, mOut, sizeof(expectedDown));
+    const uint8_t expectedDown2[] = { 0x02, 0x0F }; // -8
+    TEST_ASSERT_EQUAL(sizeof(expectedDown2), Telemetry_EncodeField(&mStream, mOut, 0x0002U, 4U, 0U));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedDown2, mOut, sizeof(expectedDown2));
+}
+
+TEST(LIB_TELEMETRY, TestDeltaLargest)
+{
+    // Field ID and difference at their longest
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+    Telemetry_EncodeField(&mStream, mOut, 0xFFFFU, 4U, 0U);
+    TEST_ASSERT_FALSE(Telemetry_Begin(&mStream));
+
+    const uint8_t expected[] = { 0xFF, 0xFF, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F };
+    _Static_assert(sizeof(expected) == TELEMETRY_FIELD_MAX_LEN, "longest field");
+    TEST_ASSERT_EQUAL(sizeof(expected), Telemetry_EncodeField(&mStream, mOut, 0xFFFFU, 4U, 0x80000000U));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, mOut, sizeof(expected));
+}
+
+TEST(LIB_TELEMETRY, TestKeyframePeriod)
+{
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+    Telemetry_EncodeField(&mStream, mOut, 0x0001U, 1U, 1U);
+    for (uint16_t i = 1U; i < KEYFRAME_PERIOD; ++i) {
+        TEST_ASSERT_FALSE(Telemetry_Begin(&mStream));
+        TEST_ASSERT_EQUAL(0U, Telemetry_EncodeField(&mStream, mOut, 0x0001U, 1U, 1U));
+    }
+
+    // Every field is sent in a keyframe, changed or not
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+    TEST_ASSERT_EQUAL(4U, Telemetry_EncodeField(&mStream, mOut, 0x0001U, 1U, 1U));
+    TEST_ASSERT_FALSE(Telemetry_Begin(&mStream));
+}
+
+TEST(LIB_TELEMETRY, TestForceKeyframe)
+{
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+    TEST_ASSERT_FALSE(Telemetry_Begin(&mStream));
+
+    Telemetry_ForceKeyframe(&mStream);
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+
+    // Period restarts from the forced keyframe
+    for (uint16_t i = 1U; i < KEYFRAME_PERIOD; ++i) {
+        TEST_ASSERT_FALSE(Telemetry_Begin(&mStream));
+    }
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+}
+
+TEST(LIB_TELEMETRY, TestNewFieldInDelta)
+{
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+    Telemetry_EncodeField(&mStream, mOut, 0x0001U, 1U, 1U);
+
+    // A new field can't be sent as a difference, it waits for a keyframe
+    TEST_ASSERT_FALSE(Telemetry_Begin(&mStream));
+    TEST_ASSERT_EQUAL(0U, Telemetry_EncodeField(&mStream, mOut, 0x0002U, 2U, 0x1234U));
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+    TEST_ASSERT_EQUAL(5U, Telemetry_EncodeField(&mStream, mOut, 0x0002U, 2U, 0x1234U));
+}
+
+TEST(LIB_TELEMETRY, TestFieldsFull)
+{
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+    for (uint16_t i = 0U; i < TELEMETRY_MAX_FIELDS; ++i) {
+        TEST_ASSERT_EQUAL(4U, Telemetry_EncodeField(&mStream, mOut, i, 1U, 0U));
+    }
+    TEST_ASSERT_EQUAL(0U, Telemetry_EncodeField(&mStream, mOut, TELEMETRY_MAX_FIELDS, 1U, 0U));
+}
+
+TEST(LIB_TELEMETRY, TestSmallFieldWraps)
+{
+    // Differences of fields under 4 bytes wrap, e.g. an 8 bit counter
+    TEST_ASSERT_TRUE(Telemetry_Begin(&mStream));
+    Telemetry_EncodeField(&mStream, mOut, 0x000AU, 1U, 0xFFU);
+    TEST_ASSERT_FALSE(Telemetry_Begin(&mStream));
+
+    // 0xFF to 0x00 is -255 modulo 2^32, receiver keeps the low byte
+    const uint8_t expected[] = { 0x0A, 0xFD, 0x03 };
+    TEST_ASSERT_EQUAL(sizeof(expected), Telemetry_EncodeField(&mStream, mOut, 0x000AU, 1U, 0x100U));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, mOut, sizeof(expected));
+}
+
+TEST_GROUP_RUNNER(LIB_TELEMETRY)
+{
+    RUN_TEST_CASE(LIB_TELEMETRY, TestVarint);
+    RUN_TEST_CASE(LIB_TELEMETRY, TestZigzag);
+    RUN_TEST_CASE(LIB_TELEMETRY, TestKeyframe);
+    RUN_TEST_CASE(LIB_TELEMETRY, TestDeltaOnlyChanged);
+    RUN_TEST_CASE(LIB_TELEMETRY, TestDeltaLargest);
+    RUN_TEST_CASE(LIB_TELEMETRY, TestKeyframePeriod);
+    RUN_TEST_CASE(LIB_TELEMETRY, TestForceKeyframe);
+    RUN_TEST_CASE(LIB_TELEMETRY, TestNewFieldInDelta);
+    RUN_TEST_CASE(LIB_TELEMETRY, TestFieldsFull);
+    RUN_TEST_CASE(LIB_TELEMETRY, TestSmallFieldWraps);
+}
+
+#define INVOKE_TEST LIB_TELEMETRY
+#include "test_main.h"
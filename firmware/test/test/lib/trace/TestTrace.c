@@ -0,0 +1,137 @@
+/*
+ * TestTrace.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Liam Flaherty
+ */
+
+#include "unity.h"
+#include "unity_fixture.h"
+
+#include <string.h>
+
+#include "stm32_hal/MockStm32f7xx_hal.h"
+
+// source code under test
+#include "trace/trace.c"
+
+static void enablePort(uint8_t port)
+{
+    mockITM.TCR |= ITM_TCR_ITMENA_Msk;
+    mockITM.TER |= 1U << port;
+    mockITM.PORT[port].u32 = 1U; // FIFO ready
+}
+
+TEST_GROUP(LIB_TRACE);
+
+TEST_SETUP(LIB_TRACE)
+{
+    memset(&mockITM, 0, sizeof(mockITM));
+    memset((uint32_t*)Trace_Dropped, 0, sizeof(Trace_Dropped));
+}
+
+TEST_TEAR_DOWN(LIB_TRACE)
+{
+    // Empty
+}
+
+TEST(LIB_TRACE, TestDisabled)
+{
+    // No debugger, nothing written or dropped
+    TEST_ASSERT_EQUAL(0U, Trace_WriteText("abcd", 4U));
+    mockITM.TCR = ITM_TCR_ITMENA_Msk;
+    mockITM.TER = 1U << TRACE_PORT_TASK;
+    TEST_ASSERT_FALSE(Trace_Enabled(TRACE_PORT_TEXT));
+    TEST_ASSERT_TRUE(Trace_Enabled(TRACE_PORT_TASK));
+    TEST_ASSERT_EQUAL(0U, Trace_WriteText("abcd", 4U));
+    TEST_ASSERT_EQUAL(0U, mockITM.PORT[TRACE_PORT_TEXT].u32);
+    TEST_ASSERT_EQUAL(0U, Trace_Dropped[TRACE_PORT_TEXT]);
+}
+
+TEST(LIB_TRACE, TestText)
+{
+    enablePort(TRACE_PORT_TEXT);
+
+    // Words, then what is left as 2 and 1 bytes, first character first
+    TEST_ASSERT_EQUAL(7U, Trace_WriteText("abcdefg", 7U));
+    TEST_ASSERT_EQUAL_HEX32(0x64636261, mockITM.PORT[TRACE_PORT_TEXT].u32);
+    TEST_ASSERT_EQUAL_HEX32(0x6665, mockITM.PORT[TRACE_PORT_TEXT].u16);
+    TEST_ASSERT_EQUAL_HEX8('g', mockITM.PORT[TRACE_PORT_TEXT].u8);
+    TEST_ASSERT_EQUAL(0U, Trace_Dropped[TRACE_PORT_TEXT]);
+}
+
+TEST(LIB_TRACE, TestTextBusy)
+{
+    enablePort(TRACE_PORT_TEXT);
+    mockITM.PORT[TRACE_PORT_TEXT].u32 = 0U; // FIFO full
+
+    TEST_ASSERT_EQUAL(0U, Trace_WriteText("abcdefg", 7U));
+    TEST_ASSERT_EQUAL(0U, mockITM.PORT[TRACE_PORT_TEXT].u16);
+    TEST_ASSERT_EQUAL(7U, Trace_Dropped[TRACE_PORT_TEXT]);
+}
+
+TEST(LIB_TRACE, TestEvent)
+{
+    enablePort(TRACE_PORT_EVENT);
+
+    const uint8_t event[] = { 0x12, 0x34, 0x01, 0x05, 0xA0, 0xB0, 0xC0, 0xD0, 0x11, 0x22, 0x33, 0x44 };
+    TEST_ASSERT_TRUE(Trace_WriteEvent(event, sizeof(event)));
+    TEST_ASSERT_EQUAL_HEX32(0x3412, mockITM.PORT[TRACE_PORT_EVENT].u16);
+    TEST_ASSERT_EQUAL_HEX8(0x05, mockITM.PORT[TRACE_PORT_EVENT].u8);
+    TEST_ASSERT_EQUAL_HEX32(0x44332211, mockITM.PORT[TRACE_PORT_EVENT].u32);
+    TEST_ASSERT_EQUAL(0U, Trace_Dropped[TRACE_PORT_EVENT]);
+
+    // Other ports aren't written
+    TEST_ASSERT_EQUAL(0U, mockITM.PORT[TRACE_PORT_TEXT].u16);
+    TEST_ASSERT_EQUAL(0U, mockITM.PORT[TRACE_PORT_TASK].u32);
+}
+
+TEST(LIB_TRACE, TestEventInvalid)
+{
+    enablePort(TRACE_PORT_EVENT);
+
+    const uint8_t event[] = { 0x12, 0x34, 0x01, 0x05, 0xA0, 0xB0 };
+    TEST_ASSERT_FALSE(Trace_WriteEvent(event, 3U));
+    TEST_ASSERT_FALSE(Trace_WriteEvent(event, sizeof(event)));
+    TEST_ASSERT_EQUAL(0U, mockITM.PORT[TRACE_PORT_EVENT].u16);
+}
+
+TEST(LIB_TRACE, TestEventBusy)
+{
+    enablePort(TRACE_PORT_EVENT);
+    mockITM.PORT[TRACE_PORT_EVENT].u32 = 0U;
+
+    const uint8_t event[] = { 0x12, 0x34, 0x00, 0x05 };
+    TEST_ASSERT_FALSE(Trace_WriteEvent(event, sizeof(event)));
+    TEST_ASSERT_EQUAL(0U, mockITM.PORT[TRACE_PORT_EVENT].u16);
+    TEST_ASSERT_EQUAL(1U, Trace_Dropped[TRACE_PORT_EVENT]);
+}
+
+TEST(LIB_TRACE, TestTaskSwitch)
+{
+    enablePort(TRACE_PORT_TASK);
+
+    // Cycle counter, with the task number in the low bits
+    mockDWT.CYCCNT = 0x12345678U;
+    Trace_TaskSwitchedIn(3U);
+    TEST_ASSERT_EQUAL_HEX32(0x12345603, mockITM.PORT[TRACE_PORT_TASK].u32);
+
+    mockITM.PORT[TRACE_PORT_TASK].u32 = 0U;
+    Trace_TaskSwitchedIn(4U);
+    TEST_ASSERT_EQUAL(0U, mockITM.PORT[TRACE_PORT_TASK].u32);
+    TEST_ASSERT_EQUAL(1U, Trace_Dropped[TRACE_PORT_TASK]);
+}
+
+TEST_GROUP_RUNNER(LIB_TRACE)
+{
+    RUN_TEST_CASE(LIB_TRACE, TestDisabled);
+    RUN_TEST_CASE(LIB_TRACE, TestText);
+    RUN_TEST_CASE(LIB_TRACE, TestTextBusy);
+    RUN_TEST_CASE(LIB_TRACE, TestEvent);
+    RUN_TEST_CASE(LIB_TRACE, TestEventInvalid);
+    RUN_TEST_CASE(LIB_TRACE, TestEventBusy);
+    RUN_TEST_CASE(LIB_TRACE, TestTaskSwitch);
+}
+
+#define INVOKE_TEST LIB_TRACE
+#include "test_main.h"
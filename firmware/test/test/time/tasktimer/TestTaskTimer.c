@@ -78,7 +78,11 @@ TEST(TIME_TASKTIMER, TimerElapsed)
     
     TEST_ASSERT_EQUAL(0, mockGetTaskNotifyValue());
 
-    // This is the timer attached to 100Hz:
+    // This is the timer attached to 1kHz, 100Hz tasks are notified every 10 ticks:
+    for (uint16_t i = 0; i < 9U; ++i) {
+        TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    }
+    TEST_ASSERT_EQUAL(0, mockGetTaskNotifyValue());
     TaskTimer_TIM_PeriodElapsedCallback(&htim1);
     TEST_ASSERT_EQUAL(1, mockGetTaskNotifyValue());
 
@@ -87,11 +91,220 @@ TEST(TIME_TASKTIMER, TimerElapsed)
     TEST_ASSERT_EQUAL(1, mockGetTaskNotifyValue());
 }
 
+TEST(TIME_TASKTIMER, DividedFrequencies)
+{
+    TaskHandle_t handles[TASKTIMER_FREQUENCY_COUNT];
+    for (uint16_t f = 0; f < TASKTIMER_FREQUENCY_COUNT; ++f) {
+        TEST_ASSERT_EQUAL(
+            TASKTIMER_STATUS_OK,
+            TaskTimer_RegisterTask(&handles[f], (TaskTimer_Frequency_T)f));
+    }
+
+    // One second of ticks, counted over every task
+    for (uint16_t i = 0; i < TASKTIMER_BASE_HZ; ++i) {
+        TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    }
+    TEST_ASSERT_EQUAL(1000 + 100 + 10 + 1, mockGetTaskNotifyValue());
+}
+
+TEST(TIME_TASKTIMER, OnlyElapsedNotified)
+{
+    TaskHandle_t fastHandle;
+    TaskHandle_t slowHandle;
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTaskPhase(&fastHandle, TASKTIMER_FREQUENCY_10HZ, 0U));
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTaskPhase(&slowHandle, TASKTIMER_FREQUENCY_1HZ, 0U));
+
+    // Only the 10Hz task after 100 ticks
+    for (uint16_t i = 0; i < 100U; ++i) {
+        TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    }
+    TEST_ASSERT_EQUAL(1, mockGetTaskNotifyValue());
+
+    // Both on the last tick of the second
+    for (uint16_t i = 100U; i < 999U; ++i) {
+        TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    }
+    TEST_ASSERT_EQUAL(9, mockGetTaskNotifyValue());
+    TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    TEST_ASSERT_EQUAL(11, mockGetTaskNotifyValue());
+}
+
+TEST(TIME_TASKTIMER, InvalidFrequency)
+{
+    TaskHandle_t someHandle;
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_ERROR_INVALID_TIMER,
+        TaskTimer_RegisterTask(&someHandle, TASKTIMER_FREQUENCY_COUNT));
+}
+
+TEST(TIME_TASKTIMER, InvalidPhase)
+{
+    TaskHandle_t someHandle;
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_ERROR_INVALID_PHASE,
+        TaskTimer_RegisterTaskPhase(&someHandle, TASKTIMER_FREQUENCY_100HZ, 10U));
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_ERROR_INVALID_PHASE,
+        TaskTimer_RegisterTaskPhase(&someHandle, TASKTIMER_FREQUENCY_1KHZ, 1U));
+    TEST_ASSERT_EQUAL(0U, TaskTimer_NumTasks());
+}
+
+TEST(TIME_TASKTIMER, PhaseRelease)
+{
+    TaskHandle_t someHandle;
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTaskPhase(&someHandle, TASKTIMER_FREQUENCY_100HZ, 3U));
+
+    // Released 3 ticks into each 10 tick period
+    TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    TEST_ASSERT_EQUAL(0, mockGetTaskNotifyValue());
+    TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    TEST_ASSERT_EQUAL(1, mockGetTaskNotifyValue());
+
+    for (uint16_t i = 3U; i < 12U; ++i) {
+        TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    }
+    TEST_ASSERT_EQUAL(1, mockGetTaskNotifyValue());
+    TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    TEST_ASSERT_EQUAL(2, mockGetTaskNotifyValue());
+}
+
+TEST(TIME_TASKTIMER, AutoPhaseSpreadsReleases)
+{
+    TaskHandle_t handles[5];
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTask(&handles[0], TASKTIMER_FREQUENCY_100HZ));
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTaskPhase(&handles[1], TASKTIMER_FREQUENCY_100HZ, 1U));
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTask(&handles[2], TASKTIMER_FREQUENCY_100HZ));
+    // Slower tasks avoid the ticks of the 100Hz tasks
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTask(&handles[3], TASKTIMER_FREQUENCY_1HZ));
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTask(&handles[4], TASKTIMER_FREQUENCY_10HZ));
+
+    const uint16_t expectedPhases[] = { 0U, 1U, 2U, 3U, 4U };
+    TEST_ASSERT_EQUAL(5U, TaskTimer_NumTasks());
+    for (uint16_t i = 0; i < 5U; ++i) {
+        TaskTimer_Stats_T stats;
+        TEST_ASSERT_TRUE(TaskTimer_GetStats(i, &stats));
+
+        // Listed by frequency, then in register order
+        const uint16_t handle = (i < 3U) ? i : (uint16_t)(7U - i);
+        TEST_ASSERT_EQUAL_PTR(&handles[handle], stats.taskHandle);
+        TEST_ASSERT_EQUAL_UINT16(expectedPhases[handle], stats.phase);
+    }
+    TaskTimer_Stats_T stats;
+    TEST_ASSERT_FALSE(TaskTimer_GetStats(5U, &stats));
+
+    // No more than one task released on any tick
+    for (uint16_t i = 0; i < TASKTIMER_BASE_HZ; ++i) {
+        TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+        TEST_ASSERT_TRUE(mockGetTaskNotifyValue() <= 1U);
+        mockSetTaskNotifyValue(0);
+    }
+}
+
+TEST(TIME_TASKTIMER, AutoPhaseAvoidsLaterFixedPhase)
+{
+    TaskHandle_t autoHandle;
+    TaskHandle_t fixedHandle;
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTask(&autoHandle, TASKTIMER_FREQUENCY_1HZ));
+    TaskTimer_Stats_T stats;
+    TEST_ASSERT_TRUE(TaskTimer_GetStats(0U, &stats));
+    TEST_ASSERT_EQUAL_PTR(&autoHandle, stats.taskHandle);
+    TEST_ASSERT_EQUAL_UINT16(0U, stats.phase);
+
+    // A fixed phase registered later on the same tick moves the auto task
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTaskPhase(&fixedHandle, TASKTIMER_FREQUENCY_100HZ, 0U));
+    TEST_ASSERT_TRUE(TaskTimer_GetStats(0U, &stats));
+    TEST_ASSERT_EQUAL_PTR(&fixedHandle, stats.taskHandle);
+    TEST_ASSERT_EQUAL_UINT16(0U, stats.phase);
+    TEST_ASSERT_TRUE(TaskTimer_GetStats(1U, &stats));
+    TEST_ASSERT_EQUAL_PTR(&autoHandle, stats.taskHandle);
+    TEST_ASSERT_EQUAL_UINT16(1U, stats.phase);
+
+    // No more than one task released on any tick
+    for (uint16_t i = 0; i < TASKTIMER_BASE_HZ; ++i) {
+        TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+        TEST_ASSERT_TRUE(mockGetTaskNotifyValue() <= 1U);
+        mockSetTaskNotifyValue(0);
+    }
+}
+
+TEST(TIME_TASKTIMER, WaitTiming)
+{
+    const uint32_t cyclesPerUs = SystemCoreClock / 1000000U;
+    TaskHandle_t someHandle;
+    TEST_ASSERT_EQUAL(
+        TASKTIMER_STATUS_OK,
+        TaskTimer_RegisterTask(&someHandle, TASKTIMER_FREQUENCY_100HZ));
+
+    // Released at 1000us, started 50us later and waits again 200us after that
+    for (uint16_t i = 0; i < 10U; ++i) {
+        mockDWT.CYCCNT = 1000U * cyclesPerUs;
+        TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    }
+    mockDWT.CYCCNT += 50U * cyclesPerUs;
+    TEST_ASSERT_EQUAL(1U, TaskTimer_Wait(&someHandle, 1U));
+    mockDWT.CYCCNT += 200U * cyclesPerUs;
+    TEST_ASSERT_EQUAL(0U, TaskTimer_Wait(&someHandle, 1U));
+
+    // Next release started 20us late, and the cycle counter wraps
+    for (uint16_t i = 0; i < 10U; ++i) {
+        mockDWT.CYCCNT = UINT32_MAX - 10U * cyclesPerUs;
+        TaskTimer_TIM_PeriodElapsedCallback(&htim1);
+    }
+    mockDWT.CYCCNT += 20U * cyclesPerUs;
+    TEST_ASSERT_EQUAL(1U, TaskTimer_Wait(&someHandle, 1U));
+    mockDWT.CYCCNT += 100U * cyclesPerUs;
+    TEST_ASSERT_EQUAL(0U, TaskTimer_Wait(&someHandle, 1U));
+
+    TaskTimer_Stats_T stats;
+    TEST_ASSERT_TRUE(TaskTimer_GetStats(0U, &stats));
+    TEST_ASSERT_EQUAL(TASKTIMER_FREQUENCY_100HZ, stats.frequency);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats.jobs);
+    TEST_ASSERT_EQUAL_UINT32(20U, stats.minLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(50U, stats.maxLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(250U, stats.maxResponseUs);
+
+    TaskTimer_ResetStats();
+    TEST_ASSERT_TRUE(TaskTimer_GetStats(0U, &stats));
+    TEST_ASSERT_EQUAL_UINT32(0U, stats.jobs);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats.minLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats.maxLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats.maxResponseUs);
+}
+
 TEST_GROUP_RUNNER(TIME_TASKTIMER)
 {
     RUN_TEST_CASE(TIME_TASKTIMER, InitOk);
     RUN_TEST_CASE(TIME_TASKTIMER, RegisterTask);
     RUN_TEST_CASE(TIME_TASKTIMER, TimerElapsed);
+    RUN_TEST_CASE(TIME_TASKTIMER, DividedFrequencies);
+    RUN_TEST_CASE(TIME_TASKTIMER, OnlyElapsedNotified);
+    RUN_TEST_CASE(TIME_TASKTIMER, InvalidFrequency);
+    RUN_TEST_CASE(TIME_TASKTIMER, InvalidPhase);
+    RUN_TEST_CASE(TIME_TASKTIMER, PhaseRelease);
+    RUN_TEST_CASE(TIME_TASKTIMER, AutoPhaseSpreadsReleases);
+    RUN_TEST_CASE(TIME_TASKTIMER, AutoPhaseAvoidsLaterFixedPhase);
+    RUN_TEST_CASE(TIME_TASKTIMER, WaitTiming);
 }
 
 #define INVOKE_TEST TIME_TASKTIMER
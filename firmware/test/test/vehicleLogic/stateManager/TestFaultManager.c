@@ -177,6 +177,36 @@ TEST(VEHICLELOGIC_FAULTMANAGER, FaultAccelPedalRange)
     stepAndAssert(FAULT_FAULT, timeoutCount); // faults should latch
 }
 
+TEST(VEHICLELOGIC_FAULTMANAGER, FaultAccelPedalWatchdog)
+{
+    uint32_t timeoutCount = pedalInvalidTimeout / tickRateMs;
+
+    // A single watchdog trip that clears is noise, not a fault
+    mVehicleState.data.inputs.accelOutOfRange = true;
+    mVehicleState.data.inputs.accelOutOfRangeTime = 1000U;
+    stepAndAssert(FAULT_NO_FAULT, 1U);
+    TEST_ASSERT_EQUAL_UINT32(1000U, mFaultMgr.internal.accelWatchdogTime);
+    mVehicleState.data.inputs.accelOutOfRange = false;
+    stepAndAssert(FAULT_NO_FAULT, timeoutCount);
+    TEST_ASSERT_EQUAL_UINT32(0U, mFaultMgr.internal.accelWatchdogTime);
+
+    // Sampled values in range, but the ADC watchdog keeps tripping. It
+    // faults after the debounce, keeping the first trip time.
+    mVehicleState.data.inputs.accelOutOfRange = true;
+    mVehicleState.data.inputs.accelOutOfRangeTime = 1234U;
+    stepAndAssert(FAULT_NO_FAULT, 1U);
+    mVehicleState.data.inputs.accelOutOfRangeTime = 1244U;
+    stepAndAssert(FAULT_NO_FAULT, timeoutCount - 1U);
+    stepAndAssert(FAULT_FAULT, 1U);
+    TEST_ASSERT_EQUAL_HEX32(FAULTMGR_FAULT_ACCELPDL_RANGE, mFaultMgr.internal.faults);
+    TEST_ASSERT_EQUAL_UINT32(1234U, mFaultMgr.internal.accelWatchdogTime);
+
+    // faults should latch
+    mVehicleState.data.inputs.accelOutOfRange = false;
+    stepAndAssert(FAULT_FAULT, timeoutCount);
+    TEST_ASSERT_EQUAL_UINT32(1234U, mFaultMgr.internal.accelWatchdogTime);
+}
+
 TEST(VEHICLELOGIC_FAULTMANAGER, FaultAccelPedalConsistency)
 {
     uint32_t timeoutCount = pedalInvalidTimeout / tickRateMs;
@@ -358,6 +388,7 @@ TEST_GROUP_RUNNER(VEHICLELOGIC_FAULTMANAGER)
 {
     RUN_TEST_CASE(VEHICLELOGIC_FAULTMANAGER, InitOk);
     RUN_TEST_CASE(VEHICLELOGIC_FAULTMANAGER, FaultAccelPedalRange);
+    RUN_TEST_CASE(VEHICLELOGIC_FAULTMANAGER, FaultAccelPedalWatchdog);
     RUN_TEST_CASE(VEHICLELOGIC_FAULTMANAGER, FaultAccelPedalConsistency);
     RUN_TEST_CASE(VEHICLELOGIC_FAULTMANAGER, FaultBrakePedalRange);
     RUN_TEST_CASE(VEHICLELOGIC_FAULTMANAGER, FaultPedalAbuse);
@@ -93,9 +93,8 @@ TEST(VEHICLELOGIC_WATCHDOGTRIGGER, TestTask)
         mockSetTaskNotifyValue(1); // to wake up
         WatchdogTrigger(&mWatchdogTrigger);
 
-        if ((i + 1) % 100 == 0) {
-            expectedGpio = !expectedGpio;
-        }
+        // Toggled each 1Hz notification
+        expectedGpio = !expectedGpio;
         TEST_ASSERT_EQUAL(expectedGpio, mockGet_GPIO_Asserted(mLedGpio.GPIOx, mLedGpio.GPIO_Pin));
     }
 }
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+import argparse
+
+"""
+Creates the slice-by-8 lookup tables for the software CRC in
+firmware/src/system-lib/crc/crc32table.c
+
+CRC is the MPEG-2 variant used by the STM32 CRC unit (and crc32mpeg2 in
+ecu-config): polynomial 0x04C11DB7, MSB first, no reflection, no final xor.
+
+Table[0][i] is the CRC (from 0) of byte i. Table[k][i] is the CRC of byte i
+followed by k zero bytes, so 8 bytes can be folded in with 8 lookups.
+"""
+
+POLY = 0x04C11DB7
+SLICES = 8
+
+
+def make_tables():
+    tables = [[0] * 256 for _ in range(SLICES)]
+    for i in range(256):
+        crc = i << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ POLY) if crc & 0x80000000 else (crc << 1)
+        tables[0][i] = crc & 0xFFFFFFFF
+    for k in range(1, SLICES):
+        for i in range(256):
+            prev = tables[k - 1][i]
+            tables[k][i] = ((prev << 8) & 0xFFFFFFFF) ^ tables[0][prev >> 24]
+    return tables
+
+
+def create_source(tables):
+    lines = [
+        '/*',
+        ' * crc32table.c',
+        ' *',
+        ' * Slice-by-8 tables for crc32.c. Generated by tools/create_crc_table.py,',
+        ' * do not edit.',
+        ' */',
+        '',
+        '#include "crc32.h"',
+        '',
+        'const uint32_t CRC32_Table[CRC32_TABLE_SLICES][256] = {',
+    ]
+    for k, table in enumerate(tables):
+        lines.append('  {')
+        for row in range(0, 256, 6):
+            values = ', '.join(f'0x{v:08X}U' for v in table[row:row + 6])
+            lines.append(f'    {values},')
+        lines.append('  },')
+    lines.append('};')
+    return '\n'.join(lines) + '\n'
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Create CRC lookup tables')
+    parser.add_argument('output', help='Path to crc32table.c')
+    args = parser.parse_args()
+
+    with open(args.output, 'w') as f:
+        f.write(create_source(make_tables()))
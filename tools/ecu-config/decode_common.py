@@ -2,30 +2,69 @@ from threading import Thread
 
 from colors import bcolors
 
-# Constants
-CHAR_COLON = 0x3A
-CHAR_CR = 0x0D
-CHAR_LF = 0x0A
+# Frame format, see firmware system-lib/uart/msgframe.h:
+#   Seq[1] Length[2] Address[2] Function[2] Data[Length] CRC[4]
+# COBS encoded, followed by a 0x00 delimiter.
+FRAME_DELIMITER = 0x00
+HEADER_LEN = 7
+CRC_LEN = 4
 
-MIN_NUM_BYTES = 10
-MAX_BUFFER_LEN = 1024
+MAX_DATA_LEN = 1024
+# Longest encoded frame, anything longer without a delimiter is dropped
+MAX_BUFFER_LEN = HEADER_LEN + MAX_DATA_LEN + CRC_LEN + 8
+
+"""
+CRC of a byte followed by the polynomial division, one entry per byte value.
+Same as Table[0] in firmware system-lib/crc/crc32table.c.
+"""
+def _crc32mpeg2_table():
+    table = []
+    for i in range(256):
+        crc = i << 24
+        for _ in range(8):
+            crc = crc << 1 if (crc & 0x80000000) == 0 else (crc << 1) ^ 0x104c11db7
+        table.append(crc)
+    return table
+
+_CRC_TABLE = _crc32mpeg2_table()
 
 """
 Use the MPEG-2 variant of CRC, because that's what the STM32 uses.
+Pass the result back in as crc to continue a CRC over more data.
 """
 def crc32mpeg2(buf, crc=0xffffffff):
     for val in buf:
-        crc ^= val << 24
-        for _ in range(8):
-            crc = crc << 1 if (crc & 0x80000000) == 0 else (crc << 1) ^ 0x104c11db7
+        crc = ((crc << 8) & 0xffffffff) ^ _CRC_TABLE[(crc >> 24) ^ val]
     return crc
 
 
+"""
+COBS decodes a frame (without the delimiter).
+Returns None if the frame isn't valid COBS.
+"""
+def cobs_decode(frame):
+    out = []
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame):
+            return None
+        block = frame[i+1:i+code]
+        if FRAME_DELIMITER in block:
+            return None
+        out.extend(block)
+        i += code
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    return out
+
+
 MSG_TYPE_LEN_VARIABLE = None
 
 class MsgType:
     """
-    Set len to None for variable length support
+    len is the data length. Set len to None for variable length support
+    type may be a tuple of types that share a handler and sequence number
     """
     def __init__(
         self,
@@ -36,6 +75,7 @@ class MsgType:
     ):
         self.name = name
         self.type = type
+        self.types = type if isinstance(type, tuple) else (type,)
         self.len = len
         self.handler = handler
 
@@ -55,132 +95,82 @@ class MsgDecoder:
         # array of MsgTypes
         self.message_type = msg_type
 
+        # Statistics
+        self.bad_frames = 0 # COBS, length or CRC errors
+        self.lost_frames = 0 # gaps in the sequence number of this type
+        self.last_seq = None
+
     def recv_bytes(self, b):
         # can receive multiple bytes at once
-        n = len(b)
-        b = int.from_bytes(b, 'little')
-        for i in range(n):
-            current_byte = (b >> (i*8)) & 0xFF
+        for current_byte in b:
             self.msg_buffer.append(current_byte)
 
             if self.OPT_PRINT_BYTES:
                 print(f'Received "{bcolors.OKCYAN}', hex(current_byte), f'{bcolors.ENDC}"')
 
-        # Should always start with a ':' character, so pop all bytes that aren't that
-        while len(self.msg_buffer) > 0 and self.msg_buffer[0] != CHAR_COLON:
-            self.msg_buffer.pop(0)
-
         if self.OPT_VERBOSE:
             print(f'{bcolors.OKBLUE}Buffer contents:', self.msg_buffer, '({})'.format(len(self.msg_buffer)), f'{bcolors.ENDC}')
 
-        # Wait until we have enough bytes
-        if self.message_type.len == MSG_TYPE_LEN_VARIABLE:
-            self.decode_bytes_variable_len(b)
-        else:
-            self.decode_bytes_fixed_len(b)
+        # Each delimiter ends a frame
+        while FRAME_DELIMITER in self.msg_buffer:
+            frame_len = self.msg_buffer.index(FRAME_DELIMITER)
+            frame = self.msg_buffer[:frame_len]
+            self.msg_buffer = self.msg_buffer[frame_len+1:]
+            if frame_len == 0:
+                continue
 
-    def decode_bytes_fixed_len(self, b):
-        while len(self.msg_buffer) >= self.message_type.len:
             if self.OPT_VERBOSE:
                 print(f'{bcolors.OKBLUE}Attempting decode{bcolors.ENDC}')
 
-            try_length = self.message_type.len
-            msg_received = self.try_decode(self.msg_buffer[:try_length], try_length)
+            msg_received = self.try_decode(frame)
             if msg_received:
-                if self.OPT_VERBOSE:
-                    print(f'{bcolors.OKBLUE}Found valid message {self.message_type.name}{bcolors.ENDC}')
-
                 self.handle_data(msg_received)
-
-                self.msg_buffer = self.msg_buffer[try_length:]
             else:
-                self.msg_buffer = self.msg_buffer[1:]
-
-    def decode_bytes_variable_len(self, b):
-        if len(self.msg_buffer) < MIN_NUM_BYTES:
-            return
+                self.bad_frames += 1
 
-        if self.OPT_VERBOSE:
-            print(f'{bcolors.OKBLUE}Attempting decode{bcolors.ENDC}')
-
-        # print(len(self.msg_buffer))
-        # print('loop attempts:', (len(self.msg_buffer) - MIN_NUM_BYTES)*(len(self.msg_buffer)-MIN_NUM_BYTES))
-        for try_offset in range(0, len(self.msg_buffer) - MIN_NUM_BYTES):
-            # The beginning of the msg could be offset slightly into the buffer
-            # so try multiple offsets into buffer
-            for try_len in range(MIN_NUM_BYTES, len(self.msg_buffer)):
-                # The msg could be any length, so try all options until something valid
-                # is received.
-                # We rely on the CRC being correct too, so even if a CRC failure
-                # may be allowed (e.g. on log messages), the message will still
-                # be lost.
-
-                msg_attempt = self.msg_buffer[try_offset:try_offset+try_len]
-
-                msg_valid = False
-                msg_received = self.try_decode(msg_attempt, try_len)
-                if msg_received:
-                    if msg_received['crc_correct']:
-                        msg_valid = True
-                        if self.OPT_VERBOSE:
-                            print(f'{bcolors.OKBLUE}Found valid message {self.message_type.name}{bcolors.ENDC}')
-                    else:
-                        if self.OPT_VERBOSE:
-                            print(f'{bcolors.OKBLUE}CRC mismatch on decode attempt {self.message_type.name}{bcolors.ENDC}')
-
-                if msg_valid:
-                    self.handle_data(msg_received)
-                    self.msg_buffer = self.msg_buffer[try_offset+try_len:]
+        if len(self.msg_buffer) > MAX_BUFFER_LEN:
+            # Can't be a valid frame, wait for the next delimiter
+            self.msg_buffer = []
+            self.bad_frames += 1
 
     """
-    Returns None if no msg received
+    Returns None if no valid msg received
     Returns dict summarizing received data.
 
     Params:
-        msg: array buffer to attempt to decode
-        try_type: MsgType object describing message type details to attempt
+        frame: COBS encoded frame, without the delimiter
     """
-    def try_decode(self, msg, expected_len):
+    def try_decode(self, frame):
         if self.OPT_VERBOSE:
             print(f'{bcolors.OKBLUE}try_decode on {self.message_type.name}{bcolors.ENDC}')
-        if len(msg) != expected_len:
+
+        msg = cobs_decode(frame)
+        if msg is None or len(msg) < HEADER_LEN + CRC_LEN:
             return None
 
-        expected_bytes = [
-            msg[0] == CHAR_COLON,
-            msg[-2] == CHAR_CR,
-            msg[-1] == CHAR_LF,
-        ]
-        if not all(expected_bytes):
+        data_len = (msg[1] << 8) | msg[2]
+        if len(msg) != HEADER_LEN + data_len + CRC_LEN:
             return None
 
         # Get CRC from message
-        msg_crc = 0
-        offset = 24
-        for byte in msg[-6:-2]:
-            msg_crc = msg_crc | (byte << offset)
-            offset -= 8
-
-        msg[-6:-2] = 4*[0]
-
-        calc_crc = crc32mpeg2(msg)
+        msg_crc = int.from_bytes(bytes(msg[-CRC_LEN:]), 'big')
+        calc_crc = crc32mpeg2(msg[:-CRC_LEN])
         if self.OPT_VERBOSE:
             print(f'{bcolors.OKBLUE}Calculated CRC', hex(calc_crc),
                 'got', hex(msg_crc), f'{bcolors.ENDC}')
 
         crc_correct = calc_crc == msg_crc
-        if not crc_correct and self.OPT_VERBOSE:
-            print(f'{bcolors.OKBLUE}CRC mismatch. Expecting', hex(calc_crc),
-                'got', hex(msg_crc), f'{bcolors.ENDC}')
-
-        addr = (msg[1] << 8) | msg[2]
-        msg_type = (msg[3] << 8) | msg[4]
-        recv_data = msg[5:-6]
+        if not crc_correct:
+            if self.OPT_VERBOSE:
+                print(f'{bcolors.OKBLUE}CRC mismatch. Expecting', hex(calc_crc),
+                    'got', hex(msg_crc), f'{bcolors.ENDC}')
+            return None
 
         ret = {
-            'payload': recv_data,
-            'msg_type': msg_type,
-            'addr': addr,
+            'payload': msg[HEADER_LEN:-CRC_LEN],
+            'msg_type': (msg[5] << 8) | msg[6],
+            'addr': (msg[3] << 8) | msg[4],
+            'seq': msg[0],
             'crc_calc': calc_crc,
             'crc_recv': msg_crc,
             'crc_correct': crc_correct
@@ -198,12 +188,23 @@ class MsgDecoder:
                 addr = msg['addr']
                 print(f'{bcolors.OKBLUE}Unexpected address {addr}{bcolors.ENDC}')
             return
-        if msg['msg_type'] != self.message_type.type:
+        if msg['msg_type'] not in self.message_type.types:
             if self.OPT_VERBOSE:
                 type = msg['msg_type']
                 print(f'{bcolors.OKBLUE}Unexpected type {type}{bcolors.ENDC}')
             return
 
+        if self.message_type.len is not MSG_TYPE_LEN_VARIABLE and \
+                len(msg['payload']) != self.message_type.len:
+            if self.OPT_VERBOSE:
+                print(f'{bcolors.OKBLUE}Unexpected length {len(msg["payload"])}{bcolors.ENDC}')
+            return
+
+        # Sender counts frames of each type
+        if self.last_seq is not None:
+            self.lost_frames += (msg['seq'] - self.last_seq - 1) & 0xFF
+        self.last_seq = msg['seq']
+
         if self.OPT_VERBOSE:
             print(f'{bcolors.OKBLUE}Invoking message handler{bcolors.ENDC}')
 
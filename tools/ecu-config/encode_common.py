@@ -1,8 +1,29 @@
-from decode_common import crc32mpeg2
+from decode_common import crc32mpeg2, FRAME_DELIMITER
 
-CHAR_COLON = 0x3A
-CHAR_CR = 0x0D
-CHAR_LF = 0x0A
+"""
+COBS encodes a frame, so it contains no delimiter bytes
+"""
+def cobs_encode(data):
+    out = [0]
+    code_pos = 0
+    code = 1
+    for byte in data:
+        if byte == 0:
+            out[code_pos] = code
+            code_pos = len(out)
+            out.append(0)
+            code = 1
+        else:
+            out.append(byte)
+            code += 1
+            if code == 0xFF:
+                # Block full, continue without an implied zero
+                out[code_pos] = code
+                code_pos = len(out)
+                out.append(0)
+                code = 1
+    out[code_pos] = code
+    return out
 
 """
 Returns byte array of standard message given input params
@@ -11,14 +32,19 @@ Args:
     target_addr: integer address of receiving device
     function: integer message function/type
     payload: standard array of message payload bytes
+    seq: sequence number, counted per function by the sender
 """
 def encode_message(
     target_addr,
     function,
-    payload
+    payload,
+    seq=0
 ):
     msg_header = [
-        CHAR_COLON,
+        seq & 0xFF,
+        # data length
+        (len(payload) >> 8) & 0xFF,
+        len(payload) & 0xFF,
         # target address
         (target_addr >> 8) & 0xFF,
         target_addr & 0xFF,
@@ -26,23 +52,15 @@ def encode_message(
         (function >> 8) & 0xFF,
         function & 0xFF
     ]
-    msg_trailing = [
-        0, 0, 0, 0, # CRC placeholder
-        CHAR_CR, CHAR_LF
-    ]
 
-    # Calculate initial message without zeroed CRC
-    msg = msg_header + payload + msg_trailing
+    # CRC covers everything before it
+    msg = msg_header + list(payload)
     calc_crc = crc32mpeg2(msg)
-
-    # Re-construct message with CRC
-    msg_trailing = [
+    msg += [
         (calc_crc >> 24) & 0xFF,
         (calc_crc >> 16) & 0xFF,
         (calc_crc >> 8) & 0xFF,
         (calc_crc >> 0) & 0xFF,
-        CHAR_CR, CHAR_LF
     ]
-    msg = msg_header + payload + msg_trailing
 
-    return bytes(msg)
\ No newline at end of file
+    return bytes(cobs_encode(msg) + [FRAME_DELIMITER])
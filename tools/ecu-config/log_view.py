@@ -4,12 +4,14 @@ Prints log data to terminal.
 """
 
 import os
+import re
+import struct
 from time import sleep
 from argparse import ArgumentParser
 import serial
 
 from decode_common import MsgDecoder, MsgType
-from serial_common import SerialHandler
+from serial_common import SerialHandler, ADDR_VCU
 from colors import bcolors
 
 BAUD_RATE = 115200
@@ -17,9 +19,36 @@ STOP_BITS = serial.STOPBITS_ONE
 
 ADDR_PC = 0x02
 MSG_TYPE_LOG = 0x02
-MSG_LEN_LOG = 43
-MSG_TYPE_STATE = 0x01
-MSG_LEN_STATE = 18
+MSG_LEN_LOG = None # variable, up to 128
+MSG_TYPE_LOG_RECORDS = 0x08
+MSG_LEN_LOG_RECORDS = None # variable, whole records up to 128
+LOG_RECORD_HEADER_LEN = 8
+LOG_SOURCE_ISR = 0x80
+MSG_TYPE_STATE = 0x04
+MSG_LEN_STATE = None # variable, fields up to 128 bytes
+STATE_FIELD_HEADER_LEN = 3
+MSG_TYPE_STATE_DELTA = 0x05 # shares the state batch sequence number
+MSG_TYPE_SUBSCRIBE = 0x0105
+MSG_TYPE_SUBSCRIBE_RESPONSE = 0x06
+MSG_LEN_SUBSCRIBE_RESPONSE = 4
+MSG_TYPE_STREAM = 0x0106
+MSG_TYPE_STREAM_BLOCK = 0x07
+MSG_LEN_STREAM_BLOCK = None # variable, whole samples up to 1024
+STREAM_BLOCK_HEADER_LEN = 8
+# Channels of a stream sample, in order (CInverter_Channel_T)
+STREAM_CHANNELS = [
+  'phase A current', 'phase B current', 'phase C current', 'DC bus current',
+  'vd', 'vq', 'flux command', 'flux feedback',
+  'id command', 'iq command', 'id feedback', 'iq feedback',
+  'modulation index', 'commanded torque', 'calculated torque', 'motor speed',
+]
+STREAM_SAMPLE_FORMAT = '>' + 'f' * len(STREAM_CHANNELS)
+SUBSCRIBE_STATUS = {
+  0x00: 'OK',
+  0x01: 'unknown field',
+  0x02: 'rate not supported',
+  0x03: 'no room',
+}
 
 FIELD_ID_NAMES = {
   0x0001: 'SDC',
@@ -33,9 +62,48 @@ FIELD_ID_NAMES = {
   0x0009: 'BMS SOC',
   0x000A: 'BMS Counter',
   0x000B: 'BMS Fault',
+  0x000C: 'BMS Min cell voltage',
+  0x000D: 'BMS Min cell temp',
+  0x0010: 'Accelerator',
+  0x0011: 'Brake pressure front',
+  0x0012: 'Brake pressure rear',
+  0x0018: 'Wheelspeed front',
+  0x0019: 'Wheelspeed rear',
+  0x0020: 'Motor temp',
+  0x0021: 'Motor speed',
+  0x0022: 'Motor torque',
+  0x0028: 'Inverter DC bus voltage',
+  0x0029: 'Inverter DC bus current',
+  0x002A: 'Inverter commanded torque',
+  0x002B: 'Inverter VSM state',
+  0x002C: 'Inverter run faults',
+}
+
+# UART link statistics, field ID is port base + stat offset
+UART_STAT_PORTS = {
+  0x0100: 'UART A',
+  0x0110: 'UART B',
 }
+UART_STAT_NAMES = [
+  'rx bytes',
+  'tx bytes',
+  'overrun errors',
+  'framing errors',
+  'noise errors',
+  'parity errors',
+  'DMA errors',
+  'rx stream overflow bytes',
+  'tx dropped bytes',
+  'tx full bytes',
+  'tx backlog peak',
+  'tx chain peak',
+]
+for port_base, port_name in UART_STAT_PORTS.items():
+  for offset, stat_name in enumerate(UART_STAT_NAMES):
+    FIELD_ID_NAMES[port_base + offset] = f'{port_name} {stat_name}'
 
 OPT_RAW = False
+LOG_FORMATS = None
 
 """
 Handler method for a log message data
@@ -55,25 +123,351 @@ def handle_log_data(msg_info):
     print(f'{bcolors.FAIL}{msg_str}{bcolors.ENDC}', end='', flush=True)
 
 
+class LogFormats:
+  """
+  Deferred log format strings, dumped from the logfmt section of the ELF by
+  the firmware build (vcu.logfmt). A record's ID is the offset of its format
+  string.
+  """
+  def __init__(self, data):
+    self.data = data
+
+  def get(self, fmt_id):
+    if fmt_id >= len(self.data):
+      return None
+    end = self.data.find(b'\0', fmt_id)
+    if end < 0:
+      return None
+    return self.data[fmt_id:end].decode(errors='replace')
+
+
+# printf conversion: flags, width and precision, length, conversion
+FORMAT_SPEC = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diuxXocfeEgG%])')
+
+"""
+Formats a deferred log record like printf on the VCU would, from its format
+string and 32 bit arguments. Signed conversions are sign extended, and float
+conversions take the bits of a float.
+Returns None if there are fewer arguments than conversions.
+"""
+def format_log_record(fmt, args):
+  out = []
+  pos = 0
+  args = list(args)
+  for match in FORMAT_SPEC.finditer(fmt):
+    out.append(fmt[pos:match.start()])
+    pos = match.end()
+    spec, _, conv = match.groups()
+    if conv == '%':
+      out.append('%')
+      continue
+    if not args:
+      return None
+    arg = args.pop(0)
+    if conv in 'di':
+      arg = arg - (1 << 32) if arg & 0x80000000 else arg
+    elif conv in 'feEgG':
+      arg = struct.unpack('>f', struct.pack('>I', arg))[0]
+    elif conv == 'u':
+      conv = 'd'
+    out.append(f'%{spec}{conv}' % arg)
+  out.append(fmt[pos:])
+  return ''.join(out)
+
+
+"""
+Splits a log records payload into (ID, source, timestamp, args) tuples. Each
+record is ID[2] Num Args[1] Source[1] Time[4] Args[4 each], big endian.
+Returns None if the payload is cut short.
+"""
+def decode_log_records(payload):
+  records = []
+  i = 0
+  while i < len(payload):
+    if i + LOG_RECORD_HEADER_LEN > len(payload):
+      return None
+    fmt_id, num_args, source, timestamp = struct.unpack_from('>HBBI', bytes(payload), i)
+    i += LOG_RECORD_HEADER_LEN
+    if i + 4 * num_args > len(payload):
+      return None
+    records.append((fmt_id, source, timestamp,
+                    struct.unpack_from(f'>{num_args}I', bytes(payload), i)))
+    i += 4 * num_args
+  return records
+
+
+class LogClock:
+  """
+  Record timestamps are 32 bit microseconds since the VCU started, which
+  wrap every 71 minutes. Records from different tasks can arrive slightly
+  out of order, so each is placed by the shortest step from the last.
+  """
+  def __init__(self):
+    self.last = None
+    self.us = 0
+
+  def update(self, timestamp):
+    """
+    Returns the seconds since the VCU started, and since the last record
+    """
+    if self.last is None:
+      self.us = timestamp
+      delta = 0
+    else:
+      delta = (timestamp - self.last) & 0xFFFFFFFF
+      if delta & 0x80000000:
+        delta -= 1 << 32
+      self.us += delta
+    self.last = timestamp
+    return self.us / 1e6, delta / 1e6
+
+
+LOG_CLOCK = LogClock()
+
+
 """
-Handler method for state message data
+Names what printed a record: a task by number (numbered in the order they
+are created), or an interrupt by its IRQ number
+"""
+def log_record_source(source):
+  if source & LOG_SOURCE_ISR:
+    exception = source & ~LOG_SOURCE_ISR
+    return f'irq {exception - 16}' if exception >= 16 else f'exc {exception}'
+  return f'task {source}' if source else 'init'
+
+
+"""
+Handler method for deferred log records
+"""
+def handle_log_records(msg_info):
+  if not msg_info['crc_correct']:
+    print(f'{bcolors.FAIL}Log records lost{bcolors.ENDC}')
+    return
+  records = decode_log_records(msg_info['payload'])
+  if records is None:
+    print('Malformed log records')
+    return
+
+  for fmt_id, source, timestamp, args in records:
+    seconds, delta = LOG_CLOCK.update(timestamp)
+    prefix = f'{seconds:12.6f} {delta:+10.6f} {log_record_source(source):<9} '
+    fmt = LOG_FORMATS.get(fmt_id) if LOG_FORMATS is not None else None
+    msg_str = format_log_record(fmt, args) if fmt is not None else None
+    if msg_str is None:
+      print(f'{bcolors.WARNING}{prefix}Log record {hex(fmt_id)} {[hex(x) for x in args]}'
+            f'{bcolors.ENDC}')
+      continue
+    if OPT_RAW:
+      msg_str = repr(msg_str)
+    print(prefix + msg_str, end='', flush=True)
+
+
+"""
+Splits a state batch payload into (field ID, size, value) tuples. Each field
+is ID[2] Size[1] Value[Size], value big endian.
+Returns None if the payload is cut short.
+"""
+def decode_state_batch(payload):
+  fields = []
+  i = 0
+  while i < len(payload):
+    if i + STATE_FIELD_HEADER_LEN > len(payload):
+      return None
+    field_id = (payload[i] << 8) | payload[i + 1]
+    field_len = payload[i + 2]
+    i += STATE_FIELD_HEADER_LEN
+    if i + field_len > len(payload):
+      return None
+    value = int.from_bytes(bytes(payload[i:i + field_len]), 'big')
+    fields.append((field_id, field_len, value))
+    i += field_len
+  return fields
+
+
+"""
+Reads an unsigned varint, LSB first, 7 bits per byte.
+Returns (value, next index), or None if the payload is cut short.
+"""
+def read_varint(payload, i):
+  value = 0
+  shift = 0
+  while i < len(payload):
+    value |= (payload[i] & 0x7F) << shift
+    shift += 7
+    i += 1
+    if payload[i - 1] & 0x80 == 0:
+      return value, i
+  return None
+
+
+"""
+Splits a state delta payload into (field ID, difference) pairs. Each field is
+varint(ID) varint(zigzag(difference)).
+Returns None if the payload is cut short.
+"""
+def decode_state_delta(payload):
+  fields = []
+  i = 0
+  while i < len(payload):
+    field_id = read_varint(payload, i)
+    if field_id is None:
+      return None
+    field_id, i = field_id
+    diff = read_varint(payload, i)
+    if diff is None:
+      return None
+    diff, i = diff
+    fields.append((field_id, (diff >> 1) ^ -(diff & 1)))
+  return fields
+
+
+class StateTracker:
+  """
+  Rebuilds state field values from state batches, which have every field of
+  a stream, and state deltas, which have the change in each field since it
+  was last sent.
+  After a gap in the sequence number a delta may have been missed, so values
+  are unknown until they are next in a state batch.
+  """
+  def __init__(self):
+    self.fields = {} # field ID: (size, value)
+    self.last_seq = None
+    self.lost_frames = 0
+
+  def _check_seq(self, seq):
+    if self.last_seq is not None and seq != (self.last_seq + 1) & 0xFF:
+      self.lost_frames += (seq - self.last_seq - 1) & 0xFF
+      self.fields.clear()
+    self.last_seq = seq
+
+  """
+  Applies a state batch or delta message.
+  Returns the (field ID, value) pairs updated, or None if malformed.
+  """
+  def apply(self, msg_type, seq, payload):
+    self._check_seq(seq)
+    updated = []
+    if msg_type == MSG_TYPE_STATE:
+      fields = decode_state_batch(payload)
+      if fields is None:
+        return None
+      for field_id, size, value in fields:
+        self.fields[field_id] = (size, value)
+        updated.append((field_id, value))
+    else:
+      fields = decode_state_delta(payload)
+      if fields is None:
+        return None
+      for field_id, diff in fields:
+        if field_id not in self.fields:
+          continue # Wait for the next state batch
+        size, value = self.fields[field_id]
+        value = (value + diff) & ((1 << (8 * size)) - 1)
+        self.fields[field_id] = (size, value)
+        updated.append((field_id, value))
+    return updated
+
+
+STATE_TRACKER = StateTracker()
+
+
+"""
+Splits a stream block payload into (first sample, dropped, samples), each
+sample a tuple of channel values.
+Returns None if the payload isn't whole samples.
+"""
+def decode_stream_block(payload):
+  sample_len = struct.calcsize(STREAM_SAMPLE_FORMAT)
+  samples_len = len(payload) - STREAM_BLOCK_HEADER_LEN
+  if samples_len < 0 or samples_len % sample_len != 0:
+    return None
+  first_sample, dropped = struct.unpack_from('>II', bytes(payload))
+  samples = [
+    struct.unpack_from(STREAM_SAMPLE_FORMAT, bytes(payload), i)
+    for i in range(STREAM_BLOCK_HEADER_LEN, len(payload), sample_len)
+  ]
+  return first_sample, dropped, samples
+
+
+class StreamWriter:
+  """
+  Writes stream samples to a CSV file, a line per sample numbered from the
+  first sample of each block. Samples missing between blocks, dropped by the
+  VCU or lost with a frame, are reported.
+  """
+  def __init__(self, file):
+    self.file = file
+    self.next_sample = None
+    self.dropped = 0 # VCU count at the last block
+    self.missing = 0
+    self.file.write('sample,' + ','.join(STREAM_CHANNELS) + '\n')
+
+  def write(self, first_sample, dropped, samples):
+    if self.next_sample is not None and first_sample != self.next_sample:
+      missing = (first_sample - self.next_sample) & 0xFFFFFFFF
+      self.missing += missing
+      print(f'{bcolors.WARNING}Stream: {missing} samples missing, '
+            f'{(dropped - self.dropped) & 0xFFFFFFFF} dropped by the VCU'
+            f'{bcolors.ENDC}')
+    self.dropped = dropped
+    for i, sample in enumerate(samples):
+      values = ','.join(f'{x:g}' for x in sample)
+      self.file.write(f'{(first_sample + i) & 0xFFFFFFFF},{values}\n')
+    self.next_sample = (first_sample + len(samples)) & 0xFFFFFFFF
+
+
+STREAM_WRITER = None
+
+"""
+Handler method for state batch and state delta message data
 """
 def handle_state_data(msg_info):
   msg_data = msg_info['payload']
   crc_correct = msg_info['crc_correct']
   if crc_correct:
-    field_id = (msg_data[0] << 8) | msg_data[1]
-    field_len = msg_data[2]
-    value = 0
-    for i in range(field_len):
-      ith_byte = msg_data[6 - i]
-      value |= ith_byte << (i*8)
-
-    if field_id not in FIELD_ID_NAMES:
-      print('Unexpected field ID {}'.format(hex(field_id)))
+    fields = STATE_TRACKER.apply(msg_info['msg_type'], msg_info['seq'], msg_data)
+    if fields is None:
+      print('Malformed state message')
       return
 
-    print('State Update {} {}'.format(FIELD_ID_NAMES[field_id], hex(value)))
+    for field_id, value in fields:
+      if field_id not in FIELD_ID_NAMES:
+        print('Unexpected field ID {}'.format(hex(field_id)))
+        continue
+
+      print('State Update {} {}'.format(FIELD_ID_NAMES[field_id], hex(value)))
+
+
+"""
+Handler method for subscribe response data
+"""
+def handle_subscribe_response(msg_info):
+  payload = msg_info['payload']
+  field_id = (payload[0] << 8) | payload[1]
+  status = SUBSCRIBE_STATUS.get(payload[3], hex(payload[3]))
+  name = FIELD_ID_NAMES.get(field_id, hex(field_id))
+  print(f'{bcolors.HEADER}Subscribe {name} at {payload[2]} Hz: {status}{bcolors.ENDC}')
+
+
+"""
+Handler method for stream block data
+"""
+def handle_stream_block(msg_info):
+  if not msg_info['crc_correct'] or STREAM_WRITER is None:
+    return
+  block = decode_stream_block(msg_info['payload'])
+  if block is None:
+    print('Malformed stream block')
+    return
+  STREAM_WRITER.write(*block)
+
+
+"""
+Parses a subscription argument, FIELD:RATE, e.g. 0x21:100
+"""
+def parse_subscription(arg):
+  field_id, rate = arg.split(':')
+  return int(field_id, 0), int(rate, 0)
 
 
 def main():
@@ -85,12 +479,26 @@ def main():
                       help='View output data without formatting')
   parser.add_argument('-b', '--bytes', dest='bytes', action='store_true',
                       help='Print each byte as it is read')
+  parser.add_argument('--baud', type=int,
+                      help='Switch the link to this baud rate after connecting')
+  parser.add_argument('-s', '--subscribe', type=parse_subscription, action='append',
+                      default=[], metavar='FIELD:RATE',
+                      help='Send a state field at RATE Hz (1 to 100, 0 to stop)')
+  parser.add_argument('--stream', metavar='CSV',
+                      help='Stream the inverter channels every tick to a CSV file')
+  parser.add_argument('-f', '--log-formats', metavar='LOGFMT',
+                      help='Deferred log format strings from the firmware build (vcu.logfmt)')
   args = parser.parse_args()
   
   if args.raw:
     global OPT_RAW
     OPT_RAW = True
 
+  if args.log_formats:
+    global LOG_FORMATS
+    with open(args.log_formats, 'rb') as file:
+      LOG_FORMATS = LogFormats(file.read())
+
   print(f'{bcolors.HEADER}Launching threads{bcolors.ENDC}')
 
   msg_log_decoder = MsgDecoder(
@@ -108,7 +516,7 @@ def main():
     self_address=ADDR_PC,
     msg_type=MsgType(
       name="STATE",
-      type=MSG_TYPE_STATE,
+      type=(MSG_TYPE_STATE, MSG_TYPE_STATE_DELTA),
       len=MSG_LEN_STATE,
       handler=handle_state_data,
     ),
@@ -122,11 +530,52 @@ def main():
       stop_bits=STOP_BITS,
   )
   serial_handler.add_decoder(msg_log_decoder)
+  serial_handler.add_decoder(MsgDecoder(
+    self_address=ADDR_PC,
+    msg_type=MsgType(
+      name="LOG_RECORDS",
+      type=MSG_TYPE_LOG_RECORDS,
+      len=MSG_LEN_LOG_RECORDS,
+      handler=handle_log_records,
+    ),
+  ))
   serial_handler.add_decoder(msg_state_decoder)
+  serial_handler.add_decoder(MsgDecoder(
+    self_address=ADDR_PC,
+    msg_type=MsgType(
+      name="SUBSCRIBE",
+      type=MSG_TYPE_SUBSCRIBE_RESPONSE,
+      len=MSG_LEN_SUBSCRIBE_RESPONSE,
+      handler=handle_subscribe_response,
+    ),
+  ))
+
+  if args.stream:
+    global STREAM_WRITER
+    STREAM_WRITER = StreamWriter(open(args.stream, 'w'))
+    serial_handler.add_decoder(MsgDecoder(
+      self_address=ADDR_PC,
+      msg_type=MsgType(
+        name="STREAM",
+        type=MSG_TYPE_STREAM_BLOCK,
+        len=MSG_LEN_STREAM_BLOCK,
+        handler=handle_stream_block,
+      ),
+    ))
+
+  if args.baud:
+    serial_handler.switch_baud_rate(args.baud)
 
   try:
     serial_handler.start()
 
+    for field_id, rate in args.subscribe:
+      payload = [(field_id >> 8) & 0xFF, field_id & 0xFF, rate] + 5*[0]
+      serial_handler.send_message(ADDR_VCU, MSG_TYPE_SUBSCRIBE, payload)
+
+    if STREAM_WRITER is not None:
+      serial_handler.send_message(ADDR_VCU, MSG_TYPE_STREAM, [1] + 7*[0])
+
     if os.name != 'nt':
       # Don't join serial_handler on windows - this would block ctrl-C
       serial_handler.join()
@@ -134,6 +583,9 @@ def main():
     print()
     print(f'{bcolors.HEADER}Quitting{bcolors.ENDC}')
 
+  if STREAM_WRITER is not None:
+    serial_handler.send_message(ADDR_VCU, MSG_TYPE_STREAM, [0] + 7*[0])
+    STREAM_WRITER.file.close()
   serial_handler.close_port()
 
 
@@ -1,7 +1,23 @@
 from threading import Thread
+from time import monotonic
 import serial
 
 from colors import bcolors
+from decode_common import MsgDecoder, MsgType
+from encode_common import encode_message
+
+# Baud rate negotiation, see firmware pcinterface/baudrate.c
+ADDR_VCU = 0x01
+ADDR_PC = 0x02
+MSG_TYPE_BAUD_REQUEST = 0x0103
+MSG_TYPE_BAUD_CONFIRM = 0x0104
+MSG_TYPE_BAUD_RESPONSE = 0x03
+MSG_LEN_BAUD_RESPONSE = 5
+BAUD_ACCEPTED = 0x00
+BAUD_REJECTED = 0x01
+BAUD_BUSY = 0x02
+BAUD_CONFIRMED = 0x03
+BAUD_CONFIRM_RETRY_S = 0.1
 
 class SerialHandler:
     def __init__(
@@ -11,6 +27,7 @@ class SerialHandler:
         stop_bits
     ):
         self.decoders = []
+        self.tx_seq = {} # next sequence number of each function
         self.thread_recv = Thread(target=self.recv, daemon=True)
         self.open_port(
             port=port,
@@ -53,6 +70,84 @@ class SerialHandler:
     def add_decoder(self, decoder):
         self.decoders.append(decoder)
 
+    """
+    Frames and sends a message, counting the sequence number per function
+    """
+    def send_message(self, target_addr, function, payload):
+        seq = self.tx_seq.get(function, 0)
+        self.tx_seq[function] = (seq + 1) & 0xFF
+        self.serial.write(encode_message(target_addr, function, payload, seq))
+
+    def wait_baud_response(self, decoder, responses, baud_rate, deadline):
+        while monotonic() < deadline:
+            b = self.serial.read(self.serial.in_waiting or 1)
+            if b:
+                decoder.recv_bytes(b)
+            for rate, status in responses:
+                if rate == baud_rate:
+                    return status
+        return None
+
+    """
+    Switches the link to a new baud rate. Call before start().
+    Returns True if switched, otherwise the link stays at the current rate.
+
+    Args:
+        baud_rate: new baud rate
+        timeout: seconds to wait for each step. Should be no longer than the
+            VCU's timeout (1 s) so both ends revert together.
+    """
+    def switch_baud_rate(self, baud_rate, timeout=1.0):
+        responses = []
+        def handle_response(msg_info):
+            payload = msg_info['payload']
+            rate = int.from_bytes(bytes(payload[0:4]), 'big')
+            responses.append((rate, payload[4]))
+
+        decoder = MsgDecoder(
+            self_address=ADDR_PC,
+            msg_type=MsgType(
+                name="BAUD",
+                type=MSG_TYPE_BAUD_RESPONSE,
+                len=MSG_LEN_BAUD_RESPONSE,
+                handler=handle_response,
+            ),
+        )
+        payload = list(baud_rate.to_bytes(4, 'big')) + 4*[0]
+        old_baud_rate = self.serial.baudrate
+
+        print(f'{bcolors.HEADER}Requesting baud rate {baud_rate}{bcolors.ENDC}')
+        self.serial.reset_input_buffer()
+        self.send_message(ADDR_VCU, MSG_TYPE_BAUD_REQUEST, payload)
+        status = self.wait_baud_response(
+            decoder, responses, baud_rate, monotonic() + timeout)
+        if status != BAUD_ACCEPTED:
+            print(f'{bcolors.FAIL}Baud rate not accepted ({status}){bcolors.ENDC}')
+            return False
+
+        # VCU switches once the response has been sent
+        self.serial.flush()
+        self.serial.baudrate = baud_rate
+        responses.clear()
+        decoder.msg_buffer = []
+
+        # Confirm at the new rate, until the VCU answers
+        deadline = monotonic() + timeout
+        status = None
+        while status is None and monotonic() < deadline:
+            self.send_message(ADDR_VCU, MSG_TYPE_BAUD_CONFIRM, payload)
+            status = self.wait_baud_response(
+                decoder, responses, baud_rate,
+                min(deadline, monotonic() + BAUD_CONFIRM_RETRY_S))
+
+        if status != BAUD_CONFIRMED:
+            print(f'{bcolors.FAIL}Baud rate not confirmed, reverting to {old_baud_rate}{bcolors.ENDC}')
+            self.serial.baudrate = old_baud_rate
+            return False
+
+        print(f'{bcolors.HEADER}Switched to baud rate {baud_rate}{bcolors.ENDC}')
+        return True
+
 
 class SerialTx:
     def __init__(